@@ -0,0 +1,121 @@
+# Copyright (c) 2017-2018 InterlockLedger Network
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# ==============================================================================
+# This module locates the Google Benchmark library. It follows the same
+# conventions of the GTest module.
+#
+# Targets:
+#    - GBench
+#
+# Variables:
+#
+#    - GBENCH_FOUND
+#    - GBENCH_INCLUDE_DIR
+#    - GBENCH_LIB
+#    - GBENCHD_LIB
+#
+# The environment variable GBENCH_HOME may be used to point to a custom
+# installation of the library.
+#
+# This method depends on MSVCCRT from OpenCS in order to work properly.
+if(__IR_GBENCH)
+  return()
+endif()
+set(__IR_GBENCH 1)
+
+function(gbench_log _msg)
+	if (GBENCH_VERBOSE)
+		message(STATUS ${_msg})
+	endif()
+endfunction()
+
+# Check the dependency on 
+if (NOT __OPENCS_MSVCCRT)
+	message(FATAL_ERROR "GBench module requires OpenCS MSVCCRT module in order to work properly.")
+endif()
+
+# Find the Google Benchmark directory
+if (NOT DEFINED GBENCH_HOME)
+	if(NOT "$ENV{GBENCH_HOME}" STREQUAL "")
+		set(GBENCH_HOME "$ENV{GBENCH_HOME}")
+	endif()
+endif()
+
+# Find the header location
+if (DEFINED GBENCH_HOME)
+	find_path(GBENCH_INCLUDE_DIR
+		benchmark/benchmark.h
+		HINTS "${GBENCH_HOME}"
+		PATH_SUFFIXES include)
+else()
+	find_path(GBENCH_INCLUDE_DIR
+		benchmark/benchmark.h)
+endif()
+
+find_package(Threads REQUIRED)
+
+if (WIN32)
+	set(_GBENCH_LIB_DIR "lib/${WIN32_TARGET_PLATFORM}/${MSVC_CRT_FLAG}")
+	find_library(GBENCH_LIB
+		benchmark.lib
+		PATHS "${GBENCH_HOME}"
+		PATH_SUFFIXES "${_GBENCH_LIB_DIR}")
+	find_library(GBENCHD_LIB
+		benchmark.lib
+		PATHS "${GBENCH_HOME}"
+		PATH_SUFFIXES "${_GBENCH_LIB_DIR}D")
+	set(GBENCH_DEPS Shlwapi.lib)
+else()
+	find_library(GBENCH_LIB
+		NAMES libbenchmark.a benchmark
+		HINTS "${GBENCH_HOME}"
+		PATH_SUFFIXES lib)
+	find_library(GBENCHD_LIB
+		libbenchmark-dbg.a
+		HINTS "${GBENCH_HOME}"
+		PATH_SUFFIXES lib)
+	if (NOT GBENCHD_LIB)
+		set(GBENCHD_LIB ${GBENCH_LIB})
+	endif()
+	set(GBENCH_DEPS Threads::Threads)
+endif()
+
+if (GBENCH_INCLUDE_DIR AND GBENCH_LIB)
+	gbench_log("Google Benchmark headers found at ${GBENCH_INCLUDE_DIR}.")
+	if(NOT TARGET GBench)
+		add_library(GBench UNKNOWN IMPORTED)
+		set_target_properties(GBench PROPERTIES
+			INTERFACE_INCLUDE_DIRECTORIES "${GBENCH_INCLUDE_DIR}"
+			INTERFACE_LINK_LIBRARIES "${GBENCH_DEPS}"
+			IMPORTED_LOCATION "${GBENCH_LIB}")
+		set_property(TARGET GBench APPEND PROPERTY
+			IMPORTED_CONFIGURATIONS RELEASE)
+		set_target_properties(GBench PROPERTIES
+			IMPORTED_LINK_INTERFACE_LANGUAGES_RELEASE "CXX"
+			IMPORTED_LOCATION_RELEASE "${GBENCH_LIB}")
+		gbench_log("Google Benchmark release lib found at ${GBENCH_LIB}.")
+		if (GBENCHD_LIB)
+			set_property(TARGET GBench APPEND PROPERTY
+				IMPORTED_CONFIGURATIONS DEBUG)
+			set_target_properties(GBench PROPERTIES
+				IMPORTED_LINK_INTERFACE_LANGUAGES_DEBUG "CXX"
+				IMPORTED_LOCATION_DEBUG "${GBENCHD_LIB}")
+			gbench_log("Google Benchmark debug lib found at ${GBENCHD_LIB}.")
+		endif()
+	endif()
+	set(GBENCH_FOUND 1)
+else()
+	gbench_log("Google Benchmark not found. The benchmarks will not be built.")
+endif()
@@ -0,0 +1,326 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <benchmark/benchmark.h>
+#include <ircommon/ilint.h>
+#include <random>
+#include <vector>
+using namespace ircommon;
+
+//------------------------------------------------------------------------------
+// The original byte by byte implementation, kept as the baseline. It must not
+// be inlined, just like the library calls it is compared to.
+//------------------------------------------------------------------------------
+#if defined(__GNUC__) || defined(__clang__)
+	#define ILIntBench_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+	#define ILIntBench_NOINLINE __declspec(noinline)
+#else
+	#define ILIntBench_NOINLINE
+#endif
+
+ILIntBench_NOINLINE static int ILIntBench_legacySize(std::uint64_t v) {
+
+	if (v < ILInt::ILINT_BASE) {
+		return 1;
+	} else if (v <= (0xFF + ILInt::ILINT_BASE)) {
+		return 2;
+	} else if ( v <= (0xFFFF + ILInt::ILINT_BASE)){
+		return 3;
+	} else if ( v <= (0xFFFFFFl + ILInt::ILINT_BASE)){
+		return 4;
+	} else if ( v <= (0xFFFFFFFFll + ILInt::ILINT_BASE)){
+		return 5;
+	} else if ( v <= (0xFFFFFFFFFFll + ILInt::ILINT_BASE)){
+		return 6;
+	} else if ( v <= (0xFFFFFFFFFFFFll + ILInt::ILINT_BASE)){
+		return 7;
+	} else if ( v <= (0xFFFFFFFFFFFFFFll + ILInt::ILINT_BASE)){
+		return 8;
+	} else {
+		return 9;
+	}
+}
+
+//------------------------------------------------------------------------------
+ILIntBench_NOINLINE static int ILIntBench_legacyEncode(std::uint64_t v, void * out, int outSize) {
+	int size;
+	std::uint8_t * p;
+	int i;
+
+	size = ILIntBench_legacySize(v);
+	if (outSize < size) {
+		return 0;
+	}
+	p = (std::uint8_t *)out;
+	if (size == 1) {
+		*p = (std::uint8_t)(v & 0xFF);
+	} else {
+		*p = ILInt::ILINT_BASE + (size - 2);
+		p++;
+		v = v - ILInt::ILINT_BASE;
+		for (i = ((size - 2) * 8); i >= 0; i -=8, p++) {
+			*p = (std::uint8_t)((v >> i) & 0xFF);
+		}
+	}
+	return size;
+}
+
+//------------------------------------------------------------------------------
+ILIntBench_NOINLINE static int ILIntBench_legacyDecode(const void * inp, int inpSize,
+		std::uint64_t * v) {
+	const std::uint8_t * p;
+	const std::uint8_t * pEnd;
+	int size;
+
+	if (inpSize <= 0) {
+		return 0;
+	}
+	p = (const std::uint8_t *) inp;
+	size = *p;
+	if (size < ILInt::ILINT_BASE) {
+		*v = size;
+		return 1;
+	} else {
+		p++;
+		size = size - ILInt::ILINT_BASE + 1;
+		if (inpSize <= size) {
+			return 0;
+		}
+		pEnd = p + size;
+		*v = 0;
+		for (; p < pEnd; p++) {
+			*v = ((*v) << 8) | ((*p) & 0xFF);
+		}
+		if (*v > (0xFFFFFFFFFFFFFFFFll - ILInt::ILINT_BASE)) {
+			return 0;
+		}
+		*v += ILInt::ILINT_BASE;
+		size++;
+		return size;
+	}
+}
+
+//------------------------------------------------------------------------------
+// Sample generation
+//------------------------------------------------------------------------------
+#define ILIntBench_SAMPLE_COUNT 4096
+
+/**
+ * Creates the samples. Distribution 0 is uniform over the encoded sizes,
+ * distribution 1 is skewed towards the small values, like the tag IDs and
+ * sizes found in real blocks, and distribution 2 are the gaps between sorted
+ * offsets as stored by the indexes.
+ */
+static std::vector<std::uint64_t> ILIntBench_createValues(int distribution,
+		std::uint64_t count = ILIntBench_SAMPLE_COUNT) {
+	std::vector<std::uint64_t> values(count);
+	std::mt19937_64 random(2018);
+
+	for (std::uint64_t & v : values) {
+		int bits;
+		if (distribution == 0) {
+			bits = 8 * (1 + (random() % 8));
+		} else if (distribution == 2) {
+			bits = ((random() % 100) < 98) ? 7 : 16;
+		} else {
+			int r = random() % 100;
+			bits = (r < 80) ? 7 : ((r < 95) ? 12 : ((r < 99) ? 20 : 40));
+		}
+		v = random() >> (64 - bits);
+	}
+	return values;
+}
+
+//------------------------------------------------------------------------------
+static std::vector<std::uint8_t> ILIntBench_encodeValues(
+		const std::vector<std::uint64_t> & values) {
+	std::vector<std::uint8_t> enc(ILInt::size(values.data(), values.size()));
+
+	ILInt::encodeMany(values.data(), values.size(), enc.data(), enc.size());
+	return enc;
+}
+
+//------------------------------------------------------------------------------
+static void ILIntBench_setLabel(benchmark::State & state,
+		std::uint64_t count = ILIntBench_SAMPLE_COUNT) {
+	static const char * const LABELS[] = {"random", "skewed", "offsets"};
+
+	state.SetLabel(LABELS[state.range(0)]);
+	state.SetItemsProcessed(state.iterations() * count);
+}
+
+//------------------------------------------------------------------------------
+// Benchmarks
+//------------------------------------------------------------------------------
+static void ILIntBench_sizeLegacy(benchmark::State & state) {
+	std::vector<std::uint64_t> values = ILIntBench_createValues(state.range(0));
+
+	for (auto _ : state) {
+		std::uint64_t total = 0;
+		for (std::uint64_t v : values) {
+			total += ILIntBench_legacySize(v);
+		}
+		benchmark::DoNotOptimize(total);
+	}
+	ILIntBench_setLabel(state);
+}
+BENCHMARK(ILIntBench_sizeLegacy)->Arg(0)->Arg(1);
+
+//------------------------------------------------------------------------------
+static void ILIntBench_size(benchmark::State & state) {
+	std::vector<std::uint64_t> values = ILIntBench_createValues(state.range(0));
+
+	for (auto _ : state) {
+		std::uint64_t total = 0;
+		for (std::uint64_t v : values) {
+			total += ILInt::size(v);
+		}
+		benchmark::DoNotOptimize(total);
+	}
+	ILIntBench_setLabel(state);
+}
+BENCHMARK(ILIntBench_size)->Arg(0)->Arg(1);
+
+//------------------------------------------------------------------------------
+static void ILIntBench_encodeLegacy(benchmark::State & state) {
+	std::vector<std::uint64_t> values = ILIntBench_createValues(state.range(0));
+	std::vector<std::uint8_t> out(values.size() * 9);
+
+	for (auto _ : state) {
+		std::uint8_t * p = out.data();
+		std::uint8_t * pEnd = p + out.size();
+		for (std::uint64_t v : values) {
+			p += ILIntBench_legacyEncode(v, p, pEnd - p);
+		}
+		benchmark::DoNotOptimize(out.data());
+	}
+	ILIntBench_setLabel(state);
+}
+BENCHMARK(ILIntBench_encodeLegacy)->Arg(0)->Arg(1);
+
+//------------------------------------------------------------------------------
+static void ILIntBench_encode(benchmark::State & state) {
+	std::vector<std::uint64_t> values = ILIntBench_createValues(state.range(0));
+	std::vector<std::uint8_t> out(values.size() * 9);
+
+	for (auto _ : state) {
+		std::uint8_t * p = out.data();
+		std::uint8_t * pEnd = p + out.size();
+		for (std::uint64_t v : values) {
+			p += ILInt::encode(v, p, pEnd - p);
+		}
+		benchmark::DoNotOptimize(out.data());
+	}
+	ILIntBench_setLabel(state);
+}
+BENCHMARK(ILIntBench_encode)->Arg(0)->Arg(1);
+
+//------------------------------------------------------------------------------
+static void ILIntBench_encodeMany(benchmark::State & state) {
+	std::vector<std::uint64_t> values = ILIntBench_createValues(state.range(0));
+	std::vector<std::uint8_t> out(values.size() * 9);
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(ILInt::encodeMany(values.data(),
+				values.size(), out.data(), out.size()));
+	}
+	ILIntBench_setLabel(state);
+}
+BENCHMARK(ILIntBench_encodeMany)->Arg(0)->Arg(1);
+
+//------------------------------------------------------------------------------
+static void ILIntBench_decodeLegacy(benchmark::State & state) {
+	std::vector<std::uint64_t> values = ILIntBench_createValues(state.range(0));
+	std::vector<std::uint8_t> enc = ILIntBench_encodeValues(values);
+
+	for (auto _ : state) {
+		const std::uint8_t * p = enc.data();
+		const std::uint8_t * pEnd = p + enc.size();
+		for (std::uint64_t & v : values) {
+			p += ILIntBench_legacyDecode(p, pEnd - p, &v);
+		}
+		benchmark::DoNotOptimize(values.data());
+	}
+	ILIntBench_setLabel(state);
+}
+BENCHMARK(ILIntBench_decodeLegacy)->Arg(0)->Arg(1);
+
+//------------------------------------------------------------------------------
+static void ILIntBench_decode(benchmark::State & state) {
+	std::vector<std::uint64_t> values = ILIntBench_createValues(state.range(0));
+	std::vector<std::uint8_t> enc = ILIntBench_encodeValues(values);
+
+	for (auto _ : state) {
+		const std::uint8_t * p = enc.data();
+		const std::uint8_t * pEnd = p + enc.size();
+		for (std::uint64_t & v : values) {
+			p += ILInt::decode(p, pEnd - p, &v);
+		}
+		benchmark::DoNotOptimize(values.data());
+	}
+	ILIntBench_setLabel(state);
+}
+BENCHMARK(ILIntBench_decode)->Arg(0)->Arg(1);
+
+//------------------------------------------------------------------------------
+static void ILIntBench_decodeMany(benchmark::State & state) {
+	std::vector<std::uint64_t> values = ILIntBench_createValues(state.range(0));
+	std::vector<std::uint8_t> enc = ILIntBench_encodeValues(values);
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(ILInt::decodeMany(enc.data(), enc.size(),
+				values.data(), values.size()));
+	}
+	ILIntBench_setLabel(state);
+}
+BENCHMARK(ILIntBench_decodeMany)->Arg(0)->Arg(1);
+
+//------------------------------------------------------------------------------
+// Large arrays, as found in the ILILIntArrayTag of the indexes
+//------------------------------------------------------------------------------
+static void ILIntBench_decodeArrayLoop(benchmark::State & state) {
+	std::vector<std::uint64_t> values = ILIntBench_createValues(state.range(0),
+			state.range(1));
+	std::vector<std::uint8_t> enc = ILIntBench_encodeValues(values);
+
+	for (auto _ : state) {
+		const std::uint8_t * p = enc.data();
+		const std::uint8_t * pEnd = p + enc.size();
+		for (std::uint64_t & v : values) {
+			p += ILInt::decode(p, pEnd - p, &v);
+		}
+		benchmark::DoNotOptimize(values.data());
+	}
+	ILIntBench_setLabel(state, values.size());
+}
+BENCHMARK(ILIntBench_decodeArrayLoop)
+	->ArgsProduct({{0, 1, 2}, {1024 * 1024}});
+
+//------------------------------------------------------------------------------
+static void ILIntBench_decodeArrayMany(benchmark::State & state) {
+	std::vector<std::uint64_t> values = ILIntBench_createValues(state.range(0),
+			state.range(1));
+	std::vector<std::uint8_t> enc = ILIntBench_encodeValues(values);
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(ILInt::decodeMany(enc.data(), enc.size(),
+				values.data(), values.size()));
+	}
+	ILIntBench_setLabel(state, values.size());
+}
+BENCHMARK(ILIntBench_decodeArrayMany)
+	->ArgsProduct({{0, 1, 2}, {1024 * 1024}});
+//------------------------------------------------------------------------------
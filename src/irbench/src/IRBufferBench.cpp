@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <benchmark/benchmark.h>
+#include <ircommon/irbuffer.h>
+#include <vector>
+using namespace ircommon;
+
+//------------------------------------------------------------------------------
+static const IRBufferGrowthPolicy * IRBufferBench_getPolicy(int idx) {
+
+	switch (idx) {
+	case 1:
+		return &IRGeometricGrowthPolicy::oneAndHalf();
+	case 2:
+		return &IRGeometricGrowthPolicy::doubling();
+	default:
+		return nullptr;
+	}
+}
+
+//------------------------------------------------------------------------------
+static const char * IRBufferBench_getPolicyName(int idx) {
+
+	switch (idx) {
+	case 1:
+		return "x1.5";
+	case 2:
+		return "x2";
+	default:
+		return "fixed";
+	}
+}
+
+//------------------------------------------------------------------------------
+static void IRBufferBench_writeILInt(benchmark::State & state) {
+	const IRBufferGrowthPolicy * policy;
+	std::uint64_t count;
+
+	policy = IRBufferBench_getPolicy(state.range(0));
+	count = state.range(1);
+	for (auto _ : state) {
+		IRBuffer out;
+		out.setGrowthPolicy(policy);
+		for (std::uint64_t i = 0; i < count; i++) {
+			out.writeILInt(i);
+		}
+		benchmark::DoNotOptimize(out.roBuffer());
+	}
+	state.SetLabel(IRBufferBench_getPolicyName(state.range(0)));
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(IRBufferBench_writeILInt)
+	->ArgsProduct({{0, 1, 2}, {1024, 16384, 65536}});
+
+//------------------------------------------------------------------------------
+static void IRBufferBench_writeInt(benchmark::State & state) {
+	const IRBufferGrowthPolicy * policy;
+	std::uint64_t count;
+
+	policy = IRBufferBench_getPolicy(state.range(0));
+	count = state.range(1);
+	for (auto _ : state) {
+		IRBuffer out;
+		out.setGrowthPolicy(policy);
+		for (std::uint64_t i = 0; i < count; i++) {
+			out.writeInt(std::uint32_t(i));
+		}
+		benchmark::DoNotOptimize(out.roBuffer());
+	}
+	state.SetLabel(IRBufferBench_getPolicyName(state.range(0)));
+	state.SetBytesProcessed(state.iterations() * count * sizeof(std::uint32_t));
+}
+BENCHMARK(IRBufferBench_writeInt)
+	->ArgsProduct({{0, 1, 2}, {1024, 16384, 65536}});
+
+//------------------------------------------------------------------------------
+static void IRBufferBench_readILInt(benchmark::State & state) {
+	IRBuffer src;
+	std::uint64_t count;
+	std::uint64_t v;
+
+	count = state.range(0);
+	for (std::uint64_t i = 0; i < count; i++) {
+		src.writeILInt(i * 0x10001);
+	}
+	for (auto _ : state) {
+		src.beginning();
+		for (std::uint64_t i = 0; i < count; i++) {
+			src.readILInt(v);
+		}
+		benchmark::DoNotOptimize(v);
+	}
+	state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(IRBufferBench_readILInt)->Arg(1024)->Arg(16384)->Arg(65536);
+
+//------------------------------------------------------------------------------
+static void IRBufferBench_readInt(benchmark::State & state) {
+	IRBuffer src;
+	std::uint64_t count;
+	std::uint32_t v;
+
+	count = state.range(0);
+	for (std::uint64_t i = 0; i < count; i++) {
+		src.writeInt(std::uint32_t(i));
+	}
+	for (auto _ : state) {
+		src.beginning();
+		for (std::uint64_t i = 0; i < count; i++) {
+			src.readInt(v);
+		}
+		benchmark::DoNotOptimize(v);
+	}
+	state.SetBytesProcessed(state.iterations() * count * sizeof(std::uint32_t));
+}
+BENCHMARK(IRBufferBench_readInt)->Arg(1024)->Arg(16384)->Arg(65536);
+
+//------------------------------------------------------------------------------
+/**
+ * Appends 64 KiB in chunks of state.range(1) bytes using the growth policy
+ * state.range(0).
+ */
+static void IRBufferBench_append(benchmark::State & state) {
+	const IRBufferGrowthPolicy * policy;
+	std::vector<std::uint8_t> chunk(state.range(1), 0x5A);
+	std::uint64_t total = 64 * 1024;
+
+	policy = IRBufferBench_getPolicy(state.range(0));
+	for (auto _ : state) {
+		IRBuffer out;
+		out.setGrowthPolicy(policy);
+		for (std::uint64_t i = 0; i < total; i += chunk.size()) {
+			out.write(chunk.data(), chunk.size());
+		}
+		benchmark::DoNotOptimize(out.roBuffer());
+	}
+	state.SetLabel(IRBufferBench_getPolicyName(state.range(0)));
+	state.SetBytesProcessed(state.iterations() * total);
+}
+BENCHMARK(IRBufferBench_append)
+	->ArgsProduct({{0, 1, 2}, {16, 256, 4096}});
+
+//------------------------------------------------------------------------------
+/**
+ * Reads 1 MiB in chunks of state.range(0) bytes.
+ */
+static void IRBufferBench_read(benchmark::State & state) {
+	std::vector<std::uint8_t> src(1024 * 1024, 0x5A);
+	std::vector<std::uint8_t> chunk(state.range(0));
+	IRBuffer inp(src.data(), src.size());
+
+	for (auto _ : state) {
+		inp.beginning();
+		while (inp.read(chunk.data(), chunk.size()) == chunk.size()) {
+		}
+		benchmark::DoNotOptimize(chunk.data());
+	}
+	state.SetBytesProcessed(state.iterations() * src.size());
+}
+BENCHMARK(IRBufferBench_read)->Arg(16)->Arg(256)->Arg(4096);
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <benchmark/benchmark.h>
+#include <ircommon/irhndlst.h>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+using namespace ircommon;
+
+//------------------------------------------------------------------------------
+/**
+ * The original single lock handle list. It is used as the reference for the
+ * sharded IRHandleList.
+ */
+class IRHandleListBenchSingleLock {
+private:
+	std::unordered_map<std::uint32_t, int> _map;
+	IRIDGenerator _generator;
+	ircommon::threading::IRRWLock _lock;
+public:
+	IRHandleListBenchSingleLock(std::uint32_t seed): _generator(seed) {}
+
+	std::uint32_t insert(int obj) {
+		std::uint32_t id;
+
+		this->_lock.lockWrite();
+		do {
+			id = this->_generator.next();
+		} while (this->_map.find(id) != this->_map.end());
+		this->_map.insert({id, obj});
+		this->_lock.unlockWrite();
+		return id;
+	}
+
+	bool remove(std::uint32_t id) {
+		bool ret;
+
+		this->_lock.lockWrite();
+		ret = (this->_map.erase(id) != 0);
+		this->_lock.unlockWrite();
+		return ret;
+	}
+
+	bool get(std::uint32_t id, int & obj) {
+		bool ret;
+
+		this->_lock.lockRead();
+		auto found = this->_map.find(id);
+		if (found != this->_map.end()) {
+			obj = found->second;
+			ret = true;
+		} else {
+			ret = false;
+		}
+		this->_lock.unlockRead();
+		return ret;
+	}
+};
+
+//------------------------------------------------------------------------------
+/**
+ * Number of entries inserted into the lists before the benchmarks.
+ */
+#define IRHandleListBench_ENTRIES 1024
+
+//------------------------------------------------------------------------------
+/**
+ * Returns a list shared by all threads of a benchmark, filled with
+ * IRHandleListBench_ENTRIES entries.
+ */
+template <class ListType>
+static ListType & IRHandleListBench_list(std::vector<std::uint32_t> *& ids) {
+	static ListType list(1234);
+	static std::vector<std::uint32_t> handles;
+	static std::once_flag once;
+
+	std::call_once(once, [](){
+		for (int i = 0; i < IRHandleListBench_ENTRIES; i++) {
+			handles.push_back(list.insert(i));
+		}
+	});
+	ids = &handles;
+	return list;
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Executes get() from all threads. One out of every state.range(0) operations
+ * is an insert() followed by a remove(); use 0 to execute only get().
+ */
+template <class ListType>
+static void IRHandleListBench_getInsert(benchmark::State & state) {
+	std::vector<std::uint32_t> * ids;
+	ListType & list = IRHandleListBench_list<ListType>(ids);
+	std::uint32_t i = state.thread_index() * 7919;
+	std::uint32_t writeEvery = state.range(0);
+	int v;
+
+	for (auto _ : state) {
+		i++;
+		if ((writeEvery) && ((i % writeEvery) == 0)) {
+			list.remove(list.insert(int(i)));
+		} else {
+			benchmark::DoNotOptimize(list.get(
+					(*ids)[i % IRHandleListBench_ENTRIES], v));
+		}
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(IRHandleListBench_getInsert, IRHandleList<int>)
+	->Arg(0)->Arg(10)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(IRHandleListBench_getInsert, IRHandleListBenchSingleLock)
+	->Arg(0)->Arg(10)->ThreadRange(1, 16)->UseRealTime();
+//------------------------------------------------------------------------------
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <benchmark/benchmark.h>
+#include <ircommon/irsecmem.h>
+#include <ircommon/irutils.h>
+#include <new>
+using namespace ircommon;
+
+//------------------------------------------------------------------------------
+/**
+ * The original allocation of secure buffers, where each buffer is allocated
+ * from the heap and locked individually. It is used as the reference for the
+ * IRSecureAllocator.
+ */
+class IRSecureAllocatorBenchLegacy {
+public:
+	void * allocate(std::uint64_t size) {
+		std::uint8_t * p = new(std::nothrow) std::uint8_t[size];
+		if (p) {
+			IRUtils::lockMemory(p, size);
+		}
+		return p;
+	}
+
+	void deallocate(void * p, std::uint64_t size) {
+		IRUtils::unlockMemory(p, size);
+		IRUtils::clearMemory(p, size);
+		delete [] (std::uint8_t *)p;
+	}
+};
+
+//------------------------------------------------------------------------------
+static IRSecureAllocator & IRSecureAllocatorBench_get(IRSecureAllocator *) {
+	return IRSecureAllocator::instance();
+}
+
+//------------------------------------------------------------------------------
+static IRSecureAllocatorBenchLegacy & IRSecureAllocatorBench_get(
+		IRSecureAllocatorBenchLegacy *) {
+	static IRSecureAllocatorBenchLegacy legacy;
+	return legacy;
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Allocates and releases a buffer of state.range(0) bytes.
+ */
+template <class AllocatorType>
+static void IRSecureAllocatorBench_allocate(benchmark::State & state) {
+	AllocatorType & a = IRSecureAllocatorBench_get((AllocatorType *)nullptr);
+	std::uint64_t size = state.range(0);
+
+	for (auto _ : state) {
+		void * p = a.allocate(size);
+		benchmark::DoNotOptimize(p);
+		a.deallocate(p, size);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(IRSecureAllocatorBench_allocate, IRSecureAllocator)
+	->Arg(32)->Arg(256)->Arg(4096)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(IRSecureAllocatorBench_allocate,
+		IRSecureAllocatorBenchLegacy)
+	->Arg(32)->Arg(256)->Arg(4096)->ThreadRange(1, 8)->UseRealTime();
+
+//------------------------------------------------------------------------------
+/**
+ * Creates and disposes an IRSecureTemp of state.range(0) bytes.
+ */
+static void IRSecureAllocatorBench_secureTemp(benchmark::State & state) {
+	std::uint64_t size = state.range(0);
+
+	for (auto _ : state) {
+		IRUtils::IRSecureTemp tmp(size);
+		benchmark::DoNotOptimize(tmp.buff());
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(IRSecureAllocatorBench_secureTemp)->Arg(32)->Arg(256)->Arg(4096);
+
+//------------------------------------------------------------------------------
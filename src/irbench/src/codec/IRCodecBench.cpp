@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <benchmark/benchmark.h>
+#include <ircommon/ircodec.h>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+using namespace ircommon;
+using namespace ircommon::codec;
+
+//------------------------------------------------------------------------------
+/**
+ * Exposes an alphabet without its lookup tables. It forces IRBase2NCodec to
+ * call getValue() and getChar() for each character as it did before the
+ * lookup tables were introduced.
+ */
+class IRCodecBenchUnmappedAlphabet: public IRAlphabet {
+private:
+	std::shared_ptr<IRAlphabet> _alphabet;
+public:
+	IRCodecBenchUnmappedAlphabet(std::shared_ptr<IRAlphabet> alphabet):
+			IRAlphabet(alphabet->size()), _alphabet(alphabet) {}
+
+	virtual ~IRCodecBenchUnmappedAlphabet() = default;
+
+	virtual int getValue(int c) const {
+		return this->_alphabet->getValue(c);
+	}
+
+	virtual int getChar(int v) const {
+		return this->_alphabet->getChar(v);
+	}
+};
+
+//------------------------------------------------------------------------------
+static std::shared_ptr<IRAlphabet> IRCodecBench_createAlphabet(int idx,
+		bool mapped) {
+	std::shared_ptr<IRAlphabet> alphabet;
+
+	switch (idx) {
+	case 0:
+		alphabet = std::make_shared<IRHexAlphabet>();
+		break;
+	case 1:
+		alphabet = std::make_shared<IRBase32Alphabet>();
+		break;
+	default:
+		alphabet = std::make_shared<IRBase64Alphabet>();
+	}
+	if (mapped) {
+		return alphabet;
+	} else {
+		return std::make_shared<IRCodecBenchUnmappedAlphabet>(alphabet);
+	}
+}
+
+//------------------------------------------------------------------------------
+static void IRCodecBench_setLabel(benchmark::State & state) {
+	static const char * NAMES[] = {"hex", "base32", "base64"};
+	std::string label;
+
+	label = NAMES[state.range(0)];
+	label.append((state.range(2)) ? " mapped" : " virtual");
+	state.SetLabel(label);
+}
+
+//------------------------------------------------------------------------------
+static void IRCodecBench_encode(benchmark::State & state) {
+	IRBase2NCodec codec(IRCodecBench_createAlphabet(state.range(0),
+			state.range(2) != 0));
+	std::vector<std::uint8_t> src(state.range(1));
+	std::string dst;
+
+	for (std::uint8_t & b : src) {
+		b = std::uint8_t(std::rand());
+	}
+	for (auto _ : state) {
+		dst.clear();
+		codec.encode(src.data(), src.size(), dst);
+		benchmark::DoNotOptimize(dst.data());
+	}
+	state.SetBytesProcessed(state.iterations() * src.size());
+	IRCodecBench_setLabel(state);
+}
+BENCHMARK(IRCodecBench_encode)
+	->ArgsProduct({{0, 1, 2}, {1024, 1024 * 1024}, {0, 1}});
+
+//------------------------------------------------------------------------------
+static void IRCodecBench_decode(benchmark::State & state) {
+	IRBase2NCodec codec(IRCodecBench_createAlphabet(state.range(0),
+			state.range(2) != 0));
+	std::vector<std::uint8_t> src(state.range(1));
+	std::vector<std::uint8_t> dst(state.range(1));
+	std::string enc;
+	int dstSize;
+
+	for (std::uint8_t & b : src) {
+		b = std::uint8_t(std::rand());
+	}
+	codec.encode(src.data(), src.size(), enc);
+	for (auto _ : state) {
+		dstSize = dst.size();
+		benchmark::DoNotOptimize(codec.decode(enc, dst.data(), dstSize));
+	}
+	state.SetBytesProcessed(state.iterations() * src.size());
+	IRCodecBench_setLabel(state);
+}
+BENCHMARK(IRCodecBench_decode)
+	->ArgsProduct({{0, 1, 2}, {1024, 1024 * 1024}, {0, 1}});
+//------------------------------------------------------------------------------
+static void IRCodecBench_encodeStream(benchmark::State & state) {
+	IRBase2NCodec codec(IRCodecBench_createAlphabet(state.range(0), true));
+	IRBase2NEncoder encoder(codec);
+	std::vector<std::uint8_t> src(1024 * 1024);
+	std::uint64_t chunk = state.range(1);
+	IRBuffer dst;
+
+	for (std::uint8_t & b : src) {
+		b = std::uint8_t(std::rand());
+	}
+	for (auto _ : state) {
+		dst.setSize(0);
+		for (std::uint64_t offs = 0; offs < src.size(); offs += chunk) {
+			encoder.update(src.data() + offs,
+					std::min(chunk, src.size() - offs), dst);
+		}
+		encoder.finish(dst);
+		benchmark::DoNotOptimize(dst.roBuffer());
+	}
+	state.SetBytesProcessed(state.iterations() * src.size());
+	IRCodecBench_setLabel(state);
+}
+BENCHMARK(IRCodecBench_encodeStream)
+	->ArgsProduct({{0, 1, 2}, {100, 4096, 65536}, {1}});
+
+//------------------------------------------------------------------------------
+static void IRCodecBench_decodeStream(benchmark::State & state) {
+	IRBase2NCodec codec(IRCodecBench_createAlphabet(state.range(0), true));
+	IRBase2NDecoder decoder(codec);
+	std::vector<std::uint8_t> src(1024 * 1024);
+	std::uint64_t chunk = state.range(1);
+	std::string enc;
+	IRBuffer dst;
+
+	for (std::uint8_t & b : src) {
+		b = std::uint8_t(std::rand());
+	}
+	codec.encode(src.data(), src.size(), enc);
+	for (auto _ : state) {
+		dst.setSize(0);
+		for (std::uint64_t offs = 0; offs < enc.size(); offs += chunk) {
+			decoder.update(enc.c_str() + offs,
+					std::min(chunk, enc.size() - offs), dst);
+		}
+		benchmark::DoNotOptimize(decoder.finish());
+	}
+	state.SetBytesProcessed(state.iterations() * src.size());
+	IRCodecBench_setLabel(state);
+}
+BENCHMARK(IRCodecBench_decodeStream)
+	->ArgsProduct({{0, 1, 2}, {100, 4096, 65536}, {1}});
+//------------------------------------------------------------------------------
@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <benchmark/benchmark.h>
+#include <irecordcore/irbciphm.h>
+#include <irecordcore/irbciphr.h>
+#include <irecordcore/irmac.h>
+#include <ircommon/irrandom.h>
+#include <algorithm>
+#include <vector>
+using namespace irecordcore::crypto;
+
+static const std::uint8_t IRBlockCipherModeBench_KEY[16] = {
+		0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+		0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+
+//------------------------------------------------------------------------------
+/**
+ * Creates the mode. Mode 0 is the plain IRBlockCipherMode and mode 1 is
+ * IRCBCBlockCipherMode, both with AES128.
+ */
+static IRBlockCipherMode * IRBlockCipherModeBench_create(int mode,
+		bool cipherMode) {
+	IRAES128BlockCipherAlgorithm * cipher;
+
+	cipher = new IRAES128BlockCipherAlgorithm(cipherMode);
+	cipher->setRawKey(IRBlockCipherModeBench_KEY,
+			sizeof(IRBlockCipherModeBench_KEY));
+	if (mode) {
+		return new IRCBCBlockCipherMode(cipher, new IRPKCS7Padding());
+	} else {
+		return new IRBlockCipherMode(cipher, new IRPKCS7Padding());
+	}
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Feeds src to the mode in chunks of chunkSize bytes or all at once if
+ * chunkSize is 0.
+ */
+static bool IRBlockCipherModeBench_run(IRBlockCipherMode & m,
+		const std::vector<std::uint8_t> & src, std::vector<std::uint8_t> & dst,
+		std::uint64_t chunkSize) {
+	const std::uint8_t * p;
+	const std::uint8_t * pEnd;
+	std::uint8_t * out;
+	std::uint64_t dstSize;
+
+	if (chunkSize == 0) {
+		chunkSize = src.size();
+	}
+	m.reset();
+	p = src.data();
+	pEnd = p + src.size();
+	out = dst.data();
+	while (p < pEnd) {
+		std::uint64_t size = std::min<std::uint64_t>(chunkSize, pEnd - p);
+		dstSize = dst.size() - (out - dst.data());
+		if (!m.process(p, size, out, dstSize, (p + size) == pEnd)) {
+			return false;
+		}
+		p += size;
+		out += dstSize;
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+static void IRBlockCipherModeBench_setLabel(benchmark::State & state,
+		bool cipherMode) {
+	std::string label;
+
+	label = state.range(0) ? "CBC" : "ECB";
+	label += cipherMode ? " cipher" : " decipher";
+	label += state.range(2) ? " per block" : " bulk";
+	state.SetLabel(label);
+	state.SetBytesProcessed(state.iterations() * state.range(1));
+}
+
+//------------------------------------------------------------------------------
+static void IRBlockCipherModeBench_cipher(benchmark::State & state) {
+	std::unique_ptr<IRBlockCipherMode> m(
+			IRBlockCipherModeBench_create(state.range(0), true));
+	std::vector<std::uint8_t> src(state.range(1), 0x5A);
+	std::vector<std::uint8_t> dst(m->getOutputSize(src.size()));
+
+	for (auto _ : state) {
+		if (!IRBlockCipherModeBench_run(*m, src, dst, state.range(2))) {
+			state.SkipWithError("Unable to cipher.");
+			break;
+		}
+		benchmark::DoNotOptimize(dst.data());
+	}
+	IRBlockCipherModeBench_setLabel(state, true);
+}
+BENCHMARK(IRBlockCipherModeBench_cipher)
+	->ArgsProduct({{0, 1},
+		{1024, 64 * 1024, 1024 * 1024, 16 * 1024 * 1024, 64 * 1024 * 1024},
+		{0, 16}});
+
+//------------------------------------------------------------------------------
+static void IRBlockCipherModeBench_decipher(benchmark::State & state) {
+	std::unique_ptr<IRBlockCipherMode> e(
+			IRBlockCipherModeBench_create(state.range(0), true));
+	std::unique_ptr<IRBlockCipherMode> m(
+			IRBlockCipherModeBench_create(state.range(0), false));
+	std::vector<std::uint8_t> plain(state.range(1) - 1, 0x5A);
+	std::vector<std::uint8_t> src(e->getOutputSize(plain.size()));
+	std::vector<std::uint8_t> dst(src.size());
+
+	if (!IRBlockCipherModeBench_run(*e, plain, src, 0)) {
+		state.SkipWithError("Unable to cipher.");
+		return;
+	}
+	for (auto _ : state) {
+		if (!IRBlockCipherModeBench_run(*m, src, dst, state.range(2))) {
+			state.SkipWithError("Unable to decipher.");
+			break;
+		}
+		benchmark::DoNotOptimize(dst.data());
+	}
+	IRBlockCipherModeBench_setLabel(state, false);
+}
+BENCHMARK(IRBlockCipherModeBench_decipher)
+	->ArgsProduct({{0, 1},
+		{1024, 64 * 1024, 1024 * 1024, 16 * 1024 * 1024, 64 * 1024 * 1024},
+		{0, 16}});
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * CBC followed by HMAC-SHA256 over the ciphertext. It is the reference for the
+ * authenticated modes.
+ */
+static void IRBlockCipherModeBench_cbcHMAC(benchmark::State & state) {
+	std::unique_ptr<IRBlockCipherMode> m(
+			IRBlockCipherModeBench_create(1, true));
+	IRHMAC hmac(new IRSHA256Hash());
+	std::vector<std::uint8_t> src(state.range(0), 0x5A);
+	std::vector<std::uint8_t> dst(m->getOutputSize(src.size()));
+	std::uint8_t tag[32];
+
+	hmac.setRawKey(IRBlockCipherModeBench_KEY,
+			sizeof(IRBlockCipherModeBench_KEY));
+	for (auto _ : state) {
+		if (!IRBlockCipherModeBench_run(*m, src, dst, 0)) {
+			state.SkipWithError("Unable to cipher.");
+			break;
+		}
+		hmac.reset();
+		hmac.update(dst.data(), dst.size());
+		hmac.finalize(tag, sizeof(tag));
+		benchmark::DoNotOptimize(tag);
+	}
+	state.SetLabel("CBC+HMAC-SHA256");
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(IRBlockCipherModeBench_cbcHMAC)
+	->Arg(4 * 1024)->Arg(1024 * 1024)->Arg(64 * 1024 * 1024);
+
+//------------------------------------------------------------------------------
+static void IRBlockCipherModeBench_ctr(benchmark::State & state) {
+	IRAES128BlockCipherAlgorithm * cipher;
+	std::vector<std::uint8_t> src(state.range(0), 0x5A);
+	std::vector<std::uint8_t> dst(src.size());
+
+	cipher = new IRAES128BlockCipherAlgorithm(true);
+	cipher->setRawKey(IRBlockCipherModeBench_KEY,
+			sizeof(IRBlockCipherModeBench_KEY));
+	IRCTRBlockCipherMode m(cipher);
+	for (auto _ : state) {
+		if (!IRBlockCipherModeBench_run(m, src, dst, 0)) {
+			state.SkipWithError("Unable to cipher.");
+			break;
+		}
+		benchmark::DoNotOptimize(dst.data());
+	}
+	state.SetLabel("CTR");
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(IRBlockCipherModeBench_ctr)
+	->Arg(4 * 1024)->Arg(1024 * 1024)->Arg(64 * 1024 * 1024);
+
+//------------------------------------------------------------------------------
+static void IRBlockCipherModeBench_gcm(benchmark::State & state) {
+	IRAES128BlockCipherAlgorithm * cipher;
+	std::vector<std::uint8_t> src(state.range(0), 0x5A);
+	std::vector<std::uint8_t> dst(src.size());
+	std::uint8_t tag[16];
+
+	cipher = new IRAES128BlockCipherAlgorithm(true);
+	cipher->setRawKey(IRBlockCipherModeBench_KEY,
+			sizeof(IRBlockCipherModeBench_KEY));
+	IRGCMBlockCipherMode m(cipher, true);
+	for (auto _ : state) {
+		if (!IRBlockCipherModeBench_run(m, src, dst, 0)) {
+			state.SkipWithError("Unable to cipher.");
+			break;
+		}
+		m.tag(tag, sizeof(tag));
+		benchmark::DoNotOptimize(tag);
+	}
+	state.SetLabel("GCM");
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(IRBlockCipherModeBench_gcm)
+	->Arg(4 * 1024)->Arg(1024 * 1024)->Arg(64 * 1024 * 1024);
+
+//------------------------------------------------------------------------------
+/**
+ * Creates the padding. The indexes follow the declaration order in
+ * irciphpd.h.
+ */
+static IRPadding * IRBlockCipherModeBench_createPadding(int padding) {
+
+	switch (padding) {
+	case 1:
+		return new IRPKCS7Padding();
+	case 2:
+		return new IRANSIX923Padding();
+	case 3:
+		return new IRISO10126Padding(new ircommon::IRXORShifRandom());
+	case 4:
+		return new IROCSRandomPadding(new ircommon::IRXORShifRandom());
+	default:
+		return new IRZeroPadding();
+	}
+}
+
+//------------------------------------------------------------------------------
+static const char * IRBlockCipherModeBench_paddingName(int padding) {
+
+	switch (padding) {
+	case 1:
+		return "PKCS7";
+	case 2:
+		return "ANSI X9.23";
+	case 3:
+		return "ISO 10126";
+	case 4:
+		return "OCS random";
+	default:
+		return "zero";
+	}
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Ciphers and deciphers state.range(1) bytes with AES128 in CBC mode using
+ * the padding state.range(0). The size is never a multiple of the block size,
+ * thus the padding is always exercised.
+ */
+static void IRBlockCipherModeBench_cbcPadding(benchmark::State & state) {
+	IRAES128BlockCipherAlgorithm * cipher;
+	IRAES128BlockCipherAlgorithm * decipher;
+	std::vector<std::uint8_t> src(state.range(1) - 1, 0x5A);
+	std::vector<std::uint8_t> enc;
+	std::vector<std::uint8_t> dec;
+
+	cipher = new IRAES128BlockCipherAlgorithm(true);
+	cipher->setRawKey(IRBlockCipherModeBench_KEY,
+			sizeof(IRBlockCipherModeBench_KEY));
+	decipher = new IRAES128BlockCipherAlgorithm(false);
+	decipher->setRawKey(IRBlockCipherModeBench_KEY,
+			sizeof(IRBlockCipherModeBench_KEY));
+	IRCBCBlockCipherMode e(cipher,
+			IRBlockCipherModeBench_createPadding(state.range(0)));
+	IRCBCBlockCipherMode d(decipher,
+			IRBlockCipherModeBench_createPadding(state.range(0)));
+	enc.resize(e.getOutputSize(src.size()));
+	dec.resize(enc.size());
+	for (auto _ : state) {
+		if (!IRBlockCipherModeBench_run(e, src, enc, 0)) {
+			state.SkipWithError("Unable to cipher.");
+			break;
+		}
+		if (!IRBlockCipherModeBench_run(d, enc, dec, 0)) {
+			state.SkipWithError("Unable to decipher.");
+			break;
+		}
+		benchmark::DoNotOptimize(dec.data());
+	}
+	state.SetLabel(IRBlockCipherModeBench_paddingName(state.range(0)));
+	state.SetBytesProcessed(state.iterations() * src.size());
+}
+BENCHMARK(IRBlockCipherModeBench_cbcPadding)
+	->ArgsProduct({{0, 1, 2, 3, 4}, {64, 4 * 1024, 1024 * 1024}});
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <benchmark/benchmark.h>
+#include <irecordcore/irhash.h>
+#include <memory>
+#include <string>
+#include <vector>
+using namespace irecordcore::crypto;
+
+//------------------------------------------------------------------------------
+static const char * IRHashBench_hashName(int type) {
+
+	switch (type) {
+	case IR_HASH_SHA1:
+		return "SHA1";
+	case IR_HASH_SHA256:
+		return "SHA256";
+	case IR_HASH_SHA512:
+		return "SHA512";
+	case IR_HASH_SHA3_256:
+		return "SHA3-256";
+	case IR_HASH_SHA3_512:
+		return "SHA3-512";
+	default:
+		return "unknown";
+	}
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Hashes state.range(1) bytes with the algorithm state.range(0) created by
+ * IRHashFactory. All algorithms supported by the factory are included.
+ */
+static void IRHashBench_hash(benchmark::State & state) {
+	IRHashFactory factory;
+	std::unique_ptr<IRHash> hash(factory.create(state.range(0)));
+	std::vector<std::uint8_t> src(state.range(1), 0x5A);
+	std::uint8_t out[64];
+
+	state.SetLabel(IRHashBench_hashName(state.range(0)));
+	if (!hash) {
+		state.SkipWithError("Unable to create the hash.");
+		return;
+	}
+	for (auto _ : state) {
+		hash->reset();
+		hash->update(src.data(), src.size());
+		hash->finalize(out, sizeof(out));
+		benchmark::DoNotOptimize(out);
+	}
+	state.SetBytesProcessed(state.iterations() * src.size());
+}
+BENCHMARK(IRHashBench_hash)
+	->ArgsProduct({{IR_HASH_SHA1, IR_HASH_SHA256, IR_HASH_SHA512,
+		IR_HASH_SHA3_256, IR_HASH_SHA3_512}, {64, 1024, 64 * 1024}});
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <benchmark/benchmark.h>
+#include <irecordcore/irmac.h>
+#include <irecordcore/irpbkdf2.h>
+#include <vector>
+using namespace irecordcore::crypto;
+
+//------------------------------------------------------------------------------
+static IRHash * IRMACBench_createHash(int type) {
+
+	switch (type) {
+	case 1:
+		return new IRSHA256Hash();
+	case 2:
+		return new IRSHA512Hash();
+	default:
+		return new IRSHA1Hash();
+	}
+}
+
+//------------------------------------------------------------------------------
+static const char * IRMACBench_hashName(int type) {
+
+	switch (type) {
+	case 1:
+		return "HMAC-SHA256";
+	case 2:
+		return "HMAC-SHA512";
+	default:
+		return "HMAC-SHA1";
+	}
+}
+
+//------------------------------------------------------------------------------
+static void IRMACBench_hmac(benchmark::State & state) {
+	IRHMAC hmac(IRMACBench_createHash(state.range(0)));
+	std::vector<std::uint8_t> msg(state.range(1), 0x5A);
+	std::uint8_t out[64];
+
+	hmac.setRawKey("password", 8);
+	for (auto _ : state) {
+		hmac.reset();
+		hmac.update(msg.data(), msg.size());
+		hmac.finalize(out, sizeof(out));
+		benchmark::DoNotOptimize(out);
+	}
+	state.SetLabel(IRMACBench_hashName(state.range(0)));
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(IRMACBench_hmac)->ArgsProduct({{0, 1, 2}, {32, 1024}});
+
+//------------------------------------------------------------------------------
+static void IRMACBench_pbkdf2(benchmark::State & state) {
+	IRPBKDF2KeyGenerator kg(new IRHMAC(IRMACBench_createHash(state.range(0))),
+			state.range(1));
+	std::uint8_t key[32];
+
+	kg.setKeySize(sizeof(key) * 8);
+	kg.setPassword("password", 8);
+	kg.setSalt("salt", 4);
+	for (auto _ : state) {
+		if (!kg.generateRaw(key, sizeof(key))) {
+			state.SkipWithError("Unable to generate the key.");
+			break;
+		}
+		benchmark::DoNotOptimize(key);
+	}
+	state.SetLabel(IRMACBench_hashName(state.range(0)));
+}
+BENCHMARK(IRMACBench_pbkdf2)->ArgsProduct({{0, 1, 2}, {100000}})
+	->Unit(benchmark::kMillisecond);
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+static void IRMACBench_pbkdf2Threads(benchmark::State & state) {
+	IRPBKDF2KeyGenerator kg(new IRHMAC(IRMACBench_createHash(1)), 100000);
+	std::vector<std::uint8_t> key(state.range(0));
+
+	kg.setKeySize(key.size() * 8);
+	kg.setThreads(state.range(1));
+	kg.setPassword("password", 8);
+	kg.setSalt("salt", 4);
+	for (auto _ : state) {
+		if (!kg.generateRaw(key.data(), key.size())) {
+			state.SkipWithError("Unable to generate the key.");
+			break;
+		}
+		benchmark::DoNotOptimize(key.data());
+	}
+	state.SetLabel(IRMACBench_hashName(1));
+}
+BENCHMARK(IRMACBench_pbkdf2Threads)->ArgsProduct({{64, 128}, {1, 0}})
+	->Unit(benchmark::kMillisecond)->UseRealTime();
+
+//------------------------------------------------------------------------------
+static void IRMACBench_pbkdf2Batch(benchmark::State & state) {
+	IRPBKDF2KeyGenerator kg(new IRHMAC(IRMACBench_createHash(1)), 10000);
+	std::vector<IRPBKDF2KeyGenerator::BatchEntry> entries(state.range(0));
+	std::vector<std::uint8_t> keys(entries.size() * 32);
+	std::vector<std::uint32_t> passwords(entries.size());
+
+	for (std::size_t i = 0; i < entries.size(); i++) {
+		passwords[i] = i;
+		entries[i].password = &passwords[i];
+		entries[i].passwordSize = sizeof(passwords[i]);
+		entries[i].salt = "salt";
+		entries[i].saltSize = 4;
+		entries[i].key = keys.data() + (i * 32);
+	}
+	kg.setKeySize(256);
+	kg.setThreads(state.range(1));
+	for (auto _ : state) {
+		if (!kg.generateRawBatch(entries.data(), entries.size())) {
+			state.SkipWithError("Unable to generate the keys.");
+			break;
+		}
+		benchmark::DoNotOptimize(keys.data());
+	}
+	state.SetLabel(IRMACBench_hashName(1));
+	state.SetItemsProcessed(state.iterations() * entries.size());
+}
+BENCHMARK(IRMACBench_pbkdf2Batch)->ArgsProduct({{64}, {1, 0}})
+	->Unit(benchmark::kMillisecond)->UseRealTime();
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <benchmark/benchmark.h>
+#include <irecordcore/irkey.h>
+#include <ircommon/irarc4.h>
+#include <ircommon/irutils.h>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <vector>
+using namespace ircommon::crypto;
+using namespace irecordcore::crypto;
+
+//------------------------------------------------------------------------------
+/**
+ * The original secret key, protected by a full ARC4 pass over the key on
+ * each lock and unlock. It is used as the reference for IRSecretKeyImpl.
+ */
+class IRSecretKeyBenchLegacy {
+private:
+	std::vector<std::uint8_t> _value;
+	IRARC4 _arc4;
+	std::mutex _mutex;
+public:
+	IRSecretKeyBenchLegacy(const void * key, std::uint64_t keySize):
+			_value((const std::uint8_t *)key,
+			((const std::uint8_t *)key) + keySize) {
+		std::uint64_t seed = std::chrono::high_resolution_clock::now(
+				).time_since_epoch().count();
+		this->_arc4.setKey(&seed, sizeof(seed));
+		this->_arc4.save();
+		this->_arc4.apply(this->_value.data(), this->_value.size());
+	}
+
+	bool exportKey(void * key, std::uint64_t & keySize) {
+		if ((!key) || (keySize < this->_value.size())) {
+			keySize = this->_value.size();
+			return false;
+		}
+		keySize = this->_value.size();
+		this->_mutex.lock();
+		this->_arc4.load();
+		this->_arc4.apply(this->_value.data(), keySize);
+		std::memcpy(key, this->_value.data(), keySize);
+		this->_arc4.save();
+		this->_arc4.apply(this->_value.data(), keySize);
+		this->_mutex.unlock();
+		return true;
+	}
+
+	void beginHot(std::uint64_t maxUses, std::uint64_t maxTime) {}
+
+	bool endHot() {
+		return true;
+	}
+};
+
+//------------------------------------------------------------------------------
+/**
+ * Exports a key of state.range(0) bytes in a loop. If state.range(1) is not
+ * 0, the loop runs inside a hot window.
+ */
+template <class KeyType>
+static void IRSecretKeyBench_exportKey(benchmark::State & state) {
+	std::vector<std::uint8_t> raw(state.range(0), 0xA5);
+	std::vector<std::uint8_t> out(raw.size());
+	KeyType key(raw.data(), raw.size());
+	IRHotScope<KeyType> scope(key, (state.range(1)) ? UINT64_MAX : 0,
+			60 * 60 * 1000);
+	std::uint64_t size;
+
+	for (auto _ : state) {
+		size = out.size();
+		benchmark::DoNotOptimize(key.exportKey(out.data(), size));
+	}
+	state.SetBytesProcessed(state.iterations() * raw.size());
+	ircommon::IRUtils::clearMemory(out.data(), out.size());
+}
+BENCHMARK_TEMPLATE(IRSecretKeyBench_exportKey, IRSecretKeyImpl)
+	->Args({16, 0})->Args({32, 0})->Args({64, 0})->Args({256, 0})
+	->Args({16, 1})->Args({32, 1})->Args({64, 1})->Args({256, 1});
+BENCHMARK_TEMPLATE(IRSecretKeyBench_exportKey, IRSecretKeyBenchLegacy)
+	->Args({16, 0})->Args({32, 0})->Args({64, 0})->Args({256, 0});
+
+//------------------------------------------------------------------------------
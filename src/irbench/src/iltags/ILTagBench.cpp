@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "../AllocationCounter.h"
+#include <benchmark/benchmark.h>
+#include <ircommon/iltag.h>
+#include <ircommon/iltagstd.h>
+#include <cstring>
+using namespace ircommon;
+using namespace ircommon::iltags;
+
+//------------------------------------------------------------------------------
+static void ILTagBench_createNested(ILTagSeqTag & root, int depth) {
+	ILTagSeqTag * curr;
+	ILByteArrayTag * leaf;
+
+	curr = &root;
+	for (int i = 1; i < depth; i++) {
+		ILTagSeqTag * child = new ILTagSeqTag();
+		curr->add(child);
+		curr = child;
+	}
+	leaf = new ILByteArrayTag();
+	leaf->value().setSize(16);
+	curr->add(leaf);
+}
+
+//------------------------------------------------------------------------------
+static void ILTagBench_serializeNested(benchmark::State & state) {
+	ILTagSeqTag root;
+	IRBuffer out;
+
+	ILTagBench_createNested(root, state.range(0));
+	for (auto _ : state) {
+		out.setSize(0);
+		root.serialize(out);
+		benchmark::DoNotOptimize(out.roBuffer());
+	}
+	state.SetComplexityN(state.range(0));
+	state.SetBytesProcessed(state.iterations() * out.size());
+}
+BENCHMARK(ILTagBench_serializeNested)
+	->RangeMultiplier(4)->Range(1, 1024)->Complexity(benchmark::oN);
+
+//------------------------------------------------------------------------------
+static void ILTagBench_serializeSeq(benchmark::State & state) {
+	ILTagSeqTag root;
+	IRBuffer out;
+
+	for (int i = 0; i < state.range(0); i++) {
+		ILTagSeqTag * child = new ILTagSeqTag();
+		ILUInt64Tag * value = new ILUInt64Tag();
+		value->setValue(i);
+		child->add(value);
+		root.add(child);
+	}
+	for (auto _ : state) {
+		out.setSize(0);
+		root.serialize(out);
+		benchmark::DoNotOptimize(out.roBuffer());
+	}
+	state.SetComplexityN(state.range(0));
+	state.SetBytesProcessed(state.iterations() * out.size());
+}
+BENCHMARK(ILTagBench_serializeSeq)
+	->RangeMultiplier(8)->Range(8, 32768)->Complexity(benchmark::oN);
+
+//------------------------------------------------------------------------------
+static void ILTagBench_createBlock(ILTagSeqTag & root, int payloadSize) {
+	ILByteArrayTag * payload;
+
+	for (int i = 0; i < 64; i++) {
+		ILUInt64Tag * field = new ILUInt64Tag();
+		field->setValue(i);
+		root.add(field);
+	}
+	payload = new ILByteArrayTag();
+	payload->value().setSize(payloadSize);
+	root.add(payload);
+}
+
+//------------------------------------------------------------------------------
+static void ILTagBench_serializeBlock(benchmark::State & state) {
+	ILTagSeqTag root;
+	std::uint64_t allocs;
+
+	ILTagBench_createBlock(root, state.range(0));
+	allocs = AllocationCounter::count();
+	for (auto _ : state) {
+		IRBuffer out;
+		root.serialize(out);
+		benchmark::DoNotOptimize(out.roBuffer());
+	}
+	state.counters["allocs"] = benchmark::Counter(
+			AllocationCounter::count() - allocs,
+			benchmark::Counter::kAvgIterations);
+	state.SetBytesProcessed(state.iterations() * root.tagSize());
+}
+BENCHMARK(ILTagBench_serializeBlock)
+	->RangeMultiplier(32)->Range(1024, 32 * 1024 * 1024);
+
+//------------------------------------------------------------------------------
+static void ILTagBench_serializeToBlock(benchmark::State & state) {
+	ILTagSeqTag root;
+	std::uint64_t allocs;
+
+	ILTagBench_createBlock(root, state.range(0));
+	allocs = AllocationCounter::count();
+	for (auto _ : state) {
+		IRBuffer out;
+		root.serializeTo(out);
+		benchmark::DoNotOptimize(out.roBuffer());
+	}
+	state.counters["allocs"] = benchmark::Counter(
+			AllocationCounter::count() - allocs,
+			benchmark::Counter::kAvgIterations);
+	state.SetBytesProcessed(state.iterations() * root.tagSize());
+}
+BENCHMARK(ILTagBench_serializeToBlock)
+	->RangeMultiplier(32)->Range(1024, 32 * 1024 * 1024);
+//------------------------------------------------------------------------------
+static void ILTagBench_deserializeBlock(benchmark::State & state) {
+	ILTagSeqTag root;
+	ILStandardTagFactory factory;
+	IRBuffer src;
+	std::uint64_t allocs;
+
+	factory.setViewMode(state.range(1) != 0);
+	ILTagBench_createBlock(root, state.range(0));
+	root.serializeTo(src);
+	allocs = AllocationCounter::count();
+	for (auto _ : state) {
+		ILTagSeqTag tag;
+		src.beginning();
+		benchmark::DoNotOptimize(factory.deserialize(src, tag));
+	}
+	state.counters["allocs"] = benchmark::Counter(
+			AllocationCounter::count() - allocs,
+			benchmark::Counter::kAvgIterations);
+	state.SetBytesProcessed(state.iterations() * src.size());
+	state.SetLabel(factory.viewMode() ? "view" : "copy");
+}
+BENCHMARK(ILTagBench_deserializeBlock)
+	->ArgsProduct({{1024, 32 * 1024, 1024 * 1024, 32 * 1024 * 1024}, {0, 1}});
+//------------------------------------------------------------------------------
+static void ILTagBench_deserializeArrayGet(benchmark::State & state) {
+	ILTagArrayTag root;
+	ILStandardTagFactory factory;
+	IRBuffer src;
+	std::uint64_t allocs;
+
+	factory.setLazyMode(state.range(1) != 0);
+	for (int i = 0; i < state.range(0); i++) {
+		ILUInt64Tag * value = new ILUInt64Tag();
+		value->setValue(i);
+		root.add(value);
+	}
+	root.serializeTo(src);
+	allocs = AllocationCounter::count();
+	for (auto _ : state) {
+		ILTagArrayTag tag;
+		src.beginning();
+		factory.deserialize(src, tag);
+		benchmark::DoNotOptimize(tag[tag.count() / 2].get());
+	}
+	state.counters["allocs"] = benchmark::Counter(
+			AllocationCounter::count() - allocs,
+			benchmark::Counter::kAvgIterations);
+	state.SetLabel(factory.lazyMode() ? "lazy" : "eager");
+}
+BENCHMARK(ILTagBench_deserializeArrayGet)
+	->ArgsProduct({{16, 1024, 65536}, {0, 1}});
+//------------------------------------------------------------------------------
+static void ILTagBench_deserializeBlockArena(benchmark::State & state) {
+	ILTagSeqTag root;
+	ILStandardTagFactory factory;
+	ILTagArena arena;
+	IRBuffer src;
+	std::uint64_t allocs;
+
+	if (state.range(0)) {
+		factory.setArena(&arena);
+	}
+	ILTagBench_createBlock(root, 256);
+	root.serializeTo(src);
+	allocs = AllocationCounter::count();
+	for (auto _ : state) {
+		src.beginning();
+		ILTag * tag = factory.deserialize(src);
+		benchmark::DoNotOptimize(tag);
+		delete tag;
+		arena.reset();
+	}
+	state.counters["allocs"] = benchmark::Counter(
+			AllocationCounter::count() - allocs,
+			benchmark::Counter::kAvgIterations);
+	state.counters["blocks"] = benchmark::Counter(state.iterations(),
+			benchmark::Counter::kIsRate);
+	state.SetBytesProcessed(state.iterations() * src.size());
+	state.SetLabel(factory.arena() ? "arena" : "heap");
+}
+BENCHMARK(ILTagBench_deserializeBlockArena)
+	->Arg(0)->Arg(1)->Iterations(250000);
+//------------------------------------------------------------------------------
+/**
+ * The comparison performed by ILTagUtil::equals() before the introduction of
+ * ILTag::equalsValue().
+ */
+static bool ILTagBench_serializedEquals(const ILTag & a, const ILTag & b) {
+	IRBuffer ba(0, true);
+	IRBuffer bb(0, true);
+
+	if (!a.serialize(ba)) {
+		return false;
+	}
+	if (!b.serialize(bb)) {
+		return false;
+	}
+	return (ba.size() == bb.size()) &&
+			(std::memcmp(ba.roBuffer(), bb.roBuffer(), ba.size()) == 0);
+}
+
+//------------------------------------------------------------------------------
+static void ILTagBench_equalsBlock(benchmark::State & state) {
+	ILTagSeqTag a;
+	ILTagSeqTag b;
+	std::uint64_t allocs;
+	bool structural;
+
+	structural = (state.range(1) != 0);
+	ILTagBench_createBlock(a, state.range(0));
+	ILTagBench_createBlock(b, state.range(0));
+	allocs = AllocationCounter::count();
+	for (auto _ : state) {
+		if (structural) {
+			benchmark::DoNotOptimize(ILTagUtil::equals(a, b));
+		} else {
+			benchmark::DoNotOptimize(ILTagBench_serializedEquals(a, b));
+		}
+	}
+	state.counters["allocs"] = benchmark::Counter(
+			AllocationCounter::count() - allocs,
+			benchmark::Counter::kAvgIterations);
+	state.SetBytesProcessed(state.iterations() * a.tagSize());
+	state.SetLabel(structural ? "structural" : "serialize");
+}
+BENCHMARK(ILTagBench_equalsBlock)
+	->ArgsProduct({{1024, 1024 * 1024, 32 * 1024 * 1024}, {0, 1}});
+//------------------------------------------------------------------------------
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <benchmark/benchmark.h>
+#include <ircommon/irjson.h>
+#include <memory>
+#include <string>
+using namespace ircommon::json;
+
+//------------------------------------------------------------------------------
+/**
+ * Creates a JSON document with a list of count records.
+ */
+static std::string IRJsonBench_createDocument(int count) {
+	std::string doc;
+
+	doc = "{\"records\": [";
+	for (int i = 0; i < count; i++) {
+		if (i) {
+			doc += ", ";
+		}
+		doc += "{\"id\": ";
+		doc += std::to_string(i);
+		doc += ", \"name\": \"record \\\"";
+		doc += std::to_string(i);
+		doc += "\\\"\", \"value\": ";
+		doc += std::to_string(i);
+		doc += ".25, \"active\": ";
+		doc += (i % 2) ? "true" : "false";
+		doc += ", \"tags\": [\"alpha\", \"beta\", \"\\u00e7\"], \"parent\": null}";
+	}
+	doc += "]}";
+	return doc;
+}
+
+//------------------------------------------------------------------------------
+static void IRJsonBench_tokenizer(benchmark::State & state) {
+	std::string doc = IRJsonBench_createDocument(state.range(0));
+	IRJsonStringTokenizer tokenizer(doc);
+	IRJsonTokenizer::TokenType type;
+
+	for (auto _ : state) {
+		tokenizer.reset();
+		do {
+			type = tokenizer.next();
+		} while ((type != IRJsonTokenizer::INPUT_END) &&
+				(type != IRJsonTokenizer::INVALID));
+		if (type == IRJsonTokenizer::INVALID) {
+			state.SkipWithError("Invalid token.");
+			break;
+		}
+	}
+	state.SetBytesProcessed(state.iterations() * doc.size());
+}
+BENCHMARK(IRJsonBench_tokenizer)->Arg(16)->Arg(1024)->Arg(16384);
+
+//------------------------------------------------------------------------------
+static void IRJsonBench_parser(benchmark::State & state) {
+	std::string doc = IRJsonBench_createDocument(state.range(0));
+	IRJsonParser parser(doc);
+
+	for (auto _ : state) {
+		parser.reset();
+		std::unique_ptr<IRJsonObject> o(parser.parseObject());
+		if (!o) {
+			state.SkipWithError("Unable to parse.");
+			break;
+		}
+	}
+	state.SetBytesProcessed(state.iterations() * doc.size());
+}
+BENCHMARK(IRJsonBench_parser)->Arg(16)->Arg(1024)->Arg(16384);
+
+//------------------------------------------------------------------------------
+static void IRJsonBench_serializer(benchmark::State & state) {
+	std::string doc = IRJsonBench_createDocument(state.range(0));
+	IRJsonParser parser(doc);
+	std::unique_ptr<IRJsonObject> o(parser.parseObject());
+	IRJsonSerializer serializer(state.range(1) != 0);
+	std::string out;
+
+	if (!o) {
+		state.SkipWithError("Unable to parse.");
+		return;
+	}
+	for (auto _ : state) {
+		out.clear();
+		serializer.serialize(*o, out);
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetBytesProcessed(state.iterations() * out.size());
+	state.SetLabel(serializer.indent() ? "indent" : "compact");
+}
+BENCHMARK(IRJsonBench_serializer)
+	->ArgsProduct({{16, 1024, 16384}, {0, 1}});
+
+//------------------------------------------------------------------------------
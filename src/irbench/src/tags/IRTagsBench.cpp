@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "../AllocationCounter.h"
+#include <benchmark/benchmark.h>
+#include <irecordcore/irhashout.h>
+#include <irecordcore/irtags.h>
+#include <ircommon/iltagstd.h>
+#include <vector>
+using namespace ircommon;
+using namespace ircommon::iltags;
+using namespace irecordcore::crypto;
+using namespace irecordcore::tags;
+
+//------------------------------------------------------------------------------
+/**
+ * Fills a block with a payload of payloadSize bytes, a 64-byte public key
+ * and a 256-byte signature.
+ */
+static void IRTagsBench_createBlock(IRBlockTag & block, int payloadSize) {
+	std::vector<std::uint8_t> payload(payloadSize, 0x5A);
+	std::vector<std::uint8_t> pub(64, 0x11);
+	std::vector<std::uint8_t> sig(256, 0x22);
+
+	block.signedTag().payload().value().set(payload.data(), payload.size());
+	block.signedTag().nextPub().value().setType(1);
+	block.signedTag().nextPub().value().set(pub.data(), pub.size());
+	block.signature().parentHashType().setValue(1);
+	block.signature().signature().value().setType(1);
+	block.signature().signature().value().set(sig.data(), sig.size());
+}
+
+//------------------------------------------------------------------------------
+static void IRTagsBench_serializeBlock(benchmark::State & state) {
+	IRBlockTag block;
+	std::uint64_t allocs;
+
+	IRTagsBench_createBlock(block, state.range(0));
+	allocs = AllocationCounter::count();
+	for (auto _ : state) {
+		IRBuffer out;
+		block.serialize(out);
+		benchmark::DoNotOptimize(out.roBuffer());
+	}
+	state.counters["allocs"] = benchmark::Counter(
+			AllocationCounter::count() - allocs,
+			benchmark::Counter::kAvgIterations);
+	state.SetBytesProcessed(state.iterations() * block.tagSize());
+}
+BENCHMARK(IRTagsBench_serializeBlock)
+	->RangeMultiplier(32)->Range(1024, 32 * 1024 * 1024);
+
+//------------------------------------------------------------------------------
+static void IRTagsBench_deserializeBlock(benchmark::State & state) {
+	IRBlockTag block;
+	ILStandardTagFactory factory;
+	IRBuffer src;
+	std::uint64_t allocs;
+
+	factory.setViewMode(state.range(1) != 0);
+	IRTagsBench_createBlock(block, state.range(0));
+	block.serialize(src);
+	allocs = AllocationCounter::count();
+	for (auto _ : state) {
+		IRBlockTag tag;
+		src.beginning();
+		if (!factory.deserialize(src, tag)) {
+			state.SkipWithError("Unable to deserialize.");
+			break;
+		}
+	}
+	state.counters["allocs"] = benchmark::Counter(
+			AllocationCounter::count() - allocs,
+			benchmark::Counter::kAvgIterations);
+	state.SetBytesProcessed(state.iterations() * src.size());
+	state.SetLabel(factory.viewMode() ? "view" : "copy");
+}
+BENCHMARK(IRTagsBench_deserializeBlock)
+	->ArgsProduct({{1024, 32 * 1024, 1024 * 1024, 32 * 1024 * 1024}, {0, 1}});
+
+//------------------------------------------------------------------------------
+/**
+ * Computes the SHA-256 of a serialized block. Mode 0 serializes the block into
+ * a buffer and hashes it, mode 1 feeds the hash directly with IRHashOutput.
+ */
+static void IRTagsBench_hashBlock(benchmark::State & state) {
+	IRBlockTag block;
+	IRSHA256Hash hash;
+	std::uint8_t digest[32];
+	std::uint64_t allocs;
+	bool stream = (state.range(1) != 0);
+
+	IRTagsBench_createBlock(block, state.range(0));
+	allocs = AllocationCounter::count();
+	for (auto _ : state) {
+		hash.reset();
+		if (stream) {
+			IRHashOutput out(hash);
+			block.serialize(out);
+		} else {
+			IRBuffer out;
+			block.serializeTo(out);
+			hash.update(out.roBuffer(), out.size());
+		}
+		hash.finalize(digest, sizeof(digest));
+		benchmark::DoNotOptimize(digest);
+	}
+	state.counters["allocs"] = benchmark::Counter(
+			AllocationCounter::count() - allocs,
+			benchmark::Counter::kAvgIterations);
+	state.SetBytesProcessed(state.iterations() * block.tagSize());
+	state.SetLabel(stream ? "stream" : "buffer");
+}
+BENCHMARK(IRTagsBench_hashBlock)
+	->ArgsProduct({{1024, 32 * 1024, 1024 * 1024, 32 * 1024 * 1024}, {0, 1}});
+
+//------------------------------------------------------------------------------
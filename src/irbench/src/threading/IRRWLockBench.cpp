@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <benchmark/benchmark.h>
+#include <ircommon/irrwlock.h>
+#include <ircommon/irsemaph.h>
+#include <mutex>
+using namespace ircommon;
+using namespace ircommon::threading;
+
+//------------------------------------------------------------------------------
+/**
+ * The original IRRWLock built on top of two mutexes and a semaphore. It is
+ * used as the reference for the new implementation.
+ */
+class IRRWLockBenchLegacy {
+private:
+	std::mutex _readLock;
+	IRSemaphore _writeLock;
+	std::mutex _writeReq;
+	volatile int _readerCount;
+public:
+	IRRWLockBenchLegacy(): _readerCount(0) {}
+
+	void lockRead() {
+		this->_writeReq.lock();
+		this->_writeReq.unlock();
+		this->_readLock.lock();
+		this->_readerCount++;
+		if (this->_readerCount == 1) {
+			this->_writeLock.wait();
+		}
+		this->_readLock.unlock();
+	}
+
+	void unlockRead() {
+		this->_readLock.lock();
+		this->_readerCount--;
+		if (this->_readerCount == 0) {
+			this->_writeLock.release();
+		}
+		this->_readLock.unlock();
+	}
+
+	void lockWrite() {
+		this->_writeReq.lock();
+		this->_writeLock.wait();
+		this->_writeReq.unlock();
+	}
+
+	void unlockWrite() {
+		this->_writeLock.release();
+	}
+};
+
+//------------------------------------------------------------------------------
+/**
+ * Executes lockRead()/lockWrite() from all threads of the benchmark. The
+ * argument is the percentage of write operations.
+ */
+template <class LockType>
+static void IRRWLockBench_lock(benchmark::State & state) {
+	static LockType lock;
+	static volatile std::uint64_t shared[8];
+	std::uint32_t writePercent = state.range(0);
+	std::uint32_t i = state.thread_index() * 37;
+	std::uint64_t v;
+
+	for (auto _ : state) {
+		i++;
+		if ((i % 100) < writePercent) {
+			lock.lockWrite();
+			for (int j = 0; j < 8; j++) {
+				shared[j] = shared[j] + 1;
+			}
+			lock.unlockWrite();
+		} else {
+			lock.lockRead();
+			v = 0;
+			for (int j = 0; j < 8; j++) {
+				v += shared[j];
+			}
+			lock.unlockRead();
+			benchmark::DoNotOptimize(v);
+		}
+	}
+	state.SetItemsProcessed(state.iterations());
+	state.SetLabel(std::to_string(100 - writePercent) + ":" +
+			std::to_string(writePercent));
+}
+BENCHMARK_TEMPLATE(IRRWLockBench_lock, IRRWLock)
+	->Arg(0)->Arg(1)->Arg(10)->Arg(50)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(IRRWLockBench_lock, IRRWLockBenchLegacy)
+	->Arg(0)->Arg(1)->Arg(10)->Arg(50)->ThreadRange(1, 64)->UseRealTime();
+//------------------------------------------------------------------------------
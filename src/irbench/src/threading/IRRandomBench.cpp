@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <benchmark/benchmark.h>
+#include <ircommon/irshrand.h>
+#include <ircommon/irtlrand.h>
+#include <irecordcore/irsrand.h>
+using namespace ircommon;
+using namespace ircommon::threading;
+using namespace irecordcore::crypto;
+
+//------------------------------------------------------------------------------
+static IRRandom * IRRandomBench_createRandom(int type) {
+
+	if (type) {
+		return new IRSecureRandom();
+	} else {
+		return new IRXORShifRandom();
+	}
+}
+
+//------------------------------------------------------------------------------
+static void IRRandomBench_setLabel(benchmark::State & state) {
+	std::string label;
+
+	label = (state.range(0)) ? "secure" : "xorshift";
+	label.append(" ");
+	label.append(std::to_string(state.range(1)));
+	label.append(" bytes");
+	state.SetLabel(label);
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Extracts state.range(1) bytes from an IRSharedRandom shared by all threads.
+ */
+static void IRRandomBench_shared(benchmark::State & state) {
+	static IRSharedRandom * random[2] = {
+			new IRSharedRandom(IRRandomBench_createRandom(0)),
+			new IRSharedRandom(IRRandomBench_createRandom(1))};
+	std::uint8_t out[256];
+	std::uint64_t size = state.range(1);
+
+	for (auto _ : state) {
+		random[state.range(0)]->nextBytes(out, size);
+		benchmark::DoNotOptimize(out);
+	}
+	state.SetBytesProcessed(state.iterations() * size);
+	IRRandomBench_setLabel(state);
+}
+BENCHMARK(IRRandomBench_shared)
+	->ArgsProduct({{0, 1}, {16, 256}})->ThreadRange(1, 16)->UseRealTime();
+
+//------------------------------------------------------------------------------
+/**
+ * Extracts state.range(1) bytes from an IRThreadLocalRandom shared by all
+ * threads. The per-thread buffer has state.range(2) bytes.
+ */
+static void IRRandomBench_threadLocal(benchmark::State & state) {
+	static IRThreadLocalRandom * random[2][2] = {
+			{new IRThreadLocalRandom(IRRandomBench_createRandom(1),
+					[]() {return IRRandomBench_createRandom(0);}),
+			new IRThreadLocalRandom(IRRandomBench_createRandom(1),
+					[]() {return IRRandomBench_createRandom(0);}, 4096)},
+			{new IRThreadLocalRandom(IRRandomBench_createRandom(1),
+					[]() {return IRRandomBench_createRandom(1);}),
+			new IRThreadLocalRandom(IRRandomBench_createRandom(1),
+					[]() {return IRRandomBench_createRandom(1);}, 4096)}};
+	std::uint8_t out[256];
+	std::uint64_t size = state.range(1);
+	IRRandom * r = random[state.range(0)][state.range(2) ? 1 : 0];
+
+	for (auto _ : state) {
+		r->nextBytes(out, size);
+		benchmark::DoNotOptimize(out);
+	}
+	state.SetBytesProcessed(state.iterations() * size);
+	IRRandomBench_setLabel(state);
+}
+BENCHMARK(IRRandomBench_threadLocal)
+	->ArgsProduct({{0, 1}, {16, 256}, {0, 4096}})->ThreadRange(1, 16)
+	->UseRealTime();
+//------------------------------------------------------------------------------
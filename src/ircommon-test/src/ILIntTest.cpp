@@ -15,6 +15,8 @@
  */
 #include "ILIntTest.h"
 #include <ircommon/ilint.h>
+#include <cstring>
+#include <vector>
 
 using namespace ircommon;
 
@@ -242,4 +244,132 @@ TEST_F(ILIntTest, encodedSize) {
 	ASSERT_EQ(9, ILInt::encodedSize(0xFF));
 }
 //------------------------------------------------------------------------------
+TEST_F(ILIntTest, decode_Padded) {
+	uint8_t enc[32];
+	uint64_t v;
+	uint64_t vDec;
+	int encSize;
+
+	// The size of the input must not affect the result
+	for (int i = 0; i < 10000; i++) {
+		v = rand() | ((uint64_t)rand() << 32);
+		v = v >> (rand() % 64);
+		memset(enc, 0xA5, sizeof(enc));
+		encSize = ILInt::encode(v, enc, sizeof(enc));
+		for (int inpSize = encSize; inpSize < 16; inpSize++) {
+			ASSERT_EQ(encSize, ILInt::decode(enc, inpSize, &vDec));
+			ASSERT_EQ(v, vDec);
+		}
+		ASSERT_EQ(0, ILInt::decode(enc, encSize - 1, &vDec));
+	}
+
+	// Overflow
+	memset(enc, 0xFF, sizeof(enc));
+	enc[8] = 0x08;
+	ASSERT_EQ(0, ILInt::decode(enc, sizeof(enc), &v));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILIntTest, sizeMany) {
+	uint64_t values[64] = {};
+	uint64_t exp;
+
+	ASSERT_EQ(0, ILInt::size(values, 0));
+	exp = 0;
+	for (int i = 0; i < 64; i++) {
+		values[i] = 0xFFFFFFFFFFFFFFFFll >> i;
+		exp += ILInt::size(values[i]);
+		ASSERT_EQ(exp, ILInt::size(values, i + 1));
+	}
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILIntTest, encodeMany) {
+	uint64_t values[64];
+	uint8_t exp[64 * 9];
+	uint8_t enc[64 * 9 + 1];
+	uint64_t expSize;
+
+	expSize = 0;
+	for (int i = 0; i < 64; i++) {
+		values[i] = 0xFFFFFFFFFFFFFFFFll >> i;
+		expSize += ILInt::encode(values[i], exp + expSize,
+				sizeof(exp) - expSize);
+	}
+	memset(enc, 0xA5, sizeof(enc));
+	ASSERT_EQ(expSize, ILInt::encodeMany(values, 64, enc, expSize));
+	ASSERT_EQ(0, memcmp(exp, enc, expSize));
+	ASSERT_EQ(0xA5, enc[expSize]);
+
+	ASSERT_EQ(0, ILInt::encodeMany(values, 64, enc, expSize - 1));
+	ASSERT_EQ(0, ILInt::encodeMany(values, 0, enc, sizeof(enc)));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILIntTest, decodeMany) {
+	uint64_t values[64];
+	uint64_t dec[64];
+	uint8_t enc[64 * 9];
+	uint64_t encSize;
+
+	for (int i = 0; i < 64; i++) {
+		values[i] = 0xFFFFFFFFFFFFFFFFll >> i;
+	}
+	encSize = ILInt::encodeMany(values, 64, enc, sizeof(enc));
+	ASSERT_EQ(encSize, ILInt::decodeMany(enc, encSize, dec, 64));
+	for (int i = 0; i < 64; i++) {
+		ASSERT_EQ(values[i], dec[i]);
+	}
 
+	// Partial
+	ASSERT_EQ(9, ILInt::decodeMany(enc, encSize, dec, 1));
+	ASSERT_EQ(0, ILInt::decodeMany(enc, encSize - 1, dec, 64));
+	ASSERT_EQ(0, ILInt::decodeMany(enc, encSize, dec, 65));
+	ASSERT_EQ(0, ILInt::decodeMany(enc, encSize, dec, 0));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILIntTest, decodeManyLong) {
+	std::vector<uint64_t> values(4096);
+	std::vector<uint64_t> dec(values.size());
+	std::vector<uint8_t> enc(values.size() * 9);
+	uint64_t encSize;
+	uint64_t v;
+
+	// Long runs of single byte values with a few larger ones in between
+	for (unsigned i = 0; i < values.size(); i++) {
+		if ((i % 53) == 0) {
+			values[i] = 0xFFFFFFFFFFFFFFFFll >> (i % 64);
+		} else if ((i % 37) == 0) {
+			values[i] = ILInt::ILINT_BASE + i;
+		} else {
+			values[i] = i % ILInt::ILINT_BASE;
+		}
+	}
+	encSize = ILInt::encodeMany(values.data(), values.size(), enc.data(),
+			enc.size());
+	ASSERT_EQ(ILInt::size(values.data(), values.size()), encSize);
+	ASSERT_EQ(encSize, ILInt::decodeMany(enc.data(), encSize, dec.data(),
+			dec.size()));
+	ASSERT_EQ(values, dec);
+
+	// All prefixes must agree with the single value decoder
+	for (unsigned count = 0; count < 100; count++) {
+		uint64_t expected = 0;
+		for (unsigned i = 0; i < count; i++) {
+			expected += ILInt::decode(enc.data() + expected,
+					encSize - expected, &v);
+			ASSERT_EQ(values[i], v);
+		}
+		ASSERT_EQ(expected, ILInt::decodeMany(enc.data(), encSize,
+				dec.data(), count));
+	}
+
+	// Overflow after a run of single byte values
+	std::memset(enc.data(), 0x01, 100);
+	std::memset(enc.data() + 100, 0xFF, 9);
+	ASSERT_EQ(0, ILInt::decodeMany(enc.data(), encSize, dec.data(),
+			dec.size()));
+	ASSERT_EQ(100, ILInt::decodeMany(enc.data(), encSize, dec.data(), 100));
+}
+//------------------------------------------------------------------------------
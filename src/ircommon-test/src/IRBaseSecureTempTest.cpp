@@ -146,7 +146,7 @@ TEST_F(IRBaseSecureTempTest, posBuff) {
 
 	tmp.clear();
 	ASSERT_EQ(0, tmp.position());
-	for (unsigned int i = 0; i <= tmp.size(); i++) {
+	for (unsigned int i = 0; i < tmp.size(); i++) {
 		tmp.setPosition(i);
 		*tmp.posBuff() = i;
 		ASSERT_EQ(i, tmp.buff()[i]);
@@ -159,7 +159,7 @@ TEST_F(IRBaseSecureTempTest, indexOperator) {
 	IRBaseSecureTemp<std::uint16_t> tmp(32);
 	IRBaseSecureTemp<std::uint16_t> & cTmp = tmp;
 
-	for (unsigned int i = 0; i <= tmp.size(); i++) {
+	for (unsigned int i = 0; i < tmp.size(); i++) {
 		tmp.clear();
 		tmp[i] = i;
 		ASSERT_EQ(i, tmp.buff()[i]);
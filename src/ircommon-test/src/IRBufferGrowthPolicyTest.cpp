@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "IRBufferGrowthPolicyTest.h"
+#include <ircommon/irbuffer.h>
+#include <stdexcept>
+using namespace ircommon;
+
+//==============================================================================
+// class IRBufferGrowthPolicyTest
+//------------------------------------------------------------------------------
+IRBufferGrowthPolicyTest::IRBufferGrowthPolicyTest() {
+}
+
+//------------------------------------------------------------------------------
+IRBufferGrowthPolicyTest::~IRBufferGrowthPolicyTest() {
+}
+
+//------------------------------------------------------------------------------
+void IRBufferGrowthPolicyTest::SetUp() {
+}
+
+//------------------------------------------------------------------------------
+void IRBufferGrowthPolicyTest::TearDown() {
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBufferGrowthPolicyTest, FixedNextSize) {
+	IRFixedGrowthPolicy p;
+
+	ASSERT_EQ(16, p.nextSize(0, 1, 16));
+	ASSERT_EQ(32, p.nextSize(16, 17, 16));
+	ASSERT_EQ(48, p.nextSize(16, 33, 16));
+	ASSERT_EQ(16, p.nextSize(1000, 15, 16));
+	ASSERT_EQ(101, p.nextSize(0, 100, 1));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBufferGrowthPolicyTest, FixedInstance) {
+
+	ASSERT_EQ(&IRFixedGrowthPolicy::instance(),
+			&IRFixedGrowthPolicy::instance());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBufferGrowthPolicyTest, GeometricConstructor) {
+
+	IRGeometricGrowthPolicy p1;
+	ASSERT_EQ(2, p1.numerator());
+	ASSERT_EQ(1, p1.denominator());
+
+	IRGeometricGrowthPolicy p2(3, 2);
+	ASSERT_EQ(3, p2.numerator());
+	ASSERT_EQ(2, p2.denominator());
+
+	ASSERT_THROW(IRGeometricGrowthPolicy(1, 1), std::invalid_argument);
+	ASSERT_THROW(IRGeometricGrowthPolicy(1, 2), std::invalid_argument);
+	ASSERT_THROW(IRGeometricGrowthPolicy(2, 0), std::invalid_argument);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBufferGrowthPolicyTest, GeometricNextSize) {
+	IRGeometricGrowthPolicy p2(2, 1);
+	IRGeometricGrowthPolicy p15(3, 2);
+
+	ASSERT_EQ(16, p2.nextSize(0, 1, 16));
+	ASSERT_EQ(32, p2.nextSize(16, 17, 16));
+	ASSERT_EQ(64, p2.nextSize(32, 33, 16));
+	ASSERT_EQ(112, p2.nextSize(32, 100, 16));
+	ASSERT_EQ(2048, p2.nextSize(1024, 1025, 16));
+
+	ASSERT_EQ(16, p15.nextSize(0, 1, 16));
+	ASSERT_EQ(32, p15.nextSize(16, 17, 16));
+	ASSERT_EQ(48, p15.nextSize(32, 33, 16));
+	ASSERT_EQ(1536, p15.nextSize(1024, 1025, 16));
+
+	// Overflow
+	ASSERT_EQ(0xFFFFFFFFFFFFFFE0ll,
+			p2.nextSize(0xFFFFFFFFFFFFFF00ll, 0xFFFFFFFFFFFFFFE0ll, 16));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBufferGrowthPolicyTest, GeometricInstances) {
+
+	ASSERT_EQ(2, IRGeometricGrowthPolicy::doubling().numerator());
+	ASSERT_EQ(1, IRGeometricGrowthPolicy::doubling().denominator());
+	ASSERT_EQ(3, IRGeometricGrowthPolicy::oneAndHalf().numerator());
+	ASSERT_EQ(2, IRGeometricGrowthPolicy::oneAndHalf().denominator());
+}
+//------------------------------------------------------------------------------
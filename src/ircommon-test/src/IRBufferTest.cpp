@@ -17,6 +17,7 @@
 #include <ircommon/irbuffer.h>
 #include <ircommon/ilint.h>
 #include <ircommon/irfp.h>
+#include <ircommon/irutils.h>
 #include <cstring>
 using namespace ircommon;
 
@@ -829,6 +830,47 @@ TEST_F(IRBufferTest, readILIntRW) {
 	}
 }
 
+//------------------------------------------------------------------------------
+TEST_F(IRBufferTest, writeILInts) {
+	IRBuffer b;
+	IRBuffer ro(IRBufferTest_SAMPLE, IRBufferTest_SAMPLE_SIZE);
+
+	ASSERT_FALSE(ro.writeILInts(IRBufferTest_ILINT_VALUES,
+			IRBufferTest_ILINT_VALUES_COUNT));
+
+	ASSERT_TRUE(b.writeILInts(IRBufferTest_ILINT_VALUES, 0));
+	ASSERT_EQ(0, b.size());
+
+	ASSERT_TRUE(b.write(0xA5));
+	ASSERT_TRUE(b.writeILInts(IRBufferTest_ILINT_VALUES,
+			IRBufferTest_ILINT_VALUES_COUNT));
+	ASSERT_EQ(1 + sizeof(IRBufferTest_ILINT_VALUES_BIN), b.size());
+	ASSERT_EQ(b.size(), b.position());
+	ASSERT_EQ(0xA5, b.roBuffer()[0]);
+	ASSERT_EQ(0, memcmp(b.roBuffer() + 1, IRBufferTest_ILINT_VALUES_BIN,
+			sizeof(IRBufferTest_ILINT_VALUES_BIN)));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBufferTest, readILInts) {
+	IRBuffer b(IRBufferTest_ILINT_VALUES_BIN,
+			sizeof(IRBufferTest_ILINT_VALUES_BIN));
+	std::uint64_t values[IRBufferTest_ILINT_VALUES_COUNT];
+
+	ASSERT_TRUE(b.readILInts(values, 0));
+	ASSERT_EQ(0, b.position());
+	ASSERT_TRUE(b.readILInts(values, IRBufferTest_ILINT_VALUES_COUNT));
+	ASSERT_EQ(b.size(), b.position());
+	for (int i = 0; i < IRBufferTest_ILINT_VALUES_COUNT; i++) {
+		ASSERT_EQ(IRBufferTest_ILINT_VALUES[i], values[i]);
+	}
+
+	// Not enough data
+	b.setPosition(1);
+	ASSERT_FALSE(b.readILInts(values, IRBufferTest_ILINT_VALUES_COUNT));
+	ASSERT_EQ(1, b.position());
+}
+
 //------------------------------------------------------------------------------
 TEST_F(IRBufferTest, roPosBuffer) {
 	IRBuffer b(IRBufferTest_ILINT_VALUES_BIN, sizeof(IRBufferTest_ILINT_VALUES_BIN));
@@ -1516,3 +1558,201 @@ TEST_F(IRBufferTest, copy) {
 
 
 
+TEST_F(IRBufferTest, growthPolicy) {
+	IRBuffer buff;
+	IRBuffer roBuff(IRBufferTest_SAMPLE, IRBufferTest_SAMPLE_SIZE);
+
+	ASSERT_TRUE(buff.growthPolicy() == nullptr);
+	ASSERT_TRUE(roBuff.growthPolicy() == nullptr);
+
+	buff.setGrowthPolicy(&IRGeometricGrowthPolicy::doubling());
+	ASSERT_TRUE(buff.growthPolicy() == &IRGeometricGrowthPolicy::doubling());
+	buff.setGrowthPolicy(nullptr);
+	ASSERT_TRUE(buff.growthPolicy() == nullptr);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBufferTest, growthPolicyWrite) {
+	IRBuffer buff(0, false, 16);
+
+	buff.setGrowthPolicy(&IRGeometricGrowthPolicy::doubling());
+	for (int i = 0; i < 16; i++) {
+		ASSERT_TRUE(buff.write(i));
+	}
+	ASSERT_EQ(16, buff.bufferSize());
+	ASSERT_TRUE(buff.write(16));
+	ASSERT_EQ(32, buff.bufferSize());
+	for (int i = 17; i < 33; i++) {
+		ASSERT_TRUE(buff.writeILInt(i));
+	}
+	ASSERT_EQ(64, buff.bufferSize());
+	ASSERT_TRUE(buff.write(IRBufferTest_SAMPLE, IRBufferTest_SAMPLE_SIZE));
+	ASSERT_EQ(IRUtils::getPaddedSize<std::uint64_t>(
+			33 + IRBufferTest_SAMPLE_SIZE, 16), buff.bufferSize());
+	ASSERT_EQ(33 + IRBufferTest_SAMPLE_SIZE, buff.size());
+	for (int i = 0; i < 33; i++) {
+		ASSERT_EQ(i, buff.roBuffer()[i]);
+	}
+	ASSERT_EQ(0, std::memcmp(IRBufferTest_SAMPLE, buff.roBuffer() + 33,
+			IRBufferTest_SAMPLE_SIZE));
+
+	// The reserve ignores the policy
+	ASSERT_TRUE(buff.reserve(buff.bufferSize() + 1));
+	ASSERT_EQ(IRUtils::getPaddedSize<std::uint64_t>(
+			33 + IRBufferTest_SAMPLE_SIZE, 16) + 16, buff.bufferSize());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBufferTest, growthPolicySecure) {
+	IRBuffer buff(0, true, 16);
+
+	buff.setGrowthPolicy(&IRGeometricGrowthPolicy::oneAndHalf());
+	for (int i = 0; i < 1024; i++) {
+		ASSERT_TRUE(buff.writeInt(std::uint32_t(i)));
+	}
+	ASSERT_EQ(4096, buff.size());
+	buff.beginning();
+	for (int i = 0; i < 1024; i++) {
+		std::uint32_t v;
+		ASSERT_TRUE(buff.readInt(v));
+		ASSERT_EQ(i, v);
+	}
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBufferTest, wrap) {
+	IRBuffer buff(0, true, 16);
+
+	ASSERT_FALSE(buff.wrap(nullptr, 1));
+	ASSERT_FALSE(buff.readOnly());
+
+	ASSERT_TRUE(buff.write(IRBufferTest_SAMPLE, 16));
+	ASSERT_TRUE(buff.wrap(IRBufferTest_SAMPLE, IRBufferTest_SAMPLE_SIZE));
+	ASSERT_TRUE(buff.readOnly());
+	ASSERT_EQ((const std::uint8_t *)IRBufferTest_SAMPLE, buff.roBuffer());
+	ASSERT_EQ(IRBufferTest_SAMPLE_SIZE, buff.size());
+	ASSERT_EQ(IRBufferTest_SAMPLE_SIZE, buff.bufferSize());
+	ASSERT_EQ(0, buff.position());
+
+	// Wrap another read-only buffer
+	ASSERT_TRUE(buff.wrap(IRBufferTest_SAMPLE + 1, 10));
+	ASSERT_EQ((const std::uint8_t *)IRBufferTest_SAMPLE + 1, buff.roBuffer());
+	ASSERT_EQ(10, buff.size());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBufferTest, detach) {
+	IRBuffer buff;
+	IRBuffer roBuff(IRBufferTest_SAMPLE, IRBufferTest_SAMPLE_SIZE);
+
+	// Writable instances are not affected
+	ASSERT_TRUE(buff.write(1));
+	ASSERT_TRUE(buff.detach());
+	ASSERT_EQ(1, buff.size());
+	ASSERT_EQ(1, buff.position());
+
+	roBuff.setPosition(3);
+	ASSERT_TRUE(roBuff.detach());
+	ASSERT_FALSE(roBuff.readOnly());
+	ASSERT_NE((const std::uint8_t *)IRBufferTest_SAMPLE, roBuff.roBuffer());
+	ASSERT_EQ(IRBufferTest_SAMPLE_SIZE, roBuff.size());
+	ASSERT_EQ(3, roBuff.position());
+	ASSERT_EQ(std::uint64_t(IRBuffer::DEFAULT_INCREMENT), roBuff.increment());
+	ASSERT_EQ(0, std::memcmp(IRBufferTest_SAMPLE, roBuff.roBuffer(),
+			IRBufferTest_SAMPLE_SIZE));
+	ASSERT_TRUE(roBuff.write(0xFF));
+	ASSERT_EQ(0xFF, roBuff.roBuffer()[3]);
+
+	ASSERT_TRUE(buff.wrap(IRBufferTest_SAMPLE, IRBufferTest_SAMPLE_SIZE));
+	ASSERT_TRUE(buff.detach());
+	ASSERT_FALSE(buff.readOnly());
+	ASSERT_EQ(0, std::memcmp(IRBufferTest_SAMPLE, buff.roBuffer(),
+			IRBufferTest_SAMPLE_SIZE));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBufferTest, wrapWrite) {
+	std::uint8_t src[64];
+	std::uint8_t exp[sizeof(src)];
+	IRBuffer buff;
+	IRBuffer roBuff(src, sizeof(src));
+
+	// The first write detaches the view
+	for (unsigned int i = 0; i < sizeof(src); i++) {
+		src[i] = std::uint8_t(i);
+	}
+	std::memcpy(exp, src, sizeof(src));
+	ASSERT_TRUE(buff.wrap(src, sizeof(src)));
+	buff.setPosition(2);
+	ASSERT_TRUE(buff.write(0xFF));
+	ASSERT_FALSE(buff.readOnly());
+	ASSERT_NE((const std::uint8_t *)src, buff.roBuffer());
+	ASSERT_EQ(sizeof(src), buff.size());
+	ASSERT_EQ(3, buff.position());
+	ASSERT_EQ(0xFF, buff.roBuffer()[2]);
+	ASSERT_EQ(0, std::memcmp(exp, src, sizeof(src)));
+
+	// Every kind of write detaches it
+	ASSERT_TRUE(buff.wrap(src, sizeof(src)));
+	ASSERT_TRUE(buff.setSize(4));
+	ASSERT_FALSE(buff.readOnly());
+	ASSERT_EQ(0, std::memcmp(exp, buff.roBuffer(), 4));
+
+	ASSERT_TRUE(buff.wrap(src, sizeof(src)));
+	ASSERT_TRUE(buff.writeILInt(0xFFFF));
+	ASSERT_FALSE(buff.readOnly());
+
+	ASSERT_TRUE(buff.wrap(src, sizeof(src)));
+	ASSERT_TRUE(buff.buffer() != nullptr);
+	ASSERT_FALSE(buff.readOnly());
+	buff.buffer()[0] = 0;
+
+	ASSERT_TRUE(buff.wrap(src, sizeof(src)));
+	ASSERT_TRUE(buff.set(IRBufferTest_SAMPLE, 8));
+	ASSERT_EQ(8, buff.size());
+	ASSERT_EQ(0, std::memcmp(exp, src, sizeof(src)));
+
+	// Instances created as read-only are never detached
+	ASSERT_FALSE(roBuff.write(1));
+	ASSERT_FALSE(roBuff.setSize(1));
+	ASSERT_TRUE(roBuff.buffer() == nullptr);
+	ASSERT_TRUE(roBuff.posBuffer() == nullptr);
+	ASSERT_TRUE(roBuff.readOnly());
+
+	// Not even after being wrapped again
+	ASSERT_TRUE(roBuff.wrap(src + 1, 8));
+	ASSERT_FALSE(roBuff.write(1));
+	ASSERT_TRUE(roBuff.buffer() == nullptr);
+	ASSERT_TRUE(roBuff.readOnly());
+	ASSERT_EQ((const std::uint8_t *)src + 1, roBuff.roBuffer());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBufferTest, ConstructorNoStorage) {
+	IRBuffer buff(IRBuffer::NO_STORAGE, true, 32);
+	IRBuffer empty(IRBuffer::NO_STORAGE);
+
+	ASSERT_FALSE(buff.readOnly());
+	ASSERT_TRUE(buff.secure());
+	ASSERT_EQ(32, buff.increment());
+	ASSERT_EQ(0, buff.size());
+	ASSERT_EQ(0, buff.bufferSize());
+	ASSERT_TRUE(buff.roBuffer() == nullptr);
+
+	ASSERT_TRUE(buff.write(IRBufferTest_SAMPLE, 40));
+	ASSERT_EQ(40, buff.size());
+	ASSERT_EQ(64, buff.bufferSize());
+	ASSERT_EQ(0, std::memcmp(IRBufferTest_SAMPLE, buff.roBuffer(), 40));
+
+	// A view replaces it without any allocation
+	ASSERT_TRUE(empty.wrap(IRBufferTest_SAMPLE, 16));
+	ASSERT_TRUE(empty.readOnly());
+	ASSERT_TRUE(empty.write(1));
+	ASSERT_FALSE(empty.readOnly());
+	ASSERT_EQ(1, empty.roBuffer()[0]);
+
+	ASSERT_THROW(IRBuffer(IRBuffer::NO_STORAGE, false, 0),
+			std::invalid_argument);
+}
+
+//------------------------------------------------------------------------------
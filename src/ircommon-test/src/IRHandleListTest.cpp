@@ -15,6 +15,8 @@
  */
 #include "IRHandleListTest.h"
 #include <ircommon/irhndlst.h>
+#include <atomic>
+#include <set>
 #include <thread>
 #include <memory>
 using namespace ircommon;
@@ -238,3 +240,68 @@ TEST_F(IRHandleListTest, Concurrency) {
 //------------------------------------------------------------------------------
 
 
+TEST_F(IRHandleListTest, ConcurrentInsertRemove) {
+	std::vector<std::shared_ptr<std::thread>> threads;
+	std::vector<std::vector<std::uint32_t>> kept(4);
+	IRHandleList<int> l(0);
+	std::set<std::uint32_t> unique;
+	IRHandleList<int>::HandleList ids;
+	std::atomic<bool> ok(true);
+
+	for (int t = 0; t < 4; t++) {
+		threads.push_back(
+				std::shared_ptr<std::thread>(
+				new std::thread([&l, &kept, &ok, t](){
+					for (int i = 0; i < 1000; i++) {
+						int v = (t * 1000) + i;
+						int found;
+						std::uint32_t h = l.insert(v);
+						if ((!l.get(h, found)) || (found != v)) {
+							ok = false;
+						}
+						if (i & 1) {
+							if (!l.remove(h)) {
+								ok = false;
+							}
+						} else {
+							kept[t].push_back(h);
+						}
+					}
+				})));
+	}
+	for (unsigned int i = 0; i < threads.size(); i++){
+		threads[i]->join();
+	}
+	ASSERT_TRUE(ok);
+	ASSERT_EQ(2000, l.size());
+
+	l.listHandles(ids);
+	ASSERT_EQ(2000, ids.size());
+	unique.insert(ids.begin(), ids.end());
+	ASSERT_EQ(2000, unique.size());
+	for (int t = 0; t < 4; t++) {
+		for (unsigned int i = 0; i < kept[t].size(); i++) {
+			int v;
+			ASSERT_TRUE(l.get(kept[t][i], v));
+			ASSERT_EQ((t * 1000) + int(i * 2), v);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRHandleListTest, alignment) {
+	std::vector<IRHandleList<int> *> lists;
+
+	for (int i = 0; i < 16; i++) {
+		IRHandleList<int> * l = new IRHandleList<int>(i);
+		ASSERT_EQ(0, std::uintptr_t(l) % 64);
+		l->insert(i);
+		lists.push_back(l);
+	}
+	for (IRHandleList<int> * l : lists) {
+		ASSERT_EQ(1, l->size());
+		delete l;
+	}
+}
+
+//------------------------------------------------------------------------------
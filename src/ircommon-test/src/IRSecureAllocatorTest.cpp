@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "IRSecureAllocatorTest.h"
+#include <ircommon/irsecmem.h>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace ircommon;
+
+//------------------------------------------------------------------------------
+/**
+ * Verifies if the allocator was able to lock its first region. Some
+ * environments restrict the amount of locked memory, thus the tests that
+ * depend on the pool are skipped in that case.
+ */
+static bool IRSecureAllocatorTest_poolAvailable(IRSecureAllocator & a) {
+	IRSecureAllocatorStats stats;
+
+	a.deallocate(a.allocate(1), 1);
+	a.getStats(stats);
+	return (stats.lockedPages > 0);
+}
+
+//==============================================================================
+// class IRSecureAllocatorTest
+//------------------------------------------------------------------------------
+IRSecureAllocatorTest::IRSecureAllocatorTest() {
+}
+
+//------------------------------------------------------------------------------
+IRSecureAllocatorTest::~IRSecureAllocatorTest() {
+}
+
+//------------------------------------------------------------------------------
+void IRSecureAllocatorTest::SetUp() {
+}
+
+//------------------------------------------------------------------------------
+void IRSecureAllocatorTest::TearDown() {
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRSecureAllocatorTest, Constructor) {
+	IRSecureAllocator a;
+	IRSecureAllocatorStats stats;
+
+	a.getStats(stats);
+	ASSERT_EQ(0, stats.lockedPages);
+	ASSERT_EQ(0, stats.bytesInUse);
+	ASSERT_EQ(0, stats.fallbacks);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRSecureAllocatorTest, instance) {
+
+	ASSERT_EQ(&IRSecureAllocator::instance(), &IRSecureAllocator::instance());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRSecureAllocatorTest, allocateDeallocate) {
+	IRSecureAllocator a;
+	IRSecureAllocatorStats stats;
+	std::vector<std::uint8_t *> buffs;
+
+	for (std::uint64_t size = 0; size <= IRSecureAllocator::MAX_CHUNK_SIZE;
+			size += 7) {
+		std::uint8_t * p = (std::uint8_t *)a.allocate(size);
+		ASSERT_NE(nullptr, p);
+		ASSERT_EQ(0, ((std::uintptr_t)p) % IRSecureAllocator::MIN_CHUNK_SIZE);
+		std::memset(p, 0xFF, size);
+		buffs.push_back(p);
+	}
+	a.getStats(stats);
+	ASSERT_LT(0, stats.bytesInUse);
+
+	std::uint64_t size = 0;
+	for (std::uint8_t * p: buffs) {
+		a.deallocate(p, size);
+		size += 7;
+	}
+	a.getStats(stats);
+	ASSERT_EQ(0, stats.bytesInUse);
+
+	// Null is ignored
+	a.deallocate(nullptr, 16);
+	a.getStats(stats);
+	ASSERT_EQ(0, stats.bytesInUse);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRSecureAllocatorTest, sizeClasses) {
+	IRSecureAllocator a;
+	IRSecureAllocatorStats stats;
+	void * p;
+
+	if (!IRSecureAllocatorTest_poolAvailable(a)) {
+		return;
+	}
+	p = a.allocate(1);
+	a.getStats(stats);
+	ASSERT_EQ(16, stats.bytesInUse);
+	a.deallocate(p, 1);
+
+	p = a.allocate(17);
+	a.getStats(stats);
+	ASSERT_EQ(32, stats.bytesInUse);
+	a.deallocate(p, 17);
+
+	p = a.allocate(IRSecureAllocator::MAX_CHUNK_SIZE);
+	a.getStats(stats);
+	ASSERT_EQ(IRSecureAllocator::MAX_CHUNK_SIZE, stats.bytesInUse);
+	a.deallocate(p, IRSecureAllocator::MAX_CHUNK_SIZE);
+
+	a.getStats(stats);
+	ASSERT_EQ(0, stats.bytesInUse);
+	ASSERT_EQ(0, stats.fallbacks);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRSecureAllocatorTest, reuse) {
+	IRSecureAllocator a;
+	void * p;
+	void * p2;
+
+	if (!IRSecureAllocatorTest_poolAvailable(a)) {
+		return;
+	}
+	p = a.allocate(64);
+	a.deallocate(p, 64);
+	p2 = a.allocate(50);
+	ASSERT_EQ(p, p2);
+	a.deallocate(p2, 50);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRSecureAllocatorTest, wipeOnFree) {
+	IRSecureAllocator a;
+	std::uint8_t * p;
+	std::uint8_t expected[128];
+
+	if (!IRSecureAllocatorTest_poolAvailable(a)) {
+		return;
+	}
+	p = (std::uint8_t *)a.allocate(sizeof(expected));
+	std::memset(p, 0xA5, sizeof(expected));
+	a.deallocate(p, sizeof(expected));
+
+	// The chunk remains mapped. Only the link of the free list may be set.
+	std::memset(expected, 0, sizeof(expected));
+	ASSERT_EQ(0, std::memcmp(p + sizeof(void *), expected + sizeof(void *),
+			sizeof(expected) - sizeof(void *)));
+
+	// Chunks are delivered without the link
+	p = (std::uint8_t *)a.allocate(sizeof(expected));
+	ASSERT_EQ(0, std::memcmp(p, expected, sizeof(expected)));
+	a.deallocate(p, sizeof(expected));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRSecureAllocatorTest, fallback) {
+	IRSecureAllocator a;
+	IRSecureAllocatorStats stats;
+	std::uint64_t size = IRSecureAllocator::MAX_CHUNK_SIZE + 1;
+	std::uint8_t * p;
+
+	p = (std::uint8_t *)a.allocate(size);
+	ASSERT_NE(nullptr, p);
+	// Fallback buffers do not share pages
+	ASSERT_EQ(0, ((std::uintptr_t)p) % 4096);
+	std::memset(p, 0xFF, size);
+	a.getStats(stats);
+	ASSERT_EQ(1, stats.fallbacks);
+	ASSERT_EQ(size, stats.bytesInUse);
+	ASSERT_EQ(0, stats.lockedPages);
+
+	a.deallocate(p, size);
+	a.getStats(stats);
+	ASSERT_EQ(1, stats.fallbacks);
+	ASSERT_EQ(0, stats.bytesInUse);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRSecureAllocatorTest, exhaustion) {
+	IRSecureAllocator a;
+	IRSecureAllocatorStats stats;
+	std::vector<void *> buffs;
+	std::uint64_t count;
+
+	if (!IRSecureAllocatorTest_poolAvailable(a)) {
+		return;
+	}
+	count = (IRSecureAllocator::MAX_REGIONS * IRSecureAllocator::REGION_SIZE) /
+			IRSecureAllocator::MAX_CHUNK_SIZE;
+	for (std::uint64_t i = 0; i < count + 4; i++) {
+		void * p = a.allocate(IRSecureAllocator::MAX_CHUNK_SIZE);
+		ASSERT_NE(nullptr, p);
+		buffs.push_back(p);
+	}
+	a.getStats(stats);
+	ASSERT_LE(4, stats.fallbacks);
+	ASSERT_EQ(IRSecureAllocator::MAX_CHUNK_SIZE * buffs.size(),
+			stats.bytesInUse);
+
+	for (void * p: buffs) {
+		a.deallocate(p, IRSecureAllocator::MAX_CHUNK_SIZE);
+	}
+	a.getStats(stats);
+	ASSERT_EQ(0, stats.bytesInUse);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRSecureAllocatorTest, Concurrent) {
+	IRSecureAllocator a;
+	IRSecureAllocatorStats stats;
+	std::vector<std::shared_ptr<std::thread>> threads;
+
+	for (int i = 0; i < 8; i++) {
+		threads.push_back(std::make_shared<std::thread>([&a, i]() {
+			std::vector<std::uint8_t *> buffs;
+			for (int j = 0; j < 1000; j++) {
+				std::uint64_t size = 1 + ((i * 131 + j * 17) % 512);
+				std::uint8_t * p = (std::uint8_t *)a.allocate(size);
+				std::memset(p, i, size);
+				buffs.push_back(p);
+				if ((j % 3) == 0) {
+					for (std::uint8_t * b: buffs) {
+						if (b[0] != i) {
+							std::abort();
+						}
+					}
+				}
+				if (buffs.size() == 8) {
+					for (unsigned int k = 0; k < buffs.size(); k++) {
+						std::uint64_t s = 1 + ((i * 131 +
+								(j - 7 + k) * 17) % 512);
+						a.deallocate(buffs[k], s);
+					}
+					buffs.clear();
+				}
+			}
+		}));
+	}
+	for (auto & t: threads) {
+		t->join();
+	}
+	a.getStats(stats);
+	ASSERT_EQ(0, stats.bytesInUse);
+}
+
+//------------------------------------------------------------------------------
@@ -15,6 +15,7 @@
  */
 #include "IRAlphabetTest.h"
 #include <set>
+#include <cstring>
 
 #include <ircommon/iralphab.h>
 
@@ -171,3 +172,23 @@ TEST_F(IRAlphabetTest, checkUniqueCharsFail) {
 }
 //------------------------------------------------------------------------------
 
+
+//------------------------------------------------------------------------------
+TEST_F(IRAlphabetTest, maps) {
+	IRDummyAlphabet a("01", 2);
+	IRGenericAlphabet b("0120", 4);
+
+	// Alphabets without lookup tables
+	ASSERT_EQ(nullptr, a.charMap());
+	ASSERT_EQ(nullptr, a.valueMap());
+
+	ASSERT_EQ(0, std::memcmp("0120", b.charMap(), 4));
+	for (int i = 0; i < 256; i++) {
+		ASSERT_EQ(b.getValue(i), b.valueMap()[i]);
+	}
+	// The first occurrence prevails
+	ASSERT_EQ(0, b.getValue('0'));
+	ASSERT_EQ(2, b.getValue('2'));
+	ASSERT_EQ(-1, b.getValue('3'));
+}
+//------------------------------------------------------------------------------
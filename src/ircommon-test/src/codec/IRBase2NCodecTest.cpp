@@ -84,6 +84,28 @@ IRDummyBase2NCodec::IRDummyBase2NCodec(
 				paddingChar, ignoreSpaces) {
 }
 
+//==============================================================================
+// class IRUnmappedAlphabet - Exposes an alphabet without its lookup tables in
+// order to force IRBase2NCodec to use getValue() and getChar().
+//------------------------------------------------------------------------------
+class IRUnmappedAlphabet: public IRAlphabet {
+private:
+	std::shared_ptr<IRAlphabet> _alphabet;
+public:
+	IRUnmappedAlphabet(std::shared_ptr<IRAlphabet> alphabet):
+			IRAlphabet(alphabet->size()), _alphabet(alphabet) {}
+
+	virtual ~IRUnmappedAlphabet() = default;
+
+	virtual int getValue(int c) const {
+		return this->_alphabet->getValue(c);
+	}
+
+	virtual int getChar(int v) const {
+		return this->_alphabet->getChar(v);
+	}
+};
+
 //==============================================================================
 // class IRBase2NCodecTest
 //------------------------------------------------------------------------------
@@ -661,4 +683,130 @@ TEST_F(IRBase2NCodecTest, encodeDecode32Padding) {
 	}
 }
 //------------------------------------------------------------------------------
-
+TEST_F(IRBase2NCodecTest, encodeDecodeMapped) {
+	char map[128];
+	std::uint8_t src[64];
+	std::uint8_t dec[128];
+	std::uint8_t exp[128];
+	int decSize;
+	int expSize;
+	std::string enc;
+	std::string expEnc;
+
+	for (int i = 0; i < 128; i++) {
+		map[i] = char(0x80 + i);
+	}
+	for (int size = 2; size <= 128; size *= 2) {
+		std::shared_ptr<IRAlphabet> mapped(
+				std::make_shared<IRGenericAlphabet>(map, size));
+		ASSERT_NE(nullptr, mapped->charMap());
+		ASSERT_NE(nullptr, mapped->valueMap());
+		IRDummyBase2NCodec c(mapped, 0, '=', true);
+		IRDummyBase2NCodec u(std::make_shared<IRUnmappedAlphabet>(mapped),
+				0, '=', true);
+		ASSERT_EQ(nullptr, u.alphabet().charMap());
+		ASSERT_EQ(nullptr, u.alphabet().valueMap());
+
+		for (int srcSize = 0; srcSize <= int(sizeof(src)); srcSize++) {
+			std::generate_n(src, srcSize, rand);
+			enc = "-";
+			expEnc = "-";
+			c.encodeCoreEx(src, srcSize, enc);
+			u.encodeCoreEx(src, srcSize, expEnc);
+			ASSERT_EQ(expEnc, enc);
+
+			// Spaces inside the groups
+			enc.erase(0, 1);
+			for (unsigned int i = 0; i < enc.size(); i += 1 + (rand() % 7)) {
+				enc.insert(enc.begin() + i, ' ');
+				i++;
+			}
+			decSize = sizeof(dec);
+			ASSERT_TRUE(c.decodeCoreEx(enc.c_str(), enc.size(), dec, decSize));
+			expSize = sizeof(exp);
+			ASSERT_TRUE(u.decodeCoreEx(enc.c_str(), enc.size(), exp, expSize));
+			ASSERT_EQ(srcSize, decSize);
+			ASSERT_EQ(expSize, decSize);
+			ASSERT_EQ(0, memcmp(src, dec, srcSize));
+
+			// Invalid character
+			if (enc.size() > 0) {
+				enc[rand() % enc.size()] = '!';
+				decSize = sizeof(dec);
+				ASSERT_FALSE(c.decodeCoreEx(enc.c_str(), enc.size(), dec,
+						decSize));
+			}
+		}
+	}
+}
+//------------------------------------------------------------------------------
+TEST_F(IRBase2NCodecTest, encodeDecodeVector) {
+	std::shared_ptr<IRAlphabet> alphabets[] = {
+			std::make_shared<IRHexAlphabet>(false),
+			std::make_shared<IRHexAlphabet>(true),
+			std::make_shared<IRBase64Alphabet>(false),
+			std::make_shared<IRBase64Alphabet>(true),
+			std::make_shared<IRBase64Alphabet>(0xF0, 0xF1),
+			std::make_shared<IRGenericAlphabet>(
+					"/+9876543210zyxwvutsrqponmlkjihgfedcba"
+					"ZYXWVUTSRQPONMLKJIHGFEDCBA", 64)};
+	std::uint8_t src[300];
+	std::uint8_t dec[512];
+	std::uint8_t exp[512];
+	int decSize;
+	int expSize;
+	std::string enc;
+	std::string expEnc;
+
+	for (std::shared_ptr<IRAlphabet> & a : alphabets) {
+		IRDummyBase2NCodec c(a, 0, '=', true);
+		IRDummyBase2NCodec u(std::make_shared<IRUnmappedAlphabet>(a),
+				0, '=', true);
+
+		for (int srcSize = 0; srcSize <= int(sizeof(src)); srcSize++) {
+			std::generate_n(src, srcSize, rand);
+			enc.clear();
+			expEnc.clear();
+			c.encodeCoreEx(src, srcSize, enc);
+			u.encodeCoreEx(src, srcSize, expEnc);
+			ASSERT_EQ(expEnc, enc);
+
+			decSize = srcSize;
+			ASSERT_TRUE(c.decodeCoreEx(enc.c_str(), enc.size(), dec, decSize));
+			ASSERT_EQ(srcSize, decSize);
+			ASSERT_EQ(0, memcmp(src, dec, srcSize));
+
+			// Both cases are accepted by the hexadecimal alphabets
+			if (a->size() == 16) {
+				std::transform(enc.begin(), enc.end(), enc.begin(), ::tolower);
+				decSize = srcSize;
+				ASSERT_TRUE(c.decodeCoreEx(enc.c_str(), enc.size(), dec,
+						decSize));
+				ASSERT_EQ(srcSize, decSize);
+				ASSERT_EQ(0, memcmp(src, dec, srcSize));
+			}
+
+			// Spaces between the blocks
+			for (unsigned int i = 0; i < enc.size(); i += 1 + (rand() % 80)) {
+				enc.insert(enc.begin() + i, '\n');
+				i++;
+			}
+			decSize = sizeof(dec);
+			ASSERT_TRUE(c.decodeCoreEx(enc.c_str(), enc.size(), dec, decSize));
+			expSize = sizeof(exp);
+			ASSERT_TRUE(u.decodeCoreEx(enc.c_str(), enc.size(), exp, expSize));
+			ASSERT_EQ(srcSize, decSize);
+			ASSERT_EQ(expSize, decSize);
+			ASSERT_EQ(0, memcmp(src, dec, srcSize));
+
+			// Invalid character
+			if (enc.size() > 0) {
+				enc[rand() % enc.size()] = '!';
+				decSize = sizeof(dec);
+				ASSERT_FALSE(c.decodeCoreEx(enc.c_str(), enc.size(), dec,
+						decSize));
+			}
+		}
+	}
+}
+//------------------------------------------------------------------------------
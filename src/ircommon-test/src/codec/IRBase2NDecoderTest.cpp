@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "IRBase2NDecoderTest.h"
+#include "IRBase2NTestCodecs.h"
+#include <ircommon/ircodec.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <stdlib.h>
+
+using namespace ircommon;
+using namespace ircommon::codec;
+
+//------------------------------------------------------------------------------
+/**
+ * Decodes src in chunks of a given size.
+ */
+static bool IRBase2NDecoderTest_decode(IRBase2NDecoder & d,
+		const std::string & src, int chunk, std::string & dst) {
+	std::uint64_t dstSize;
+
+	dst.clear();
+	for (int offs = 0; offs < int(src.size()); offs += chunk) {
+		int len = std::min(chunk, int(src.size()) - offs);
+		std::string::size_type start = dst.size();
+		dstSize = d.getUpdateSize(len);
+		dst.resize(start + dstSize);
+		if (!d.update(src.c_str() + offs, len, &(dst[0]) + start, dstSize)) {
+			return false;
+		}
+		dst.resize(start + dstSize);
+	}
+	return d.finish();
+}
+
+//==============================================================================
+// class IRBase2NDecoderTest
+//------------------------------------------------------------------------------
+IRBase2NDecoderTest::IRBase2NDecoderTest() {
+}
+
+//------------------------------------------------------------------------------
+IRBase2NDecoderTest::~IRBase2NDecoderTest() {
+}
+
+//------------------------------------------------------------------------------
+void IRBase2NDecoderTest::SetUp() {
+}
+
+//------------------------------------------------------------------------------
+void IRBase2NDecoderTest::TearDown() {
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBase2NDecoderTest, Constructor) {
+	IRBase2NCodec codec(std::make_shared<IRBase64Alphabet>(), 4, '=');
+	IRBase2NDecoder * d;
+
+	d = new IRBase2NDecoder(codec);
+	ASSERT_EQ(&codec, &d->codec());
+	ASSERT_EQ(0, d->getUpdateSize(0));
+	ASSERT_TRUE(d->finish());
+	delete d;
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBase2NDecoderTest, getUpdateSize) {
+	IRBase2NCodec codec(std::make_shared<IRBase64Alphabet>(), 4, '=');
+	IRBase2NDecoder d(codec);
+	std::uint8_t dst[16];
+	std::uint64_t dstSize;
+
+	ASSERT_EQ(0, d.getUpdateSize(0));
+	ASSERT_EQ(0, d.getUpdateSize(1));
+	ASSERT_EQ(1, d.getUpdateSize(2));
+	ASSERT_EQ(3, d.getUpdateSize(4));
+	ASSERT_EQ(0x300000000ull, d.getUpdateSize(0x400000000ull));
+
+	dstSize = sizeof(dst);
+	ASSERT_TRUE(d.update("Z", 1, dst, dstSize));
+	ASSERT_EQ(0, dstSize);
+	ASSERT_EQ(0, d.getUpdateSize(0));
+	ASSERT_EQ(1, d.getUpdateSize(1));
+
+	dstSize = sizeof(dst);
+	ASSERT_TRUE(d.update("m", 1, dst, dstSize));
+	ASSERT_EQ(1, dstSize);
+	ASSERT_EQ('f', dst[0]);
+	ASSERT_EQ(0, d.getUpdateSize(0));
+	ASSERT_EQ(1, d.getUpdateSize(1));
+
+	d.reset();
+	ASSERT_EQ(0, d.getUpdateSize(1));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBase2NDecoderTest, updateFinish) {
+	std::vector<std::shared_ptr<IRBase2NCodec>> codecs;
+	std::uint8_t src[300];
+	std::string enc;
+	std::string dec;
+	static const int CHUNKS[] = {1, 2, 3, 5, 7, 64, 1000};
+
+	for (unsigned int i = 0; i < sizeof(src); i++) {
+		src[i] = std::uint8_t(rand());
+	}
+	IRBase2NTestCodecs_create(codecs);
+	for (auto codec: codecs) {
+		IRBase2NDecoder d(*codec);
+		for (int size = 0; size <= int(sizeof(src)); size += 1 + (size / 10)) {
+			enc.clear();
+			codec->encode(src, size, enc);
+			for (int chunk: CHUNKS) {
+				ASSERT_TRUE(IRBase2NDecoderTest_decode(d, enc, chunk, dec));
+				ASSERT_EQ(size, dec.size());
+				ASSERT_EQ(0, std::memcmp(src, dec.c_str(), size));
+			}
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBase2NDecoderTest, updateFinishSpaces) {
+	IRBase2NCodec codec(std::make_shared<IRBase64Alphabet>(), 4, '=', true);
+	IRBase2NDecoder d(codec);
+	std::uint8_t src[200];
+	std::string enc;
+	std::string dec;
+
+	for (unsigned int i = 0; i < sizeof(src); i++) {
+		src[i] = std::uint8_t(rand());
+	}
+	codec.encode(src, sizeof(src) - 1, enc);
+	for (unsigned int i = 0; i < enc.size(); i += 1 + (rand() % 40)) {
+		enc.insert(i, 1, '\n');
+	}
+	enc.append(" \r\n");
+	for (int chunk = 1; chunk < 80; chunk++) {
+		ASSERT_TRUE(IRBase2NDecoderTest_decode(d, enc, chunk, dec));
+		ASSERT_EQ(sizeof(src) - 1, dec.size());
+		ASSERT_EQ(0, std::memcmp(src, dec.c_str(), dec.size()));
+	}
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBase2NDecoderTest, padding) {
+	IRBase2NCodec codec(std::make_shared<IRBase64Alphabet>(), 4, '=', true);
+	IRBase2NDecoder d(codec);
+	std::uint8_t exp[16];
+	int expSize;
+	std::string dec;
+	static const char * SAMPLES[] = {
+			"", "Zg==", "Zg=", "Zg===", "Zg=A", "Zg= =", "Zg==\n", "Zm8=",
+			"Zm9v", "Z===", "Zg==Zg==", "=", "===="};
+
+	for (const char * sample: SAMPLES) {
+		std::string src(sample);
+		expSize = sizeof(exp);
+		bool retval = codec.decode(src, exp, expSize);
+		for (int chunk = 1; chunk <= int(src.size()) + 1; chunk++) {
+			d.reset();
+			ASSERT_EQ(retval, IRBase2NDecoderTest_decode(d, src, chunk, dec));
+			if (retval) {
+				ASSERT_EQ(expSize, dec.size());
+				ASSERT_EQ(0, std::memcmp(exp, dec.c_str(), expSize));
+			}
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBase2NDecoderTest, updateBuffer) {
+	IRBase2NCodec codec(std::make_shared<IRBase64Alphabet>(), 4, '=');
+	IRBase2NDecoder d(codec);
+	std::uint8_t src[100];
+	std::string enc;
+	IRBuffer out;
+
+	for (unsigned int i = 0; i < sizeof(src); i++) {
+		src[i] = std::uint8_t(rand());
+	}
+	codec.encode(src, sizeof(src), enc);
+
+	ASSERT_TRUE(out.write("prefix", 6));
+	for (unsigned int offs = 0; offs < enc.size(); offs += 9) {
+		ASSERT_TRUE(d.update(enc.c_str() + offs,
+				std::min(std::size_t(9), enc.size() - offs), out));
+		ASSERT_EQ(out.size(), out.position());
+	}
+	ASSERT_TRUE(d.finish());
+	ASSERT_EQ(6 + sizeof(src), out.size());
+	ASSERT_EQ(0, std::memcmp("prefix", out.roBuffer(), 6));
+	ASSERT_EQ(0, std::memcmp(src, out.roBuffer() + 6, sizeof(src)));
+
+	// Overwrite in the middle of the buffer
+	out.setPosition(2);
+	ASSERT_TRUE(d.update("Zm9v", 4, out));
+	ASSERT_TRUE(d.finish());
+	ASSERT_EQ(6 + sizeof(src), out.size());
+	ASSERT_EQ(5, out.position());
+	ASSERT_EQ(0, std::memcmp("prfoo", out.roBuffer(), 5));
+
+	// The size is restored on failure
+	out.setSize(6);
+	out.setPosition(6);
+	ASSERT_FALSE(d.update("Zm9v!Zm9v", 9, out));
+	ASSERT_EQ(6, out.size());
+
+	// Read-only buffers
+	d.reset();
+	IRBuffer ro(src, sizeof(src));
+	ASSERT_FALSE(d.update("Zm9v", 4, ro));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBase2NDecoderTest, updateFail) {
+	IRBase2NCodec codec(std::make_shared<IRBase64Alphabet>(), 4, '=');
+	IRBase2NDecoder d(codec);
+	std::uint8_t dst[16];
+	std::uint64_t dstSize;
+
+	dstSize = 2;
+	ASSERT_FALSE(d.update("Zm9v", 4, dst, dstSize));
+	dstSize = sizeof(dst);
+	ASSERT_FALSE(d.update(nullptr, 4, dst, dstSize));
+	ASSERT_FALSE(d.update("Zm9v", 4, nullptr, dstSize));
+	ASSERT_FALSE(d.update("Zm9!", 4, dst, dstSize));
+
+	d.reset();
+	dstSize = 0;
+	ASSERT_TRUE(d.update("Z", 1, nullptr, dstSize));
+	ASSERT_EQ(0, dstSize);
+}
+
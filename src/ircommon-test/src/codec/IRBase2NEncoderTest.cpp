@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "IRBase2NEncoderTest.h"
+#include "IRBase2NTestCodecs.h"
+#include <ircommon/ircodec.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <stdlib.h>
+
+using namespace ircommon;
+using namespace ircommon::codec;
+
+//==============================================================================
+// class IRBase2NEncoderTest
+//------------------------------------------------------------------------------
+IRBase2NEncoderTest::IRBase2NEncoderTest() {
+}
+
+//------------------------------------------------------------------------------
+IRBase2NEncoderTest::~IRBase2NEncoderTest() {
+}
+
+//------------------------------------------------------------------------------
+void IRBase2NEncoderTest::SetUp() {
+}
+
+//------------------------------------------------------------------------------
+void IRBase2NEncoderTest::TearDown() {
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBase2NEncoderTest, Constructor) {
+	IRBase2NCodec codec(std::make_shared<IRBase64Alphabet>(), 4, '=');
+	IRBase2NEncoder * e;
+
+	e = new IRBase2NEncoder(codec);
+	ASSERT_EQ(&codec, &e->codec());
+	ASSERT_EQ(0, e->encodedSize());
+	ASSERT_EQ(0, e->getFinishSize());
+	delete e;
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBase2NEncoderTest, getSizes) {
+	IRBase2NCodec codec(std::make_shared<IRBase64Alphabet>(), 4, '=');
+	IRBase2NEncoder e(codec);
+	std::uint8_t src[3] = {1, 2, 3};
+	char dst[16];
+	std::uint64_t dstSize;
+
+	ASSERT_EQ(0, e.getUpdateSize(0));
+	ASSERT_EQ(1, e.getUpdateSize(1));
+	ASSERT_EQ(2, e.getUpdateSize(2));
+	ASSERT_EQ(4, e.getUpdateSize(3));
+	ASSERT_EQ(0x400000000ull, e.getUpdateSize(0x300000000ull));
+
+	dstSize = sizeof(dst);
+	ASSERT_TRUE(e.update(src, 1, dst, dstSize));
+	ASSERT_EQ(1, dstSize);
+	ASSERT_EQ(1, e.encodedSize());
+	ASSERT_EQ(0, e.getUpdateSize(0));
+	ASSERT_EQ(1, e.getUpdateSize(1));
+	ASSERT_EQ(3, e.getFinishSize());
+
+	dstSize = sizeof(dst);
+	ASSERT_TRUE(e.update(src, 1, dst, dstSize));
+	ASSERT_EQ(1, dstSize);
+	ASSERT_EQ(2, e.encodedSize());
+	ASSERT_EQ(2, e.getFinishSize());
+
+	dstSize = sizeof(dst);
+	ASSERT_TRUE(e.update(src, 1, dst, dstSize));
+	ASSERT_EQ(2, dstSize);
+	ASSERT_EQ(4, e.encodedSize());
+	ASSERT_EQ(0, e.getFinishSize());
+
+	e.reset();
+	ASSERT_EQ(0, e.encodedSize());
+	ASSERT_EQ(0, e.getUpdateSize(0));
+	ASSERT_EQ(0, e.getFinishSize());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBase2NEncoderTest, updateFinish) {
+	std::vector<std::shared_ptr<IRBase2NCodec>> codecs;
+	std::uint8_t src[300];
+	std::string exp;
+	std::string enc;
+	std::uint64_t dstSize;
+	static const int CHUNKS[] = {1, 2, 3, 5, 7, 64, 1000};
+
+	for (unsigned int i = 0; i < sizeof(src); i++) {
+		src[i] = std::uint8_t(rand());
+	}
+	IRBase2NTestCodecs_create(codecs);
+	for (auto codec: codecs) {
+		IRBase2NEncoder e(*codec);
+		for (int size = 0; size <= int(sizeof(src)); size += 1 + (size / 10)) {
+			exp.clear();
+			codec->encode(src, size, exp);
+			for (int chunk: CHUNKS) {
+				enc.clear();
+				for (int offs = 0; offs < size; offs += chunk) {
+					int len = std::min(chunk, size - offs);
+					std::string::size_type start = enc.size();
+					dstSize = e.getUpdateSize(len);
+					enc.resize(start + dstSize);
+					ASSERT_TRUE(e.update(src + offs, len, &(enc[start]), dstSize));
+					ASSERT_EQ(enc.size() - start, dstSize);
+				}
+				ASSERT_EQ(enc.size(), e.encodedSize());
+				std::string::size_type start = enc.size();
+				dstSize = e.getFinishSize();
+				enc.resize(start + dstSize + 1);
+				ASSERT_TRUE(e.finish(&(enc[start]), dstSize));
+				enc.resize(start + dstSize);
+				ASSERT_EQ(exp, enc);
+				ASSERT_EQ(0, e.encodedSize());
+			}
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBase2NEncoderTest, updateFinishBuffer) {
+	std::vector<std::shared_ptr<IRBase2NCodec>> codecs;
+	std::uint8_t src[257];
+	std::string exp;
+	IRBuffer out;
+
+	for (unsigned int i = 0; i < sizeof(src); i++) {
+		src[i] = std::uint8_t(rand());
+	}
+	IRBase2NTestCodecs_create(codecs);
+	for (auto codec: codecs) {
+		IRBase2NEncoder e(*codec);
+		exp = "prefix";
+		codec->encode(src, sizeof(src), exp);
+
+		out.setSize(0);
+		ASSERT_TRUE(out.write("prefix", 6));
+		for (unsigned int offs = 0; offs < sizeof(src); offs += 10) {
+			ASSERT_TRUE(e.update(src + offs,
+					std::min(std::size_t(10), sizeof(src) - offs), out));
+			ASSERT_EQ(out.size(), out.position());
+		}
+		ASSERT_TRUE(e.finish(out));
+		ASSERT_EQ(exp.size(), out.size());
+		ASSERT_EQ(exp.size(), out.position());
+		ASSERT_EQ(0, std::memcmp(exp.c_str(), out.roBuffer(), exp.size()));
+	}
+
+	// Overwrite in the middle of the buffer
+	IRBase2NCodec codec(std::make_shared<IRHexAlphabet>());
+	IRBase2NEncoder e(codec);
+	out.setSize(0);
+	ASSERT_TRUE(out.write("0123456789", 10));
+	out.setPosition(2);
+	ASSERT_TRUE(e.update(src, 2, out));
+	ASSERT_TRUE(e.finish(out));
+	ASSERT_EQ(10, out.size());
+	ASSERT_EQ(6, out.position());
+	exp = "01";
+	codec.encode(src, 2, exp);
+	exp.append("6789");
+	ASSERT_EQ(0, std::memcmp(exp.c_str(), out.roBuffer(), exp.size()));
+
+	// Read-only buffers
+	IRBuffer ro(src, sizeof(src));
+	ASSERT_FALSE(e.update(src, 1, ro));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBase2NEncoderTest, updateFinishFail) {
+	IRBase2NCodec codec(std::make_shared<IRBase64Alphabet>(), 4, '=');
+	IRBase2NEncoder e(codec);
+	std::uint8_t src[3] = {1, 2, 3};
+	char dst[16];
+	std::uint64_t dstSize;
+
+	dstSize = 3;
+	ASSERT_FALSE(e.update(src, 3, dst, dstSize));
+	dstSize = sizeof(dst);
+	ASSERT_FALSE(e.update(nullptr, 3, dst, dstSize));
+	ASSERT_FALSE(e.update(src, 3, nullptr, dstSize));
+	ASSERT_EQ(0, e.encodedSize());
+
+	dstSize = 0;
+	ASSERT_TRUE(e.update(src, 0, nullptr, dstSize));
+	ASSERT_EQ(0, dstSize);
+
+	dstSize = sizeof(dst);
+	ASSERT_TRUE(e.update(src, 1, dst, dstSize));
+	dstSize = 2;
+	ASSERT_FALSE(e.finish(dst, dstSize));
+	ASSERT_FALSE(e.finish(nullptr, dstSize));
+	dstSize = 3;
+	ASSERT_TRUE(e.finish(dst, dstSize));
+	ASSERT_EQ(3, dstSize);
+	ASSERT_EQ(0, std::memcmp("Q==", dst, 3));
+}
+
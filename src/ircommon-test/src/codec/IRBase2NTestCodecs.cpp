@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "IRBase2NTestCodecs.h"
+
+using namespace ircommon::codec;
+
+//------------------------------------------------------------------------------
+void IRBase2NTestCodecs_create(
+		std::vector<std::shared_ptr<IRBase2NCodec>> & codecs) {
+	char map[128];
+
+	for (int i = 0; i < 128; i++) {
+		map[i] = char(128 + i);
+	}
+	codecs.push_back(std::make_shared<IRBase2NCodec>(
+			std::make_shared<IRBinaryAlphabet>()));
+	codecs.push_back(std::make_shared<IRBase2NCodec>(
+			std::make_shared<IRGenericAlphabet>("0123", 4), 4, '='));
+	codecs.push_back(std::make_shared<IRBase2NCodec>(
+			std::make_shared<IRGenericAlphabet>("01234567", 8), 8, '='));
+	codecs.push_back(std::make_shared<IRBase2NCodec>(
+			std::make_shared<IRHexAlphabet>()));
+	codecs.push_back(std::make_shared<IRBase2NCodec>(
+			std::make_shared<IRBase32Alphabet>(), 8, '='));
+	codecs.push_back(std::make_shared<IRBase2NCodec>(
+			std::make_shared<IRBase64Alphabet>()));
+	codecs.push_back(std::make_shared<IRBase2NCodec>(
+			std::make_shared<IRBase64Alphabet>(), 4, '='));
+	codecs.push_back(std::make_shared<IRBase2NCodec>(
+			std::make_shared<IRGenericAlphabet>(map, 128), 8, '='));
+}
+
+//------------------------------------------------------------------------------
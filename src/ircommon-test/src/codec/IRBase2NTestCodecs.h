@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _IRBASE2NTESTCODECS_H_
+#define _IRBASE2NTESTCODECS_H_
+
+#include <memory>
+#include <vector>
+#include <ircommon/ircodec.h>
+
+/**
+ * Creates codecs for all supported character sizes, with and without padding.
+ * It is shared by the tests of IRBase2NEncoder and IRBase2NDecoder.
+ *
+ * @param[out] codecs The list that will receive the codecs.
+ */
+void IRBase2NTestCodecs_create(
+		std::vector<std::shared_ptr<ircommon::codec::IRBase2NCodec>> & codecs);
+
+#endif /* _IRBASE2NTESTCODECS_H_ */
@@ -16,6 +16,7 @@
 #include "IRProtectedMemoryTest.h"
 #include <ircommon/irpmem.h>
 #include <cstring>
+#include <thread>
 using namespace ircommon;
 using namespace ircommon::crypto;
 
@@ -95,6 +96,188 @@ TEST_F(IRProtectedMemoryTest, protectUnprotect) {
 	ASSERT_NE(0, std::memcmp(exp, p.value(), p.size()));
 }
 
+//------------------------------------------------------------------------------
+TEST_F(IRProtectedMemoryTest, protectUnprotectSizes) {
+	std::uint8_t exp[67];
+
+	for (unsigned int i = 0; i < sizeof(exp); i++) {
+		exp[i] = i + 1;
+	}
+	for (unsigned int size = 1; size <= sizeof(exp); size++) {
+		IRProtectedMemory p(size);
+		ASSERT_TRUE(p.lock());
+		std::memcpy(p.value(), exp, size);
+		ASSERT_TRUE(p.unlock());
+		for (int i = 0; i < 3; i++) {
+			ASSERT_TRUE(p.lock());
+			ASSERT_EQ(0, std::memcmp(exp, p.value(), size));
+			ASSERT_TRUE(p.unlock());
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRProtectedMemoryTest, plain) {
+	IRProtectedMemory p(16);
+
+	ASSERT_FALSE(p.plain());
+	ASSERT_TRUE(p.lock());
+	ASSERT_TRUE(p.unlock());
+	ASSERT_FALSE(p.plain());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRProtectedMemoryTest, hotUses) {
+	std::uint8_t exp[32];
+	IRProtectedMemory p(sizeof(exp));
+
+	for (unsigned int i = 0; i < sizeof(exp); i++) {
+		exp[i] = i;
+	}
+	ASSERT_TRUE(p.lock());
+	std::memcpy(p.value(), exp, p.size());
+	ASSERT_TRUE(p.unlock());
+
+	p.beginHot(3, 60000);
+	ASSERT_FALSE(p.plain());
+	for (int i = 0; i < 2; i++) {
+		ASSERT_TRUE(p.lock());
+		ASSERT_EQ(0, std::memcmp(exp, p.value(), p.size()));
+		ASSERT_TRUE(p.unlock());
+		ASSERT_TRUE(p.plain());
+		ASSERT_EQ(0, std::memcmp(exp, p.value(), p.size()));
+	}
+	// Last use
+	ASSERT_TRUE(p.lock());
+	ASSERT_TRUE(p.unlock());
+	ASSERT_FALSE(p.plain());
+	ASSERT_NE(0, std::memcmp(exp, p.value(), p.size()));
+
+	// The window is closed
+	ASSERT_TRUE(p.lock());
+	ASSERT_TRUE(p.unlock());
+	ASSERT_FALSE(p.plain());
+	ASSERT_TRUE(p.endHot());
+
+	ASSERT_TRUE(p.lock());
+	ASSERT_EQ(0, std::memcmp(exp, p.value(), p.size()));
+	ASSERT_TRUE(p.unlock());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRProtectedMemoryTest, hotTime) {
+	IRProtectedMemory p(16);
+
+	p.beginHot(1000, 1);
+	std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	ASSERT_TRUE(p.lock());
+	ASSERT_TRUE(p.unlock());
+	ASSERT_FALSE(p.plain());
+	ASSERT_TRUE(p.endHot());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRProtectedMemoryTest, endHot) {
+	IRProtectedMemory p(16);
+
+	p.beginHot(1000, 60000);
+	ASSERT_TRUE(p.lock());
+	ASSERT_TRUE(p.unlock());
+	ASSERT_TRUE(p.plain());
+	ASSERT_TRUE(p.endHot());
+	ASSERT_FALSE(p.plain());
+
+	// Nothing to do
+	ASSERT_TRUE(p.endHot());
+	ASSERT_FALSE(p.plain());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRProtectedMemoryTest, IRHotScope) {
+	IRProtectedMemory p(16);
+
+	{
+		IRHotScope<IRProtectedMemory> scope(p, 1000, 60000);
+		ASSERT_TRUE(p.lock());
+		ASSERT_TRUE(p.unlock());
+		ASSERT_TRUE(p.plain());
+	}
+	ASSERT_FALSE(p.plain());
+}
+
+//------------------------------------------------------------------------------
+
+TEST_F(IRProtectedMemoryTest, maskEpochs) {
+	std::uint8_t first[64];
+	IRProtectedMemory p(sizeof(first));
+
+	// With a zero value, the protected bytes are the key stream itself
+	std::memcpy(first, p.value(), p.size());
+	ASSERT_TRUE(p.lock());
+	ASSERT_TRUE(p.unlock());
+	ASSERT_EQ(0, std::memcmp(first, p.value(), p.size()));
+
+	// Hot windows start new epochs
+	p.beginHot(1, 60000);
+	ASSERT_TRUE(p.lock());
+	ASSERT_TRUE(p.unlock());
+	ASSERT_NE(0, std::memcmp(first, p.value(), p.size()));
+	std::memcpy(first, p.value(), p.size());
+	ASSERT_TRUE(p.endHot());
+	ASSERT_TRUE(p.lock());
+	ASSERT_TRUE(p.unlock());
+	ASSERT_NE(0, std::memcmp(first, p.value(), p.size()));
+	ASSERT_TRUE(p.lock());
+	for (unsigned int i = 0; i < p.size(); i++) {
+		ASSERT_EQ(0, p.value()[i]);
+	}
+	ASSERT_TRUE(p.unlock());
+}
 
 //------------------------------------------------------------------------------
+TEST_F(IRProtectedMemoryTest, lockNested) {
+	std::uint8_t exp[16];
+	IRProtectedMemory p(sizeof(exp));
 
+	std::memset(exp, 0, sizeof(exp));
+	ASSERT_TRUE(p.lock());
+	ASSERT_TRUE(p.lock());
+	ASSERT_TRUE(p.plain());
+	ASSERT_TRUE(p.unlock());
+	ASSERT_TRUE(p.plain());
+	ASSERT_EQ(0, std::memcmp(exp, p.value(), p.size()));
+	ASSERT_TRUE(p.unlock());
+	ASSERT_FALSE(p.plain());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRProtectedMemoryTest, endHotLocked) {
+	std::uint8_t exp[16];
+	IRProtectedMemory p(sizeof(exp));
+
+	std::memset(exp, 0, sizeof(exp));
+	p.beginHot(1000, 60000);
+	ASSERT_TRUE(p.lock());
+	// Must not deadlock nor protect the data while it is in use
+	ASSERT_TRUE(p.endHot());
+	ASSERT_TRUE(p.plain());
+	ASSERT_EQ(0, std::memcmp(exp, p.value(), p.size()));
+	ASSERT_TRUE(p.unlock());
+	ASSERT_FALSE(p.plain());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRProtectedMemoryTest, IRHotScopeLocked) {
+	IRProtectedMemory p(16);
+
+	ASSERT_TRUE(p.lock());
+	{
+		IRHotScope<IRProtectedMemory> scope(p, 1000, 60000);
+		ASSERT_TRUE(p.plain());
+	}
+	ASSERT_TRUE(p.plain());
+	ASSERT_TRUE(p.unlock());
+	ASSERT_FALSE(p.plain());
+}
+
+//------------------------------------------------------------------------------
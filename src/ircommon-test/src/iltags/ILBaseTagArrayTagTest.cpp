@@ -316,3 +316,41 @@ TEST_F(ILBaseTagArrayTagTest, deserializeValue) {
 }
 
 //------------------------------------------------------------------------------
+TEST_F(ILBaseTagArrayTagTest, deserializeValueLazy) {
+	ILBaseTagArrayTag tag(ILTag::TAG_ILTAG_ARRAY);
+	ILTagFactory f;
+	ILTag * t;
+	IRBuffer serialized;
+	IRBuffer out;
+
+	ASSERT_TRUE(serialized.writeILInt(256));
+	for (int i = 0; i < 256; i++) {
+		t = ILBaseTagListTagTest::createSample(0xFF + i, i);
+		ASSERT_TRUE(t->serialize(serialized));
+		delete t;
+	}
+	f.setLazyMode(true);
+	ASSERT_TRUE(tag.deserializeValue(f, serialized.roBuffer(), serialized.size()));
+	ASSERT_EQ(256, tag.count());
+	ASSERT_TRUE(tag.pending(128));
+	ASSERT_EQ(0xFF + 128, tag[128]->id());
+	ASSERT_EQ(128, tag[128]->size());
+	ASSERT_FALSE(tag.pending(128));
+	ASSERT_TRUE(tag.pending(127));
+
+	ASSERT_EQ(serialized.size(), tag.size());
+	ASSERT_TRUE(tag.serialize(out));
+	ASSERT_EQ(tag.tagSize(), out.size());
+	ASSERT_EQ(0, std::memcmp(serialized.roBuffer(),
+			out.roBuffer() + (out.size() - serialized.size()),
+			serialized.size()));
+
+	// Wrong count
+	serialized.beginning();
+	ASSERT_TRUE(serialized.writeILInt(255));
+	ASSERT_FALSE(tag.deserializeValue(f, serialized.roBuffer(), serialized.size()));
+	serialized.beginning();
+	ASSERT_TRUE(serialized.writeILInt(0));
+	ASSERT_FALSE(tag.deserializeValue(f, serialized.roBuffer(), serialized.size()));
+}
+//------------------------------------------------------------------------------
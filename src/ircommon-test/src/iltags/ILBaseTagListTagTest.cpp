@@ -16,7 +16,9 @@
 #include "ILBaseTagListTagTest.h"
 #include <ircommon/iltag.h>
 #include <ircommon/ilint.h>
+#include <ircommon/iltagarena.h>
 #include <cstring>
+#include <thread>
 using namespace ircommon;
 using namespace ircommon::iltags;
 
@@ -469,6 +471,215 @@ TEST_F(ILBaseTagListTagTest, deserializeValue) {
 	}
 }
 
+//------------------------------------------------------------------------------
+TEST_F(ILBaseTagListTagTest, deserializeValueLazy) {
+	ILBaseTagListTag tag(ILTag::TAG_ILTAG_ARRAY);
+	ILTagFactory f;
+	ILTag * t;
+	IRBuffer serialized;
+	IRBuffer out;
+
+	for (int i = 0; i < 256; i++) {
+		t = ILBaseTagListTagTest::createSample(0xFF + i, i);
+		ASSERT_TRUE(t->serialize(serialized));
+		delete t;
+	}
+	f.setLazyMode(true);
+	ASSERT_TRUE(tag.deserializeValue(f, serialized.roBuffer(), serialized.size()));
+	ASSERT_EQ(256, tag.count());
+	ASSERT_EQ(serialized.size(), tag.size());
+	for (unsigned int i = 0; i < tag.count(); i++) {
+		ASSERT_TRUE(tag.pending(i));
+	}
+
+	// Entries not decoded are serialized as is
+	ASSERT_TRUE(tag.serialize(out));
+	ASSERT_EQ(tag.tagSize(), out.size());
+	ASSERT_EQ(0, std::memcmp(serialized.roBuffer(),
+			out.roBuffer() + (out.size() - serialized.size()),
+			serialized.size()));
+
+	// Decode on demand
+	ASSERT_EQ(0xFF + 10, tag[10]->id());
+	ASSERT_EQ(10, tag[10]->size());
+	ASSERT_FALSE(tag.pending(10));
+	ASSERT_TRUE(tag.pending(11));
+	ASSERT_EQ(0xFF + 11, tag.get(11)->id());
+	ASSERT_FALSE(tag.pending(11));
+	ASSERT_EQ(serialized.size(), tag.size());
+
+	ASSERT_TRUE(tag.decodeAll());
+	for (unsigned int i = 0; i < tag.count(); i++) {
+		ASSERT_FALSE(tag.pending(i));
+		ASSERT_EQ(0xFF + i, tag[i]->id());
+		ASSERT_EQ(i, tag[i]->size());
+	}
+
+	// Invalid entry
+	serialized.setSize(serialized.size() - 1);
+	ASSERT_FALSE(tag.deserializeValue(f, serialized.roBuffer(), serialized.size()));
+	ASSERT_EQ(0, tag.count());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILBaseTagListTagTest, deserializeValueLazyEdit) {
+	ILBaseTagListTag tag(ILTag::TAG_ILTAG_ARRAY);
+	ILTagFactory f;
+	ILTag * t;
+	IRBuffer serialized;
+	IRBuffer out;
+	IRBuffer expected;
+
+	for (int i = 0; i < 4; i++) {
+		t = ILBaseTagListTagTest::createSample(0xFF + i, i);
+		ASSERT_TRUE(t->serialize(serialized));
+		delete t;
+	}
+	f.setLazyMode(true);
+	ASSERT_TRUE(tag.deserializeValue(f, serialized.roBuffer(), serialized.size()));
+
+	ASSERT_TRUE(tag.insert(1, ILBaseTagListTagTest::createSample(0x10, 1)));
+	ASSERT_TRUE(tag.add(ILBaseTagListTagTest::createSample(0x11, 2)));
+	ASSERT_TRUE(tag.remove(3));
+	ASSERT_EQ(5, tag.count());
+	ASSERT_TRUE(tag.pending(0));
+	ASSERT_FALSE(tag.pending(1));
+	ASSERT_TRUE(tag.pending(2));
+	ASSERT_TRUE(tag.pending(3));
+	ASSERT_FALSE(tag.pending(4));
+
+	for (unsigned int i = 0; i < tag.count(); i++) {
+		ASSERT_TRUE(tag[i]->serialize(expected));
+	}
+	ASSERT_EQ(expected.size(), tag.size());
+	ASSERT_TRUE(tag.serialize(out));
+	ASSERT_EQ(tag.tagSize(), out.size());
+	ASSERT_EQ(0, std::memcmp(expected.roBuffer(),
+			out.roBuffer() + (out.size() - expected.size()),
+			expected.size()));
+	ASSERT_EQ(0x10, tag[1]->id());
+	ASSERT_EQ(0xFF + 3, tag[3]->id());
+	ASSERT_EQ(0x11, tag[4]->id());
+
+	tag.clear();
+	ASSERT_EQ(0, tag.count());
+	ASSERT_TRUE(tag.add(ILBaseTagListTagTest::createSample(0x11, 2)));
+	ASSERT_FALSE(tag.pending(0));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILBaseTagListTagTest, deserializeValueLazyFail) {
+	ILBaseTagListTag tag(ILTag::TAG_ILTAG_ARRAY);
+	const ILBaseTagListTag & ctag = tag;
+	ILTagFactory f(false, true);
+	ILTag * t;
+	IRBuffer serialized;
+
+	for (int i = 0; i < 4; i++) {
+		t = ILBaseTagListTagTest::createSample(0xFF + i, i);
+		ASSERT_TRUE(t->serialize(serialized));
+		delete t;
+	}
+	f.setLazyMode(true);
+	ASSERT_TRUE(tag.deserializeValue(f, serialized.roBuffer(), serialized.size()));
+
+	// Unknown tags are rejected in strict mode
+	try {
+		tag[0];
+		FAIL();
+	} catch (std::runtime_error & e) {}
+	try {
+		ctag[1];
+		FAIL();
+	} catch (std::runtime_error & e) {}
+	ASSERT_TRUE(tag.pending(0));
+	ASSERT_FALSE(tag.decodeAll());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILBaseTagListTagTest, deserializeValueLazyFraming) {
+	ILBaseTagListTag tag(ILTag::TAG_ILTAG_ARRAY);
+	ILTagFactory f;
+	IRBuffer serialized;
+
+	f.setLazyMode(true);
+	ASSERT_TRUE(serialized.writeILInt(0x20));
+	ASSERT_TRUE(serialized.writeILInt(1));
+	ASSERT_TRUE(serialized.write(0xAA));
+
+	// Size larger than the remaining bytes
+	serialized.setSize(3);
+	ASSERT_TRUE(serialized.writeILInt(0x21));
+	ASSERT_TRUE(serialized.writeILInt(100));
+	ASSERT_TRUE(serialized.write(0xAA));
+	ASSERT_FALSE(tag.deserializeValue(f, serialized.roBuffer(), serialized.size()));
+	ASSERT_EQ(0, tag.count());
+
+	// Truncated header
+	serialized.setSize(3);
+	ASSERT_TRUE(serialized.write(0xF9));
+	ASSERT_FALSE(tag.deserializeValue(f, serialized.roBuffer(), serialized.size()));
+	ASSERT_EQ(0, tag.count());
+
+	// Truncated implicit value
+	serialized.setSize(3);
+	ASSERT_TRUE(serialized.writeILInt(ILTag::TAG_UINT32));
+	ASSERT_TRUE(serialized.write(0xAA));
+	ASSERT_FALSE(tag.deserializeValue(f, serialized.roBuffer(), serialized.size()));
+	ASSERT_EQ(0, tag.count());
+
+	serialized.setSize(3);
+	ASSERT_TRUE(tag.deserializeValue(f, serialized.roBuffer(), serialized.size()));
+	ASSERT_EQ(1, tag.count());
+	ASSERT_TRUE(tag.pending(0));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILBaseTagListTagTest, deserializeValueLazyConcurrent) {
+	ILBaseTagListTag tag(ILTag::TAG_ILTAG_ARRAY);
+	const ILBaseTagListTag & ctag = tag;
+	ILTagFactory f;
+	ILTag * t;
+	IRBuffer serialized;
+	bool ok[4];
+	IRBuffer out[4];
+	std::thread threads[4];
+
+	for (int i = 0; i < 256; i++) {
+		t = ILBaseTagListTagTest::createSample(0xFF + i, i);
+		ASSERT_TRUE(t->serialize(serialized));
+		delete t;
+	}
+	f.setLazyMode(true);
+	ASSERT_TRUE(tag.deserializeValue(f, serialized.roBuffer(), serialized.size()));
+
+	// Readers decode the entries while the others serialize the list
+	for (int i = 0; i < 4; i++) {
+		threads[i] = std::thread([&ctag, &ok, &out, i]() {
+			ok[i] = true;
+			for (unsigned int j = 0; (j < ctag.count()) && ok[i]; j++) {
+				if (i % 2) {
+					ok[i] = (ctag[(j + 64 * i) % ctag.count()] != nullptr);
+				} else {
+					out[i].setSize(0);
+					ok[i] = ctag.serialize(out[i]) &&
+							(out[i].size() == ctag.tagSize());
+				}
+			}
+		});
+	}
+	for (int i = 0; i < 4; i++) {
+		threads[i].join();
+	}
+	for (int i = 0; i < 4; i++) {
+		ASSERT_TRUE(ok[i]);
+	}
+	for (unsigned int i = 0; i < tag.count(); i++) {
+		ASSERT_FALSE(tag.pending(i));
+		ASSERT_EQ(0xFF + i, ctag[i]->id());
+	}
+}
+
 //------------------------------------------------------------------------------
 TEST_F(ILBaseTagListTagTest, get) {
 	ILBaseTagListTag tag(ILTag::TAG_ILTAG_ARRAY);
@@ -516,3 +727,113 @@ TEST_F(ILBaseTagListTagTest, isFull) {
 }
 //------------------------------------------------------------------------------
 
+
+//------------------------------------------------------------------------------
+TEST_F(ILBaseTagListTagTest, equalsValue) {
+	ILBaseTagListTag a(ILTag::TAG_ILTAG_ARRAY);
+	ILBaseTagListTag b(ILTag::TAG_ILTAG_ARRAY);
+	ILBaseTagListTag c(ILTag::TAG_ILTAG_ARRAY);
+	ILTagFactory f;
+	ILTag * t;
+	IRBuffer serialized;
+
+	for (int i = 0; i < 4; i++) {
+		t = ILBaseTagListTagTest::createSample(0xFF + i, i);
+		ASSERT_TRUE(t->serialize(serialized));
+		ASSERT_TRUE(c.add(t));
+	}
+	f.setLazyMode(true);
+	ASSERT_TRUE(a.deserializeValue(f, serialized.roBuffer(), serialized.size()));
+	ASSERT_TRUE(b.deserializeValue(f, serialized.roBuffer(), serialized.size()));
+
+	// Pending entries are compared as is
+	ASSERT_TRUE(ILTagUtil::equals(a, b));
+	for (unsigned int i = 0; i < a.count(); i++) {
+		ASSERT_TRUE(a.pending(i));
+		ASSERT_TRUE(b.pending(i));
+	}
+
+	// Pending entries against decoded entries
+	ASSERT_TRUE(ILTagUtil::equals(a, c));
+	ASSERT_TRUE(ILTagUtil::equals(c, b));
+	ASSERT_FALSE(a.pending(0));
+	ASSERT_TRUE(ILTagUtil::equals(a, b));
+
+	// Distinct values
+	c[3] = ILBaseTagListTag::SharedPointer(
+			ILBaseTagListTagTest::createSample(0xFF + 3, 3));
+	static_cast<ILRawTag &>(*c[3]).value().setSize(2);
+	static_cast<ILRawTag &>(*c[3]).value().write(0);
+	ASSERT_EQ(a.size(), c.size());
+	ASSERT_FALSE(ILTagUtil::equals(a, c));
+	ASSERT_FALSE(ILTagUtil::equals(b, c));
+	ASSERT_TRUE(c.remove(3));
+	ASSERT_FALSE(ILTagUtil::equals(a, c));
+
+	// nullptr is equivalent to an empty TAG_NULL
+	a.clear();
+	b.clear();
+	ASSERT_TRUE(a.add((ILTag *)nullptr));
+	ASSERT_TRUE(b.add((ILTag *)nullptr));
+	ASSERT_TRUE(ILTagUtil::equals(a, b));
+	b.clear();
+	ASSERT_TRUE(b.add(new ILRawTag(ILTag::TAG_NULL)));
+	ASSERT_TRUE(ILTagUtil::equals(a, b));
+	ASSERT_TRUE(ILTagUtil::equals(b, a));
+	b.clear();
+	ASSERT_TRUE(b.add(new ILRawTag(ILTag::TAG_BOOL)));
+	ASSERT_FALSE(ILTagUtil::equals(a, b));
+	ASSERT_FALSE(ILTagUtil::equals(b, a));
+}
+TEST_F(ILBaseTagListTagTest, deserializeValueLazyArena) {
+	ILTagArena arena;
+	ILTagFactory f;
+	IRBuffer serialized;
+	ILTag * t;
+	std::unique_ptr<ILBaseTagListTag> lists[2];
+	std::uint64_t used;
+	bool ok[4];
+	std::thread threads[4];
+
+	for (int i = 0; i < 64; i++) {
+		t = ILBaseTagListTagTest::createSample(0xFF + i, i);
+		ASSERT_TRUE(t->serialize(serialized));
+		delete t;
+	}
+	f.setLazyMode(true);
+	f.setArena(&arena);
+
+	// Lists that share an arena are decoded eagerly
+	for (int i = 0; i < 2; i++) {
+		lists[i].reset(new ILBaseTagListTag(ILTag::TAG_ILTAG_ARRAY));
+		ASSERT_TRUE(lists[i]->deserializeValue(f, serialized.roBuffer(),
+				serialized.size()));
+		for (unsigned int j = 0; j < lists[i]->count(); j++) {
+			ASSERT_FALSE(lists[i]->pending(j));
+		}
+	}
+	used = arena.used();
+	ASSERT_LT(0, used);
+
+	// Readers of both lists never touch the arena
+	for (int i = 0; i < 4; i++) {
+		const ILBaseTagListTag & ctag = *lists[i % 2];
+		threads[i] = std::thread([&ctag, &ok, i]() {
+			ok[i] = true;
+			for (unsigned int j = 0; (j < ctag.count()) && ok[i]; j++) {
+				const ILTag * e = ctag[(j + 16 * i) % ctag.count()].get();
+				ok[i] = (e != nullptr) &&
+						(e->id() == 0xFF + (j + 16 * i) % ctag.count());
+			}
+		});
+	}
+	for (int i = 0; i < 4; i++) {
+		threads[i].join();
+	}
+	for (int i = 0; i < 4; i++) {
+		ASSERT_TRUE(ok[i]);
+	}
+	ASSERT_EQ(used, arena.used());
+}
+
+//------------------------------------------------------------------------------
@@ -130,4 +130,24 @@ TEST_F(ILBigDecimalTagTest, deserializeValue) {
 	}
 }
 //------------------------------------------------------------------------------
+TEST_F(ILBigDecimalTagTest, deserializeValueView) {
+	ILBigDecimalTag t;
+	IRBuffer src;
+	ILTagFactory f;
 
+	ASSERT_TRUE(src.writeInt((std::int32_t)-2));
+	for (int i = 0; i < 32; i++) {
+		ASSERT_TRUE(src.write(i));
+	}
+	f.setViewMode(true);
+	ASSERT_TRUE(t.deserializeValue(f, src.roBuffer(), src.size()));
+	ASSERT_EQ(-2, t.scale());
+	ASSERT_EQ(32, t.integral().size());
+	ASSERT_EQ(src.roBuffer() + 4, t.integral().roBuffer());
+
+	ASSERT_TRUE(t.setIntegral(src.roBuffer(), 4));
+	ASSERT_EQ(4, t.integral().size());
+	ASSERT_NE(src.roBuffer(), t.integral().roBuffer());
+	ASSERT_EQ(0, std::memcmp(src.roBuffer(), t.integral().roBuffer(), 4));
+}
+//------------------------------------------------------------------------------
@@ -129,6 +129,17 @@ TEST_F(ILILIntArrayTagTest, deserialize) {
 	for(unsigned int i = 0; i < t.count(); i++) {
 		ASSERT_EQ(values[i], t[i]);
 	}
+
+	// Truncated
+	ASSERT_FALSE(t.deserializeValue(f, src.roBuffer(), src.size() - 1));
+	ASSERT_EQ(0, t.count());
+
+	// Invalid count
+	src.setSize(0);
+	ASSERT_TRUE(src.writeILInt(0xFFFFFFFFFFFFll));
+	ASSERT_TRUE(src.writeILInt(0));
+	ASSERT_FALSE(t.deserializeValue(f, src.roBuffer(), src.size()));
+	ASSERT_EQ(0, t.count());
 }
 
 //------------------------------------------------------------------------------
@@ -99,6 +99,39 @@ TEST_F(ILRawTagTest, deserializeValue) {
 	ASSERT_EQ(0, std::memcmp(exp, t.value().roBuffer(), t.size()));
 }
 
+//------------------------------------------------------------------------------
+TEST_F(ILRawTagTest, deserializeValueView) {
+	ILTagFactory f;
+	ILRawTag t(0xFF);
+	std::uint8_t exp[512];
+
+	std::memset(exp, 0xFA, sizeof(exp));
+	f.setViewMode(true);
+	ASSERT_TRUE(t.deserializeValue(f, exp, sizeof(exp)));
+	ASSERT_EQ(sizeof(exp), t.size());
+	ASSERT_TRUE(t.value().readOnly());
+	ASSERT_EQ(exp, t.value().roBuffer());
+
+	// Writes copy the value instead of failing or touching the source
+	t.value().setPosition(t.value().size());
+	ASSERT_TRUE(t.value().write(0x01));
+	ASSERT_FALSE(t.value().readOnly());
+	ASSERT_EQ(sizeof(exp) + 1, t.size());
+	ASSERT_EQ(0xFA, t.value().roBuffer()[0]);
+	ASSERT_EQ(0x01, t.value().roBuffer()[sizeof(exp)]);
+	for (unsigned int i = 0; i < sizeof(exp); i++) {
+		ASSERT_EQ(0xFA, exp[i]);
+	}
+
+	// Back to the copy mode
+	f.setViewMode(false);
+	ASSERT_TRUE(t.deserializeValue(f, exp, 16));
+	ASSERT_FALSE(t.value().readOnly());
+	ASSERT_NE(exp, t.value().roBuffer());
+	ASSERT_EQ(16, t.size());
+	ASSERT_EQ(0, std::memcmp(exp, t.value().roBuffer(), t.size()));
+}
+
 //------------------------------------------------------------------------------
 TEST_F(ILRawTagTest, serialize) {
 	ILTagFactory f;
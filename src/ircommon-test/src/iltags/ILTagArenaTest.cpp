@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ILTagArenaTest.h"
+#include <cstring>
+#include <cstddef>
+#include <ircommon/iltag.h>
+#include <ircommon/iltagstd.h>
+#include <ircommon/iltagarena.h>
+using namespace ircommon;
+using namespace ircommon::iltags;
+
+//==============================================================================
+// class ILTagArenaTest
+//------------------------------------------------------------------------------
+ILTagArenaTest::ILTagArenaTest() {
+}
+
+//------------------------------------------------------------------------------
+ILTagArenaTest::~ILTagArenaTest() {
+}
+
+//------------------------------------------------------------------------------
+void ILTagArenaTest::SetUp() {
+}
+
+//------------------------------------------------------------------------------
+void ILTagArenaTest::TearDown() {
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagArenaTest,Constructor) {
+
+	ILTagArena a1;
+	ASSERT_EQ(ILTagArena::DEFAULT_CHUNK_SIZE, a1.chunkSize());
+	ASSERT_FALSE(a1.secure());
+	ASSERT_EQ(0, a1.used());
+
+	ILTagArena a2(128, true);
+	ASSERT_EQ(128, a2.chunkSize());
+	ASSERT_TRUE(a2.secure());
+
+	ASSERT_THROW(ILTagArena(0), std::invalid_argument);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagArenaTest, allocate) {
+	ILTagArena a(128);
+	std::uint8_t * p;
+	std::uint8_t * prev;
+
+	prev = nullptr;
+	for (int i = 1; i < 64; i++) {
+		p = (std::uint8_t *)a.allocate(i);
+		ASSERT_TRUE(p != nullptr);
+		ASSERT_EQ(0, ((std::uintptr_t)p) % alignof(std::max_align_t));
+		ASSERT_NE(prev, p);
+		std::memset(p, i, i);
+		prev = p;
+	}
+
+	// Larger than the chunk
+	p = (std::uint8_t *)a.allocate(1024);
+	ASSERT_TRUE(p != nullptr);
+	std::memset(p, 0xFF, 1024);
+	ASSERT_TRUE(a.used() >= 1024 + 63);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagArenaTest, reset) {
+	ILTagArena a(256, true);
+	void * first;
+
+	first = a.allocate(16);
+	ASSERT_TRUE(first != nullptr);
+	for (int i = 0; i < 32; i++) {
+		ASSERT_TRUE(a.allocate(64) != nullptr);
+	}
+	ASSERT_TRUE(a.used() > 256);
+
+	a.reset();
+	ASSERT_EQ(0, a.used());
+	ASSERT_TRUE(a.allocate(16) != nullptr);
+	ASSERT_EQ(16, a.used());
+	a.reset();
+	a.reset();
+	ASSERT_EQ(0, a.used());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagArenaTest, secure) {
+	ILTagArena a;
+
+	ASSERT_FALSE(a.secure());
+	a.setSecure(true);
+	ASSERT_TRUE(a.secure());
+	a.setSecure(false);
+	ASSERT_FALSE(a.secure());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagArenaTest, Scope) {
+	ILTagArena a1;
+	ILTagArena a2;
+
+	ASSERT_TRUE(ILTagArena::current() == nullptr);
+	{
+		ILTagArena::Scope s1(&a1);
+		ASSERT_EQ(&a1, ILTagArena::current());
+		ASSERT_FALSE(a1.secure());
+		{
+			ILTagArena::Scope s2(&a2, true);
+			ASSERT_EQ(&a2, ILTagArena::current());
+			ASSERT_TRUE(a2.secure());
+			{
+				ILTagArena::Scope s3(nullptr, true);
+				ASSERT_TRUE(ILTagArena::current() == nullptr);
+			}
+			ASSERT_EQ(&a2, ILTagArena::current());
+			{
+				ILTagArena::Scope s4(&a2, false);
+				ASSERT_TRUE(a2.secure());
+			}
+			ASSERT_TRUE(a2.secure());
+		}
+		ASSERT_EQ(&a1, ILTagArena::current());
+		ASSERT_FALSE(a2.secure());
+	}
+	ASSERT_TRUE(ILTagArena::current() == nullptr);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagArenaTest, ScopeSecureWipe) {
+	ILTagArena a(64);
+	std::uint8_t * p;
+
+	{
+		ILTagArena::Scope s(&a, true);
+		p = (std::uint8_t *)a.allocate(32);
+		ASSERT_TRUE(p != nullptr);
+		std::memset(p, 0xFF, 32);
+	}
+	ASSERT_FALSE(a.secure());
+
+	// The blocks allocated in secure mode are still wiped
+	a.reset();
+	ASSERT_EQ(p, a.allocate(32));
+	for (int i = 0; i < 32; i++) {
+		ASSERT_EQ(0, p[i]);
+	}
+
+	// But not the ones allocated later
+	std::memset(p, 0xFF, 32);
+	a.reset();
+	ASSERT_EQ(p, a.allocate(32));
+	ASSERT_EQ(0xFF, p[0]);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagArenaTest, allocateObject) {
+	ILTagArena a;
+	void * p;
+
+	// Heap
+	p = ILTagArena::allocateObject(32);
+	ASSERT_TRUE(p != nullptr);
+	std::memset(p, 0, 32);
+	ILTagArena::releaseObject(p);
+	ASSERT_EQ(0, a.used());
+
+	// Arena
+	{
+		ILTagArena::Scope s(&a);
+		p = ILTagArena::allocateObject(32);
+	}
+	ASSERT_TRUE(p != nullptr);
+	ASSERT_TRUE(a.used() >= 32);
+	std::memset(p, 0, 32);
+	ILTagArena::releaseObject(p);
+	ILTagArena::releaseObject(nullptr);
+
+	// Heap objects released while an arena holds memory
+	p = ILTagArena::allocateObject(32);
+	ASSERT_TRUE(p != nullptr);
+	std::memset(p, 0, 32);
+	ILTagArena::releaseObject(p);
+	ASSERT_TRUE(a.used() >= 32);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagArenaTest, newTag) {
+	ILTagArena a;
+	ILTag * tag;
+
+	tag = new ILUInt64Tag();
+	ASSERT_EQ(0, a.used());
+	delete tag;
+
+	{
+		ILTagArena::Scope s(&a);
+		tag = new ILUInt64Tag();
+	}
+	ASSERT_TRUE(a.used() >= sizeof(ILUInt64Tag));
+	delete tag;
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagArenaTest, deserialize) {
+	ILTagArena a(1024);
+	ILStandardTagFactory f;
+	ILTagSeqTag src;
+	IRBuffer serialized;
+	ILTag * tag;
+
+	for (int i = 0; i < 128; i++) {
+		ILUInt64Tag * v = new ILUInt64Tag();
+		v->setValue(i);
+		ASSERT_TRUE(src.add(v));
+	}
+	ASSERT_TRUE(src.serialize(serialized));
+	ASSERT_EQ(0, a.used());
+
+	f.setArena(&a);
+	serialized.beginning();
+	tag = f.deserialize(serialized);
+	ASSERT_TRUE(tag != nullptr);
+	ASSERT_TRUE(a.used() >= 129 * sizeof(ILUInt64Tag));
+	ASSERT_TRUE(ILTagArena::current() == nullptr);
+	ASSERT_FALSE(a.secure());
+	ASSERT_EQ(ILTag::TAG_ILTAG_SEQ, tag->id());
+	ILTagSeqTag * seq = static_cast<ILTagSeqTag *>(tag);
+	ASSERT_EQ(128, seq->count());
+	for (int i = 0; i < 128; i++) {
+		ASSERT_EQ(i, static_cast<ILUInt64Tag *>((*seq)[i].get())->value());
+	}
+	delete tag;
+	a.reset();
+
+	// Secure mode
+	f.setSecure(true);
+	serialized.beginning();
+	tag = f.deserialize(serialized);
+	ASSERT_TRUE(tag != nullptr);
+	ASSERT_FALSE(a.secure());
+	delete tag;
+	a.reset();
+}
+//------------------------------------------------------------------------------
+TEST_F(ILTagArenaTest, chunkReuse) {
+	std::uint8_t * p;
+	std::uint8_t * q;
+
+	{
+		ILTagArena a;
+		p = (std::uint8_t *)a.allocate(5 * 1024 * 1024 + 1);
+		ASSERT_TRUE(p != nullptr);
+		std::memset(p, 0xFF, 5 * 1024 * 1024 + 1);
+	}
+	{
+		ILTagArena a;
+		q = (std::uint8_t *)a.allocate(5 * 1024 * 1024 + 1);
+		ASSERT_EQ(p, q);
+		// Released chunks are returned to the system
+		ASSERT_EQ(0, q[0]);
+		ASSERT_EQ(0, q[5 * 1024 * 1024]);
+
+		ASSERT_TRUE(a.allocate(std::size_t(1) << 40) == nullptr);
+		ASSERT_TRUE(a.allocate(16) != nullptr);
+	}
+}
+
+//------------------------------------------------------------------------------
@@ -407,6 +407,46 @@ TEST_F(ILTagFactoryTest, strictMode) {
 	ASSERT_FALSE(f.strictMode());
 }
 
+//------------------------------------------------------------------------------
+TEST_F(ILTagFactoryTest, viewMode) {
+	ILTagFactory f;
+
+	ASSERT_FALSE(f.viewMode());
+
+	f.setViewMode(true);
+	ASSERT_TRUE(f.viewMode());
+
+	f.setViewMode(false);
+	ASSERT_FALSE(f.viewMode());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagFactoryTest, lazyMode) {
+	ILTagFactory f;
+
+	ASSERT_FALSE(f.lazyMode());
+
+	f.setLazyMode(true);
+	ASSERT_TRUE(f.lazyMode());
+
+	f.setLazyMode(false);
+	ASSERT_FALSE(f.lazyMode());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagFactoryTest, arena) {
+	ILTagFactory f;
+	ILTagArena a;
+
+	ASSERT_TRUE(f.arena() == nullptr);
+
+	f.setArena(&a);
+	ASSERT_EQ(&a, f.arena());
+
+	f.setArena(nullptr);
+	ASSERT_TRUE(f.arena() == nullptr);
+}
+
 //------------------------------------------------------------------------------
 TEST_F(ILTagFactoryTest, deserializeIRBufferILTag) {
 	ILTagFactory f;
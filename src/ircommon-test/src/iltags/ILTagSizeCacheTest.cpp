@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ILTagSizeCacheTest.h"
+#include <cstring>
+#include <thread>
+#include <ircommon/ilint.h>
+#include <ircommon/iltag.h>
+#include <ircommon/iltagstd.h>
+using namespace ircommon;
+using namespace ircommon::iltags;
+
+//==============================================================================
+// class ILCountingTag
+//------------------------------------------------------------------------------
+class ILCountingTag: public ILTag{
+protected:
+	std::uint8_t _value;
+	virtual bool serializeValue(ircommon::IRBuffer & out) const;
+public:
+	mutable int sizeCalls;
+	ILCountingTag(std::uint64_t id):ILTag(id),_value(0),sizeCalls(0) {}
+	virtual ~ILCountingTag() = default;
+	virtual std::uint64_t size() const;
+	virtual bool deserializeValue(const ILTagFactory & factory,
+			const void * buff, std::uint64_t size);
+};
+
+//------------------------------------------------------------------------------
+bool ILCountingTag::serializeValue(ircommon::IRBuffer & out) const {
+	return out.write(this->_value);
+}
+
+//------------------------------------------------------------------------------
+std::uint64_t ILCountingTag::size() const {
+	this->sizeCalls++;
+	return 1;
+}
+
+//------------------------------------------------------------------------------
+bool ILCountingTag::deserializeValue(const ILTagFactory & factory,
+		const void * buff, std::uint64_t size) {
+	return false;
+}
+
+//==============================================================================
+// class ILTagSizeCacheTest
+//------------------------------------------------------------------------------
+ILTagSizeCacheTest::ILTagSizeCacheTest() {
+}
+
+//------------------------------------------------------------------------------
+ILTagSizeCacheTest::~ILTagSizeCacheTest() {
+}
+
+//------------------------------------------------------------------------------
+void ILTagSizeCacheTest::SetUp() {
+}
+
+//------------------------------------------------------------------------------
+void ILTagSizeCacheTest::TearDown() {
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagSizeCacheTest, currentPass) {
+	std::uint64_t pass;
+
+	ASSERT_EQ(0, ILTagSizeCache::currentPass());
+	{
+		ILTagSizeCache c1;
+		pass = ILTagSizeCache::currentPass();
+		ASSERT_NE(0, pass);
+		{
+			ILTagSizeCache c2;
+			ASSERT_EQ(pass, ILTagSizeCache::currentPass());
+		}
+		ASSERT_EQ(pass, ILTagSizeCache::currentPass());
+	}
+	ASSERT_EQ(0, ILTagSizeCache::currentPass());
+	{
+		ILTagSizeCache c1;
+		ASSERT_NE(0, ILTagSizeCache::currentPass());
+		ASSERT_NE(pass, ILTagSizeCache::currentPass());
+	}
+	ASSERT_EQ(0, ILTagSizeCache::currentPass());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagSizeCacheTest, cachedSize) {
+	ILCountingTag t(64);
+
+	ASSERT_EQ(1, t.cachedSize());
+	ASSERT_EQ(1, t.cachedSize());
+	ASSERT_EQ(2, t.sizeCalls);
+
+	t.sizeCalls = 0;
+	{
+		ILTagSizeCache c;
+		ASSERT_EQ(1, t.cachedSize());
+		ASSERT_EQ(3, t.tagSize());
+		ASSERT_EQ(1, t.cachedSize());
+		ASSERT_EQ(1, t.sizeCalls);
+	}
+	{
+		ILTagSizeCache c;
+		ASSERT_EQ(1, t.cachedSize());
+		ASSERT_EQ(2, t.sizeCalls);
+	}
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagSizeCacheTest, serializeNested) {
+	ILTagSeqTag root;
+	ILTagSeqTag * curr;
+	ILCountingTag * leaf;
+	IRBuffer out;
+
+	// Creates a deep tree
+	curr = &root;
+	for (int i = 0; i < 16; i++) {
+		ILTagSeqTag * child = new ILTagSeqTag();
+		ASSERT_TRUE(curr->add(child));
+		curr = child;
+	}
+	leaf = new ILCountingTag(64);
+	ASSERT_TRUE(curr->add(leaf));
+
+	ASSERT_TRUE(root.serialize(out));
+	ASSERT_EQ(1, leaf->sizeCalls);
+	ASSERT_EQ(root.tagSize(), out.size());
+
+	// Modify the tree between the passes
+	ASSERT_TRUE(curr->add(new ILCountingTag(65)));
+	out.setSize(0);
+	ASSERT_TRUE(root.serialize(out));
+	ASSERT_EQ(root.tagSize(), out.size());
+	ASSERT_EQ(0, ILTagSizeCache::currentPass());
+}
+//------------------------------------------------------------------------------
+
+TEST_F(ILTagSizeCacheTest, serializeConcurrent) {
+	ILTagSeqTag root;
+	ILTagSeqTag * curr;
+	IRBuffer exp;
+	bool ok[4];
+	IRBuffer out[4];
+	std::thread threads[4];
+
+	curr = &root;
+	for (int i = 0; i < 64; i++) {
+		ILTagSeqTag * child = new ILTagSeqTag();
+		ASSERT_TRUE(curr->add(new ILStringTag()));
+		ASSERT_TRUE(curr->add(child));
+		curr = child;
+	}
+	ASSERT_TRUE(root.serialize(exp));
+
+	// Const serializations of the same tag may share it
+	for (int i = 0; i < 4; i++) {
+		threads[i] = std::thread([&root, &ok, &out, i]() {
+			ok[i] = true;
+			for (int j = 0; (j < 256) && ok[i]; j++) {
+				out[i].setSize(0);
+				ok[i] = root.serialize(out[i]);
+			}
+		});
+	}
+	for (int i = 0; i < 4; i++) {
+		threads[i].join();
+	}
+	for (int i = 0; i < 4; i++) {
+		ASSERT_TRUE(ok[i]);
+		ASSERT_EQ(exp.size(), out[i].size());
+		ASSERT_EQ(0, std::memcmp(exp.roBuffer(), out[i].roBuffer(), exp.size()));
+	}
+}
+//------------------------------------------------------------------------------
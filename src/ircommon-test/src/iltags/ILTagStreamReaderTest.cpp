@@ -0,0 +1,433 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ILTagStreamReaderTest.h"
+#include <cstring>
+#include <cstdio>
+#include <sstream>
+#include <algorithm>
+#include <vector>
+#include <ircommon/ilint.h>
+#include <ircommon/iltagstd.h>
+#include <ircommon/iltagstream.h>
+using namespace ircommon;
+using namespace ircommon::iltags;
+
+//==============================================================================
+// class ILTagStreamReaderTest
+//------------------------------------------------------------------------------
+ILTagStreamReaderTest::ILTagStreamReaderTest() {
+}
+
+//------------------------------------------------------------------------------
+ILTagStreamReaderTest::~ILTagStreamReaderTest() {
+}
+
+//------------------------------------------------------------------------------
+void ILTagStreamReaderTest::SetUp() {
+}
+
+//------------------------------------------------------------------------------
+void ILTagStreamReaderTest::TearDown() {
+}
+
+//------------------------------------------------------------------------------
+static void ILTagStreamReaderTest_createSample(IRBuffer & out) {
+	ILILIntTag ilint;
+	ILUInt32Tag u32;
+	ILByteArrayTag bytes;
+	ILTagSeqTag seq;
+	ILTagArrayTag * array;
+
+	ilint.setValue(0xFFFFFF);
+	ASSERT_TRUE(ilint.serialize(out));
+	u32.setValue(0x01020304);
+	ASSERT_TRUE(u32.serialize(out));
+	for (int i = 0; i < 1000; i++) {
+		ASSERT_TRUE(bytes.value().write(i));
+	}
+	ASSERT_TRUE(bytes.serialize(out));
+
+	array = new ILTagArrayTag();
+	for (int i = 0; i < 3; i++) {
+		ILUInt32Tag * v = new ILUInt32Tag();
+		v->setValue(i);
+		ASSERT_TRUE(array->add(v));
+	}
+	ASSERT_TRUE(seq.add(array));
+	ASSERT_TRUE(seq.add(new ILStringTag()));
+	ASSERT_TRUE(seq.serialize(out));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagStreamReaderTest, next) {
+	IRBuffer sample;
+	std::uint64_t tagId;
+	std::uint64_t tagSize;
+
+	ILTagStreamReaderTest_createSample(sample);
+	ILTagMemoryInput in(sample.roBuffer(), sample.size());
+	ILTagStreamReader r(in);
+
+	ASSERT_TRUE(r.next(tagId, tagSize));
+	ASSERT_EQ(ILTag::TAG_ILINT64, tagId);
+	ASSERT_EQ(ILInt::size(0xFFFFFF), tagSize);
+	ASSERT_EQ(tagId, r.tagId());
+	ASSERT_EQ(tagSize, r.tagSize());
+	ASSERT_EQ(tagSize, r.remaining());
+
+	ASSERT_TRUE(r.next(tagId, tagSize));
+	ASSERT_EQ(ILTag::TAG_UINT32, tagId);
+	ASSERT_EQ(4, tagSize);
+
+	ASSERT_TRUE(r.next(tagId, tagSize));
+	ASSERT_EQ(ILTag::TAG_BYTE_ARRAY, tagId);
+	ASSERT_EQ(1000, tagSize);
+
+	ASSERT_TRUE(r.next(tagId, tagSize));
+	ASSERT_EQ(ILTag::TAG_ILTAG_SEQ, tagId);
+
+	ASSERT_FALSE(r.next(tagId, tagSize));
+	ASSERT_TRUE(r.eof());
+	ASSERT_FALSE(r.hasError());
+	ASSERT_EQ(sample.size(), in.position());
+
+	// Truncated
+	ILTagMemoryInput in2(sample.roBuffer(), sample.size() - 1);
+	ILTagStreamReader r2(in2);
+	for (int i = 0; i < 3; i++) {
+		ASSERT_TRUE(r2.next(tagId, tagSize));
+	}
+	ASSERT_TRUE(r2.next(tagId, tagSize));
+	ASSERT_FALSE(r2.skip());
+	ASSERT_TRUE(r2.hasError());
+	ASSERT_FALSE(r2.next(tagId, tagSize));
+	ASSERT_FALSE(r2.eof());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagStreamReaderTest, read) {
+	IRBuffer sample;
+	std::uint64_t tagId;
+	std::uint64_t tagSize;
+	std::uint8_t buff[1000];
+	std::uint64_t v;
+
+	ILTagStreamReaderTest_createSample(sample);
+	ILTagMemoryInput in(sample.roBuffer(), sample.size());
+	ILTagStreamReader r(in);
+
+	ASSERT_TRUE(r.next(tagId, tagSize));
+	ASSERT_TRUE(r.readILInt(v));
+	ASSERT_EQ(0xFFFFFF, v);
+	ASSERT_EQ(0, r.remaining());
+	ASSERT_FALSE(r.read(buff, 1));
+
+	ASSERT_TRUE(r.next(tagId, tagSize));
+	ASSERT_TRUE(r.read(buff, 2));
+	ASSERT_EQ(1, buff[0]);
+	ASSERT_EQ(2, buff[1]);
+	ASSERT_EQ(2, r.remaining());
+
+	// Incremental reads
+	ASSERT_TRUE(r.next(tagId, tagSize));
+	for (int i = 0; i < 1000; i += 100) {
+		ASSERT_TRUE(r.read(buff + i, 100));
+		ASSERT_EQ(1000 - i - 100, r.remaining());
+	}
+	for (int i = 0; i < 1000; i++) {
+		ASSERT_EQ(i & 0xFF, buff[i]);
+	}
+
+	ASSERT_TRUE(r.next(tagId, tagSize));
+	IRBuffer body;
+	ASSERT_TRUE(r.read(body));
+	ASSERT_EQ(tagSize, body.size());
+	ASSERT_EQ(0, std::memcmp(sample.roBuffer() + sample.size() - tagSize,
+			body.roBuffer(), tagSize));
+	ASSERT_FALSE(r.next(tagId, tagSize));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagStreamReaderTest, readTag) {
+	IRBuffer sample;
+	ILStandardTagFactory f;
+	std::uint64_t tagId;
+	std::uint64_t tagSize;
+	ILTag * tag;
+
+	ILTagStreamReaderTest_createSample(sample);
+	ILTagMemoryInput in(sample.roBuffer(), sample.size());
+	ILTagStreamReader r(in);
+
+	ASSERT_TRUE(r.next(tagId, tagSize));
+	tag = r.readTag(f);
+	ASSERT_TRUE(tag != nullptr);
+	ASSERT_EQ(0xFFFFFF, static_cast<ILILIntTag *>(tag)->value());
+	delete tag;
+
+	ASSERT_TRUE(r.next(tagId, tagSize));
+	tag = r.readTag(f);
+	ASSERT_TRUE(tag != nullptr);
+	ASSERT_EQ(0x01020304, static_cast<ILUInt32Tag *>(tag)->value());
+	delete tag;
+
+	// Partially read
+	std::uint8_t b;
+	ASSERT_TRUE(r.next(tagId, tagSize));
+	ASSERT_TRUE(r.read(&b, 1));
+	ASSERT_TRUE(r.readTag(f) == nullptr);
+
+	// View mode is not allowed
+	ASSERT_TRUE(r.next(tagId, tagSize));
+	f.setViewMode(true);
+	ASSERT_TRUE(r.readTag(f) == nullptr);
+	f.setViewMode(false);
+	tag = r.readTag(f);
+	ASSERT_TRUE(tag != nullptr);
+	ASSERT_EQ(ILTag::TAG_ILTAG_SEQ, tag->id());
+	ASSERT_EQ(2, static_cast<ILTagSeqTag *>(tag)->count());
+	delete tag;
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagStreamReaderTest, enter) {
+	IRBuffer sample;
+	std::uint64_t tagId;
+	std::uint64_t tagSize;
+	std::uint64_t count;
+	std::uint8_t buff[4];
+
+	ILTagStreamReaderTest_createSample(sample);
+	ILTagMemoryInput in(sample.roBuffer(), sample.size());
+	ILTagStreamReader r(in);
+
+	ASSERT_FALSE(r.leave());
+	ASSERT_TRUE(r.next(tagId, tagSize));
+	ASSERT_FALSE(r.enter());
+	for (int i = 0; i < 3; i++) {
+		ASSERT_TRUE(r.next(tagId, tagSize));
+	}
+	ASSERT_EQ(ILTag::TAG_ILTAG_SEQ, tagId);
+	ASSERT_TRUE(r.enter());
+	ASSERT_EQ(1, r.depth());
+
+	ASSERT_TRUE(r.next(tagId, tagSize));
+	ASSERT_EQ(ILTag::TAG_ILTAG_ARRAY, tagId);
+	ASSERT_TRUE(r.readILInt(count));
+	ASSERT_EQ(3, count);
+	ASSERT_TRUE(r.enter());
+	ASSERT_EQ(2, r.depth());
+	for (unsigned int i = 0; i < count; i++) {
+		ASSERT_TRUE(r.next(tagId, tagSize));
+		ASSERT_EQ(ILTag::TAG_UINT32, tagId);
+		ASSERT_TRUE(r.read(buff, 4));
+		ASSERT_EQ(i, buff[3]);
+	}
+	ASSERT_FALSE(r.next(tagId, tagSize));
+	ASSERT_TRUE(r.leave());
+	ASSERT_EQ(1, r.depth());
+
+	ASSERT_TRUE(r.next(tagId, tagSize));
+	ASSERT_EQ(ILTag::TAG_STRING, tagId);
+	ASSERT_EQ(0, tagSize);
+	ASSERT_FALSE(r.next(tagId, tagSize));
+	ASSERT_TRUE(r.leave());
+	ASSERT_EQ(0, r.depth());
+	ASSERT_FALSE(r.next(tagId, tagSize));
+	ASSERT_EQ(sample.size(), in.position());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagStreamReaderTest, leave) {
+	IRBuffer sample;
+	std::uint64_t tagId;
+	std::uint64_t tagSize;
+
+	ILTagStreamReaderTest_createSample(sample);
+	ASSERT_TRUE(sample.writeILInt(ILTag::TAG_NULL));
+	ILTagMemoryInput in(sample.roBuffer(), sample.size());
+	ILTagStreamReader r(in);
+
+	for (int i = 0; i < 4; i++) {
+		ASSERT_TRUE(r.next(tagId, tagSize));
+	}
+	ASSERT_TRUE(r.enter());
+	ASSERT_TRUE(r.next(tagId, tagSize));
+	ASSERT_TRUE(r.enter());
+	// Leave both without reading
+	ASSERT_TRUE(r.leave());
+	ASSERT_TRUE(r.leave());
+	ASSERT_TRUE(r.next(tagId, tagSize));
+	ASSERT_EQ(ILTag::TAG_NULL, tagId);
+	ASSERT_FALSE(r.next(tagId, tagSize));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagStreamReaderTest, ILTagIStreamInput) {
+	IRBuffer sample;
+	std::uint64_t tagId;
+	std::uint64_t tagSize;
+	int count;
+
+	ILTagStreamReaderTest_createSample(sample);
+	std::istringstream s(std::string((const char *)sample.roBuffer(),
+			sample.size()));
+	ILTagIStreamInput in(s);
+	ILTagStreamReader r(in);
+
+	count = 0;
+	while (r.next(tagId, tagSize)) {
+		count++;
+	}
+	ASSERT_EQ(4, count);
+	ASSERT_TRUE(r.eof());
+	ASSERT_FALSE(r.hasError());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagStreamReaderTest, ILTagFDInput) {
+	IRBuffer sample;
+	std::uint64_t tagId;
+	std::uint64_t tagSize;
+	std::uint8_t buff[1000];
+	std::FILE * f;
+
+	ILTagStreamReaderTest_createSample(sample);
+	f = std::tmpfile();
+	ASSERT_TRUE(f != nullptr);
+	ASSERT_EQ(sample.size(), std::fwrite(sample.roBuffer(), 1, sample.size(), f));
+	std::fflush(f);
+	std::rewind(f);
+
+	ILTagFDInput in(fileno(f));
+	ILTagStreamReader r(in);
+	ASSERT_TRUE(r.next(tagId, tagSize));
+	ASSERT_TRUE(r.next(tagId, tagSize));
+	ASSERT_TRUE(r.next(tagId, tagSize));
+	ASSERT_TRUE(r.read(buff, sizeof(buff)));
+	for (unsigned int i = 0; i < sizeof(buff); i++) {
+		ASSERT_EQ(i & 0xFF, buff[i]);
+	}
+	ASSERT_TRUE(r.next(tagId, tagSize));
+	ASSERT_FALSE(r.next(tagId, tagSize));
+	ASSERT_TRUE(r.eof());
+	ASSERT_FALSE(r.hasError());
+	std::fclose(f);
+
+	// Truncated in the middle of the last tag
+	f = std::tmpfile();
+	ASSERT_TRUE(f != nullptr);
+	ASSERT_EQ(sample.size() - 1,
+			std::fwrite(sample.roBuffer(), 1, sample.size() - 1, f));
+	std::fflush(f);
+	std::rewind(f);
+
+	ILTagFDInput in2(fileno(f));
+	ILTagStreamReader r2(in2);
+	while (r2.next(tagId, tagSize)) {
+	}
+	ASSERT_FALSE(r2.eof());
+	ASSERT_TRUE(r2.hasError());
+	std::fclose(f);
+}
+//------------------------------------------------------------------------------
+
+TEST_F(ILTagStreamReaderTest, truncated) {
+	IRBuffer sample;
+	std::vector<std::uint64_t> ends;
+	std::uint64_t tagId;
+	std::uint64_t tagSize;
+
+	ILTagStreamReaderTest_createSample(sample);
+	ILTagMemoryInput in(sample.roBuffer(), sample.size());
+	ILTagStreamReader r(in);
+	ends.push_back(0);
+	while (r.next(tagId, tagSize)) {
+		ASSERT_TRUE(r.skip());
+		ends.push_back(in.position());
+	}
+
+	// Only cuts between top level tags are a clean end of the input
+	for (std::uint64_t size = 0; size <= sample.size(); size++) {
+		bool clean = (std::find(ends.begin(), ends.end(), size) != ends.end());
+		int count;
+
+		ILTagMemoryInput in2(sample.roBuffer(), size);
+		ILTagStreamReader r2(in2);
+		count = 0;
+		while (r2.next(tagId, tagSize)) {
+			count++;
+		}
+		ASSERT_EQ(clean, r2.eof());
+		ASSERT_EQ(!clean, r2.hasError());
+
+		std::istringstream s(std::string((const char *)sample.roBuffer(),
+				size));
+		ILTagIStreamInput in3(s);
+		ILTagStreamReader r3(in3);
+		while (r3.next(tagId, tagSize)) {
+			count--;
+		}
+		ASSERT_EQ(0, count);
+		ASSERT_EQ(clean, r3.eof());
+		ASSERT_EQ(!clean, r3.hasError());
+	}
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagStreamReaderTest, corrupted) {
+	IRBuffer sample;
+	std::uint64_t tagId;
+	std::uint64_t tagSize;
+
+	// A sequence with a byte array larger than the sequence itself
+	ASSERT_TRUE(sample.writeILInt(ILTag::TAG_ILTAG_SEQ));
+	ASSERT_TRUE(sample.writeILInt(3));
+	ASSERT_TRUE(sample.writeILInt(ILTag::TAG_NULL));
+	ASSERT_TRUE(sample.writeILInt(ILTag::TAG_BYTE_ARRAY));
+	ASSERT_TRUE(sample.writeILInt(10));
+	ILTagMemoryInput in(sample.roBuffer(), sample.size());
+	ILTagStreamReader r(in);
+
+	ASSERT_TRUE(r.next(tagId, tagSize));
+	ASSERT_TRUE(r.enter());
+	ASSERT_TRUE(r.next(tagId, tagSize));
+	ASSERT_EQ(ILTag::TAG_NULL, tagId);
+	ASSERT_FALSE(r.next(tagId, tagSize));
+	ASSERT_TRUE(r.hasError());
+	ASSERT_FALSE(r.eof());
+	ASSERT_FALSE(r.leave());
+	ASSERT_FALSE(r.next(tagId, tagSize));
+
+	// The end of a level is neither an error nor the end of the input
+	sample.setSize(0);
+	ASSERT_TRUE(sample.writeILInt(ILTag::TAG_ILTAG_SEQ));
+	ASSERT_TRUE(sample.writeILInt(1));
+	ASSERT_TRUE(sample.writeILInt(ILTag::TAG_NULL));
+	ILTagMemoryInput in2(sample.roBuffer(), sample.size());
+	ILTagStreamReader r2(in2);
+	ASSERT_TRUE(r2.next(tagId, tagSize));
+	ASSERT_TRUE(r2.enter());
+	ASSERT_TRUE(r2.next(tagId, tagSize));
+	ASSERT_FALSE(r2.next(tagId, tagSize));
+	ASSERT_FALSE(r2.hasError());
+	ASSERT_FALSE(r2.eof());
+	ASSERT_TRUE(r2.leave());
+	ASSERT_FALSE(r2.next(tagId, tagSize));
+	ASSERT_TRUE(r2.eof());
+}
+
+//------------------------------------------------------------------------------
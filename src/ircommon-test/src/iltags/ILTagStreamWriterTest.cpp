@@ -0,0 +1,443 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ILTagStreamWriterTest.h"
+#include <cstring>
+#include <cstdio>
+#include <sstream>
+#include <ircommon/irutils.h>
+#include <ircommon/iltagstd.h>
+#include <ircommon/iltagstream.h>
+using namespace ircommon;
+using namespace ircommon::iltags;
+
+//==============================================================================
+// class ILTagStreamWriterTest_MarkedSeq
+//------------------------------------------------------------------------------
+/**
+ * Sequence that writes a marker byte before its entries.
+ */
+class ILTagStreamWriterTest_MarkedSeq: public ILTagSeqTag {
+protected:
+	virtual bool serializeValue(IRBuffer & out) const {
+		if (!out.write(0xA5)) {
+			return false;
+		}
+		return ILTagSeqTag::serializeValue(out);
+	}
+
+	virtual bool writeValue(ILTagStreamWriter & out) const {
+		std::uint8_t marker = 0xA5;
+		if (!out.writeBody(&marker, 1)) {
+			return false;
+		}
+		return ILTagSeqTag::writeValue(out);
+	}
+public:
+	virtual std::uint64_t size() const {
+		return 1 + ILTagSeqTag::size();
+	}
+};
+
+//==============================================================================
+// class ILTagStreamWriterTest_PlainTag
+//------------------------------------------------------------------------------
+/**
+ * Tag written by the default ILTag::writeValue().
+ */
+class ILTagStreamWriterTest_PlainTag: public ILTag {
+protected:
+	virtual bool serializeValue(IRBuffer & out) const {
+		return out.write("plain", 5);
+	}
+public:
+	ILTagStreamWriterTest_PlainTag(): ILTag(0x1234) {}
+
+	virtual std::uint64_t size() const {
+		return 5;
+	}
+
+	virtual bool deserializeValue(const ILTagFactory & factory,
+			const void * buff, std::uint64_t size) {
+		return false;
+	}
+};
+
+//==============================================================================
+// class ILTagStreamWriterTest
+//------------------------------------------------------------------------------
+ILTagStreamWriterTest::ILTagStreamWriterTest() {
+}
+
+//------------------------------------------------------------------------------
+ILTagStreamWriterTest::~ILTagStreamWriterTest() {
+}
+
+//------------------------------------------------------------------------------
+void ILTagStreamWriterTest::SetUp() {
+}
+
+//------------------------------------------------------------------------------
+void ILTagStreamWriterTest::TearDown() {
+}
+
+//------------------------------------------------------------------------------
+static ILTag * ILTagStreamWriterTest_createSample() {
+	ILTagSeqTag * seq;
+	ILTagArrayTag * array;
+	ILByteArrayTag * bytes;
+	ILILIntTag * ilint;
+	ILStringTag * str;
+
+	seq = new ILTagSeqTag();
+	array = new ILTagArrayTag();
+	for (int i = 0; i < 3; i++) {
+		ILUInt32Tag * v = new ILUInt32Tag();
+		v->setValue(i);
+		array->add(v);
+	}
+	array->add(ILBaseTagListTag::SharedPointer());
+	seq->add(array);
+	bytes = new ILByteArrayTag();
+	for (int i = 0; i < 1000; i++) {
+		bytes->value().write(i);
+	}
+	seq->add(bytes);
+	ilint = new ILILIntTag();
+	ilint->setValue(0xFFFFFFFF);
+	seq->add(ilint);
+	str = new ILStringTag();
+	str->setValue("Tears in rain");
+	seq->add(str);
+	return seq;
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagStreamWriterTest, write) {
+	IRBuffer act;
+	ILTagBufferOutput out(act);
+	ILTagStreamWriter w(out);
+	IRBuffer exp;
+	ILTag * tag;
+
+	tag = ILTagStreamWriterTest_createSample();
+	ASSERT_TRUE(tag->serialize(exp));
+	ASSERT_TRUE(w.write(*tag));
+	ASSERT_EQ(0, w.depth());
+	ASSERT_EQ(exp.size(), act.size());
+	ASSERT_EQ(0, std::memcmp(exp.roBuffer(), act.roBuffer(),
+			exp.size()));
+	delete tag;
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagStreamWriterTest, beginTag) {
+	IRBuffer act;
+	ILTagBufferOutput out(act);
+	ILTagStreamWriter w(out);
+	ILByteArrayTag exp;
+	IRBuffer serialized;
+	std::uint8_t buff[100];
+
+	for (unsigned int i = 0; i < sizeof(buff); i++) {
+		buff[i] = i;
+	}
+	for (int i = 0; i < 10; i++) {
+		ASSERT_TRUE(exp.value().write(buff, sizeof(buff)));
+	}
+	ASSERT_TRUE(exp.serialize(serialized));
+
+	ASSERT_FALSE(w.writeBody(buff, 1));
+	ASSERT_FALSE(w.writeILInt(1));
+	ASSERT_FALSE(w.endTag());
+	ASSERT_TRUE(w.beginTag(ILTag::TAG_BYTE_ARRAY, 1000));
+	ASSERT_EQ(1, w.depth());
+	for (int i = 0; i < 10; i++) {
+		ASSERT_FALSE(w.endTag());
+		ASSERT_TRUE(w.writeBody(buff, sizeof(buff)));
+	}
+	ASSERT_FALSE(w.writeBody(buff, 1));
+	ASSERT_TRUE(w.endTag());
+	ASSERT_EQ(0, w.depth());
+	ASSERT_EQ(serialized.size(), act.size());
+	ASSERT_EQ(0, std::memcmp(serialized.roBuffer(), act.roBuffer(),
+			serialized.size()));
+
+	// Implicit sizes
+	ASSERT_FALSE(w.beginTag(ILTag::TAG_UINT32, 5));
+	ASSERT_FALSE(w.beginTag(ILTag::TAG_ILINT64, 0));
+	ASSERT_FALSE(w.beginTag(ILTag::TAG_ILINT64, 10));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagStreamWriterTest, beginTagNested) {
+	IRBuffer act;
+	ILTagBufferOutput out(act);
+	ILTagStreamWriter w(out);
+	ILTagArrayTag exp;
+	IRBuffer serialized;
+	std::uint8_t buff[4];
+
+	for (int i = 0; i < 2; i++) {
+		ILUInt32Tag * v = new ILUInt32Tag();
+		v->setValue(i);
+		ASSERT_TRUE(exp.add(v));
+	}
+	ASSERT_TRUE(exp.serialize(serialized));
+
+	ASSERT_TRUE(w.beginTag(ILTag::TAG_ILTAG_ARRAY, exp.size()));
+	ASSERT_TRUE(w.writeILInt(2));
+	ASSERT_TRUE(w.beginTag(ILTag::TAG_UINT32, 4));
+	ASSERT_EQ(2, w.depth());
+	IRUtils::int2BE(std::uint32_t(0), buff);
+	ASSERT_TRUE(w.writeBody(buff, 4));
+	ASSERT_TRUE(w.endTag());
+	ILUInt32Tag v;
+	v.setValue(1);
+	ASSERT_TRUE(w.write(v));
+	// No room left
+	ASSERT_FALSE(w.write(v));
+	ASSERT_FALSE(w.beginTag(ILTag::TAG_UINT32, 4));
+	ASSERT_TRUE(w.endTag());
+	ASSERT_EQ(serialized.size(), act.size());
+	ASSERT_EQ(0, std::memcmp(serialized.roBuffer(), act.roBuffer(),
+			serialized.size()));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagStreamWriterTest, ILTagOStreamOutput) {
+	std::ostringstream s;
+	ILTagOStreamOutput out(s);
+	ILTagStreamWriter w(out);
+	IRBuffer exp;
+	ILTag * tag;
+
+	tag = ILTagStreamWriterTest_createSample();
+	ASSERT_TRUE(tag->serialize(exp));
+	ASSERT_TRUE(w.write(*tag));
+	ASSERT_EQ(exp.size(), s.str().size());
+	ASSERT_EQ(0, std::memcmp(exp.roBuffer(), s.str().data(), exp.size()));
+	delete tag;
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagStreamWriterTest, ILTagFDOutput) {
+	IRBuffer exp;
+	IRBuffer act;
+	ILTag * tag;
+	std::FILE * f;
+
+	f = std::tmpfile();
+	ASSERT_TRUE(f != nullptr);
+	tag = ILTagStreamWriterTest_createSample();
+	ASSERT_TRUE(tag->serialize(exp));
+	{
+		ILTagFDOutput out(fileno(f));
+		ILTagStreamWriter w(out);
+		ASSERT_TRUE(w.write(*tag));
+	}
+	delete tag;
+
+	std::rewind(f);
+	ASSERT_TRUE(act.setSize(exp.size()));
+	ASSERT_EQ(exp.size(), std::fread(act.buffer(), 1, act.size(), f));
+	ASSERT_EQ(0, std::memcmp(exp.roBuffer(), act.roBuffer(), exp.size()));
+	std::fclose(f);
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagStreamWriterTest, ILTagBufferOutput) {
+	IRBuffer act;
+	ILTagBufferOutput out(act);
+	std::uint8_t buff[16];
+
+	for (unsigned int i = 0; i < sizeof(buff); i++) {
+		buff[i] = i;
+	}
+	ASSERT_TRUE(act.write(buff, 1));
+	ASSERT_TRUE(out.write(buff, sizeof(buff)));
+	ASSERT_TRUE(out.write(buff, 0));
+	ASSERT_EQ(1 + sizeof(buff), act.size());
+	ASSERT_EQ(0, act.roBuffer()[0]);
+	ASSERT_EQ(0, std::memcmp(buff, act.roBuffer() + 1, sizeof(buff)));
+
+	IRBuffer ro(buff, sizeof(buff));
+	ILTagBufferOutput roOut(ro);
+	ASSERT_FALSE(roOut.write(buff, sizeof(buff)));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagStreamWriterTest, ILTagTeeOutput) {
+	IRBuffer a;
+	IRBuffer b;
+	ILTagBufferOutput outA(a);
+	ILTagBufferOutput outB(b);
+	ILTagTeeOutput out(outA, outB);
+	IRBuffer exp;
+	ILTag * tag;
+
+	tag = ILTagStreamWriterTest_createSample();
+	ASSERT_TRUE(tag->serialize(exp));
+	ASSERT_TRUE(tag->serialize(out));
+	delete tag;
+	ASSERT_EQ(exp.size(), a.size());
+	ASSERT_EQ(0, std::memcmp(exp.roBuffer(), a.roBuffer(), exp.size()));
+	ASSERT_EQ(exp.size(), b.size());
+	ASSERT_EQ(0, std::memcmp(exp.roBuffer(), b.roBuffer(), exp.size()));
+
+	// Failures of any sink are reported
+	IRBuffer ro(exp.roBuffer(), exp.size());
+	ILTagBufferOutput roOut(ro);
+	ILTagTeeOutput out1(roOut, outB);
+	ILTagTeeOutput out2(outA, roOut);
+	ASSERT_FALSE(out1.write(exp.roBuffer(), 1));
+	ASSERT_FALSE(out2.write(exp.roBuffer(), 1));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagStreamWriterTest, serializeOutput) {
+	IRBuffer act;
+	ILTagBufferOutput out(act);
+	IRBuffer exp;
+	ILNullTag nullTag;
+	ILILIntTag ilint;
+	ILStringTag str;
+	ILTag * tag;
+
+	// Leaf tags
+	ilint.setValue(0x123456789ABCll);
+	str.setValue("Like tears in rain");
+	ASSERT_TRUE(nullTag.serialize(exp));
+	ASSERT_TRUE(ilint.serialize(exp));
+	ASSERT_TRUE(str.serialize(exp));
+	ASSERT_TRUE(nullTag.serialize(out));
+	ASSERT_TRUE(ilint.serialize(out));
+	ASSERT_TRUE(str.serialize(out));
+	ASSERT_EQ(exp.size(), act.size());
+	ASSERT_EQ(0, std::memcmp(exp.roBuffer(), act.roBuffer(), exp.size()));
+
+	exp.setSize(0);
+	act.setSize(0);
+	tag = ILTagStreamWriterTest_createSample();
+	ASSERT_TRUE(tag->serialize(exp));
+	ASSERT_TRUE(tag->serialize(out));
+	delete tag;
+	ASSERT_EQ(exp.size(), act.size());
+	ASSERT_EQ(0, std::memcmp(exp.roBuffer(), act.roBuffer(), exp.size()));
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagStreamWriterTest, writeListSubclass) {
+	IRBuffer act;
+	ILTagBufferOutput out(act);
+	ILTagStreamWriter w(out);
+	ILTagStreamWriterTest_MarkedSeq seq;
+	IRBuffer exp;
+
+	seq.add(ILTagStreamWriterTest_createSample());
+	seq.add(ILBaseTagListTag::SharedPointer());
+	ASSERT_TRUE(seq.serialize(exp));
+	ASSERT_TRUE(w.write(seq));
+	ASSERT_EQ(exp.size(), act.size());
+	ASSERT_EQ(0, std::memcmp(exp.roBuffer(), act.roBuffer(), exp.size()));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagStreamWriterTest, writeLazy) {
+	IRBuffer act;
+	ILTagBufferOutput out(act);
+	ILTagStreamWriter w(out);
+	ILStandardTagFactory factory;
+	ILTagSeqTag seq;
+	IRBuffer exp;
+	ILTag * tag;
+
+	tag = ILTagStreamWriterTest_createSample();
+	ASSERT_TRUE(tag->serialize(exp));
+	delete tag;
+
+	factory.setLazyMode(true);
+	exp.beginning();
+	ASSERT_TRUE(factory.deserialize(exp, seq));
+	ASSERT_EQ(4, seq.count());
+	ASSERT_TRUE(w.write(seq));
+	ASSERT_EQ(exp.size(), act.size());
+	ASSERT_EQ(0, std::memcmp(exp.roBuffer(), act.roBuffer(), exp.size()));
+	// The entries are copied without being decoded
+	for (std::uint64_t i = 0; i < seq.count(); i++) {
+		ASSERT_TRUE(seq.pending(i));
+	}
+}
+//------------------------------------------------------------------------------
+TEST_F(ILTagStreamWriterTest, writeStandardTags) {
+	IRBuffer act;
+	ILTagBufferOutput out(act);
+	ILTagStreamWriter w(out);
+	ILTagSeqTag seq;
+	IRBuffer exp;
+	ILBoolTag * b;
+	ILInt16Tag * i16;
+	ILUInt64Tag * u64;
+	ILBinary32Tag * f32;
+	ILBinary64Tag * f64;
+	ILBinary128Tag * f128;
+	ILBigDecimalTag * bdec;
+	ILILIntArrayTag * ints;
+	std::uint8_t opaque[16];
+
+	ASSERT_TRUE(seq.add(new ILNullTag()));
+	b = new ILBoolTag();
+	b->setValue(true);
+	ASSERT_TRUE(seq.add(b));
+	i16 = new ILInt16Tag();
+	i16->setValue(-2);
+	ASSERT_TRUE(seq.add(i16));
+	u64 = new ILUInt64Tag();
+	u64->setValue(0x0123456789ABCDEFll);
+	ASSERT_TRUE(seq.add(u64));
+	f32 = new ILBinary32Tag();
+	f32->setValue(1.5f);
+	ASSERT_TRUE(seq.add(f32));
+	f64 = new ILBinary64Tag();
+	f64->setValue(-3.25);
+	ASSERT_TRUE(seq.add(f64));
+	for (int i = 0; i < (int)sizeof(opaque); i++) {
+		opaque[i] = i;
+	}
+	f128 = new ILBinary128Tag();
+	ASSERT_TRUE(f128->setValue(opaque, sizeof(opaque)));
+	ASSERT_TRUE(seq.add(f128));
+	bdec = new ILBigDecimalTag(true);
+	bdec->setScale(-7);
+	ASSERT_TRUE(bdec->setIntegral(opaque, 5));
+	ASSERT_TRUE(seq.add(bdec));
+	ASSERT_TRUE(seq.add(new ILBigDecimalTag()));
+	ints = new ILILIntArrayTag();
+	for (int i = 0; i < 10; i++) {
+		ASSERT_TRUE(ints->add(0xFFll << (i * 6)));
+	}
+	ASSERT_TRUE(seq.add(ints));
+	ASSERT_TRUE(seq.add(new ILStringTag()));
+	ASSERT_TRUE(seq.add(new ILTagStreamWriterTest_PlainTag()));
+
+	ASSERT_TRUE(seq.serialize(exp));
+	ASSERT_TRUE(w.write(seq));
+	ASSERT_EQ(exp.size(), act.size());
+	ASSERT_EQ(0, std::memcmp(exp.roBuffer(), act.roBuffer(), exp.size()));
+}
+
+//------------------------------------------------------------------------------
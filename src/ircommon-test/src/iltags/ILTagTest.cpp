@@ -64,6 +64,27 @@ bool ILDummyTag::deserializeValue(const ILTagFactory & factory,
 	return true;
 }
 
+//==============================================================================
+// class ILFailingDummyTag
+//------------------------------------------------------------------------------
+/**
+ * ILDummyTag that writes its value and then fails or reports a wrong size.
+ */
+class ILFailingDummyTag: public ILDummyTag {
+protected:
+	bool _wrongSize;
+	virtual bool serializeValue(ircommon::IRBuffer & out) const {
+		return ILDummyTag::serializeValue(out) && this->_wrongSize;
+	}
+public:
+	ILFailingDummyTag(std::uint64_t id, bool wrongSize):ILDummyTag(id),
+			_wrongSize(wrongSize) {}
+	virtual ~ILFailingDummyTag() = default;
+	virtual std::uint64_t size() const {
+		return this->_wrongSize ? 2 : 1;
+	}
+};
+
 //==============================================================================
 // class ILTagTest
 //------------------------------------------------------------------------------
@@ -154,6 +175,50 @@ TEST_F(ILTagTest, serializeExplicit) {
 	ASSERT_EQ(0, std::memcmp(exp.roBuffer(), out.roBuffer(), exp.size()));
 }
 
+//------------------------------------------------------------------------------
+TEST_F(ILTagTest, serializeTo) {
+	IRBuffer out(0, false, 1);
+	IRBuffer exp;
+
+	ILDummyTag t1(0xFF);
+	t1.set(0xAA);
+	ASSERT_TRUE(t1.serializeTo(out));
+	ASSERT_TRUE(t1.serialize(exp));
+	ASSERT_LE(t1.tagSize(), out.bufferSize());
+	ASSERT_GE(t1.tagSize() + out.increment(), out.bufferSize());
+	ASSERT_EQ(exp.size(), out.size());
+	ASSERT_EQ(0, std::memcmp(exp.roBuffer(), out.roBuffer(), exp.size()));
+
+	// Append to the end of the buffer
+	ILDummyTag t2(1);
+	t2.set(0x55);
+	ASSERT_TRUE(t2.serializeTo(out));
+	ASSERT_TRUE(t2.serialize(exp));
+	ASSERT_LE(t1.tagSize() + t2.tagSize(), out.bufferSize());
+	ASSERT_GE(t1.tagSize() + t2.tagSize() + out.increment(), out.bufferSize());
+	ASSERT_EQ(exp.size(), out.size());
+	ASSERT_EQ(0, std::memcmp(exp.roBuffer(), out.roBuffer(), exp.size()));
+
+	IRBuffer ro(exp.roBuffer(), exp.size());
+	ASSERT_FALSE(t1.serializeTo(ro));
+
+	// Failures discard the partial serialization
+	for (int wrongSize = 0; wrongSize < 2; wrongSize++) {
+		ILFailingDummyTag t3(0xFF, wrongSize);
+		ASSERT_FALSE(t3.serializeTo(out));
+		ASSERT_EQ(exp.size(), out.size());
+		ASSERT_EQ(exp.size(), out.position());
+		ASSERT_EQ(0, std::memcmp(exp.roBuffer(), out.roBuffer(), exp.size()));
+	}
+
+	// Only the size and the position are restored inside the data
+	ILFailingDummyTag t4(0x1234, true);
+	out.setPosition(1);
+	ASSERT_FALSE(t4.serializeTo(out));
+	ASSERT_EQ(exp.size(), out.size());
+	ASSERT_EQ(1, out.position());
+}
+
 //------------------------------------------------------------------------------
 TEST_F(ILTagTest, deserializeValue) {
 	std::uint8_t buff[8];
@@ -17,6 +17,8 @@
 #include <ircommon/ilint.h>
 #include <ircommon/iltag.h>
 #include <ircommon/iltagstd.h>
+#include <cstring>
+#include <limits>
 
 using namespace ircommon;
 using namespace ircommon::iltags;
@@ -106,3 +108,85 @@ TEST_F(ILTagUtilTest, equals) {
     ASSERT_FALSE(ILTagUtil::equals(t3, t1));
 }
 
+
+//------------------------------------------------------------------------------
+TEST_F(ILTagUtilTest, equalsStandard) {
+	ILBoolTag b1;
+	ILBoolTag b2;
+	ILILIntTag i1;
+	ILILIntTag i2;
+	ILBinary64Tag f1;
+	ILBinary64Tag f2;
+	ILStringTag s1;
+	ILStringTag s2;
+	ILBinary128Tag o1;
+	ILBinary128Tag o2;
+	ILBigDecimalTag d1;
+	ILBigDecimalTag d2;
+	ILILIntArrayTag a1;
+	ILILIntArrayTag a2;
+	ILRawTag r(ILTag::TAG_ILINT64);
+	std::uint8_t buff[16];
+
+	b2.setValue(true);
+	ASSERT_TRUE(ILTagUtil::equals(b1, b1));
+	ASSERT_FALSE(ILTagUtil::equals(b1, b2));
+	b1.setValue(true);
+	ASSERT_TRUE(ILTagUtil::equals(b1, b2));
+
+	// Same size, distinct values
+	i1.setValue(1);
+	i2.setValue(2);
+	ASSERT_FALSE(ILTagUtil::equals(i1, i2));
+	i2.setValue(1);
+	ASSERT_TRUE(ILTagUtil::equals(i1, i2));
+	i2.setValue(0xFFFF);
+	ASSERT_FALSE(ILTagUtil::equals(i1, i2));
+
+	// Distinct classes with the same serialization
+	ASSERT_TRUE(r.value().writeILInt(0xFFFF));
+	ASSERT_TRUE(ILTagUtil::equals(i2, r));
+	ASSERT_TRUE(ILTagUtil::equals(r, i2));
+	ASSERT_FALSE(ILTagUtil::equals(i1, r));
+
+	// Floating points are compared bitwise
+	f1.setValue(0.0);
+	f2.setValue(-0.0);
+	ASSERT_FALSE(ILTagUtil::equals(f1, f2));
+	f1.setValue(std::numeric_limits<double>::quiet_NaN());
+	f2.setValue(std::numeric_limits<double>::quiet_NaN());
+	ASSERT_TRUE(ILTagUtil::equals(f1, f2));
+
+	s1.setValue("abcd");
+	s2.setValue("abce");
+	ASSERT_FALSE(ILTagUtil::equals(s1, s2));
+	s2.setValue("abcd");
+	ASSERT_TRUE(ILTagUtil::equals(s1, s2));
+
+	std::memset(buff, 0, sizeof(buff));
+	ASSERT_TRUE(o1.setValue(buff, sizeof(buff)));
+	ASSERT_TRUE(o2.setValue(buff, sizeof(buff)));
+	ASSERT_TRUE(ILTagUtil::equals(o1, o2));
+	buff[15] = 1;
+	ASSERT_TRUE(o2.setValue(buff, sizeof(buff)));
+	ASSERT_FALSE(ILTagUtil::equals(o1, o2));
+
+	ASSERT_TRUE(d1.setIntegral(buff, sizeof(buff)));
+	ASSERT_TRUE(d2.setIntegral(buff, sizeof(buff)));
+	ASSERT_TRUE(ILTagUtil::equals(d1, d2));
+	d2.setScale(1);
+	ASSERT_FALSE(ILTagUtil::equals(d1, d2));
+	d2.setScale(0);
+	buff[0] = 1;
+	ASSERT_TRUE(d2.setIntegral(buff, sizeof(buff)));
+	ASSERT_FALSE(ILTagUtil::equals(d1, d2));
+
+	ASSERT_TRUE(a1.add(1));
+	ASSERT_TRUE(a1.add(2));
+	ASSERT_TRUE(a2.add(1));
+	ASSERT_TRUE(a2.add(3));
+	ASSERT_FALSE(ILTagUtil::equals(a1, a2));
+	ASSERT_TRUE(a2.remove(1));
+	ASSERT_TRUE(a2.add(2));
+	ASSERT_TRUE(ILTagUtil::equals(a1, a2));
+}
@@ -20,6 +20,7 @@
 #include <memory>
 #include <algorithm>
 #include <chrono>
+#include <atomic>
 
 using namespace ircommon;
 using namespace ircommon::threading;
@@ -139,3 +140,93 @@ TEST_F(IRRWLockTest, Sync) {
 }
 //------------------------------------------------------------------------------
 
+
+//------------------------------------------------------------------------------
+TEST_F(IRRWLockTest, WriterNotStarved) {
+	IRRWLock lock;
+	std::vector< std::shared_ptr<std::thread> > threads;
+	std::atomic<bool> stop(false);
+
+	// Overlapping readers keep the lock busy all the time
+	for (int i = 0; i < 4; i++) {
+		threads.push_back(std::make_shared<std::thread>([&lock, &stop](){
+			while (!stop) {
+				lock.lockRead();
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				lock.unlockRead();
+			}
+		}));
+	}
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	for (int i = 0; i < 10; i++) {
+		lock.lockWrite();
+		lock.unlockWrite();
+	}
+	stop = true;
+	for (unsigned int i = 0; i < threads.size(); i++) {
+		threads[i]->join();
+	}
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRRWLockTest, ReaderNotStarved) {
+	IRRWLock lock;
+	std::vector< std::shared_ptr<std::thread> > threads;
+	std::atomic<bool> stop(false);
+
+	// Writers queue one after another all the time
+	for (int i = 0; i < 4; i++) {
+		threads.push_back(std::make_shared<std::thread>([&lock, &stop](){
+			while (!stop) {
+				lock.lockWrite();
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				lock.unlockWrite();
+			}
+		}));
+	}
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	for (int i = 0; i < 10; i++) {
+		lock.lockRead();
+		lock.unlockRead();
+	}
+	stop = true;
+	for (unsigned int i = 0; i < threads.size(); i++) {
+		threads[i]->join();
+	}
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRRWLockTest, Counter) {
+	IRRWLock lock;
+	std::vector< std::shared_ptr<std::thread> > threads;
+	std::atomic<int> errors(0);
+	int a = 0;
+	int b = 0;
+
+	// Writers keep a == b; readers must never see them different
+	for (int i = 0; i < 8; i++) {
+		threads.push_back(std::make_shared<std::thread>([&lock, &errors, &a, &b, i](){
+			for (int j = 0; j < 20000; j++) {
+				if (((i + j) % 4) == 0) {
+					lock.lockWrite();
+					a++;
+					b++;
+					lock.unlockWrite();
+				} else {
+					lock.lockRead();
+					if (a != b) {
+						errors++;
+					}
+					lock.unlockRead();
+				}
+			}
+		}));
+	}
+	for (unsigned int i = 0; i < threads.size(); i++) {
+		threads[i]->join();
+	}
+	ASSERT_EQ(0, errors);
+	ASSERT_EQ(40000, a);
+	ASSERT_EQ(40000, b);
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "IRThreadLocalRandomTest.h"
+#include "../IRDummyRandom.h"
+#include <ircommon/irtlrand.h>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace ircommon;
+using namespace ircommon::threading;
+
+//------------------------------------------------------------------------------
+static IRRandom * IRThreadLocalRandomTest_createXORShift() {
+	return new IRXORShifRandom();
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Creates the generator expected to be forked by the first thread that uses
+ * an IRThreadLocalRandom whose parent is IRXORShifRandom(parentSeed).
+ */
+static void IRThreadLocalRandomTest_firstFork(std::uint64_t parentSeed,
+		IRXORShifRandom & child) {
+	IRXORShifRandom parent(parentSeed);
+	std::uint8_t seed[IRThreadLocalRandom::SEED_SIZE];
+
+	parent.nextBytes(seed, sizeof(seed));
+	child.setSeed(seed, sizeof(seed));
+}
+
+//==============================================================================
+// class IRThreadLocalRandomTest
+//------------------------------------------------------------------------------
+IRThreadLocalRandomTest::IRThreadLocalRandomTest() {
+}
+
+//------------------------------------------------------------------------------
+IRThreadLocalRandomTest::~IRThreadLocalRandomTest() {
+}
+
+//------------------------------------------------------------------------------
+void IRThreadLocalRandomTest::SetUp() {
+}
+
+//------------------------------------------------------------------------------
+void IRThreadLocalRandomTest::TearDown() {
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRThreadLocalRandomTest, Constructor) {
+	IRThreadLocalRandom * r;
+
+	r = new IRThreadLocalRandom(new IRDummyRandom(),
+			IRThreadLocalRandomTest_createXORShift);
+	ASSERT_EQ(0, r->bufferSize());
+	ASSERT_EQ(0, r->forkCount());
+	delete r;
+
+	r = new IRThreadLocalRandom(new IRDummyRandom(),
+			IRThreadLocalRandomTest_createXORShift, 128);
+	ASSERT_EQ(128, r->bufferSize());
+	ASSERT_EQ(0, r->forkCount());
+	delete r;
+
+	ASSERT_THROW(IRThreadLocalRandom(nullptr,
+			IRThreadLocalRandomTest_createXORShift), std::invalid_argument);
+	ASSERT_THROW(IRThreadLocalRandom(new IRDummyRandom(), nullptr),
+			std::invalid_argument);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRThreadLocalRandomTest, fork) {
+	IRThreadLocalRandom r(new IRXORShifRandom(1234),
+			IRThreadLocalRandomTest_createXORShift);
+	IRXORShifRandom exp;
+
+	IRThreadLocalRandomTest_firstFork(1234, exp);
+	for (int i = 0; i < 16; i++) {
+		ASSERT_EQ(exp.next64(), r.next64());
+		ASSERT_EQ(exp.next32(), r.next32());
+		ASSERT_EQ(exp.next16(), r.next16());
+		ASSERT_EQ(exp.next(), r.next());
+		ASSERT_EQ(exp.nextBoolean(), r.nextBoolean());
+		ASSERT_EQ(exp.nextFloat(), r.nextFloat());
+		ASSERT_EQ(exp.nextDouble(), r.nextDouble());
+	}
+	ASSERT_EQ(1, r.forkCount());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRThreadLocalRandomTest, forkThreads) {
+	IRThreadLocalRandom r(new IRXORShifRandom(1234),
+			IRThreadLocalRandomTest_createXORShift);
+	std::vector<std::shared_ptr<std::thread>> threads;
+	std::uint8_t out[8][32];
+
+	for (int i = 0; i < 8; i++) {
+		threads.push_back(std::make_shared<std::thread>([&r, &out, i]() {
+			r.nextBytes(out[i], sizeof(out[i]));
+		}));
+	}
+	for (unsigned int i = 0; i < threads.size(); i++) {
+		threads[i]->join();
+	}
+	// The slots are released when the threads exit
+	ASSERT_EQ(0, r.forkCount());
+	for (int i = 0; i < 8; i++) {
+		for (int j = i + 1; j < 8; j++) {
+			ASSERT_NE(0, std::memcmp(out[i], out[j], sizeof(out[i])));
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRThreadLocalRandomTest, multipleInstances) {
+	IRThreadLocalRandom r1(new IRXORShifRandom(1234),
+			IRThreadLocalRandomTest_createXORShift);
+	IRThreadLocalRandom r2(new IRXORShifRandom(5678),
+			IRThreadLocalRandomTest_createXORShift);
+	IRXORShifRandom exp1;
+	IRXORShifRandom exp2;
+
+	IRThreadLocalRandomTest_firstFork(1234, exp1);
+	IRThreadLocalRandomTest_firstFork(5678, exp2);
+	for (int i = 0; i < 16; i++) {
+		ASSERT_EQ(exp1.next64(), r1.next64());
+		ASSERT_EQ(exp2.next64(), r2.next64());
+	}
+
+	// A new instance never reuses the slots of a disposed one
+	for (int i = 0; i < 4; i++) {
+		IRThreadLocalRandom r3(new IRXORShifRandom(i),
+				IRThreadLocalRandomTest_createXORShift);
+		IRXORShifRandom exp3;
+		IRThreadLocalRandomTest_firstFork(i, exp3);
+		ASSERT_EQ(exp3.next64(), r3.next64());
+		ASSERT_EQ(1, r3.forkCount());
+	}
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRThreadLocalRandomTest, setSeed) {
+	IRThreadLocalRandom r(new IRXORShifRandom(1234),
+			IRThreadLocalRandomTest_createXORShift, 64);
+	IRXORShifRandom exp;
+	std::uint8_t seed[16];
+	std::uint64_t v;
+
+	r.next64();
+	r.setSeed(0x0123456789ABCDEFll);
+	exp.setSeed(0x0123456789ABCDEFll);
+	for (int i = 0; i < 16; i++) {
+		ASSERT_EQ(exp.next64(), r.next64());
+	}
+
+	for (unsigned int i = 0; i < sizeof(seed); i++) {
+		seed[i] = i;
+	}
+	r.setSeed(seed, sizeof(seed));
+	exp.setSeed(seed, sizeof(seed));
+	for (int i = 0; i < 16; i++) {
+		ASSERT_EQ(exp.next64(), r.next64());
+	}
+
+	// Other threads are not affected
+	std::thread t([&r, &v]() {
+		v = r.next64();
+	});
+	t.join();
+	ASSERT_EQ(1, r.forkCount());
+	exp.setSeed(seed, sizeof(seed));
+	ASSERT_NE(exp.next64(), v);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRThreadLocalRandomTest, nextBytesBuffered) {
+	IRThreadLocalRandom r(new IRXORShifRandom(1234),
+			IRThreadLocalRandomTest_createXORShift, 64);
+	IRXORShifRandom exp;
+	std::uint8_t expOut[4096];
+	std::uint8_t out[4096];
+	unsigned int offs;
+
+	// Requests smaller than the buffer follow the stream of the generator
+	IRThreadLocalRandomTest_firstFork(1234, exp);
+	exp.nextBytes(expOut, sizeof(expOut));
+	offs = 0;
+	for (unsigned int size = 0; offs + size <= sizeof(out); size = (size + 7) % 64) {
+		r.nextBytes(out + offs, size);
+		offs += size;
+	}
+	ASSERT_EQ(0, std::memcmp(expOut, out, offs));
+
+	// Large requests bypass the buffer
+	IRThreadLocalRandom r2(new IRXORShifRandom(1234),
+			IRThreadLocalRandomTest_createXORShift, 64);
+	r2.nextBytes(out, 1000);
+	ASSERT_EQ(0, std::memcmp(expOut, out, 1000));
+	r2.nextBytes(out, 10);
+	ASSERT_EQ(0, std::memcmp(expOut + 1000, out, 10));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRThreadLocalRandomTest, threadChurn) {
+	IRThreadLocalRandom r(new IRXORShifRandom(1234),
+			IRThreadLocalRandomTest_createXORShift, 64);
+	int forks[64];
+
+	r.next64();
+	for (int i = 0; i < 64; i++) {
+		std::thread t([&r, &forks, i]() {
+			r.next64();
+			forks[i] = r.forkCount();
+		});
+		t.join();
+	}
+	for (int i = 0; i < 64; i++) {
+		ASSERT_EQ(2, forks[i]);
+	}
+	ASSERT_EQ(1, r.forkCount());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRThreadLocalRandomTest, threadCache) {
+	std::size_t initial;
+
+	initial = IRThreadLocalRandom::threadCacheSize();
+
+	// The current thread purges its own entries
+	for (int i = 0; i < 16; i++) {
+		IRThreadLocalRandom r(new IRXORShifRandom(i),
+				IRThreadLocalRandomTest_createXORShift);
+		r.next64();
+		ASSERT_EQ(initial + 1, IRThreadLocalRandom::threadCacheSize());
+	}
+	ASSERT_EQ(initial, IRThreadLocalRandom::threadCacheSize());
+
+	// Other threads purge theirs on their next fork
+	std::unique_ptr<IRThreadLocalRandom> r1(new IRThreadLocalRandom(
+			new IRXORShifRandom(1), IRThreadLocalRandomTest_createXORShift));
+	IRThreadLocalRandom r2(new IRXORShifRandom(2),
+			IRThreadLocalRandomTest_createXORShift);
+	std::promise<void> used;
+	std::promise<void> disposed;
+	std::size_t sizes[3];
+	std::thread t([&r1, &r2, &sizes, &used, &disposed]() {
+		r1->next64();
+		sizes[0] = IRThreadLocalRandom::threadCacheSize();
+		used.set_value();
+		disposed.get_future().wait();
+		sizes[1] = IRThreadLocalRandom::threadCacheSize();
+		r2.next64();
+		sizes[2] = IRThreadLocalRandom::threadCacheSize();
+	});
+	used.get_future().wait();
+	r1.reset();
+	disposed.set_value();
+	t.join();
+	ASSERT_EQ(1, sizes[0]);
+	ASSERT_EQ(1, sizes[1]);
+	ASSERT_EQ(1, sizes[2]);
+	ASSERT_EQ(0, r2.forkCount());
+}
+
+//------------------------------------------------------------------------------
@@ -150,6 +150,47 @@ public:
 	static int decode(const void * inp, int inpSize, uint64_t & v) {
 		return decode(inp, inpSize, &v);
 	}
+
+	/**
+	 * Returns the number of bytes required to encode a sequence of values.
+	 *
+	 * @param[in] values The values.
+	 * @param[in] count The number of values.
+	 * @return The number of bytes required to encode all values.
+	 * @since 2018.04.24
+	 */
+	static std::uint64_t size(const std::uint64_t * values,
+			std::uint64_t count);
+
+	/**
+	 * Encodes a sequence of values. The encoded values are written
+	 * contiguously. The contents of out after the returned size are
+	 * undefined.
+	 *
+	 * @param[in] values The values.
+	 * @param[in] count The number of values.
+	 * @param[out] out The output buffer.
+	 * @param[in] outSize The size of out in bytes.
+	 * @return The number of bytes used or 0 in case of failure or if count
+	 * is 0.
+	 * @since 2018.04.24
+	 */
+	static std::uint64_t encodeMany(const std::uint64_t * values,
+			std::uint64_t count, void * out, std::uint64_t outSize);
+
+	/**
+	 * Decodes a sequence of contiguous values.
+	 *
+	 * @param[in] inp The encoded values.
+	 * @param[in] inpSize The size of inp in bytes.
+	 * @param[out] values The decoded values.
+	 * @param[in] count The number of values to decode.
+	 * @return The number of bytes read from inp or 0 in case of failure or if
+	 * count is 0.
+	 * @since 2018.04.24
+	 */
+	static std::uint64_t decodeMany(const void * inp, std::uint64_t inpSize,
+			std::uint64_t * values, std::uint64_t count);
 };
 
 } //namespace ircommon
@@ -19,13 +19,18 @@
 #include <cstdint>
 #include <vector>
 #include <memory>
+#include <atomic>
+#include <mutex>
 #include <ircommon/irbuffer.h>
+#include <ircommon/iltagarena.h>
 
 namespace ircommon {
 namespace iltags {
 
 // Pre-declaration of ILTagFactory
 class ILTagFactory;
+class ILTagOutput;
+class ILTagStreamWriter;
 
 /**
  * This abstract class is the base class for all ILTags implemented by this
@@ -159,6 +164,23 @@ private:
 	 * The tag ID.
 	 */
 	std::uint64_t _tagID;
+
+	/**
+	 * The value of size() computed during the serialization pass
+	 * _cachedSizePass.
+	 *
+	 * <p>Both fields are atomic because const serializations of the same tag
+	 * may run on multiple threads, each with its own pass. Since the tag
+	 * cannot change while any pass is active, every thread stores the same
+	 * value here, thus no ordering between the fields is required.</p>
+	 */
+	mutable std::atomic<std::uint64_t> _cachedSize;
+
+	/**
+	 * The serialization pass that computed _cachedSize. 0 means that no value
+	 * is cached.
+	 */
+	mutable std::atomic<std::uint64_t> _cachedSizePass;
 protected:
 	/**
 	 * Serializes the value of this tag.  The serialization must be written to
@@ -171,6 +193,27 @@ protected:
 	 * tag.
 	 */
 	virtual bool serializeValue(ircommon::IRBuffer & out) const = 0;
+
+	/**
+	 * Writes the value of this tag to a stream writer. It is called by
+	 * ILTagStreamWriter right after the header of this tag is written.
+	 *
+	 * <p>The default implementation serializes the value into a temporary
+	 * secure buffer, since the value may be secret. Tags that hold other tags
+	 * or large values should override this method to write their contents
+	 * directly to the writer. All standard tags do so.</p>
+	 *
+	 * <p>Subclasses of classes that override this method, like ILRawTag and
+	 * ILBaseTagListTag, must override it as well if they change the output
+	 * of serializeValue().</p>
+	 *
+	 * @param[in] out The writer.
+	 * @return true for success or false otherwise.
+	 * @since 2018.04.26
+	 */
+	virtual bool writeValue(ILTagStreamWriter & out) const;
+
+	friend class ILTagStreamWriter;
 public:
 	/**
 	 * Creates a new instance of this class.
@@ -184,6 +227,29 @@ public:
 	 */
 	virtual ~ILTag() = default;
 
+	/**
+	 * Allocates the memory of a new tag. The memory will be allocated inside
+	 * the ILTagArena active in the current thread or in the heap if there is
+	 * none.
+	 *
+	 * @param[in] size The size of the instance.
+	 * @return The allocated memory.
+	 * @since 2018.04.22
+	 */
+	static void * operator new(std::size_t size) {
+		return ILTagArena::allocateObject(size);
+	}
+
+	/**
+	 * Releases the memory of a tag.
+	 *
+	 * @param[in] ptr The memory to be released.
+	 * @since 2018.04.22
+	 */
+	static void operator delete(void * ptr) {
+		ILTagArena::releaseObject(ptr);
+	}
+
 	/**
 	 * Returns the ID of this tag.
 	 *
@@ -200,10 +266,24 @@ public:
 	 */
 	virtual std::uint64_t size() const = 0;
 
+	/**
+	 * Returns the size of the serialized value in bytes. Inside an
+	 * ILTagSizeCache scope, size() is called only once and its value is reused
+	 * by all subsequent calls.
+	 *
+	 * @return The size of the value.
+	 * @since 2018.04.19
+	 */
+	std::uint64_t cachedSize() const;
+
 	/**
 	 * Returns the total size of the serialized tag, including the Id, the size
 	 * (if required) and the size of the value.
 	 *
+	 * <p>This method uses cachedSize() to determine the size of the value, so
+	 * the size of nested tags is computed only once inside an ILTagSizeCache
+	 * scope.</p>
+	 *
 	 * @return The total size of the tag in bytes.
 	 */
 	std::uint64_t tagSize() const;
@@ -212,10 +292,42 @@ public:
 	 * Serializes this tag. The serialization must be written to the current
 	 * position of the buffer out.
 	 *
-	 * @param[out]
+	 * <p>This method runs inside an ILTagSizeCache scope, thus the size of
+	 * each inner tag is computed only once, making the serialization linear in
+	 * the size of the tag tree.</p>
+	 *
+	 * @param[out] out The output buffer.
+	 * @return true for success or false otherwise.
 	 */
 	bool serialize(ircommon::IRBuffer & out) const;
 
+	/**
+	 * Serializes this tag using a single memory allocation. The total size of
+	 * the tag is computed up front, the buffer out is reserved to hold it and
+	 * the serialization is written to the current position of out without
+	 * further growth of the buffer.
+	 *
+	 * <p>This method should be preferred over serialize() when the tag is
+	 * large or has many inner tags.</p>
+	 *
+	 * @param[out] out The output buffer. On failure, its size and position
+	 * are restored, thus bytes appended to it are discarded.
+	 * @return true for success or false otherwise.
+	 * @since 2018.04.19
+	 */
+	bool serializeTo(ircommon::IRBuffer & out) const;
+
+	/**
+	 * Serializes this tag to an output sink. The bytes are sent to the sink
+	 * as they are produced by ILTagStreamWriter, thus the serialization of
+	 * the whole tag is never held in memory.
+	 *
+	 * @param[out] out The output sink.
+	 * @return true for success or false otherwise.
+	 * @since 2018.04.26
+	 */
+	bool serialize(ILTagOutput & out) const;
+
 	/**
 	 * Deserializes the value of the tag.
 	 *
@@ -227,6 +339,23 @@ public:
 	virtual bool deserializeValue(const ILTagFactory & factory,
 			const void * buff, std::uint64_t size) = 0;
 
+	/**
+	 * Verifies if the value of this tag is equal to the value of another tag.
+	 * This method is called by ILTagUtil::equals() only after both tags are
+	 * known to share the same ID and size.
+	 *
+	 * <p>The default implementation compares the serialization of both
+	 * values. Subclasses should override it to compare their values in place
+	 * when the other tag has the same class, falling back to this
+	 * implementation otherwise. Subclasses that change the serialization of
+	 * their parents must override this method as well.</p>
+	 *
+	 * @param[in] other The other tag.
+	 * @return true if the values are equal or false otherwise.
+	 * @since 2018.04.26
+	 */
+	virtual bool equalsValue(const ILTag & other) const;
+
 	/**
 	 * Verifies if this tag is implicit or not.
 	 * @return true if this tag is implicit or false otherwise.
@@ -277,10 +406,55 @@ public:
 	static std::uint64_t getImplicitValueSize(std::uint64_t tagId);
 };
 
+/**
+ * This class implements a scope where the sizes of the ILTag instances are
+ * computed only once. It is used by ILTag::serialize() to avoid the
+ * recomputation of the size of the inner tags at each nesting level.
+ *
+ * <p>Scopes can be nested, but only the outermost scope of each thread starts
+ * a new serialization pass. All values cached by a pass are discarded once
+ * the pass ends, so tags may be freely modified between passes.</p>
+ *
+ * @since 2018.04.19
+ * @warning The tags must not be modified while a scope is active. The same
+ * tag instance may be serialized by multiple threads at the same time as long
+ * as none of them modifies it.
+ */
+class ILTagSizeCache {
+private:
+	/**
+	 * Flag that indicates if this scope started the current pass.
+	 */
+	bool _owner;
+public:
+	/**
+	 * Creates a new instance of this class. It starts a new serialization pass
+	 * if none is active in the current thread.
+	 */
+	ILTagSizeCache();
+
+	/**
+	 * Disposes this instance and ends the serialization pass if it was
+	 * started by this instance.
+	 */
+	~ILTagSizeCache();
+
+	/**
+	 * Returns the serialization pass active in the current thread.
+	 *
+	 * @return The current pass or 0 if there is no active pass.
+	 */
+	static std::uint64_t currentPass();
+};
+
 /**
  * This class implements the base class for all raw tags. The tag
  * information will be stored inside a IRBuffer to allow manipulation.
  *
+ * <p>When deserialized by a factory in view mode, the internal buffer
+ * becomes a read-only view of the source bytes. The first modification of
+ * the value copies these bytes into an internal buffer.</p>
+ *
  * @author Fabio Jun Takada Chino (fchino at opencs.com.br)
  * @since 2017.12.27
  */
@@ -289,6 +463,8 @@ protected:
 	ircommon::IRBuffer _value;
 
 	virtual bool serializeValue(ircommon::IRBuffer & out) const;
+
+	virtual bool writeValue(ILTagStreamWriter & out) const;
 public:
 	/**
 	 * Creates a new instance of this class.
@@ -299,7 +475,7 @@ public:
 	 */
 	ILRawTag(std::uint64_t id, bool secure = false,
 			std::uint64_t inc = ircommon::IRBuffer::DEFAULT_INCREMENT) :
-			ILTag(id), _value(0, secure, inc) {}
+			ILTag(id), _value(ircommon::IRBuffer::NO_STORAGE, secure, inc) {}
 
 	/**
 	 * Disposes this instance and releases all associated resources.
@@ -313,6 +489,8 @@ public:
 	virtual bool deserializeValue(const ILTagFactory & factory,
 			const void * buff, std::uint64_t size);
 
+	virtual bool equalsValue(const ILTag & other) const;
+
 	/**
 	 * Grants read-only access to the internal buffer.
 	 *
@@ -345,6 +523,17 @@ public:
 /**
  * This class implements the base class for all tag list tags.
  *
+ * <p>When deserialized by a factory in lazy mode, this class records only the
+ * position of each entry. Each entry will be decoded on its first access
+ * through get() or operator []. Entries not decoded yet are serialized
+ * directly from their original bytes.</p>
+ *
+ * <p>The framing of all entries is validated by deserializeValue(), but their
+ * values are validated only when they are decoded. The decoding performed by
+ * the const methods is guarded by an internal lock, thus a lazy list may be
+ * read by multiple threads at the same time. The non-const methods still
+ * require exclusive access to the instance.</p>
+ *
  * @author Fabio Jun Takada Chino (fchino at opencs.com.br)
  * @since 2018.02.16
  * @note As a safeguard, entries set to nullptr will be encoded as TAG_NULL.
@@ -353,11 +542,98 @@ class ILBaseTagListTag: public ILTag {
 public:
 	typedef std::shared_ptr<ILTag> SharedPointer;
 protected:
-	std::vector<SharedPointer> _list;
+	/**
+	 * Location of an entry inside the lazy value.
+	 *
+	 * @since 2018.04.21
+	 */
+	struct LazyEntry {
+		/**
+		 * Offset of the entry.
+		 */
+		std::uint64_t offset;
+		/**
+		 * Size of the entry or 0 if it is already decoded.
+		 */
+		std::uint64_t size;
+	};
+
+	mutable std::vector<SharedPointer> _list;
+
+	/**
+	 * Locations of the entries. It is either empty or has the same size of
+	 * _list.
+	 */
+	mutable std::vector<LazyEntry> _lazyEntries;
+
+	/**
+	 * Guards _list and _lazyEntries while the const methods decode the
+	 * entries. It exists only while there are entries not decoded yet.
+	 */
+	std::unique_ptr<std::mutex> _lazyLock;
+
+	/**
+	 * The serialized entries not decoded yet.
+	 */
+	std::unique_ptr<IRBuffer> _lazyValue;
+
+	/**
+	 * The factory used to decode the entries.
+	 */
+	const ILTagFactory * _lazyFactory;
 
 	virtual bool serializeValue(ircommon::IRBuffer & out) const;
 
+	virtual bool writeValue(ILTagStreamWriter & out) const;
+
 	std::uint64_t _maxEntries;
+
+	/**
+	 * Deserializes all entries found inside the given buffer. The current
+	 * entries are removed before the deserialization.
+	 *
+	 * @param[in] factory The tag factory.
+	 * @param[in] buff The buffer.
+	 * @param[in] size The size of the buffer.
+	 * @return true for success or false otherwise.
+	 * @since 2018.04.21
+	 */
+	bool deserializeEntries(const ILTagFactory & factory,
+			const void * buff, std::uint64_t size);
+
+	/**
+	 * Decodes an entry if it was not decoded yet.
+	 *
+	 * @param[in] idx The index of the entry.
+	 * @return true for success or false otherwise.
+	 * @since 2018.04.21
+	 */
+	bool decodeEntry(std::uint64_t idx) const;
+
+	/**
+	 * Returns the current state of an entry. It is safe to call this method
+	 * while other threads decode the entries of this instance.
+	 *
+	 * @param[in] idx The index of the entry.
+	 * @param[out] entry The location of the entry. Its size is set to 0 if
+	 * the entry is not pending.
+	 * @return The decoded entry. It is nullptr if the entry is pending or
+	 * null.
+	 * @since 2018.04.26
+	 */
+	const ILTag * entryState(std::uint64_t idx, LazyEntry & entry) const;
+
+	/**
+	 * Releases the information about the entries not decoded yet.
+	 *
+	 * @since 2018.04.21
+	 */
+	void releaseLazy() {
+		this->_lazyEntries.clear();
+		this->_lazyValue.reset();
+		this->_lazyFactory = nullptr;
+		this->_lazyLock.reset();
+	}
 public:
 	/**
 	 * Creates a new instance of this class.
@@ -367,7 +643,7 @@ public:
 	 */
 	ILBaseTagListTag(std::uint64_t id,
 			std::uint64_t maxEntries = 0xFFFFFFFFFFFFFFFFll) :
-		ILTag(id), _maxEntries(maxEntries){}
+		ILTag(id), _lazyFactory(nullptr), _maxEntries(maxEntries){}
 
 	/**
 	 * Disposes this instance and releases all associated resources.
@@ -388,6 +664,8 @@ public:
 	virtual bool deserializeValue(const ILTagFactory & factory,
 			const void * buff, std::uint64_t size);
 
+	virtual bool equalsValue(const ILTag & other) const;
+
 	/**
 	 * Adds a new tag to the end of the array.
 	 *
@@ -441,13 +719,35 @@ public:
 	 */
 	void clear() {
 		this->_list.clear();
+		this->releaseLazy();
 	}
 
+	/**
+	 * Verifies if the entry at a given position is still waiting to be
+	 * decoded.
+	 *
+	 * @param[in] idx The position.
+	 * @return true if the entry was not decoded yet or false otherwise.
+	 * @note No bound check is performed.
+	 * @since 2018.04.21
+	 */
+	bool pending(std::uint64_t idx) const;
+
+	/**
+	 * Decodes all entries not decoded yet. On success, the original bytes of
+	 * the entries are released.
+	 *
+	 * @return true for success or false otherwise.
+	 * @since 2018.04.21
+	 */
+	bool decodeAll();
+
 	/**
 	 * Grants read/write access to the tag a given position.
 	 *
 	 * @param[in] idx The position.
 	 * @return A reference to the SharedPointer that holds the tag.
+	 * @exception std::runtime_error If the entry cannot be decoded.
 	 * @note No bound check is performed.
 	 */
 	SharedPointer & operator [](std::uint64_t idx);
@@ -457,6 +757,7 @@ public:
 	 *
 	 * @param[in] idx The position.
 	 * @return A reference to the SharedPointer that holds the tag.
+	 * @exception std::runtime_error If the entry cannot be decoded.
 	 * @note No bound check is performed.
 	 */
 	const SharedPointer & operator [](std::uint64_t idx) const;
@@ -466,6 +767,8 @@ public:
 	 *
 	 * @param[in] idx The position.
 	 * @return A reference to the SharedPointer that holds the tag.
+	 * @exception std::out_of_range If idx is out of range.
+	 * @exception std::runtime_error If the entry cannot be decoded.
 	 */
 	SharedPointer & get(std::uint64_t idx);
 
@@ -474,6 +777,8 @@ public:
 	 *
 	 * @param[in] idx The position.
 	 * @return A reference to the SharedPointer that holds the tag.
+	 * @exception std::out_of_range If idx is out of range.
+	 * @exception std::runtime_error If the entry cannot be decoded.
 	 */
 	const SharedPointer & get(std::uint64_t idx) const;
 
@@ -510,6 +815,8 @@ protected:
 	std::vector<SharedPointer> _list;
 
 	virtual bool serializeValue(ircommon::IRBuffer & out) const;
+
+	virtual bool writeValue(ILTagStreamWriter & out) const;
 public:
 	/**
 	 * Creates a new instance of this class.
@@ -567,6 +874,18 @@ private:
 	 * Flag that indicates the state of the strict mode.
 	 */
 	bool _strictMode;
+	/**
+	 * Flag that indicates the state of the view mode.
+	 */
+	bool _viewMode;
+	/**
+	 * Flag that indicates the state of the lazy mode.
+	 */
+	bool _lazyMode;
+	/**
+	 * The arena used to allocate the new tags.
+	 */
+	ILTagArena * _arena;
 public:
 	/**
 	 * Creates a new instance of this class.
@@ -575,7 +894,8 @@ public:
 	 * @param[in] strictMode The strict mode state.
 	 */
 	ILTagFactory(bool secureMode = false, bool strictMode = false):
-		_secure(secureMode),_strictMode(strictMode) {};
+		_secure(secureMode),_strictMode(strictMode), _viewMode(false),
+		_lazyMode(false), _arena(nullptr) {};
 
 	/**
 	 * Disposes this instance and releases all associated resources.
@@ -644,6 +964,92 @@ public:
 		this->_strictMode = v;
 	}
 
+	/**
+	 * Returns the view mode status. If true, the tags that hold opaque values
+	 * will not copy them during the deserialization. Instead, they will hold
+	 * read-only views of the source bytes.
+	 *
+	 * <p>The view mode is disabled by default.</p>
+	 *
+	 * @return The value of flag view mode.
+	 * @note The caller must ensure that the source bytes remain unchanged
+	 * during the lifetime of the deserialized tags. Since the source bytes are
+	 * not owned by the tags, they will not be wiped even in secure mode.
+	 * @since 2018.04.20
+	 */
+	bool viewMode() const {
+		return this->_viewMode;
+	}
+
+	/**
+	 * Sets the state of the view mode.
+	 *
+	 * @param[in] v Use true to enable it or false otherwise.
+	 * @since 2018.04.20
+	 */
+	void setViewMode(bool v) {
+		this->_viewMode = v;
+	}
+
+	/**
+	 * Returns the lazy mode status. If true, the list tags will record only
+	 * the position of their entries during the deserialization. Each entry
+	 * will be decoded on its first access.
+	 *
+	 * <p>The lazy mode is disabled by default.</p>
+	 *
+	 * <p>The lazy mode is ignored while an arena is set. The entries would be
+	 * decoded later by any thread that reads them, but the arena may be used
+	 * only by the thread that owns it.</p>
+	 *
+	 * @return The value of flag lazy mode.
+	 * @note This instance will be used to decode the entries, thus it must
+	 * exist until all entries are decoded or the tags are disposed.
+	 * @since 2018.04.21
+	 */
+	bool lazyMode() const {
+		return this->_lazyMode;
+	}
+
+	/**
+	 * Sets the state of the lazy mode.
+	 *
+	 * @param[in] v Use true to enable it or false otherwise.
+	 * @since 2018.04.21
+	 */
+	void setLazyMode(bool v) {
+		this->_lazyMode = v;
+	}
+
+	/**
+	 * Returns the arena used to allocate the tags created by deserialize().
+	 *
+	 * @return The arena or null if the tags are allocated in the heap.
+	 * @since 2018.04.22
+	 */
+	ILTagArena * arena() const {
+		return this->_arena;
+	}
+
+	/**
+	 * Sets the arena used to allocate the tags created by deserialize(). If
+	 * set, the whole deserialized tree, including the control blocks of the
+	 * list entries, will be allocated inside the arena.
+	 *
+	 * <p>If the secure mode is enabled, the secure mode of the arena will
+	 * also be enabled during the deserialization.</p>
+	 *
+	 * <p>While an arena is set, the lazy mode is ignored and the lists are
+	 * always decoded eagerly.</p>
+	 *
+	 * @param[in] arena The arena or null to use the heap.
+	 * @note The arena must outlive all tags created by this factory.
+	 * @since 2018.04.22
+	 */
+	void setArena(ILTagArena * arena) {
+		this->_arena = arena;
+	}
+
 	/**
 	 * This method extracts the tag header from an IRBuffer. The header will
 	 * be read from the input buffer current position. On success, the position
@@ -702,12 +1108,13 @@ public:
 	static bool sameClass(const ILTag & a, const ILTag & b);
 
 	/**
-	 * Verifies if two ILTag instances are equal.
+	 * Verifies if two ILTag instances are equal, that is, if they would
+	 * produce the same serialization.
 	 *
-	 * <p>This is achieved by comparing their serializations. Because
-	 * of that, the use of this method should be avoided whenever
-	 * possible. The main motivation to this method is to ease
-	 * the creation of unit-tests regarding the tags.</p>
+	 * <p>The IDs and the sizes of the tags are compared first and the
+	 * values are compared by ILTag::equalsValue() only if they match. Tags
+	 * that do not override ILTag::equalsValue() are still compared by
+	 * serializing both values.</p>
 	 *
 	 * @param[in] a An ILTag.
 	 * @param[in] b Another ILTag.
@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _IRCOMMON_ILTAGARENA_H_
+#define _IRCOMMON_ILTAGARENA_H_
+
+#include <cstdint>
+#include <cstddef>
+
+namespace ircommon {
+namespace iltags {
+
+/**
+ * This class implements a monotonic memory arena used to hold ILTag
+ * instances. Each allocation is a single pointer bump inside the current
+ * chunk and individual deallocations are ignored. All memory is released
+ * at once by reset() or by the destructor.
+ *
+ * <p>Allocations are redirected to an arena only while it is active in the
+ * current thread (see ILTagArena::Scope). ILTagFactory does this
+ * automatically when an arena is set by ILTagFactory::setArena().</p>
+ *
+ * <p>If the secure mode is enabled, the used memory is wiped before being
+ * released or reused.</p>
+ *
+ * <p>Objects carry no header. The chunks of all arenas are carved from a
+ * single address range reserved on first use (16 GiB on 64-bit platforms),
+ * thus releaseObject() recognizes arena blocks with a range check, without
+ * locks or lookups. Memory is committed only for the chunks in use. Creating
+ * or releasing a chunk costs a system call.</p>
+ *
+ * <p>Only the tag objects themselves and the control blocks of the list
+ * entries are placed in the arena. Their internal storage, like IRBuffer
+ * contents, std::vector and std::string data or shared payloads, still comes
+ * from the heap and is released by the destructors.</p>
+ *
+ * <p>An arena has no internal lock and must be owned by a single thread at a
+ * time. Only that thread may allocate from it, reset it or destroy it.
+ * Objects allocated inside it may be deleted by any thread.</p>
+ *
+ * @since 2018.04.22
+ * @warning The arena must outlive all objects allocated inside it. The
+ * destructors of the objects are still called as usual, only the memory
+ * release is deferred. All objects must be destroyed before reset() is
+ * called, otherwise the heap memory they own leaks.
+ */
+class ILTagArena {
+public:
+	enum {
+		/**
+		 * Default size of each chunk.
+		 */
+		DEFAULT_CHUNK_SIZE = 64 * 1024
+	};
+
+	/**
+	 * This class activates an arena in the current thread during its
+	 * lifetime. The previous arena and the previous secure mode of the
+	 * arena are restored when this instance is destroyed.
+	 *
+	 * @since 2018.04.22
+	 */
+	class Scope {
+	private:
+		/**
+		 * The previous arena.
+		 */
+		ILTagArena * _previous;
+		/**
+		 * The arena activated by this scope.
+		 */
+		ILTagArena * _arena;
+		/**
+		 * The secure mode of _arena before this scope.
+		 */
+		bool _secure;
+	public:
+		/**
+		 * Creates a new instance of this class.
+		 *
+		 * @param[in] arena The arena to be activated or null to disable the
+		 * arenas in this scope.
+		 * @param[in] secure If true, the secure mode of the arena will be
+		 * enabled until the end of this scope. Blocks allocated meanwhile are
+		 * still wiped when the arena is reset or destroyed.
+		 */
+		Scope(ILTagArena * arena, bool secure = false);
+
+		/**
+		 * Restores the previous arena and the secure mode of the arena.
+		 */
+		~Scope();
+	};
+private:
+	/**
+	 * Header of each chunk. The data follows it.
+	 */
+	struct Chunk {
+		Chunk * next;
+		std::size_t size;
+		std::size_t capacity;
+	};
+
+	/**
+	 * The list of chunks. The first one is the current chunk.
+	 */
+	Chunk * _chunks;
+
+	/**
+	 * Position of the next allocation inside the current chunk.
+	 */
+	std::size_t _offset;
+
+	/**
+	 * Size of each new chunk.
+	 */
+	std::size_t _chunkSize;
+
+	/**
+	 * Total number of bytes allocated.
+	 */
+	std::uint64_t _used;
+
+	/**
+	 * The secure mode flag.
+	 */
+	bool _secure;
+
+	/**
+	 * Set if a block was allocated while the secure mode was enabled. The
+	 * memory must be wiped on the next reset even if the secure mode was
+	 * disabled meanwhile.
+	 */
+	bool _wipe;
+
+	/**
+	 * Returns the address of the data of a given chunk.
+	 *
+	 * @param[in] chunk The chunk.
+	 * @return The address of the data.
+	 */
+	static std::uint8_t * chunkData(Chunk * chunk);
+
+	/**
+	 * Releases a chunk.
+	 *
+	 * @param[in] chunk The chunk.
+	 * @param[in] used Number of bytes to wipe in secure mode.
+	 */
+	void releaseChunk(Chunk * chunk, std::size_t used);
+public:
+	/**
+	 * Creates a new instance of this class.
+	 *
+	 * @param[in] chunkSize The size of each chunk.
+	 * @param[in] secure The secure mode flag.
+	 * @exception std::invalid_argument If chunkSize is 0.
+	 */
+	ILTagArena(std::size_t chunkSize = DEFAULT_CHUNK_SIZE,
+			bool secure = false);
+
+	/**
+	 * Disposes this instance and releases all associated memory.
+	 */
+	virtual ~ILTagArena();
+
+	ILTagArena(const ILTagArena &) = delete;
+	ILTagArena & operator = (const ILTagArena &) = delete;
+
+	/**
+	 * Allocates a new block of memory. The block will be aligned to
+	 * alignof(std::max_align_t).
+	 *
+	 * @param[in] size The size of the block.
+	 * @return The block or null if it cannot be allocated.
+	 */
+	void * allocate(std::size_t size);
+
+	/**
+	 * Releases all blocks at once. The current chunk is kept for reuse.
+	 *
+	 * @warning All objects allocated by this arena must be already
+	 * destroyed.
+	 */
+	void reset();
+
+	/**
+	 * Returns the number of bytes allocated since the last reset().
+	 *
+	 * @return The number of bytes allocated.
+	 */
+	std::uint64_t used() const {
+		return this->_used;
+	}
+
+	/**
+	 * Returns the size of the chunks.
+	 *
+	 * @return The size of the chunks.
+	 */
+	std::size_t chunkSize() const {
+		return this->_chunkSize;
+	}
+
+	/**
+	 * Verifies if the secure mode is enabled.
+	 *
+	 * @return true if it is enabled or false otherwise.
+	 */
+	bool secure() const {
+		return this->_secure;
+	}
+
+	/**
+	 * Sets the secure mode.
+	 *
+	 * @param[in] v The new value.
+	 */
+	void setSecure(bool v) {
+		this->_secure = v;
+	}
+
+	/**
+	 * Returns the arena active in the current thread.
+	 *
+	 * @return The active arena or null if there is none.
+	 */
+	static ILTagArena * current();
+
+	/**
+	 * Allocates an object. It uses the active arena if available or the
+	 * heap otherwise. No header is added to the object.
+	 *
+	 * @param[in] size The size of the object.
+	 * @return The allocated memory.
+	 * @exception std::bad_alloc If the memory cannot be allocated.
+	 * @note The memory must be released by releaseObject().
+	 */
+	static void * allocateObject(std::size_t size);
+
+	/**
+	 * Releases the memory allocated by allocateObject(). Memory that belongs
+	 * to an arena is released only when the arena is reset or destroyed.
+	 * Other memory goes straight back to the heap.
+	 *
+	 * @param[in] ptr The memory to be released. It may be null.
+	 */
+	static void releaseObject(void * ptr);
+};
+
+/**
+ * Standard allocator that uses ILTagArena::allocateObject() and
+ * ILTagArena::releaseObject(). It can be used to place the control blocks of
+ * std::shared_ptr inside the active arena.
+ *
+ * @since 2018.04.22
+ */
+template <class T>
+class ILTagArenaAllocator {
+public:
+	typedef T value_type;
+
+	ILTagArenaAllocator() = default;
+
+	template <class U>
+	ILTagArenaAllocator(const ILTagArenaAllocator<U> &) {}
+
+	T * allocate(std::size_t n) {
+		return static_cast<T *>(ILTagArena::allocateObject(n * sizeof(T)));
+	}
+
+	void deallocate(T * p, std::size_t n) {
+		ILTagArena::releaseObject(p);
+	}
+};
+
+template <class T, class U>
+bool operator == (const ILTagArenaAllocator<T> &,
+		const ILTagArenaAllocator<U> &) {
+	return true;
+}
+
+template <class T, class U>
+bool operator != (const ILTagArenaAllocator<T> &,
+		const ILTagArenaAllocator<U> &) {
+	return false;
+}
+
+} // namespace iltags
+} // namespace ircommon
+
+#endif /* _IRCOMMON_ILTAGARENA_H_ */
@@ -17,6 +17,7 @@
 #define _IRCOMMON_ILTAGSTD_H_
 
 #include <ircommon/iltag.h>
+#include <ircommon/iltagstream.h>
 #include <ircommon/irutils.h>
 #include <ircommon/irfp.h>
 #include <cstring>
@@ -33,6 +34,8 @@ namespace iltags {
 class ILNullTag : public ILTag {
 protected:
 	virtual bool serializeValue(ircommon::IRBuffer & out) const;
+
+	virtual bool writeValue(ILTagStreamWriter & out) const;
 public:
 	ILNullTag() : ILTag(ILTag::TAG_NULL){}
 
@@ -44,6 +47,8 @@ public:
 
 	virtual bool deserializeValue(const ILTagFactory & factory,
 			const void * buff, std::uint64_t size);
+
+	virtual bool equalsValue(const ILTag & other) const;
 };
 
 /**
@@ -57,6 +62,8 @@ protected:
 	bool _value;
 
 	virtual bool serializeValue(ircommon::IRBuffer & out) const;
+
+	virtual bool writeValue(ILTagStreamWriter & out) const;
 public:
 	ILBoolTag() : ILTag(ILTag::TAG_BOOL), _value(false){}
 
@@ -67,6 +74,8 @@ public:
 	virtual bool deserializeValue(const ILTagFactory & factory,
 			const void * buff, std::uint64_t size);
 
+	virtual bool equalsValue(const ILTag & other) const;
+
 	/**
 	 * Returns the value of this tag.
 	 *
@@ -107,6 +116,13 @@ protected:
 	virtual bool serializeValue(ircommon::IRBuffer & out) const {
 		return out.writeInt(this->_value);
 	}
+
+	virtual bool writeValue(ILTagStreamWriter & out) const {
+		std::uint8_t buff[sizeof(ValueType)];
+
+		IRUtils::int2BE(this->_value, buff);
+		return out.writeBody(buff, sizeof(buff));
+	}
 public:
 	ILBasicIntTag() : ILTag(TagID), _value(0) {}
 	virtual ~ILBasicIntTag() = default;
@@ -125,6 +141,15 @@ public:
 		return true;
 	}
 
+	virtual bool equalsValue(const ILTag & other) const {
+
+		if (!ILTagUtil::sameClass(*this, other)) {
+			return ILTag::equalsValue(other);
+		}
+		return (this->_value ==
+				static_cast<const ILBasicIntTag &>(other)._value);
+	}
+
 	/**
 	 * Returns the value of this tag.
 	 *
@@ -219,6 +244,8 @@ protected:
 	std::uint64_t _value;
 
 	virtual bool serializeValue(ircommon::IRBuffer & out) const;
+
+	virtual bool writeValue(ILTagStreamWriter & out) const;
 public:
 	ILILIntTag() : ILTag(ILTag::TAG_ILINT64), _value(false){}
 
@@ -229,6 +256,8 @@ public:
 	virtual bool deserializeValue(const ILTagFactory & factory,
 			const void * buff, std::uint64_t size);
 
+	virtual bool equalsValue(const ILTag & other) const;
+
 	/**
 	 * Returns the value of this tag.
 	 *
@@ -269,6 +298,13 @@ protected:
 	virtual bool serializeValue(ircommon::IRBuffer & out) const {
 		return out.writeFloat(this->_value);
 	}
+
+	virtual bool writeValue(ILTagStreamWriter & out) const {
+		std::uint8_t buff[sizeof(ValueType)];
+
+		IRFloatingPoint::toBytes(true, this->_value, buff);
+		return out.writeBody(buff, sizeof(buff));
+	}
 public:
 	ILBasicFloatTag() : ILTag(TagID),_value(0){}
 	virtual ~ILBasicFloatTag() = default;
@@ -287,6 +323,17 @@ public:
 		return true;
 	}
 
+	virtual bool equalsValue(const ILTag & other) const {
+
+		if (!ILTagUtil::sameClass(*this, other)) {
+			return ILTag::equalsValue(other);
+		}
+		// Compare the bits as the serialization does, so NaN equals NaN.
+		return (std::memcmp(&this->_value,
+				&static_cast<const ILBasicFloatTag &>(other)._value,
+				sizeof(ValueType)) == 0);
+	}
+
 	/**
 	 * Returns the value of this tag.
 	 *
@@ -333,6 +380,8 @@ protected:
 	std::string _value;
 
 	virtual bool serializeValue(ircommon::IRBuffer & out) const;
+
+	virtual bool writeValue(ILTagStreamWriter & out) const;
 public:
 	ILStringTag() : ILTag(ILTag::TAG_STRING), _value(){}
 
@@ -343,6 +392,8 @@ public:
 	virtual bool deserializeValue(const ILTagFactory & factory,
 			const void * buff, std::uint64_t size);
 
+	virtual bool equalsValue(const ILTag & other) const;
+
 	/**
 	 * Returns the value of this tag.
 	 *
@@ -404,6 +455,10 @@ protected:
 	virtual bool serializeValue(ircommon::IRBuffer & out) const {
 		return out.write(this->_value, ValueSize);
 	}
+
+	virtual bool writeValue(ILTagStreamWriter & out) const {
+		return out.writeBody(this->_value, ValueSize);
+	}
 public:
 	ILBasicFixedOpaqueTag() : ILTag(TagID){}
 
@@ -418,6 +473,16 @@ public:
 		return this->setValue(buff, size);
 	}
 
+	virtual bool equalsValue(const ILTag & other) const {
+
+		if (!ILTagUtil::sameClass(*this, other)) {
+			return ILTag::equalsValue(other);
+		}
+		return (std::memcmp(this->_value,
+				static_cast<const ILBasicFixedOpaqueTag &>(other)._value,
+				ValueSize) == 0);
+	}
+
 	/**
 	 * Returns the value of this tag. It always have size() bytes in length.
 	 *
@@ -498,9 +563,11 @@ private:
 	std::int32_t _scale;
 protected:
 	virtual bool serializeValue(ircommon::IRBuffer & out) const;
+
+	virtual bool writeValue(ILTagStreamWriter & out) const;
 public:
 	ILBigDecimalTag(bool secureMode = false) : ILTag(ILTag::TAG_BDEC),
-			_integral(0, secureMode), _scale(0) {}
+			_integral(IRBuffer::NO_STORAGE, secureMode), _scale(0) {}
 
 	virtual ~ILBigDecimalTag() = default;
 
@@ -509,6 +576,8 @@ public:
 	virtual bool deserializeValue(const ILTagFactory & factory,
 			const void * buff, std::uint64_t size);
 
+	virtual bool equalsValue(const ILTag & other) const;
+
 	/**
 	 * Returns the scale of this big decimal.
 	 *
@@ -553,6 +622,8 @@ private:
 	std::vector<std::uint64_t> _values;
 protected:
 	virtual bool serializeValue(ircommon::IRBuffer & out) const;
+
+	virtual bool writeValue(ILTagStreamWriter & out) const;
 public:
 	/**
 	 * Creates a new instance of this class.
@@ -569,6 +640,8 @@ public:
 	virtual bool deserializeValue(const ILTagFactory & factory,
 			const void * buff, std::uint64_t size);
 
+	virtual bool equalsValue(const ILTag & other) const;
+
 	/**
 	 * Returns the number of elements.
 	 *
@@ -0,0 +1,633 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _IRCOMMON_ILTAGSTREAM_H_
+#define _IRCOMMON_ILTAGSTREAM_H_
+
+#include <cstdint>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <ircommon/iltag.h>
+
+namespace ircommon {
+namespace iltags {
+
+/**
+ * This is the base class for all input sources used by ILTagStreamReader.
+ *
+ * @since 2018.04.23
+ */
+class ILTagInput {
+public:
+	/**
+	 * Disposes this instance and releases all associated resources.
+	 */
+	virtual ~ILTagInput() = default;
+
+	/**
+	 * Reads exactly size bytes from the source.
+	 *
+	 * @param[out] buff The output buffer.
+	 * @param[in] size The number of bytes to read.
+	 * @return true for success or false if the bytes are not available.
+	 */
+	virtual bool read(void * buff, std::uint64_t size) = 0;
+
+	/**
+	 * Skips exactly size bytes from the source. The default implementation
+	 * reads the bytes and discards them.
+	 *
+	 * @param[in] size The number of bytes to skip.
+	 * @return true for success or false if the bytes are not available.
+	 */
+	virtual bool skip(std::uint64_t size);
+
+	/**
+	 * Verifies if the source has no more bytes. It may block until a byte is
+	 * available. The default implementation returns false, thus the end of
+	 * sources that do not override it is reported as an error.
+	 *
+	 * @return true if there are no more bytes or false otherwise.
+	 * @since 2018.04.26
+	 */
+	virtual bool atEnd();
+};
+
+/**
+ * This is the base class for all output sinks used by ILTagStreamWriter.
+ *
+ * @since 2018.04.23
+ */
+class ILTagOutput {
+public:
+	/**
+	 * Disposes this instance and releases all associated resources.
+	 */
+	virtual ~ILTagOutput() = default;
+
+	/**
+	 * Writes the given bytes to the sink.
+	 *
+	 * @param[in] buff The bytes to be written.
+	 * @param[in] size The number of bytes.
+	 * @return true for success or false otherwise.
+	 */
+	virtual bool write(const void * buff, std::uint64_t size) = 0;
+};
+
+/**
+ * Input source that reads from a memory region. It can be used with files
+ * mapped into memory.
+ *
+ * @since 2018.04.23
+ */
+class ILTagMemoryInput: public ILTagInput {
+private:
+	const std::uint8_t * _buff;
+	std::uint64_t _size;
+	std::uint64_t _position;
+public:
+	/**
+	 * Creates a new instance of this class.
+	 *
+	 * @param[in] buff The memory region. It must exist during the lifetime of
+	 * this instance.
+	 * @param[in] size The size of the memory region.
+	 */
+	ILTagMemoryInput(const void * buff, std::uint64_t size):
+			_buff((const std::uint8_t *)buff), _size(size), _position(0) {}
+
+	virtual ~ILTagMemoryInput() = default;
+
+	virtual bool read(void * buff, std::uint64_t size);
+
+	virtual bool skip(std::uint64_t size);
+
+	virtual bool atEnd();
+
+	/**
+	 * Returns the current position inside the memory region.
+	 *
+	 * @return The current position.
+	 */
+	std::uint64_t position() const {
+		return this->_position;
+	}
+};
+
+/**
+ * Input source that reads from a std::istream.
+ *
+ * @since 2018.04.23
+ */
+class ILTagIStreamInput: public ILTagInput {
+private:
+	std::istream & _in;
+public:
+	/**
+	 * Creates a new instance of this class.
+	 *
+	 * @param[in] in The input stream.
+	 */
+	ILTagIStreamInput(std::istream & in): _in(in) {}
+
+	virtual ~ILTagIStreamInput() = default;
+
+	virtual bool read(void * buff, std::uint64_t size);
+
+	virtual bool skip(std::uint64_t size);
+
+	virtual bool atEnd();
+};
+
+/**
+ * Output sink that writes to a std::ostream.
+ *
+ * @since 2018.04.23
+ */
+class ILTagOStreamOutput: public ILTagOutput {
+private:
+	std::ostream & _out;
+public:
+	/**
+	 * Creates a new instance of this class.
+	 *
+	 * @param[in] out The output stream.
+	 */
+	ILTagOStreamOutput(std::ostream & out): _out(out) {}
+
+	virtual ~ILTagOStreamOutput() = default;
+
+	virtual bool write(const void * buff, std::uint64_t size);
+};
+
+/**
+ * Output sink that writes to an IRBuffer.
+ *
+ * @since 2018.04.26
+ */
+class ILTagBufferOutput: public ILTagOutput {
+private:
+	IRBuffer & _out;
+public:
+	/**
+	 * Creates a new instance of this class.
+	 *
+	 * @param[in] out The output buffer. The bytes are written to its current
+	 * position.
+	 */
+	ILTagBufferOutput(IRBuffer & out): _out(out) {}
+
+	virtual ~ILTagBufferOutput() = default;
+
+	virtual bool write(const void * buff, std::uint64_t size);
+};
+
+/**
+ * Output sink that sends the same bytes to two other sinks. It can be used
+ * to store a tag and compute its hash in a single pass.
+ *
+ * @since 2018.04.26
+ */
+class ILTagTeeOutput: public ILTagOutput {
+private:
+	ILTagOutput & _first;
+	ILTagOutput & _second;
+public:
+	/**
+	 * Creates a new instance of this class.
+	 *
+	 * @param[in] first The first sink.
+	 * @param[in] second The second sink.
+	 */
+	ILTagTeeOutput(ILTagOutput & first, ILTagOutput & second):
+			_first(first), _second(second) {}
+
+	virtual ~ILTagTeeOutput() = default;
+
+	virtual bool write(const void * buff, std::uint64_t size);
+};
+
+/**
+ * Input source that reads from a file descriptor.
+ *
+ * @since 2018.04.23
+ */
+class ILTagFDInput: public ILTagInput {
+private:
+	int _fd;
+
+	/**
+	 * Flag that indicates that _peek holds a byte read by atEnd().
+	 */
+	bool _hasPeek;
+
+	/**
+	 * The byte read by atEnd().
+	 */
+	std::uint8_t _peek;
+public:
+	/**
+	 * Creates a new instance of this class.
+	 *
+	 * @param[in] fd The file descriptor. It will not be closed by this
+	 * instance.
+	 */
+	ILTagFDInput(int fd): _fd(fd), _hasPeek(false), _peek(0) {}
+
+	virtual ~ILTagFDInput() = default;
+
+	virtual bool read(void * buff, std::uint64_t size);
+
+	virtual bool atEnd();
+};
+
+/**
+ * Output sink that writes to a file descriptor.
+ *
+ * @since 2018.04.23
+ */
+class ILTagFDOutput: public ILTagOutput {
+private:
+	int _fd;
+public:
+	/**
+	 * Creates a new instance of this class.
+	 *
+	 * @param[in] fd The file descriptor. It will not be closed by this
+	 * instance.
+	 */
+	ILTagFDOutput(int fd): _fd(fd) {}
+
+	virtual ~ILTagFDOutput() = default;
+
+	virtual bool write(const void * buff, std::uint64_t size);
+};
+
+/**
+ * This class implements a pull-based reader of tags. It reads the tag headers
+ * one by one and lets the caller decide if the body of each tag will be
+ * skipped, read incrementally, deserialized or entered to walk the inner
+ * tags.
+ *
+ * <p>Only the bytes requested by the caller are kept in memory, thus it can
+ * be used to process sources much larger than the available memory.</p>
+ *
+ * <p>When next() returns false, hasError() tells a corrupted or truncated
+ * input apart from the end of the current level, and eof() tells if the
+ * end of the input was reached cleanly. Once an error is found, all
+ * further operations fail.</p>
+ *
+ * @since 2018.04.23
+ */
+class ILTagStreamReader {
+private:
+	/**
+	 * The input source.
+	 */
+	ILTagInput & _in;
+
+	/**
+	 * Bytes not consumed yet of each entered tag.
+	 */
+	std::vector<std::uint64_t> _levels;
+
+	/**
+	 * Bytes not consumed yet of the body of the current tag.
+	 */
+	std::uint64_t _remaining;
+
+	/**
+	 * Flag that indicates that the first byte of the body was already read.
+	 * It happens only with TAG_ILINT64.
+	 */
+	bool _hasPeek;
+
+	/**
+	 * The first byte of the body if _hasPeek is true.
+	 */
+	std::uint8_t _peek;
+
+	/**
+	 * Flag that indicates that the input is corrupted, truncated or could
+	 * not be read.
+	 */
+	bool _error;
+
+	/**
+	 * Flag that indicates that the end of the input was reached between
+	 * top level tags.
+	 */
+	bool _eof;
+
+	/**
+	 * The ID of the current tag.
+	 */
+	std::uint64_t _tagId;
+
+	/**
+	 * The size of the body of the current tag.
+	 */
+	std::uint64_t _tagSize;
+
+	/**
+	 * Reads bytes from the input and updates the current level.
+	 *
+	 * @param[out] buff The output buffer.
+	 * @param[in] size The number of bytes.
+	 * @return true for success or false otherwise.
+	 */
+	bool readHeaderBytes(void * buff, std::uint64_t size);
+
+	/**
+	 * Reads an ILInt from the header of the tag.
+	 *
+	 * @param[out] v The value read.
+	 * @return true for success or false otherwise.
+	 */
+	bool readHeaderILInt(std::uint64_t & v);
+
+	/**
+	 * Marks this reader as failed.
+	 *
+	 * @return Always false.
+	 */
+	bool fail() {
+		this->_error = true;
+		return false;
+	}
+public:
+	/**
+	 * Creates a new instance of this class.
+	 *
+	 * @param[in] in The input source.
+	 */
+	ILTagStreamReader(ILTagInput & in);
+
+	/**
+	 * Disposes this instance and releases all associated resources.
+	 */
+	virtual ~ILTagStreamReader() = default;
+
+	/**
+	 * Moves to the next tag. The unread bytes of the current tag are skipped.
+	 *
+	 * @param[out] tagId The ID of the tag.
+	 * @param[out] tagSize The size of the body of the tag.
+	 * @return true for success or false if there are no more tags in the
+	 * current level or if the input is corrupted. Use hasError() and eof()
+	 * to tell these cases apart.
+	 */
+	bool next(std::uint64_t & tagId, std::uint64_t & tagSize);
+
+	/**
+	 * Verifies if this reader found a corrupted or truncated input or failed
+	 * to read it.
+	 *
+	 * @return true if an error was found or false otherwise.
+	 * @since 2018.04.26
+	 */
+	bool hasError() const {
+		return this->_error;
+	}
+
+	/**
+	 * Verifies if the last call to next() reached the end of the input
+	 * between top level tags.
+	 *
+	 * @return true if the end of the input was reached or false otherwise.
+	 * @since 2018.04.26
+	 */
+	bool eof() const {
+		return this->_eof;
+	}
+
+	/**
+	 * Returns the ID of the current tag.
+	 *
+	 * @return The ID of the current tag.
+	 */
+	std::uint64_t tagId() const {
+		return this->_tagId;
+	}
+
+	/**
+	 * Returns the size of the body of the current tag.
+	 *
+	 * @return The size of the body of the current tag.
+	 */
+	std::uint64_t tagSize() const {
+		return this->_tagSize;
+	}
+
+	/**
+	 * Returns the number of bytes of the current tag body not read yet.
+	 *
+	 * @return The number of bytes not read yet.
+	 */
+	std::uint64_t remaining() const {
+		return this->_remaining;
+	}
+
+	/**
+	 * Skips the remaining of the body of the current tag.
+	 *
+	 * @return true for success or false otherwise.
+	 */
+	bool skip();
+
+	/**
+	 * Reads a chunk of the body of the current tag.
+	 *
+	 * @param[out] buff The output buffer.
+	 * @param[in] size The number of bytes to read. It cannot be larger than
+	 * remaining().
+	 * @return true for success or false otherwise.
+	 */
+	bool read(void * buff, std::uint64_t size);
+
+	/**
+	 * Reads an ILInt from the body of the current tag. It can be used to read
+	 * the number of entries of an array before entering it.
+	 *
+	 * @param[out] v The value read.
+	 * @return true for success or false otherwise.
+	 */
+	bool readILInt(std::uint64_t & v);
+
+	/**
+	 * Reads the remaining of the body of the current tag into a buffer.
+	 *
+	 * @param[out] out The output buffer. The bytes are written to its current
+	 * position.
+	 * @return true for success or false otherwise.
+	 */
+	bool read(IRBuffer & out);
+
+	/**
+	 * Deserializes the current tag. Only the body of this tag is loaded into
+	 * memory. It must be called before any byte of the body is read.
+	 *
+	 * @param[in] factory The factory used to create the tag. It cannot be in
+	 * view mode because the bytes of the tag are released by this method.
+	 * @return The new tag or null in case of failure.
+	 */
+	ILTag * readTag(const ILTagFactory & factory);
+
+	/**
+	 * Enters the body of the current tag. The next calls to next() will
+	 * return the tags inside it.
+	 *
+	 * @return true for success or false otherwise.
+	 */
+	bool enter();
+
+	/**
+	 * Leaves the tag entered by the last call to enter(). All unread bytes
+	 * of the entered tag are skipped.
+	 *
+	 * @return true for success or false otherwise.
+	 */
+	bool leave();
+
+	/**
+	 * Returns the number of entered tags.
+	 *
+	 * @return The current depth.
+	 */
+	std::uint64_t depth() const {
+		return this->_levels.size();
+	}
+};
+
+/**
+ * This class implements a push-based writer of tags. Each tag is written
+ * as its header followed by its body without buffering the whole tag.
+ *
+ * <p>Tags can be written at once by write() or piece by piece with
+ * beginTag(), writeBody() and endTag(). Both methods can be mixed to nest
+ * tags inside a tag being written.</p>
+ *
+ * @since 2018.04.23
+ */
+class ILTagStreamWriter {
+private:
+	/**
+	 * The output sink.
+	 */
+	ILTagOutput & _out;
+
+	/**
+	 * Bytes not written yet of each open tag.
+	 */
+	std::vector<std::uint64_t> _levels;
+
+	/**
+	 * Writes bytes to the output and updates the current level.
+	 *
+	 * @param[in] buff The bytes.
+	 * @param[in] size The number of bytes.
+	 * @return true for success or false otherwise.
+	 */
+	bool emit(const void * buff, std::uint64_t size);
+
+	/**
+	 * Writes an ILInt to the output and updates the current level.
+	 *
+	 * @param[in] v The value.
+	 * @return true for success or false otherwise.
+	 */
+	bool emitILInt(std::uint64_t v);
+
+	/**
+	 * Writes the tag without the size cache scope.
+	 *
+	 * @param[in] tag The tag.
+	 * @return true for success or false otherwise.
+	 */
+	bool writeTag(const ILTag & tag);
+public:
+	/**
+	 * Creates a new instance of this class.
+	 *
+	 * @param[in] out The output sink.
+	 */
+	ILTagStreamWriter(ILTagOutput & out): _out(out) {}
+
+	/**
+	 * Disposes this instance and releases all associated resources.
+	 */
+	virtual ~ILTagStreamWriter() = default;
+
+	/**
+	 * Writes the header of a new tag. Its body must be written by
+	 * writeBody(), write() or nested beginTag() calls.
+	 *
+	 * @param[in] tagId The ID of the tag.
+	 * @param[in] tagSize The size of the body of the tag.
+	 * @return true for success or false otherwise.
+	 */
+	bool beginTag(std::uint64_t tagId, std::uint64_t tagSize);
+
+	/**
+	 * Writes a chunk of the body of the current tag.
+	 *
+	 * @param[in] buff The bytes.
+	 * @param[in] size The number of bytes.
+	 * @return true for success or false otherwise.
+	 */
+	bool writeBody(const void * buff, std::uint64_t size);
+
+	/**
+	 * Writes an ILInt into the body of the current tag.
+	 *
+	 * @param[in] v The value.
+	 * @return true for success or false otherwise.
+	 */
+	bool writeILInt(std::uint64_t v);
+
+	/**
+	 * Finishes the current tag.
+	 *
+	 * @return true for success or false if the body was not fully written.
+	 */
+	bool endTag();
+
+	/**
+	 * Writes a whole tag. List tags are written entry by entry and raw tags
+	 * are written directly from their values. All other tags are written by
+	 * ILTag::writeValue(), thus only the values of the leaf tags that do not
+	 * override it are buffered.
+	 *
+	 * @param[in] tag The tag.
+	 * @return true for success or false otherwise.
+	 */
+	bool write(const ILTag & tag);
+
+	/**
+	 * Returns the number of open tags.
+	 *
+	 * @return The current depth.
+	 */
+	std::uint64_t depth() const {
+		return this->_levels.size();
+	}
+};
+
+} // namespace iltags
+} // namespace ircommon
+
+#endif /* _IRCOMMON_ILTAGSTREAM_H_ */
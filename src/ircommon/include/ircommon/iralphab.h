@@ -17,6 +17,7 @@
 #define __IRCOMMON_IRALPHAB_H__
 
 #include <stdexcept>
+#include <cstdint>
 
 namespace ircommon {
 namespace codec {
@@ -39,6 +40,55 @@ namespace codec {
 class IRAlphabet{
 private:
 	int _size;
+
+	/**
+	 * The characters indexed by their values or nullptr if the subclass does
+	 * not provide the lookup tables.
+	 */
+	const char * _charMap;
+
+	/**
+	 * The values indexed by the characters. Invalid characters are mapped
+	 * to -1.
+	 */
+	std::int16_t _valueMap[256];
+protected:
+	/**
+	 * Sets the lookup tables used by this alphabet. The value of each
+	 * character in map is its index. If a character appears more than once,
+	 * only its first occurrence is mapped.
+	 *
+	 * <p>This method is expected to be called only by the constructors of the
+	 * subclasses.</p>
+	 *
+	 * @param[in] map The characters of this alphabet. It must have size()
+	 * characters and must remain valid during the lifetime of this instance.
+	 * @since 2018.04.26
+	 */
+	void setMap(const char * map);
+
+	/**
+	 * Maps an additional character to a given value. It is used to map
+	 * alternative forms of the characters, such as the other letter case.
+	 *
+	 * @param[in] c The character.
+	 * @param[in] v The value.
+	 * @since 2018.04.26
+	 */
+	void addValue(int c, int v) {
+		this->_valueMap[std::uint8_t(c)] = v;
+	}
+
+	/**
+	 * Returns the value of the character using the lookup tables.
+	 *
+	 * @param[in] c The character.
+	 * @return The value of the character or -1 if the character is invalid.
+	 * @since 2018.04.26
+	 */
+	int mappedValue(int c) const {
+		return this->_valueMap[std::uint8_t(c)];
+	}
 public:
 	/**
 	 * Creates a new instance of this class with a given size.
@@ -53,6 +103,37 @@ public:
 	 */
 	virtual ~IRAlphabet() = default;
 
+	IRAlphabet(const IRAlphabet &) = delete;
+
+	IRAlphabet & operator = (const IRAlphabet &) = delete;
+
+	/**
+	 * Returns the characters of this alphabet indexed by their values. It
+	 * allows the codecs to avoid calls to getChar().
+	 *
+	 * @return The characters or nullptr if this alphabet does not provide
+	 * lookup tables.
+	 * @since 2018.04.26
+	 */
+	const char * charMap() const {
+		return this->_charMap;
+	}
+
+	/**
+	 * Returns the values of the characters of this alphabet indexed by the
+	 * characters. Invalid characters are mapped to -1. It allows the codecs to
+	 * avoid calls to getValue().
+	 *
+	 * @return The 256 entries of the table or nullptr if this alphabet does
+	 * not provide lookup tables.
+	 * @note Subclasses of the alphabets that provide lookup tables must not
+	 * change the behavior of getValue() and getChar().
+	 * @since 2018.04.26
+	 */
+	const std::int16_t * valueMap() const {
+		return (this->_charMap) ? this->_valueMap : nullptr;
+	}
+
 	/**
 	 * Returns the size of this alphabet.
 	 *
@@ -110,7 +191,6 @@ public:
 	 *
 	 * @param[in] c The character.
 	 * @return The value of the character or -1 if the character is invalid.
-	 * @note This method always performs a sequential scan on the mapping.
 	 */
 	virtual int getValue(int c) const;
 
@@ -183,11 +263,6 @@ public:
  * @author Fabio Jun Takada Chino (fchino at opencs.com.br)
  */
 class IRHexAlphabet: public IRAlphabet {
-private:
-	/**
-	 * The map.
-	 */
-	const char * _map;
 public:
 	/**
 	 * Creates a new instance of this class.
@@ -232,16 +307,6 @@ public:
  * @author Fabio Jun Takada Chino (fchino at opencs.com.br)
  */
 class IRBase32Alphabet: public IRAlphabet {
-private:
-	/**
-	 * Flag that indicates the use of the extended hex instead of the normal
-	 * alphabet.
-	 */
-	bool _extendedHex;
-	/**
-	 * The current mapping.
-	 */
-	const char * _map;
 public:
 	enum {
 		/**
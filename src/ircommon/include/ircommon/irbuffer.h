@@ -20,6 +20,132 @@
 
 namespace ircommon {
 
+/**
+ * This is the base class for all growth policies of IRBuffer. A growth policy
+ * determines the new size of the internal buffer whenever a write operation
+ * requires more space than the one available.
+ *
+ * @since 2018.04.19
+ */
+class IRBufferGrowthPolicy {
+public:
+	/**
+	 * Creates a new instance of this class.
+	 */
+	IRBufferGrowthPolicy() = default;
+
+	/**
+	 * Disposes this instance and releases all associated resources.
+	 */
+	virtual ~IRBufferGrowthPolicy() = default;
+
+	/**
+	 * Computes the new size of the buffer.
+	 *
+	 * @param[in] buffSize The current size of the buffer.
+	 * @param[in] minSize The minimum size required. It is always larger than
+	 * buffSize.
+	 * @param[in] inc The increment of the buffer.
+	 * @return The new size of the buffer. It must be equal or larger than
+	 * minSize.
+	 */
+	virtual std::uint64_t nextSize(std::uint64_t buffSize,
+			std::uint64_t minSize, std::uint64_t inc) const = 0;
+};
+
+/**
+ * This class implements the fixed growth policy. The new size of the buffer
+ * is the minimum size padded to a multiple of the increment. It is the default
+ * policy of IRBuffer.
+ *
+ * @since 2018.04.19
+ */
+class IRFixedGrowthPolicy : public IRBufferGrowthPolicy {
+public:
+	IRFixedGrowthPolicy() = default;
+
+	virtual ~IRFixedGrowthPolicy() = default;
+
+	virtual std::uint64_t nextSize(std::uint64_t buffSize,
+			std::uint64_t minSize, std::uint64_t inc) const;
+
+	/**
+	 * Returns a shared instance of this class.
+	 *
+	 * @return The shared instance.
+	 */
+	static const IRFixedGrowthPolicy & instance();
+};
+
+/**
+ * This class implements the geometric growth policy. The size of the buffer
+ * is multiplied by a constant factor, defined by a ratio, on each growth.
+ * This makes the cost of appending N bytes in small writes O(N). The new
+ * size is always rounded up to the nearest multiple of the increment.
+ *
+ * @since 2018.04.19
+ */
+class IRGeometricGrowthPolicy : public IRBufferGrowthPolicy {
+private:
+	/**
+	 * The numerator of the factor.
+	 */
+	std::uint64_t _num;
+	/**
+	 * The denominator of the factor.
+	 */
+	std::uint64_t _den;
+public:
+	/**
+	 * Creates a new instance of this class. The growth factor is num/den.
+	 *
+	 * @param[in] num The numerator of the factor.
+	 * @param[in] den The denominator of the factor.
+	 * @exception std::invalid_argument If den is 0 or num/den is not larger
+	 * than 1.
+	 */
+	IRGeometricGrowthPolicy(std::uint64_t num = 2, std::uint64_t den = 1);
+
+	virtual ~IRGeometricGrowthPolicy() = default;
+
+	virtual std::uint64_t nextSize(std::uint64_t buffSize,
+			std::uint64_t minSize, std::uint64_t inc) const;
+
+	/**
+	 * Returns the numerator of the factor.
+	 *
+	 * @return The numerator.
+	 */
+	std::uint64_t numerator() const {
+		return this->_num;
+	}
+
+	/**
+	 * Returns the denominator of the factor.
+	 *
+	 * @return The denominator.
+	 */
+	std::uint64_t denominator() const {
+		return this->_den;
+	}
+
+	/**
+	 * Returns a shared instance of this class that doubles the size of the
+	 * buffer on each growth.
+	 *
+	 * @return The shared instance.
+	 */
+	static const IRGeometricGrowthPolicy & doubling();
+
+	/**
+	 * Returns a shared instance of this class that multiplies the size of
+	 * the buffer by 1.5 on each growth.
+	 *
+	 * @return The shared instance.
+	 */
+	static const IRGeometricGrowthPolicy & oneAndHalf();
+};
+
 // TODO This class requires tests
 
 /**
@@ -68,6 +194,41 @@ protected:
 	 */
 	bool _secure;
 
+	/**
+	 * The growth policy. If null, the fixed growth policy is used.
+	 */
+	const IRBufferGrowthPolicy * _growthPolicy;
+
+	/**
+	 * Flag that indicates that this instance is a view created by wrap().
+	 * Views are detached by the first write operation.
+	 */
+	bool _view;
+
+	/**
+	 * Prepares this instance for a write operation. Views created by wrap()
+	 * are detached.
+	 *
+	 * @return true if this instance can be written or false otherwise.
+	 * @since 2018.04.26
+	 */
+	bool writable() {
+		if (this->_view) {
+			return this->detach();
+		}
+		return !this->readOnly();
+	}
+
+	/**
+	 * Allocates a new buffer. Secure buffers are allocated from the
+	 * IRSecureAllocator.
+	 *
+	 * @param[in] buffSize The size of the buffer.
+	 * @return The new buffer or null in case of failure.
+	 * @since 2018.04.26
+	 */
+	std::uint8_t * allocate(std::uint64_t buffSize);
+
 	/**
 	 * Disposes the buffer.
 	 *
@@ -75,6 +236,27 @@ protected:
 	 * @param[in] buffSize The size of the buffer.
 	 */
 	void dispose(std::uint8_t * buff, std::uint64_t buffSize);
+
+	/**
+	 * Replaces the internal buffer by a new one with the given size. The
+	 * data is copied to the new buffer and the old one is disposed.
+	 *
+	 * @param[in] newBuffSize The new size of the buffer. It must be larger
+	 * than or equal to the size of the data.
+	 * @return true for success or false otherwise.
+	 * @since 2018.04.19
+	 */
+	bool resize(std::uint64_t newBuffSize);
+
+	/**
+	 * Grows the internal buffer according to the growth policy in order to
+	 * hold at least minSize bytes. It is used by all write operations.
+	 *
+	 * @param[in] minSize The minimum size of the buffer.
+	 * @return true for success or false otherwise.
+	 * @since 2018.04.19
+	 */
+	bool grow(std::uint64_t minSize);
 public:
 	enum {
 		/**
@@ -84,6 +266,16 @@ public:
 		DEFAULT_INCREMENT = 16
 	};
 
+	/**
+	 * Marker used to select the constructor that creates instances without
+	 * storage.
+	 *
+	 * @since 2018.04.26
+	 */
+	enum NoStorage {
+		NO_STORAGE
+	};
+
 	/**
 	 * Creates a new instance of this class. It wraps the constant byte array
 	 * pointed by buff. The resulting instance will be read-only.
@@ -107,6 +299,21 @@ public:
 	IRBuffer(std::uint64_t reserved = 0, bool secure = false,
 			std::uint64_t inc = DEFAULT_INCREMENT);
 
+	/**
+	 * Creates a new empty instance of this class without storage. The
+	 * internal buffer is allocated by the first write operation, thus
+	 * buffer() and roBuffer() return null until then. It is useful for
+	 * instances that are likely to be replaced by wrap() or set().
+	 *
+	 * @param[in] marker Must be NO_STORAGE.
+	 * @param[in] secure If true, all memory allocations will be treated as secure.
+	 * @param[in] inc The size of the increment. Must be a value larger than 0.
+	 * @exception std::invalid_argument If inc is 0.
+	 * @since 2018.04.26
+	 */
+	IRBuffer(NoStorage marker, bool secure = false,
+			std::uint64_t inc = DEFAULT_INCREMENT);
+
 	/**
 	 * Disposes this instance and releases all associated resources.
 	 */
@@ -141,7 +348,8 @@ public:
 	}
 
 	/**
-	 * Returns a writeable pointer to the buffer.
+	 * Returns a writeable pointer to the buffer. Views created by wrap() are
+	 * detached before.
 	 *
 	 * @return The pointer to the buffer or NULL if this instance
 	 * is read-only.
@@ -149,6 +357,7 @@ public:
 	 * resize operations may lead to changes in this value.
 	 */
 	std::uint8_t * buffer() {
+		this->writable();
 		return this->_buff;
 	}
 
@@ -231,9 +440,35 @@ public:
 	 * @param[in] newSize The new reserved size.
 	 * @return true for success or false otherwise.
 	 * @note This method will never shrink the internal buffer.
+	 * @note The growth policy is not used by this method. The new size of the
+	 * buffer will always be newSize padded to a multiple of the increment.
 	 */
 	bool reserve(std::uint64_t newSize);
 
+	/**
+	 * Returns the growth policy of this instance.
+	 *
+	 * @return The growth policy or null if the fixed growth policy is used.
+	 * @since 2018.04.19
+	 */
+	const IRBufferGrowthPolicy * growthPolicy() const {
+		return this->_growthPolicy;
+	}
+
+	/**
+	 * Sets the growth policy used by all write operations.
+	 *
+	 * @param[in] policy The new growth policy. Use null to restore the default
+	 * fixed growth policy. This instance does not claim the ownership of the
+	 * policy, so it must exist during the lifetime of this instance.
+	 * @note Secure buffers are always wiped on each reallocation regardless
+	 * of the policy.
+	 * @since 2018.04.19
+	 */
+	void setGrowthPolicy(const IRBufferGrowthPolicy * policy) {
+		this->_growthPolicy = policy;
+	}
+
 	/**
 	 * Writes a certain number of bytes into the buffer.
 	 *
@@ -325,6 +560,28 @@ public:
 	 */
 	bool readILInt(std::uint64_t & v);
 
+	/**
+	 * Writes a sequence of ILInt64 values into the buffer. The buffer grows
+	 * at most once.
+	 *
+	 * @param[in] values The values to be written.
+	 * @param[in] count The number of values.
+	 * @return true for success or false otherwise.
+	 * @since 2018.04.24
+	 */
+	bool writeILInts(const std::uint64_t * values, std::uint64_t count);
+
+	/**
+	 * Reads a sequence of ILInt64 values from the buffer.
+	 *
+	 * @param[out] values The values read.
+	 * @param[in] count The number of values to read.
+	 * @return true for success or false otherwise.
+	 * @note On failure, the position of the buffer remains unchanged.
+	 * @since 2018.04.24
+	 */
+	bool readILInts(std::uint64_t * values, std::uint64_t count);
+
 	/**
 	 * Returns a read-only pointer to the buffer at the current position.
 	 *
@@ -342,7 +599,7 @@ public:
 	 * @since 2018.01.22
 	 */
 	std::uint8_t * posBuffer() {
-		if (this->readOnly()) {
+		if (!this->writable()) {
 			return nullptr;
 		} else {
 			return this->buffer() + this->position();
@@ -576,6 +833,36 @@ public:
 	 */
 	bool readFloat(double & v);
 
+	/**
+	 * Turns this instance into a read-only view of an external buffer. The
+	 * internal buffer, if any, is disposed and the position is moved to the
+	 * beginning of the data.
+	 *
+	 * @param[in] buff The buffer to be wrapped. It cannot be null.
+	 * @param[in] buffSize The size of the buffer.
+	 * @return true for success or false otherwise.
+	 * @note The buffer pointed by buff will be used directly so it must exist
+	 * while it is wrapped by this instance. Furthermore, this buffer will not
+	 * be disposed by this instance.
+	 * @note Unlike instances created as read-only, the view is detached by
+	 * the first write operation, thus the wrapped buffer is never modified.
+	 * Instances created as read-only remain read-only.
+	 * @since 2018.04.20
+	 */
+	bool wrap(const void * buff, std::uint64_t buffSize);
+
+	/**
+	 * Turns a read-only instance into a writable one by copying the wrapped
+	 * data into a new internal buffer. The size and position are preserved.
+	 * It does nothing if this instance is already writable. Views created by
+	 * wrap() call it automatically on the first write operation.
+	 *
+	 * @return true for success or false otherwise.
+	 * @note Instances created as read-only will use the default increment.
+	 * @since 2018.04.20
+	 */
+	bool detach();
+
 	/**
 	 * Copies the contents of another instance into this instance. It will copy
 	 * the current data and the current read/write position.
@@ -17,6 +17,7 @@
 #define __IRCOMMON_IRCODEC_H__
 
 #include <ircommon/iralphab.h>
+#include <ircommon/irbuffer.h>
 #include <string>
 #include <memory>
 #include <cstdint>
@@ -153,6 +154,104 @@ private:
 	int _clearMask;
 	int _charSize;
 	bool _ignoreSpaces;
+
+	/**
+	 * Size of the standard alphabet recognized by the constructor or 0 if
+	 * the alphabet is not a standard one. It selects the vectorized kernels
+	 * for Base16 and Base64.
+	 */
+	int _standardAlphabet;
+
+	/**
+	 * Implements encodeBits() using the lookup tables of the alphabet. The
+	 * character size is a template parameter in order to allow the compiler
+	 * to unroll the processing of each group of bytes.
+	 *
+	 * @param[in] src The source data.
+	 * @param[in] srcEnd The end of the source data.
+	 * @param[out] dst The output. It must have room for all characters.
+	 * @param[in,out] bitBuffer The bits not encoded yet.
+	 * @param[in,out] bitBufferSize The number of bits in bitBuffer.
+	 * @return The end of the output.
+	 * @since 2018.04.26
+	 */
+	template <int CharSize>
+	char * encodeMapped(const std::uint8_t * src, const std::uint8_t * srcEnd,
+			char * dst, std::uint64_t & bitBuffer, int & bitBufferSize) const;
+
+	/**
+	 * Implements decodeBits() using the lookup tables of the alphabet. The
+	 * character size is a template parameter in order to allow the compiler
+	 * to unroll the processing of each group of characters.
+	 *
+	 * @param[in] src The source data.
+	 * @param[in] srcEnd The end of the source data.
+	 * @param[in,out] dst The output. On return, it points to the end of the
+	 * output.
+	 * @param[in] dstEnd The end of the output buffer.
+	 * @param[in,out] bitBuffer The bits not decoded yet.
+	 * @param[in,out] bitBufferSize The number of bits in bitBuffer.
+	 * @return true on success or false otherwise.
+	 * @since 2018.04.26
+	 */
+	template <int CharSize>
+	bool decodeMapped(const char * src, const char * srcEnd,
+			std::uint8_t * & dst, std::uint8_t * dstEnd,
+			std::uint64_t & bitBuffer, int & bitBufferSize) const;
+
+	/**
+	 * Encodes all bytes of src. The bits that do not fill a character are
+	 * kept in bitBuffer, allowing the encoding to be resumed by another call.
+	 *
+	 * @param[in] src The source data.
+	 * @param[in] srcSize The size of src.
+	 * @param[out] dst The output. It must have room for
+	 * (bitBufferSize + srcSize * 8) / characterSize() characters.
+	 * @param[in,out] bitBuffer The bits not encoded yet.
+	 * @param[in,out] bitBufferSize The number of bits in bitBuffer. It is
+	 * always smaller than characterSize().
+	 * @return The end of the output.
+	 * @since 2018.04.26
+	 */
+	char * encodeBits(const std::uint8_t * src, std::uint64_t srcSize,
+			char * dst, std::uint64_t & bitBuffer, int & bitBufferSize) const;
+
+	/**
+	 * Encodes the bits left in bitBuffer by encodeBits() as the last
+	 * character of the encoded data.
+	 *
+	 * @param[out] dst The output. It must have room for one character.
+	 * @param[in,out] bitBuffer The bits not encoded yet.
+	 * @param[in,out] bitBufferSize The number of bits in bitBuffer. It is
+	 * set to 0 on return.
+	 * @return The end of the output.
+	 * @since 2018.04.26
+	 */
+	char * flushBits(char * dst, std::uint64_t & bitBuffer,
+			int & bitBufferSize) const;
+
+	/**
+	 * Decodes all characters of src. The bits that do not fill a byte are
+	 * kept in bitBuffer, allowing the decoding to be resumed by another call.
+	 *
+	 * @param[in] src The source data without the padding.
+	 * @param[in] srcSize The size of src.
+	 * @param[in,out] dst The output. On return, it points to the end of the
+	 * output.
+	 * @param[in] dstEnd The end of the output buffer. It must have room for
+	 * (bitBufferSize + srcSize * characterSize()) / 8 bytes.
+	 * @param[in,out] bitBuffer The bits not decoded yet.
+	 * @param[in,out] bitBufferSize The number of bits in bitBuffer. It is
+	 * always smaller than 8.
+	 * @return true on success or false if src contains an invalid character.
+	 * @since 2018.04.26
+	 */
+	bool decodeBits(const char * src, std::uint64_t srcSize,
+			std::uint8_t * & dst, std::uint8_t * dstEnd,
+			std::uint64_t & bitBuffer, int & bitBufferSize) const;
+
+	friend class IRBase2NEncoder;
+	friend class IRBase2NDecoder;
 protected:
 	virtual void encodeCore(const std::uint8_t * src, int srcSize,
 			std::string & dst) const;
@@ -169,6 +268,8 @@ protected:
 	 *
 	 * @param[in] c The character to be tested.
 	 * @return true if the character must be ignored or false otherwise.
+	 * @note If the alphabet provides lookup tables, this method is called only
+	 * for characters that are not part of the alphabet.
 	 */
 	virtual bool isIgnored(int c) const;
 public:
@@ -254,6 +355,211 @@ public:
 	}
 };
 
+/**
+ * This class implements an incremental encoder based on IRBase2NCodec. The data
+ * can be fed in chunks of any size, up to 64-bit long, and the output is
+ * written to buffers provided by the caller or to an IRBuffer. The bits that
+ * do not fill a whole character are carried from one call to the next.
+ *
+ * <p>The output of a sequence of update() calls followed by finish() is
+ * identical to the output of IRBase2NCodec::encode() over the concatenation of
+ * all chunks, including the padding.</p>
+ *
+ * @note The codec must outlive this instance.
+ * @since 2018.04.26
+ */
+class IRBase2NEncoder {
+private:
+	const IRBase2NCodec & _codec;
+	std::uint64_t _bitBuffer;
+	int _bitBufferSize;
+	std::uint64_t _encodedSize;
+public:
+	/**
+	 * Creates a new instance of this class.
+	 *
+	 * @param[in] codec The codec.
+	 */
+	IRBase2NEncoder(const IRBase2NCodec & codec);
+
+	virtual ~IRBase2NEncoder() = default;
+
+	/**
+	 * Returns the codec used by this instance.
+	 */
+	const IRBase2NCodec & codec() const {
+		return this->_codec;
+	}
+
+	/**
+	 * Returns the number of characters produced since the last reset,
+	 * including the padding.
+	 */
+	std::uint64_t encodedSize() const {
+		return this->_encodedSize;
+	}
+
+	/**
+	 * Discards the bits not encoded yet and prepares this instance to encode a
+	 * new value.
+	 */
+	void reset();
+
+	/**
+	 * Returns the exact number of characters produced by update() for a chunk
+	 * of a given size.
+	 *
+	 * @param[in] srcSize The size of the chunk.
+	 * @return The number of characters.
+	 */
+	std::uint64_t getUpdateSize(std::uint64_t srcSize) const {
+		return (this->_bitBufferSize + (srcSize * 8)) /
+				this->_codec.characterSize();
+	}
+
+	/**
+	 * Returns the exact number of characters produced by finish().
+	 *
+	 * @return The number of characters.
+	 */
+	std::uint64_t getFinishSize() const;
+
+	/**
+	 * Encodes a chunk of data.
+	 *
+	 * @param[in] src The data.
+	 * @param[in] srcSize The size of src in bytes.
+	 * @param[out] dst The output buffer.
+	 * @param[in,out] dstSize On input, the size of dst. It must be at least
+	 * getUpdateSize(srcSize). On output, the number of characters written.
+	 * @return true on success or false otherwise.
+	 */
+	bool update(const void * src, std::uint64_t srcSize, void * dst,
+			std::uint64_t & dstSize);
+
+	/**
+	 * Encodes a chunk of data into an IRBuffer. The characters are written at
+	 * the current position of dst.
+	 *
+	 * @param[in] src The data.
+	 * @param[in] srcSize The size of src in bytes.
+	 * @param[out] dst The output buffer.
+	 * @return true on success or false otherwise.
+	 */
+	bool update(const void * src, std::uint64_t srcSize, IRBuffer & dst);
+
+	/**
+	 * Writes the last character and the padding. This instance is reset on
+	 * success.
+	 *
+	 * @param[out] dst The output buffer.
+	 * @param[in,out] dstSize On input, the size of dst. It must be at least
+	 * getFinishSize(). On output, the number of characters written.
+	 * @return true on success or false otherwise.
+	 */
+	bool finish(void * dst, std::uint64_t & dstSize);
+
+	/**
+	 * Writes the last character and the padding into an IRBuffer. This
+	 * instance is reset on success.
+	 *
+	 * @param[out] dst The output buffer.
+	 * @return true on success or false otherwise.
+	 */
+	bool finish(IRBuffer & dst);
+};
+
+/**
+ * This class implements an incremental decoder based on IRBase2NCodec. The
+ * encoded data can be fed in chunks of any size, up to 64-bit long, and the
+ * output is written to buffers provided by the caller or to an IRBuffer. The
+ * bits that do not fill a whole byte are carried from one call to the next.
+ *
+ * <p>The padding is verified as it arrives: once the first padding character
+ * is found, only padding and ignored characters are accepted. The padding
+ * size is validated by finish() using the same rules of
+ * IRBase2NCodec::decode().</p>
+ *
+ * @note The codec must outlive this instance.
+ * @note The state of this instance is undefined after a failure. Call reset()
+ * before reusing it.
+ * @since 2018.04.26
+ */
+class IRBase2NDecoder {
+private:
+	const IRBase2NCodec & _codec;
+	std::uint64_t _bitBuffer;
+	int _bitBufferSize;
+	std::uint64_t _totalSize;
+	std::uint64_t _paddingSize;
+public:
+	/**
+	 * Creates a new instance of this class.
+	 *
+	 * @param[in] codec The codec.
+	 */
+	IRBase2NDecoder(const IRBase2NCodec & codec);
+
+	virtual ~IRBase2NDecoder() = default;
+
+	/**
+	 * Returns the codec used by this instance.
+	 */
+	const IRBase2NCodec & codec() const {
+		return this->_codec;
+	}
+
+	/**
+	 * Discards the bits not decoded yet and prepares this instance to decode a
+	 * new value.
+	 */
+	void reset();
+
+	/**
+	 * Returns the maximum number of bytes produced by update() for a chunk of
+	 * a given size. Padding and ignored characters are not considered.
+	 *
+	 * @param[in] srcSize The size of the chunk.
+	 * @return The number of bytes.
+	 */
+	std::uint64_t getUpdateSize(std::uint64_t srcSize) const {
+		return (this->_bitBufferSize +
+				(srcSize * this->_codec.characterSize())) / 8;
+	}
+
+	/**
+	 * Decodes a chunk of encoded data.
+	 *
+	 * @param[in] src The encoded data.
+	 * @param[in] srcSize The number of characters in src.
+	 * @param[out] dst The output buffer.
+	 * @param[in,out] dstSize On input, the size of dst. It must be at least
+	 * getUpdateSize(srcSize). On output, the number of bytes written.
+	 * @return true on success or false otherwise.
+	 */
+	bool update(const char * src, std::uint64_t srcSize, void * dst,
+			std::uint64_t & dstSize);
+
+	/**
+	 * Decodes a chunk of encoded data into an IRBuffer. The bytes are written
+	 * at the current position of dst.
+	 *
+	 * @param[in] src The encoded data.
+	 * @param[in] srcSize The number of characters in src.
+	 * @param[out] dst The output buffer.
+	 * @return true on success or false otherwise.
+	 */
+	bool update(const char * src, std::uint64_t srcSize, IRBuffer & dst);
+
+	/**
+	 * Verifies the padding and discards the remaining bits. This instance is
+	 * reset on success.
+	 *
+	 * @return true on success or false if the padding is invalid.
+	 */
+	bool finish();
+};
+
 } // namespace codec
 } //namespace ircommon
 
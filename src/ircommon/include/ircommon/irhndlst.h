@@ -16,9 +16,11 @@
 #ifndef _IRCOMMON_IRHNDLST_H_
 #define _IRCOMMON_IRHNDLST_H_
 
+#include <cstdint>
 #include <unordered_map>
 #include <memory>
 #include <vector>
+#include <mutex>
 #include <ircommon/irrwlock.h>
 #include <ircommon/iridgen.h>
 
@@ -28,6 +30,11 @@ namespace ircommon {
  * This class template implements a list of objects that can be identified by
  * a unique handle.
  *
+ * <p>The entries are distributed among a fixed number of shards according to
+ * a hash of the handle. Each shard has its own lock, thus concurrent callers
+ * only contend when they access the same shard. The ID generator is protected
+ * by a dedicated mutex that is held only while the next ID is computed.</p>
+ *
  * @tparam ObjectType The type of the object.
  * @author Fabio Jun Takada Chino (fchino at opencs.com.br)
  * @since 2017.01.11
@@ -35,16 +42,65 @@ namespace ircommon {
  */
 template <class ObjectType>
 class IRHandleList {
-private:
-	std::unordered_map<std::uint32_t, ObjectType> _map;
-	IRIDGenerator _generator;
-	ircommon::threading::IRRWLock _lock;
 public:
 	/**
 	 * Type of the list of handles.
 	 */
 	typedef std::vector<std::uint32_t> HandleList;
 
+	/**
+	 * Number of bits of the hash used to select the shard.
+	 *
+	 * @since 2018.04.26
+	 */
+	static constexpr int SHARD_BITS = 4;
+
+	/**
+	 * Number of shards.
+	 *
+	 * @since 2018.04.26
+	 */
+	static constexpr int SHARD_COUNT = 1 << SHARD_BITS;
+private:
+	/**
+	 * A shard of the list. It is aligned to a cache line in order to avoid
+	 * false sharing between the locks of neighbor shards.
+	 *
+	 * @since 2018.04.26
+	 */
+	struct alignas(64) Shard {
+		std::unordered_map<std::uint32_t, ObjectType> map;
+		ircommon::threading::IRRWLock lock;
+	};
+
+	Shard _shards[SHARD_COUNT];
+	IRIDGenerator _generator;
+	std::mutex _generatorLock;
+
+	/**
+	 * Returns the shard that holds a given ID. The IDs are mixed by a
+	 * multiplicative hash before the selection.
+	 *
+	 * @param[in] id The ID.
+	 * @return The shard.
+	 * @since 2018.04.26
+	 */
+	Shard & shard(std::uint32_t id) {
+		return this->_shards[
+				(id * std::uint32_t(0x9E3779B1)) >> (32 - SHARD_BITS)];
+	}
+
+	/**
+	 * Returns the next ID from the generator.
+	 *
+	 * @return The next ID.
+	 * @since 2018.04.26
+	 */
+	std::uint32_t nextID() {
+		std::lock_guard<std::mutex> lock(this->_generatorLock);
+		return this->_generator.next();
+	}
+public:
 	/**
 	 * Creates a new instance of this class.
 	 *
@@ -59,15 +115,54 @@ public:
 	virtual ~IRHandleList() = default;
 
 	/**
+	 * Allocates the memory of a new list aligned to a cache line. It is
+	 * required because the global operator new does not honor extended
+	 * alignments before C++17.
 	 *
-	 * @note This method executes a read lock.
+	 * @param[in] size The size of the instance.
+	 * @return The allocated memory.
+	 * @since 2018.04.26
+	 */
+	static void * operator new(std::size_t size) {
+		std::uint8_t * raw;
+		std::uintptr_t p;
+
+		raw = (std::uint8_t *)::operator new(
+				size + alignof(Shard) + sizeof(void *));
+		p = ((std::uintptr_t)(raw + sizeof(void *)) + alignof(Shard) - 1) &
+				~std::uintptr_t(alignof(Shard) - 1);
+		((void **)p)[-1] = raw;
+		return (void *)p;
+	}
+
+	/**
+	 * Releases the memory of a list.
+	 *
+	 * @param[in] ptr The memory to be released.
+	 * @since 2018.04.26
+	 */
+	static void operator delete(void * ptr) {
+		if (ptr) {
+			::operator delete(((void **)ptr)[-1]);
+		}
+	}
+
+	/**
+	 * Returns the number of entries in this list.
+	 *
+	 * @return The number of entries.
+	 * @note This method executes a read lock on each shard, one at a time.
+	 * It is not an atomic snapshot of the list: entries inserted or removed
+	 * concurrently may or may not be counted.
 	 */
 	int size() {
-		int size;
+		int size = 0;
 
-		this->_lock.lockRead();
-		size = this->_map.size();
-		this->_lock.unlockRead();
+		for (Shard & s : this->_shards) {
+			s.lock.lockRead();
+			size += s.map.size();
+			s.lock.unlockRead();
+		}
 		return size;
 	}
 
@@ -76,18 +171,19 @@ public:
 	 *
 	 * @param[in] obj The object added into the list.
 	 * @return The id assigned to the given object.
-	 * @note This method executes a write lock.
+	 * @note This method executes a write lock on a single shard.
 	 */
 	std::uint32_t insert(ObjectType obj){
 		std::uint32_t id;
+		bool inserted;
 
-		this->_lock.lockWrite();
 		do {
-			id = this->_generator.next();
-		} while (this->_map.find(id) != this->_map.end());
-
-		this->_map.insert({id, obj});
-		this->_lock.unlockWrite();
+			id = this->nextID();
+			Shard & s = this->shard(id);
+			s.lock.lockWrite();
+			inserted = s.map.insert({id, obj}).second;
+			s.lock.unlockWrite();
+		} while (!inserted);
 		return id;
 	}
 
@@ -96,20 +192,15 @@ public:
 	 *
 	 * @param[in] The ID of the object to be removed.
 	 * @return true if the object was removed or false otherwise.
-	 * @note This method executes a write lock.
+	 * @note This method executes a write lock on a single shard.
 	 */
 	bool remove(std::uint32_t id) {
+		Shard & s = this->shard(id);
 		bool ret;
 
-		this->_lock.lockWrite();
-		auto found = this->_map.find(id);
-		if (found != this->_map.end()) {
-			this->_map.erase(found);
-			ret = true;
-		} else {
-			ret = false;
-		}
-		this->_lock.unlockWrite();
+		s.lock.lockWrite();
+		ret = (s.map.erase(id) != 0);
+		s.lock.unlockWrite();
 		return ret;
 	}
 
@@ -119,31 +210,36 @@ public:
 	 * @param[in] The object id.
 	 * @param[out] The object found, if any.
 	 * @return true if the object exists or false otherwise.
-	 * @note This method executes a read lock.
+	 * @note This method executes a read lock on a single shard.
 	 */
 	bool get(std::uint32_t id, ObjectType & obj) {
+		Shard & s = this->shard(id);
 		bool ret;
 
-		this->_lock.lockRead();
-		auto found = this->_map.find(id);
-		if (found != this->_map.end()) {
+		s.lock.lockRead();
+		auto found = s.map.find(id);
+		if (found != s.map.end()) {
 			obj = found->second;
 			ret = true;
 		} else {
 			ret = false;
 		}
-		this->_lock.unlockRead();
+		s.lock.unlockRead();
 		return ret;
 	}
 
 	/**
 	 * Removes all entries in this list.
-	 * @note This method executes a write lock.
+	 * @note This method executes a write lock on each shard, one at a time.
+	 * It is not atomic across shards: entries inserted concurrently into a
+	 * shard already cleared are kept.
 	 */
 	void clear() {
-		this->_lock.lockWrite();
-		this->_map.clear();
-		this->_lock.unlockWrite();
+		for (Shard & s : this->_shards) {
+			s.lock.lockWrite();
+			s.map.clear();
+			s.lock.unlockWrite();
+		}
 	}
 
 	/**
@@ -151,13 +247,15 @@ public:
 	 *
 	 * @return true if the id is inside the list or false otherwise.
 	 * @since 2017.01.12
-	 * @note This method executes a read lock.
+	 * @note This method executes a read lock on a single shard.
 	 */
 	bool contains(std::uint32_t id){
+		Shard & s = this->shard(id);
 		bool ret;
-		this->_lock.lockRead();
-		ret = (this->_map.find(id) != this->_map.end());
-		this->_lock.unlockRead();
+
+		s.lock.lockRead();
+		ret = (s.map.find(id) != s.map.end());
+		s.lock.unlockRead();
 		return ret;
 	}
 
@@ -165,14 +263,18 @@ public:
 	 * Returns the list of handles.
 	 *
 	 * @param[out] The list of handles inside this instance.
-	 * @note This method executes a read lock.
+	 * @note This method executes a read lock on each shard, one at a time.
+	 * It is not an atomic snapshot of the list: handles inserted or removed
+	 * concurrently may or may not be listed.
 	 */
 	void listHandles(HandleList & ids) {
-		this->_lock.lockRead();
-		for (auto entry = this->_map.begin(); entry != this->_map.end(); entry++) {
-			ids.push_back(entry->first);
+		for (Shard & s : this->_shards) {
+			s.lock.lockRead();
+			for (auto entry = s.map.begin(); entry != s.map.end(); entry++) {
+				ids.push_back(entry->first);
+			}
+			s.lock.unlockRead();
 		}
-		this->_lock.unlockRead();
 	}
 };
 
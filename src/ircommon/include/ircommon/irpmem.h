@@ -16,6 +16,7 @@
 #ifndef _IRCOMMON_IRPMEM_H_
 #define _IRCOMMON_IRPMEM_H_
 
+#include <chrono>
 #include <cstdint>
 #include <mutex>
 #ifndef _WIN32
@@ -43,6 +44,21 @@ namespace crypto {
  * usage of this class only for critical information such as passwords
  * and long term keys.</p> 
  *
+ * <p>On Posix systems, the value is masked by a word-wise XOR with an ARC4
+ * key stream as long as the value, kept in a secure buffer. A new key stream
+ * is drawn only when an epoch starts: on construction, beginHot() and
+ * endHot(). Thus protect() and unprotect() cost a single XOR pass and all
+ * protections inside the same epoch reuse the same key stream.</p>
+ *
+ * <p>Code that uses the data repeatedly in a short period of time may open a
+ * hot window with beginHot(). While it is open, unlock() keeps the data
+ * unprotected until the given number of uses or the given time is consumed.
+ * The class IRHotScope can be used to ensure that endHot() is always
+ * called.</p>
+ *
+ * <p>The internal lock is recursive, thus the thread that holds lock() may
+ * call lock() again, beginHot(), endHot() and plain() without deadlocks.</p>
+ *
  * @author Fabio Jun Takada Chino (fchino at opencs.com.br)
  * @since 2018.01.30
  * @note This class is thread safe.
@@ -55,12 +71,54 @@ protected:
 
 	std::uint64_t _valueSize;
 	
-	std::mutex _mutex;
+	std::recursive_mutex _mutex;
+
+	/**
+	 * Number of calls to lock() not matched by unlock() yet. Only the thread
+	 * that owns _mutex may change it.
+	 */
+	std::uint64_t _locks;
 
 	#ifndef _WIN32
 	IRARC4 * _arc4;
+
+	/**
+	 * Key stream of the current protection epoch.
+	 */
+	std::uint8_t * _mask;
+
+	/**
+	 * Size of _mask in bytes. It is a multiple of 8.
+	 */
+	std::uint64_t _maskSize;
+
+	/**
+	 * Flag that indicates that a new epoch started, thus the next call to
+	 * protect() must draw a new key stream.
+	 */
+	bool _newEpoch;
 	#endif //_WIN32
 
+	/**
+	 * Flag that indicates that the data is currently unprotected.
+	 */
+	bool _plain;
+
+	/**
+	 * Flag that indicates that a hot window is open.
+	 */
+	bool _hot;
+
+	/**
+	 * Number of uses remaining in the current hot window.
+	 */
+	std::uint64_t _hotUses;
+
+	/**
+	 * Deadline of the current hot window.
+	 */
+	std::chrono::steady_clock::time_point _hotDeadline;
+
 	bool protect();
 
 	bool unprotect();
@@ -79,12 +137,46 @@ public:
 
 	/**
 	 * This method protects the data in memory and releases 
-	 * the lock.
+	 * the lock. If lock() was called more than once by the current thread,
+	 * the data is protected only by the last call to this method.
 	 *
 	 * @return true for success or false otherwise. 
 	 */
 	virtual bool unlock();
 
+	/**
+	 * Opens a hot window. While it is open, unlock() will keep the data
+	 * unprotected in the locked memory until maxUses calls to unlock() are
+	 * performed or maxTime expires, whichever comes first. Since the
+	 * expiration is verified only by unlock(), endHot() must be called when
+	 * the window is no longer required.
+	 *
+	 * @param[in] maxUses The maximum number of uses.
+	 * @param[in] maxTime The maximum duration of the window in milliseconds.
+	 * @note It starts a new masking epoch.
+	 * @since 2018.04.26
+	 * @see IRHotScope
+	 */
+	void beginHot(std::uint64_t maxUses, std::uint64_t maxTime);
+
+	/**
+	 * Closes the current hot window, if any, and protects the data again.
+	 * If the current thread holds lock(), the data is protected by the
+	 * matching unlock() instead. It starts a new masking epoch.
+	 *
+	 * @return true for success or false otherwise.
+	 * @since 2018.04.26
+	 */
+	bool endHot();
+
+	/**
+	 * Verifies if the data is currently unprotected.
+	 *
+	 * @return true if the data is unprotected or false otherwise.
+	 * @since 2018.04.26
+	 */
+	bool plain();
+
 	/**
 	 * The size of the data.
 	 *
@@ -105,6 +197,44 @@ public:
 	}
 };
 
+/**
+ * This helper class opens a hot window on a given object and closes it when
+ * disposed. It can be used with any class that implements
+ * beginHot(std::uint64_t, std::uint64_t) and endHot(), like
+ * IRProtectedMemory. With IRProtectedMemory, the scope may be closed while
+ * lock() is held.
+ *
+ * @tparam HotType The type of the object.
+ * @since 2018.04.26
+ */
+template <class HotType>
+class IRHotScope {
+private:
+	HotType & _obj;
+public:
+	/**
+	 * Creates a new instance of this class.
+	 *
+	 * @param[in] obj The object.
+	 * @param[in] maxUses The maximum number of uses.
+	 * @param[in] maxTime The maximum duration of the window in milliseconds.
+	 */
+	IRHotScope(HotType & obj, std::uint64_t maxUses, std::uint64_t maxTime):
+			_obj(obj) {
+		this->_obj.beginHot(maxUses, maxTime);
+	}
+
+	// Copy constructor is forbidden
+	IRHotScope(const IRHotScope &) = delete;
+
+	/**
+	 * Disposes this instance and closes the hot window.
+	 */
+	~IRHotScope() {
+		this->_obj.endHot();
+	}
+};
+
 } // namespace crypto
 } // namespace ircommon
 
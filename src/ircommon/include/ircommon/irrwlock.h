@@ -16,8 +16,10 @@
 #ifndef __IRCOMMON_IRRWLOCK_H__
 #define __IRCOMMON_IRRWLOCK_H__
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <mutex>
-#include <ircommon/irsemaph.h>
 
 namespace ircommon {
 namespace threading {
@@ -26,30 +28,142 @@ namespace threading {
  * This class implements a read/write lock that allows multiple simultaneous
  * readers but only a single writer access to the resource.
  *
+ * <p>The lock state is kept in a single atomic word, thus uncontended
+ * acquisitions and releases require a single atomic operation. Threads that
+ * must wait are parked on condition variables.</p>
+ *
+ * <p>Once a writer requests the lock, new readers wait until it is released,
+ * and all readers waiting at the moment a writer releases the lock are
+ * admitted before the next writer can proceed. Thus neither readers nor
+ * writers can be starved by the other group. Parked writers are woken one
+ * at a time and compete for the lock, avoiding lock convoys.</p>
+ *
  * @since 2017.12.26
  * @author Fabio Jun Takada Chino (fchino at opencs.com.br)
  */
 class IRRWLock {
 private:
 	/**
-	 * Mutex that prevents the concurrent access to _readerCount.
+	 * Mask of the number of active readers in _state.
+	 */
+	static constexpr std::uint32_t READER_MASK = 0x3FFFFFFF;
+
+	/**
+	 * Flag of _state set while a writer owns or is acquiring the lock.
+	 */
+	static constexpr std::uint32_t WRITER = 0x40000000;
+
+	/**
+	 * Flag of _state set while there are threads parked. It forces the
+	 * release operations to take the slow path.
+	 */
+	static constexpr std::uint32_t WAITERS = 0x80000000;
+
+	/**
+	 * The state of the lock. It holds the number of active readers and the
+	 * flags WRITER and WAITERS.
+	 *
+	 * @since 2018.04.26
 	 */
-	std::mutex _readLock;
+	std::atomic<std::uint32_t> _state;
 
 	/**
-	 * Mutex that prevents concurrent writers.
+	 * Mutex that protects the slow path.
+	 *
+	 * @since 2018.04.26
 	 */
-	IRSemaphore _writeLock;
+	std::mutex _mutex;
 
 	/**
-	 * Mutex that prevents new readers after the first write lock request.
+	 * Where readers wait for the release of the writer.
+	 *
+	 * @since 2018.04.26
 	 */
-	std::mutex _writeReq;
+	std::condition_variable _readers;
 
 	/**
-	 * Number of readers using the resource.
+	 * Where writers wait for the release of the current writer.
+	 *
+	 * @since 2018.04.26
 	 */
-	volatile int _readerCount;
+	std::condition_variable _writers;
+
+	/**
+	 * Where the writer that owns the WRITER flag waits for the active
+	 * readers to leave.
+	 *
+	 * @since 2018.04.26
+	 */
+	std::condition_variable _drain;
+
+	/**
+	 * Number of parked readers. Protected by _mutex.
+	 *
+	 * @since 2018.04.26
+	 */
+	int _waitingReaders;
+
+	/**
+	 * Number of parked writers. Protected by _mutex.
+	 *
+	 * @since 2018.04.26
+	 */
+	int _waitingWriters;
+
+	/**
+	 * Incremented each time the parked readers are admitted. Protected by
+	 * _mutex.
+	 *
+	 * @since 2018.04.26
+	 */
+	std::uint32_t _readerPhase;
+
+	/**
+	 * Incremented each time a writer releases the lock with parked writers.
+	 * Protected by _mutex.
+	 *
+	 * @since 2018.04.26
+	 */
+	std::uint32_t _writerPhase;
+
+	/**
+	 * Sets the WAITERS flag if, and only if, the WRITER flag is still set.
+	 * Must be called with _mutex locked.
+	 *
+	 * @return true if the flag was set or false if the writer released the
+	 * lock in the meantime.
+	 * @since 2018.04.26
+	 */
+	bool markWaiters();
+
+	/**
+	 * Clears the WAITERS flag if there are no more parked threads. Must be
+	 * called with _mutex locked.
+	 *
+	 * @since 2018.04.26
+	 */
+	void updateWaiters();
+
+	/**
+	 * Slow path of lockRead().
+	 *
+	 * @since 2018.04.26
+	 */
+	void lockReadSlow();
+
+	/**
+	 * Slow path of lockWrite().
+	 *
+	 * @since 2018.04.26
+	 */
+	void lockWriteSlow();
+
+	/**
+	 * Slow path of unlockWrite().
+	 *
+	 * @since 2018.04.26
+	 */
+	void unlockWriteSlow();
 public:
 	/**
 	 * Creates a new instance of this class.
@@ -61,9 +175,13 @@ public:
  	 */
 	virtual ~IRRWLock();
 
+	IRRWLock(const IRRWLock &) = delete;
+
+	IRRWLock & operator = (const IRRWLock &) = delete;
+
 	/**
 	 * Acquire the lock for reading. This method will block if a writer is
-	 * running.
+	 * running or waiting.
 	 */
 	void lockRead();
 
@@ -80,7 +198,8 @@ public:
 	void lockWrite();
 
 	/**
-	 * Releases the lock for writting.
+	 * Releases the lock for writting. Readers that were waiting are admitted
+	 * before the next writer.
 	 */
 	void unlockWrite();
 };
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _IRCOMMON_IRSECMEM_H_
+#define _IRCOMMON_IRSECMEM_H_
+
+#include <cstdint>
+#include <mutex>
+
+namespace ircommon {
+
+/**
+ * Usage statistics of the IRSecureAllocator.
+ *
+ * @since 2018.04.26
+ */
+struct IRSecureAllocatorStats {
+	/**
+	 * Number of memory pages locked by the pool regions.
+	 */
+	std::uint64_t lockedPages;
+	/**
+	 * Number of bytes currently allocated, including the fallback allocations.
+	 */
+	std::uint64_t bytesInUse;
+	/**
+	 * Number of allocations that could not be served by the pool.
+	 */
+	std::uint64_t fallbacks;
+};
+
+/**
+ * This class implements the process-wide allocator of the secure memory
+ * buffers.
+ *
+ * <p>It keeps a few large regions that are locked into the physical memory
+ * and, whenever supported, excluded from core dumps. Those regions are carved
+ * into chunks of power of 2 size classes that are recycled through free
+ * lists, thus a single lock is required for each region instead of one for
+ * each allocation.</p>
+ *
+ * <p>All chunks are cleared when released. Requests larger than
+ * MAX_CHUNK_SIZE or that cannot be served by the pool are counted as
+ * fallbacks. Each fallback buffer is mapped into its own pages and locked,
+ * thus releasing it never unlocks memory still used by other buffers. This
+ * costs whole pages of locked memory and two or three system calls for each
+ * allocation and release, thus large secure buffers should be reused instead
+ * of being allocated repeatedly.</p>
+ *
+ * @since 2018.04.26
+ * @note This class is thread safe.
+ */
+class IRSecureAllocator {
+public:
+	/**
+	 * Size of the smallest size class.
+	 */
+	static constexpr std::uint64_t MIN_CHUNK_SIZE = 16;
+
+	/**
+	 * Size of the largest size class.
+	 */
+	static constexpr std::uint64_t MAX_CHUNK_SIZE = 4096;
+
+	/**
+	 * Number of size classes.
+	 */
+	static constexpr int CLASS_COUNT = 9;
+
+	/**
+	 * Size of each region.
+	 */
+	static constexpr std::uint64_t REGION_SIZE = 64 * 1024;
+
+	/**
+	 * Maximum number of regions.
+	 */
+	static constexpr int MAX_REGIONS = 64;
+private:
+	/**
+	 * Head of the free list of each size class. The link is stored in the
+	 * first bytes of each free chunk.
+	 */
+	void * _free[CLASS_COUNT];
+
+	/**
+	 * The regions. Only the first _regionCount entries are valid.
+	 */
+	std::uint8_t * _regions[MAX_REGIONS];
+
+	/**
+	 * Number of regions.
+	 */
+	int _regionCount;
+
+	/**
+	 * Number of bytes of the last region that were not carved yet.
+	 */
+	std::uint64_t _regionFree;
+
+	/**
+	 * Set when the system refuses to provide a new region.
+	 */
+	bool _exhausted;
+
+	/**
+	 * The page size.
+	 */
+	std::uint64_t _pageSize;
+
+	/**
+	 * Statistics.
+	 */
+	IRSecureAllocatorStats _stats;
+
+	/**
+	 * Protects all fields of this instance.
+	 */
+	std::mutex _mutex;
+
+	/**
+	 * Returns the size class of a given size.
+	 *
+	 * @param[in] size The size. It must be at most MAX_CHUNK_SIZE.
+	 * @return The size class.
+	 */
+	static int sizeClass(std::uint64_t size);
+
+	/**
+	 * Returns the size of the chunks of a given class.
+	 *
+	 * @param[in] c The class.
+	 * @return The size of the chunks.
+	 */
+	static std::uint64_t classSize(int c) {
+		return MIN_CHUNK_SIZE << c;
+	}
+
+	/**
+	 * Verifies if the given pointer belongs to one of the regions.
+	 *
+	 * @param[in] p The pointer.
+	 * @return true if it belongs to the pool or false otherwise.
+	 */
+	bool inPool(const void * p) const;
+
+	/**
+	 * Maps, locks and registers a new region.
+	 *
+	 * @return true for success or false otherwise.
+	 */
+	bool addRegion();
+
+	/**
+	 * Extracts a chunk from the pool.
+	 *
+	 * @param[in] c The class.
+	 * @return The chunk or null if the pool is exhausted.
+	 */
+	void * poolAllocate(int c);
+
+	/**
+	 * Returns the number of bytes mapped by fallbackAllocate() for a given
+	 * size.
+	 *
+	 * @param[in] size The size.
+	 * @return The size rounded up to a multiple of the page size.
+	 */
+	std::uint64_t fallbackSize(std::uint64_t size) const {
+		return ((size + this->_pageSize - 1) / this->_pageSize) *
+				this->_pageSize;
+	}
+
+	/**
+	 * Maps and locks a buffer outside of the pool. Each buffer has its own
+	 * pages.
+	 *
+	 * @param[in] size The size.
+	 * @return The buffer or null in case of failure.
+	 */
+	void * fallbackAllocate(std::uint64_t size) const;
+
+	/**
+	 * Releases a buffer allocated by fallbackAllocate().
+	 *
+	 * @param[in] p The buffer.
+	 * @param[in] size The size.
+	 */
+	void fallbackDeallocate(void * p, std::uint64_t size) const;
+public:
+	/**
+	 * Creates a new instance of this class. No region is allocated until
+	 * the first allocation.
+	 *
+	 * @note Most applications should use the shared instance returned by
+	 * instance().
+	 */
+	IRSecureAllocator();
+
+	/**
+	 * Disposes this instance. All regions are cleared and released, thus all
+	 * chunks must be released before.
+	 */
+	~IRSecureAllocator();
+
+	// Copy is forbidden
+	IRSecureAllocator(const IRSecureAllocator &) = delete;
+	IRSecureAllocator & operator = (const IRSecureAllocator &) = delete;
+
+	/**
+	 * Returns the process-wide instance. It is never disposed, thus it can
+	 * be used by static objects.
+	 *
+	 * @return The shared instance.
+	 */
+	static IRSecureAllocator & instance();
+
+	/**
+	 * Allocates a secure buffer. The chunks returned by this method are
+	 * aligned to MIN_CHUNK_SIZE. The contents of the new buffer are
+	 * undefined.
+	 *
+	 * @param[in] size The size of the buffer.
+	 * @return The new buffer or null in case of failure.
+	 */
+	void * allocate(std::uint64_t size);
+
+	/**
+	 * Clears and releases a buffer allocated by allocate().
+	 *
+	 * @param[in] p The buffer. If null, this method does nothing.
+	 * @param[in] size The size of the buffer. It must be the same value used
+	 * to allocate it.
+	 */
+	void deallocate(void * p, std::uint64_t size);
+
+	/**
+	 * Returns the current statistics.
+	 *
+	 * @param[out] stats The statistics.
+	 */
+	void getStats(IRSecureAllocatorStats & stats);
+};
+
+} //namespace ircommon
+
+#endif /* _IRCOMMON_IRSECMEM_H_ */
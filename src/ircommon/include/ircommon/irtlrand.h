@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _IRCOMMON_IRTLRAND_H_
+#define _IRCOMMON_IRTLRAND_H_
+
+#include <ircommon/irrandom.h>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ircommon {
+namespace threading {
+
+/**
+ * This class implements an IRRandom that can be shared among multiple threads
+ * without serializing the calls.
+ *
+ * <p>Each thread that uses an instance of this class receives its own
+ * IRRandom, created by a factory and seeded with bytes extracted from a
+ * parent source. The parent is locked only while a new thread forks its
+ * generator, thus the extraction of random values scales with the number of
+ * threads.</p>
+ *
+ * <p>Optionally, each thread may keep a buffer of pre-generated bytes that is
+ * refilled in bulk. All values are then extracted from this buffer. The
+ * consumed bytes are cleared from the buffer.</p>
+ *
+ * <p>The per-thread generators are owned by this instance. The generator of a
+ * thread is released when the thread exits, and all remaining generators are
+ * released when this instance is disposed. The thread-local cache entries
+ * that point to disposed instances are purged, thus neither structure grows
+ * with the number of threads or instances that ever existed.</p>
+ *
+ * @since 2018.04.26
+ */
+class IRThreadLocalRandom : public ircommon::IRRandom {
+public:
+	/**
+	 * Type of the factory of the per-thread generators.
+	 */
+	typedef std::function<ircommon::IRRandom * ()> Factory;
+
+	/**
+	 * Number of bytes extracted from the parent to seed each per-thread
+	 * generator.
+	 */
+	static constexpr int SEED_SIZE = 32;
+private:
+	/**
+	 * The thread-local cache of slots. It is defined by the implementation.
+	 */
+	struct ThreadCache;
+
+	/**
+	 * The state of a single thread.
+	 */
+	struct Slot {
+		std::unique_ptr<ircommon::IRRandom> random;
+		std::unique_ptr<std::uint8_t[]> buffer;
+		std::uint64_t available;
+	};
+
+	/**
+	 * The parent source.
+	 */
+	std::unique_ptr<ircommon::IRRandom> _parent;
+
+	/**
+	 * The factory of the per-thread generators.
+	 */
+	Factory _factory;
+
+	/**
+	 * Size of the per-thread buffer. 0 means no buffer.
+	 */
+	std::uint64_t _bufferSize;
+
+	/**
+	 * Unique identifier of this instance. It is used as the key of the
+	 * thread-local cache of slots and is never reused.
+	 */
+	std::uint64_t _id;
+
+	/**
+	 * All slots created by this instance.
+	 */
+	std::vector<std::unique_ptr<Slot>> _slots;
+
+	/**
+	 * Protects the parent and the list of slots.
+	 */
+	std::mutex _mutex;
+
+	/**
+	 * Returns the slot of the calling thread, forking a new generator if
+	 * necessary.
+	 *
+	 * @return The slot of the calling thread.
+	 */
+	Slot & slot();
+
+	/**
+	 * Creates the slot of the calling thread.
+	 *
+	 * @return The new slot.
+	 */
+	Slot * fork();
+
+	/**
+	 * Returns the cache of slots of the calling thread.
+	 *
+	 * @return The cache of the calling thread.
+	 * @since 2018.04.26
+	 */
+	static ThreadCache & threadCache();
+
+	/**
+	 * Releases the slot of a thread that is exiting.
+	 *
+	 * @param[in] slot The slot to be released.
+	 * @since 2018.04.26
+	 */
+	void release(Slot * slot);
+public:
+	/**
+	 * Creates a new instance of this class.
+	 *
+	 * @param[in] parent The parent source used to seed the per-thread
+	 * generators. This class will take ownership of this instance.
+	 * @param[in] factory The factory of the per-thread generators. Each call
+	 * must return a new instance.
+	 * @param[in] bufferSize Size of the per-thread buffer in bytes. Use 0 to
+	 * disable the buffering.
+	 * @exception std::invalid_argument If parent or factory are null.
+	 */
+	IRThreadLocalRandom(IRRandom * parent, Factory factory,
+			std::uint64_t bufferSize = 0);
+
+	/**
+	 * Dispose this instance and releases all associated resources, including
+	 * all per-thread generators.
+	 */
+	virtual ~IRThreadLocalRandom();
+
+	/**
+	 * Returns the size of the per-thread buffer.
+	 */
+	std::uint64_t bufferSize() const {
+		return this->_bufferSize;
+	}
+
+	/**
+	 * Returns the number of live threads that forked a generator from this
+	 * instance.
+	 */
+	int forkCount();
+
+	/**
+	 * Returns the number of slots cached by the calling thread, including the
+	 * ones that belong to instances already disposed but not purged yet.
+	 *
+	 * @return The number of cached slots.
+	 * @since 2018.04.26
+	 */
+	static std::size_t threadCacheSize();
+
+	/**
+	 * Sets the seed of the generator of the calling thread. Its buffer is
+	 * discarded.
+	 *
+	 * @param[in] seed The seed value.
+	 */
+	virtual void setSeed(std::uint64_t seed);
+
+	/**
+	 * Sets the seed of the generator of the calling thread. Its buffer is
+	 * discarded.
+	 *
+	 * @param[in] seed The seed value.
+	 * @param[in] seedSize The seed size.
+	 */
+	virtual void setSeed(const void * seed, std::uint64_t seedSize);
+
+	virtual bool nextBoolean();
+
+	virtual std::uint8_t next();
+
+	virtual std::uint16_t next16();
+
+	virtual std::uint32_t next32();
+
+	virtual std::uint64_t next64();
+
+	virtual float nextFloat();
+
+	virtual double nextDouble();
+
+	virtual void nextBytes(void * out, std::uint64_t outSize);
+};
+
+} //namespace threading
+} //namespace ircommon
+
+#endif /* _IRCOMMON_IRTLRAND_H_ */
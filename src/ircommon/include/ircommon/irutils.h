@@ -16,7 +16,9 @@
 #ifndef INCLUDE_IRUTILS_IRBUFFER_H_
 #define INCLUDE_IRUTILS_IRBUFFER_H_
 
+#include <ircommon/irsecmem.h>
 #include <cstdint>
+#include <new>
 #include <stdexcept>
 
 namespace ircommon {
@@ -203,6 +205,9 @@ public:
  * This helper class implements a temporary basic type buffer that will clean
  * itself when disposed.
  *
+ * <p>Starting on version 2018.04.26, the buffer is allocated from the
+ * IRSecureAllocator.</p>
+ *
  * @since 2018.04.12
  * @author Fabio Jun Takada Chino (fchino at opencs.com.br)
  * @see IRAutoMemoryCleaner
@@ -218,9 +223,14 @@ public:
 	 * Creates a new instance of this class.
 	 *
 	 * @param[in] size The size of the temporary buffer in bytes.
+	 * @exception std::bad_alloc If the buffer cannot be allocated.
 	 */
 	IRBaseSecureTemp(std::uint64_t size): _buffSize(size),
-			_buff(new BaseType[size]), _position(0) {
+			_buff((BaseType *)IRSecureAllocator::instance().allocate(
+					size * sizeof(BaseType))), _position(0) {
+		if (!this->_buff) {
+			throw std::bad_alloc();
+		}
 	}
 
 	// Copy constructor is forbidden
@@ -230,10 +240,8 @@ public:
 	 * Disposes this instance and releases all associated resources.
 	 */
 	~IRBaseSecureTemp() {
-		if (this->_buff) {
-			this->clear();
-			delete [] this->_buff;
-		}
+		IRSecureAllocator::instance().deallocate(this->_buff,
+				this->_buffSize * sizeof(BaseType));
 	}
 
 	/**
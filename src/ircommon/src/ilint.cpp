@@ -14,56 +14,342 @@
  * limitations under the License.
  */
 #include "ircommon/ilint.h"
+#include <cstring>
+#ifdef _MSC_VER
+	#include <intrin.h>
+	#include <stdlib.h>
+#endif //_MSC_VER
+#if (defined(__GNUC__) || defined(__clang__)) && \
+		(defined(__x86_64__) || defined(__i386__))
+	#define ILINT_SIMD_X86
+	#include <immintrin.h>
+#endif
 
 using namespace ircommon;
 
 //==============================================================================
-// Class ILInt
+// Helper functions
 //------------------------------------------------------------------------------
-int ILInt::size(uint64_t v) {
+/**
+ * Returns the number of bytes required to hold the significant bits of v.
+ * It returns 1 if v is 0.
+ */
+static inline int ILInt_significantBytes(std::uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+	return (64 - __builtin_clzll(v | 1) + 7) >> 3;
+#elif defined(_MSC_VER) && defined(_M_X64)
+	unsigned long idx;
+	_BitScanReverse64(&idx, v | 1);
+	return (idx >> 3) + 1;
+#else
+	int n = 1;
+	while (v > 0xFF) {
+		v = v >> 8;
+		n++;
+	}
+	return n;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Loads 8 bytes as a big endian value.
+ */
+static inline std::uint64_t ILInt_loadBE64(const std::uint8_t * p) {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+	std::uint64_t v;
+	std::memcpy(&v, p, sizeof(v));
+	return __builtin_bswap64(v);
+#elif defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+	std::uint64_t v;
+	std::memcpy(&v, p, sizeof(v));
+	return v;
+#elif defined(_MSC_VER)
+	std::uint64_t v;
+	std::memcpy(&v, p, sizeof(v));
+	return _byteswap_uint64(v);
+#else
+	std::uint64_t v = 0;
+	for (int i = 0; i < 8; i++) {
+		v = (v << 8) | p[i];
+	}
+	return v;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Stores v as 8 big endian bytes.
+ */
+static inline void ILInt_storeBE64(std::uint64_t v, std::uint8_t * p) {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+	v = __builtin_bswap64(v);
+	std::memcpy(p, &v, sizeof(v));
+#elif defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+	std::memcpy(p, &v, sizeof(v));
+#elif defined(_MSC_VER)
+	v = _byteswap_uint64(v);
+	std::memcpy(p, &v, sizeof(v));
+#else
+	for (int i = 7; i >= 0; i--) {
+		p[i] = (std::uint8_t)v;
+		v = v >> 8;
+	}
+#endif
+}
 
-	if (v < ILINT_BASE) {
+//------------------------------------------------------------------------------
+/**
+ * Returns the encoded size of v.
+ */
+static inline int ILInt_size(std::uint64_t v) {
+	return (v < ILInt::ILINT_BASE) ? 1 :
+			1 + ILInt_significantBytes(v - ILInt::ILINT_BASE);
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Decodes a value without the bound check. At least 9 bytes must be
+ * available at inp.
+ */
+static inline int ILInt_decodeFast(const std::uint8_t * inp,
+		std::uint64_t & v) {
+	int prefix;
+	int n;
+
+	prefix = *inp;
+	if (prefix < ILInt::ILINT_BASE) {
+		v = prefix;
 		return 1;
-	} else if (v <= (0xFF + ILINT_BASE)) {
-		return 2;
-	} else if ( v <= (0xFFFF + ILINT_BASE)){
-		return 3;
-	} else if ( v <= (0xFFFFFFl + ILINT_BASE)){
-		return 4;
-	} else if ( v <= (0xFFFFFFFFll + ILINT_BASE)){
-		return 5;
-	} else if ( v <= (0xFFFFFFFFFFll + ILINT_BASE)){
-		return 6;
-	} else if ( v <= (0xFFFFFFFFFFFFll + ILINT_BASE)){
-		return 7;
-	} else if ( v <= (0xFFFFFFFFFFFFFFll + ILINT_BASE)){
-		return 8;
+	}
+	n = prefix - ILInt::ILINT_BASE + 1;
+	v = ILInt_loadBE64(inp + 1) >> ((8 - n) * 8);
+	if (v > (0xFFFFFFFFFFFFFFFFll - ILInt::ILINT_BASE)) {
+		return 0;
+	}
+	v += ILInt::ILINT_BASE;
+	return n + 1;
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Encodes a value without the bound check. size must be ILInt::size(v).
+ */
+static inline void ILInt_encodeFast(std::uint64_t v, int size,
+		std::uint8_t * out) {
+
+	if (size == 1) {
+		*out = (std::uint8_t)v;
+		return;
+	}
+	*out = ILInt::ILINT_BASE + (size - 2);
+	v -= ILInt::ILINT_BASE;
+	for (int i = size - 1; i > 0; i--) {
+		out[i] = (std::uint8_t)v;
+		v = v >> 8;
+	}
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Encodes a value using a single 8 byte store for the payload. At least 9
+ * bytes must be available at out and the bytes after the encoded value are
+ * overwritten. size must be ILInt::size(v).
+ */
+static inline void ILInt_encodeWide(std::uint64_t v, int size,
+		std::uint8_t * out) {
+
+	if (size == 1) {
+		*out = (std::uint8_t)v;
+	} else {
+		*out = ILInt::ILINT_BASE + (size - 2);
+		ILInt_storeBE64((v - ILInt::ILINT_BASE) << ((9 - size) * 8), out + 1);
+	}
+}
+
+#ifdef ILINT_SIMD_X86
+//------------------------------------------------------------------------------
+// SIMD decoding
+//------------------------------------------------------------------------------
+/**
+ * Signature of the vectorized decoders used by ILInt::decodeMany().
+ *
+ * <p>They decode values while a full window is readable from p and at least a
+ * window of values is writable at values + i. p and i are updated to the
+ * first value not decoded.</p>
+ *
+ * @return true on success or false if an invalid value was found.
+ */
+typedef bool (*ILInt_decodeBlockFunc)(const std::uint8_t *& p,
+		const std::uint8_t * pEnd, std::uint64_t * values,
+		std::uint64_t count, std::uint64_t & i);
+
+//------------------------------------------------------------------------------
+/**
+ * Decodes the values that follow a run of single byte values, one by one with
+ * ILInt_decodeFast(), until a new run of at least 2 single byte values is
+ * found. The vector scan does not pay off for large or isolated small values.
+ *
+ * @return 1 on success, 0 if there is no room for the fast decoder or -1 if
+ * a value is invalid.
+ */
+static inline int ILInt_decodeBlockTail(const std::uint8_t *& p,
+		const std::uint8_t * pEnd, std::uint64_t * values,
+		std::uint64_t count, std::uint64_t & i) {
+	int size;
+
+	while ((pEnd - p) >= 9) {
+		size = ILInt_decodeFast(p, values[i]);
+		if (size == 0) {
+			return -1;
+		}
+		p += size;
+		i++;
+		if ((i == count) || ((pEnd - p) < 2) ||
+				((p[0] < ILInt::ILINT_BASE) && (p[1] < ILInt::ILINT_BASE))) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+ * SSE4.1 decoder. It scans a 16 byte window for ILInt headers (bytes greater
+ * than or equal to ILINT_BASE). All bytes before the first header are single
+ * byte values, so they are widened to 64 bits at once. The multi-byte value
+ * that ends the run is decoded with ILInt_decodeFast().
+ */
+__attribute__((target("sse4.1")))
+static bool ILInt_decodeBlockSSE41(const std::uint8_t *& p,
+		const std::uint8_t * pEnd, std::uint64_t * values,
+		std::uint64_t count, std::uint64_t & i) {
+	const __m128i base = _mm_set1_epi8((char)ILInt::ILINT_BASE);
+
+	while (((count - i) >= 16) && ((pEnd - p) >= 16)) {
+		__m128i in = _mm_loadu_si128((const __m128i *)p);
+		unsigned mask = _mm_movemask_epi8(
+				_mm_cmpeq_epi8(_mm_max_epu8(in, base), in));
+		if ((mask & 1) == 0) {
+			// Widens the run of single byte values
+			__m128i * out = (__m128i *)(values + i);
+			_mm_storeu_si128(out, _mm_cvtepu8_epi64(in));
+			_mm_storeu_si128(out + 1,
+					_mm_cvtepu8_epi64(_mm_srli_si128(in, 2)));
+			_mm_storeu_si128(out + 2,
+					_mm_cvtepu8_epi64(_mm_srli_si128(in, 4)));
+			_mm_storeu_si128(out + 3,
+					_mm_cvtepu8_epi64(_mm_srli_si128(in, 6)));
+			_mm_storeu_si128(out + 4,
+					_mm_cvtepu8_epi64(_mm_srli_si128(in, 8)));
+			_mm_storeu_si128(out + 5,
+					_mm_cvtepu8_epi64(_mm_srli_si128(in, 10)));
+			_mm_storeu_si128(out + 6,
+					_mm_cvtepu8_epi64(_mm_srli_si128(in, 12)));
+			_mm_storeu_si128(out + 7,
+					_mm_cvtepu8_epi64(_mm_srli_si128(in, 14)));
+			if (mask == 0) {
+				p += 16;
+				i += 16;
+				continue;
+			}
+			int n = __builtin_ctz(mask);
+			p += n;
+			i += n;
+		}
+		int ret = ILInt_decodeBlockTail(p, pEnd, values, count, i);
+		if (ret <= 0) {
+			return (ret == 0);
+		}
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+ * AVX2 version of ILInt_decodeBlockSSE41() that uses a 32 byte window.
+ */
+__attribute__((target("avx2")))
+static bool ILInt_decodeBlockAVX2(const std::uint8_t *& p,
+		const std::uint8_t * pEnd, std::uint64_t * values,
+		std::uint64_t count, std::uint64_t & i) {
+	const __m256i base = _mm256_set1_epi8((char)ILInt::ILINT_BASE);
+
+	while (((count - i) >= 32) && ((pEnd - p) >= 32)) {
+		__m256i in = _mm256_loadu_si256((const __m256i *)p);
+		unsigned mask = (unsigned)_mm256_movemask_epi8(
+				_mm256_cmpeq_epi8(_mm256_max_epu8(in, base), in));
+		if ((mask & 1) == 0) {
+			// Widens the run of single byte values
+			__m128i lo = _mm256_castsi256_si128(in);
+			__m128i hi = _mm256_extracti128_si256(in, 1);
+			__m256i * out = (__m256i *)(values + i);
+			_mm256_storeu_si256(out, _mm256_cvtepu8_epi64(lo));
+			_mm256_storeu_si256(out + 1,
+					_mm256_cvtepu8_epi64(_mm_srli_si128(lo, 4)));
+			_mm256_storeu_si256(out + 2,
+					_mm256_cvtepu8_epi64(_mm_srli_si128(lo, 8)));
+			_mm256_storeu_si256(out + 3,
+					_mm256_cvtepu8_epi64(_mm_srli_si128(lo, 12)));
+			_mm256_storeu_si256(out + 4, _mm256_cvtepu8_epi64(hi));
+			_mm256_storeu_si256(out + 5,
+					_mm256_cvtepu8_epi64(_mm_srli_si128(hi, 4)));
+			_mm256_storeu_si256(out + 6,
+					_mm256_cvtepu8_epi64(_mm_srli_si128(hi, 8)));
+			_mm256_storeu_si256(out + 7,
+					_mm256_cvtepu8_epi64(_mm_srli_si128(hi, 12)));
+			if (mask == 0) {
+				p += 32;
+				i += 32;
+				continue;
+			}
+			int n = __builtin_ctz(mask);
+			p += n;
+			i += n;
+		}
+		int ret = ILInt_decodeBlockTail(p, pEnd, values, count, i);
+		if (ret <= 0) {
+			return (ret == 0);
+		}
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Selects the best decoder supported by the current CPU.
+ *
+ * @return The decoder or nullptr if no vectorized decoder is available.
+ */
+static ILInt_decodeBlockFunc ILInt_selectDecodeBlock() {
+
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		return ILInt_decodeBlockAVX2;
+	} else if (__builtin_cpu_supports("sse4.1")) {
+		return ILInt_decodeBlockSSE41;
 	} else {
-		return 9;
+		return nullptr;
 	}
 }
+#endif //ILINT_SIMD_X86
+
+//==============================================================================
+// Class ILInt
+//------------------------------------------------------------------------------
+int ILInt::size(uint64_t v) {
+	return ILInt_size(v);
+}
 
 //------------------------------------------------------------------------------
 int ILInt::encode(uint64_t v, void * out, int outSize) {
 	int size;
-	uint8_t * p;
-	int i;
 
-	size = ILInt::size(v);
+	size = ILInt_size(v);
 	if (outSize < size) {
 		return 0;
 	}
-	p = (uint8_t *)out;
-	if (size == 1) {
-		*p = (uint8_t)(v & 0xFF);
-	} else {
-		*p = ILINT_BASE + (size - 2);
-		p++;
-		v = v - ILINT_BASE;
-		for (i = ((size - 2) * 8); i >= 0; i -=8, p++) {
-			*p = (uint8_t)((v >> i) & 0xFF);
-		}
-	}
+	ILInt_encodeFast(v, size, (uint8_t *)out);
 	return size;
 }
 
@@ -77,6 +363,9 @@ int ILInt::decode(const void * inp, int inpSize, uint64_t * v) {
 		return 0;
 	}
 	p = (const uint8_t *) inp;
+	if (inpSize >= 9) {
+		return ILInt_decodeFast(p, *v);
+	}
 	size = *p;
 	if (size < ILINT_BASE) {
 		*v = size;
@@ -100,4 +389,77 @@ int ILInt::decode(const void * inp, int inpSize, uint64_t * v) {
 		return size;
 	}
 }
+
+//------------------------------------------------------------------------------
+std::uint64_t ILInt::size(const std::uint64_t * values, std::uint64_t count) {
+	std::uint64_t total;
+
+	total = 0;
+	for (std::uint64_t i = 0; i < count; i++) {
+		total += ILInt_size(values[i]);
+	}
+	return total;
+}
+
+//------------------------------------------------------------------------------
+std::uint64_t ILInt::encodeMany(const std::uint64_t * values,
+		std::uint64_t count, void * out, std::uint64_t outSize) {
+	std::uint8_t * p;
+	std::uint8_t * pEnd;
+	std::uint64_t i;
+	int size;
+
+	p = (std::uint8_t *)out;
+	pEnd = p + outSize;
+	// Fast path while a full ILInt is guaranteed to be writable
+	for (i = 0; (i < count) && ((pEnd - p) >= 9); i++) {
+		size = ILInt_size(values[i]);
+		ILInt_encodeWide(values[i], size, p);
+		p += size;
+	}
+	for (; i < count; i++) {
+		size = ILInt_size(values[i]);
+		if ((std::uint64_t)(pEnd - p) < (std::uint64_t)size) {
+			return 0;
+		}
+		ILInt_encodeFast(values[i], size, p);
+		p += size;
+	}
+	return p - ((std::uint8_t *)out);
+}
+
+//------------------------------------------------------------------------------
+std::uint64_t ILInt::decodeMany(const void * inp, std::uint64_t inpSize,
+		std::uint64_t * values, std::uint64_t count) {
+	const std::uint8_t * p;
+	const std::uint8_t * pEnd;
+	std::uint64_t i;
+	int size;
+
+	p = (const std::uint8_t *)inp;
+	pEnd = p + inpSize;
+	i = 0;
+#ifdef ILINT_SIMD_X86
+	static const ILInt_decodeBlockFunc decodeBlock = ILInt_selectDecodeBlock();
+	if ((decodeBlock) && (!decodeBlock(p, pEnd, values, count, i))) {
+		return 0;
+	}
+#endif //ILINT_SIMD_X86
+	// Fast path while a full ILInt is guaranteed to be readable
+	for (; (i < count) && ((pEnd - p) >= 9); i++) {
+		size = ILInt_decodeFast(p, values[i]);
+		if (size == 0) {
+			return 0;
+		}
+		p += size;
+	}
+	for (; i < count; i++) {
+		size = ILInt::decode(p, (int)(pEnd - p), values + i);
+		if (size == 0) {
+			return 0;
+		}
+		p += size;
+	}
+	return p - ((const std::uint8_t *)inp);
+}
 //------------------------------------------------------------------------------
@@ -15,7 +15,11 @@
  */
 #include <ircommon/iltag.h>
 #include <ircommon/ilint.h>
+#include <ircommon/iltagstream.h>
 #include <cstring>
+#include <stdexcept>
+#include <atomic>
+#include <mutex>
 
 using namespace ircommon;
 using namespace ircommon::iltags;
@@ -43,16 +47,34 @@ static const std::uint64_t ILTag_STANDARD_SIZES[16] = {
 };
 
 //------------------------------------------------------------------------------
-ILTag::ILTag(std::uint64_t id): _tagID(id) {
+ILTag::ILTag(std::uint64_t id): _tagID(id), _cachedSize(0),
+		_cachedSizePass(0) {
+}
+
+//------------------------------------------------------------------------------
+std::uint64_t ILTag::cachedSize() const {
+	std::uint64_t pass;
+
+	pass = ILTagSizeCache::currentPass();
+	if (pass == 0) {
+		return this->size();
+	}
+	if (this->_cachedSizePass.load(std::memory_order_relaxed) != pass) {
+		this->_cachedSize.store(this->size(), std::memory_order_relaxed);
+		this->_cachedSizePass.store(pass, std::memory_order_relaxed);
+	}
+	return this->_cachedSize.load(std::memory_order_relaxed);
 }
 
 //------------------------------------------------------------------------------
 std::uint64_t ILTag::tagSize() const {
 	std::uint64_t ret;
+	std::uint64_t size;
 
-	ret = ILInt::size(this->id()) + this->size();
+	size = this->cachedSize();
+	ret = ILInt::size(this->id()) + size;
 	if (!this->isImplicit()) {
-		ret += ILInt::size(this->size());
+		ret += ILInt::size(size);
 	}
 	return ret;
 }
@@ -69,19 +91,118 @@ std::uint64_t ILTag::getImplicitValueSize(std::uint64_t tagId) {
 
 //------------------------------------------------------------------------------
 bool ILTag::serialize(ircommon::IRBuffer & out) const {
+	ILTagSizeCache cache;
 
 	// Add the ID.
 	if (!out.writeILInt(this->id())) {
 		return false;
 	}
 	// Add the size if required
-	if ((!this->isImplicit()) && (!out.writeILInt(this->size()))) {
+	if ((!this->isImplicit()) && (!out.writeILInt(this->cachedSize()))) {
 		return false;
 	}
 	// Add the body
 	return this->serializeValue(out);
 }
 
+//------------------------------------------------------------------------------
+bool ILTag::serializeTo(ircommon::IRBuffer & out) const {
+	ILTagSizeCache cache;
+	std::uint64_t start;
+	std::uint64_t oldSize;
+	std::uint64_t size;
+
+	start = out.position();
+	oldSize = out.size();
+	size = this->tagSize();
+	if (!out.reserve(start + size)) {
+		return false;
+	}
+	if ((!this->serialize(out)) || ((out.position() - start) != size)) {
+		// Discard the partial serialization
+		out.setSize(oldSize);
+		out.setPosition(start);
+		return false;
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool ILTag::serialize(ILTagOutput & out) const {
+	ILTagStreamWriter w(out);
+
+	return w.write(*this);
+}
+
+//------------------------------------------------------------------------------
+bool ILTag::writeValue(ILTagStreamWriter & out) const {
+	IRBuffer tmp(this->cachedSize(), true);
+
+	if (!this->serializeValue(tmp)) {
+		return false;
+	}
+	if (tmp.size() == 0) {
+		return true;
+	}
+	return out.writeBody(tmp.roBuffer(), tmp.size());
+}
+
+//------------------------------------------------------------------------------
+bool ILTag::equalsValue(const ILTag & other) const {
+	IRBuffer a(0, true);
+	IRBuffer b(0, true);
+
+	if (!this->serializeValue(a)) {
+		return false;
+	}
+	if (!other.serializeValue(b)) {
+		return false;
+	}
+	if (a.size() != b.size()) {
+		return false;
+	}
+	return (std::memcmp(a.roBuffer(), b.roBuffer(), a.size()) == 0);
+}
+
+//==============================================================================
+// Class ILTagSizeCache
+//------------------------------------------------------------------------------
+/**
+ * Source of the serialization pass numbers. It is shared by all threads in
+ * order to ensure that a value cached by a thread is never mistaken by a
+ * value cached by another one.
+ */
+static std::atomic<std::uint64_t> ILTagSizeCache_passCounter(0);
+
+/**
+ * The serialization pass active in the current thread.
+ */
+static thread_local std::uint64_t ILTagSizeCache_currentPass = 0;
+
+//------------------------------------------------------------------------------
+ILTagSizeCache::ILTagSizeCache() {
+
+	if (ILTagSizeCache_currentPass == 0) {
+		ILTagSizeCache_currentPass = ++ILTagSizeCache_passCounter;
+		this->_owner = true;
+	} else {
+		this->_owner = false;
+	}
+}
+
+//------------------------------------------------------------------------------
+ILTagSizeCache::~ILTagSizeCache() {
+
+	if (this->_owner) {
+		ILTagSizeCache_currentPass = 0;
+	}
+}
+
+//------------------------------------------------------------------------------
+std::uint64_t ILTagSizeCache::currentPass() {
+	return ILTagSizeCache_currentPass;
+}
+
 //==============================================================================
 // Class ILRawTag
 //------------------------------------------------------------------------------
@@ -89,25 +210,90 @@ bool ILRawTag::serializeValue(ircommon::IRBuffer & out) const {
 	return out.write(this->value().roBuffer(), this->value().size());
 }
 
+//------------------------------------------------------------------------------
+bool ILRawTag::writeValue(ILTagStreamWriter & out) const {
+
+	// The value is written directly from the tag
+	if (this->value().size() == 0) {
+		return true;
+	}
+	return out.writeBody(this->value().roBuffer(), this->value().size());
+}
+
 //------------------------------------------------------------------------------
 bool ILRawTag::deserializeValue(const ILTagFactory & factory,
 		const void * buff, std::uint64_t size) {
+
+	if (factory.viewMode()) {
+		return this->_value.wrap(buff, size);
+	}
 	return this->_value.set(buff, size);
 }
 
+//------------------------------------------------------------------------------
+bool ILRawTag::equalsValue(const ILTag & other) const {
+
+	if (!ILTagUtil::sameClass(*this, other)) {
+		return ILTag::equalsValue(other);
+	}
+	const IRBuffer & o = static_cast<const ILRawTag &>(other).value();
+	if (this->_value.size() != o.size()) {
+		return false;
+	}
+	return (std::memcmp(this->_value.roBuffer(), o.roBuffer(),
+			o.size()) == 0);
+}
+
 //==============================================================================
 // Class ILTagListTag
 //------------------------------------------------------------------------------
 bool ILBaseTagListTag::serializeValue(ircommon::IRBuffer & out) const {
+	LazyEntry entry;
+	const ILTag * tag;
 
 	for (std::uint64_t i = 0; i < this->count(); i++) {
-		if (this->_list[i] == nullptr) {
+		tag = this->entryState(i, entry);
+		if (entry.size != 0) {
+			// Entries not decoded yet are copied as is.
+			if (!out.write(this->_lazyValue->roBuffer() + entry.offset,
+					entry.size)) {
+				return false;
+			}
+		} else if (tag == nullptr) {
 			// Shortcut to write a TAG_NULL that is a single 0.
 			if (!out.write(0)) {
 				return false;
 			}
 		} else {
-			if (!this->_list[i]->serialize(out)) {
+			if (!tag->serialize(out)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool ILBaseTagListTag::writeValue(ILTagStreamWriter & out) const {
+	static const std::uint8_t nullTag = 0;
+	LazyEntry entry;
+	const ILTag * tag;
+
+	for (std::uint64_t i = 0; i < this->count(); i++) {
+		tag = this->entryState(i, entry);
+		if (entry.size != 0) {
+			// Entries not decoded yet are copied as is.
+			if (!out.writeBody(this->_lazyValue->roBuffer() + entry.offset,
+					entry.size)) {
+				return false;
+			}
+		} else if (tag == nullptr) {
+			// Shortcut to write a TAG_NULL that is a single 0.
+			if (!out.writeBody(&nullTag, 1)) {
+				return false;
+			}
+		} else {
+			if (!out.write(*tag)) {
 				return false;
 			}
 		}
@@ -118,30 +304,195 @@ bool ILBaseTagListTag::serializeValue(ircommon::IRBuffer & out) const {
 //------------------------------------------------------------------------------
 std::uint64_t ILBaseTagListTag::size() const {
 	std::uint64_t total;
+	LazyEntry entry;
+	const ILTag * tag;
 
 	total = 0;
-	for (unsigned int i = 0; i < this->count(); i++) {
-		if (this->_list[i] == nullptr) {
+	for (std::uint64_t i = 0; i < this->count(); i++) {
+		tag = this->entryState(i, entry);
+		if (entry.size != 0) {
+			total += entry.size;
+		} else if (tag == nullptr) {
 			total += 1;
 		} else {
-			total += this->_list[i]->tagSize();
+			total += tag->tagSize();
 		}
 	}
 	return total;
 }
 
 //------------------------------------------------------------------------------
-bool ILBaseTagListTag::deserializeValue(const ILTagFactory & factory,
+bool ILBaseTagListTag::deserializeEntries(const ILTagFactory & factory,
 			const void * buff, std::uint64_t size) {
 	IRBuffer inp(buff, size);
 
 	this->clear();
+	// Entries decoded later could use the arena from any thread
+	if ((!factory.lazyMode()) || (factory.arena())) {
+		while (inp.available() != 0) {
+			ILTag * tag = factory.deserialize(inp);
+			if (!tag) {
+				return false;
+			}
+			if (!this->add(tag)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Only the headers are read in lazy mode
 	while (inp.available() != 0) {
-		ILTag * tag = factory.deserialize(inp);
-		if (!tag) {
+		LazyEntry entry;
+		std::uint64_t tagId;
+		std::uint64_t tagSize;
+
+		if (this->isFull()) {
+			this->clear();
 			return false;
 		}
-		if (!this->add(tag)) {
+		entry.offset = inp.position();
+		if ((!ILTagFactory::extractTagHeader(inp, tagId, tagSize)) ||
+				(inp.available() < tagSize)) {
+			this->clear();
+			return false;
+		}
+		inp.skip(tagSize);
+		entry.size = inp.position() - entry.offset;
+		this->_list.push_back(SharedPointer());
+		this->_lazyEntries.push_back(entry);
+	}
+	if (this->_lazyEntries.empty()) {
+		return true;
+	}
+	this->_lazyValue.reset(new IRBuffer(0, factory.secure()));
+	if (factory.viewMode()) {
+		if (!this->_lazyValue->wrap(buff, size)) {
+			this->clear();
+			return false;
+		}
+	} else {
+		if (!this->_lazyValue->set(buff, size)) {
+			this->clear();
+			return false;
+		}
+	}
+	this->_lazyFactory = &factory;
+	this->_lazyLock.reset(new std::mutex());
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool ILBaseTagListTag::decodeEntry(std::uint64_t idx) const {
+	ILTag * tag;
+
+	if (!this->_lazyLock) {
+		return true;
+	}
+	std::lock_guard<std::mutex> lock(*this->_lazyLock);
+	if ((this->_lazyEntries.empty()) || (this->_lazyEntries[idx].size == 0)) {
+		// Already decoded, maybe by another thread
+		return true;
+	}
+	LazyEntry & entry = this->_lazyEntries[idx];
+	IRBuffer inp(this->_lazyValue->roBuffer() + entry.offset, entry.size);
+
+	tag = this->_lazyFactory->deserialize(inp);
+	if (!tag) {
+		return false;
+	}
+	this->_list[idx].reset(tag);
+	entry.size = 0;
+	return true;
+}
+
+//------------------------------------------------------------------------------
+const ILTag * ILBaseTagListTag::entryState(std::uint64_t idx,
+		LazyEntry & entry) const {
+
+	if (this->_lazyLock) {
+		std::lock_guard<std::mutex> lock(*this->_lazyLock);
+		if (!this->_lazyEntries.empty()) {
+			entry = this->_lazyEntries[idx];
+			return this->_list[idx].get();
+		}
+	}
+	entry.offset = 0;
+	entry.size = 0;
+	return this->_list[idx].get();
+}
+
+//------------------------------------------------------------------------------
+bool ILBaseTagListTag::pending(std::uint64_t idx) const {
+	LazyEntry entry;
+
+	this->entryState(idx, entry);
+	return (entry.size != 0);
+}
+
+//------------------------------------------------------------------------------
+bool ILBaseTagListTag::decodeAll() {
+
+	for (std::uint64_t i = 0; i < this->count(); i++) {
+		if (!this->decodeEntry(i)) {
+			return false;
+		}
+	}
+	this->releaseLazy();
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool ILBaseTagListTag::deserializeValue(const ILTagFactory & factory,
+			const void * buff, std::uint64_t size) {
+	return this->deserializeEntries(factory, buff, size);
+}
+
+//------------------------------------------------------------------------------
+bool ILBaseTagListTag::equalsValue(const ILTag & other) const {
+
+	if (!ILTagUtil::sameClass(*this, other)) {
+		return ILTag::equalsValue(other);
+	}
+	const ILBaseTagListTag & o = static_cast<const ILBaseTagListTag &>(other);
+	if (this->count() != o.count()) {
+		return false;
+	}
+	for (std::uint64_t i = 0; i < this->count(); i++) {
+		LazyEntry ea;
+		LazyEntry eb;
+		const ILTag * a = this->entryState(i, ea);
+		const ILTag * b = o.entryState(i, eb);
+		if ((ea.size != 0) && (eb.size != 0)) {
+			// Both entries are still serialized, compare them as is.
+			if ((ea.size != eb.size) || (std::memcmp(
+					this->_lazyValue->roBuffer() + ea.offset,
+					o._lazyValue->roBuffer() + eb.offset, ea.size) != 0)) {
+				return false;
+			}
+			continue;
+		}
+		if (ea.size != 0) {
+			if (!this->decodeEntry(i)) {
+				return false;
+			}
+			a = this->entryState(i, ea);
+		}
+		if (eb.size != 0) {
+			if (!o.decodeEntry(i)) {
+				return false;
+			}
+			b = o.entryState(i, eb);
+		}
+		if (a == b) {
+			continue;
+		} else if ((a == nullptr) || (b == nullptr)) {
+			// nullptr is serialized as a single 0.
+			const ILTag * t = (a != nullptr) ? a : b;
+			if ((t->id() != ILTag::TAG_NULL) || (t->tagSize() != 1)) {
+				return false;
+			}
+		} else if (!ILTagUtil::equals(*a, *b)) {
 			return false;
 		}
 	}
@@ -155,6 +506,9 @@ bool ILBaseTagListTag::add(SharedPointer obj) {
 		return false;
 	} else {
 		this->_list.push_back(obj);
+		if (!this->_lazyEntries.empty()) {
+			this->_lazyEntries.push_back(LazyEntry{0, 0});
+		}
 		return true;
 	}
 }
@@ -165,7 +519,11 @@ bool ILBaseTagListTag::add(ILTag * obj) {
 	if (this->isFull()) {
 		return false;
 	} else {
-		this->_list.push_back(SharedPointer(obj));
+		this->_list.push_back(SharedPointer(obj, std::default_delete<ILTag>(),
+				ILTagArenaAllocator<ILTag>()));
+		if (!this->_lazyEntries.empty()) {
+			this->_lazyEntries.push_back(LazyEntry{0, 0});
+		}
 		return true;
 	}
 }
@@ -177,6 +535,10 @@ bool ILBaseTagListTag::insert(std::uint64_t idx, SharedPointer obj) {
 		return false;
 	} else {
 		this->_list.insert(this->_list.begin() + idx, obj);
+		if (!this->_lazyEntries.empty()) {
+			this->_lazyEntries.insert(this->_lazyEntries.begin() + idx,
+					LazyEntry{0, 0});
+		}
 		return true;
 	}
 }
@@ -187,7 +549,12 @@ bool ILBaseTagListTag::insert(std::uint64_t idx, ILTag * obj) {
 	if (this->isFull() || (idx >= this->maxEntries())) {
 		return false;
 	} else {
-		this->_list.insert(this->_list.begin() + idx, SharedPointer(obj));
+		this->_list.insert(this->_list.begin() + idx, SharedPointer(obj,
+				std::default_delete<ILTag>(), ILTagArenaAllocator<ILTag>()));
+		if (!this->_lazyEntries.empty()) {
+			this->_lazyEntries.insert(this->_lazyEntries.begin() + idx,
+					LazyEntry{0, 0});
+		}
 		return true;
 	}
 }
@@ -196,16 +563,27 @@ bool ILBaseTagListTag::insert(std::uint64_t idx, ILTag * obj) {
 bool ILBaseTagListTag::remove(std::uint64_t idx) {
 
 	this->_list.erase(this->_list.begin() + idx);
+	if (!this->_lazyEntries.empty()) {
+		this->_lazyEntries.erase(this->_lazyEntries.begin() + idx);
+	}
 	return true;
 }
 
 //------------------------------------------------------------------------------
 ILBaseTagListTag::SharedPointer & ILBaseTagListTag::operator [](std::uint64_t idx) {
+
+	if (!this->decodeEntry(idx)) {
+		throw std::runtime_error("Unable to decode the entry!");
+	}
 	return this->_list[idx];
 }
 
 //------------------------------------------------------------------------------
 const ILBaseTagListTag::SharedPointer & ILBaseTagListTag::operator [](std::uint64_t idx) const {
+
+	if (!this->decodeEntry(idx)) {
+		throw std::runtime_error("Unable to decode the entry!");
+	}
 	return this->_list[idx];
 }
 
@@ -240,6 +618,15 @@ bool ILBaseTagArrayTag::serializeValue(ircommon::IRBuffer & out) const {
     return ILBaseTagListTag::serializeValue(out);
 }
 
+//------------------------------------------------------------------------------
+bool ILBaseTagArrayTag::writeValue(ILTagStreamWriter & out) const {
+
+	if (!out.writeILInt(this->count())) {
+		return false;
+	}
+	return ILBaseTagListTag::writeValue(out);
+}
+
 //------------------------------------------------------------------------------
 std::uint64_t ILBaseTagArrayTag::size() const {
 	return ILInt::size(this->count()) + ILBaseTagListTag::size();
@@ -258,16 +645,11 @@ bool ILBaseTagArrayTag::deserializeValue(const ILTagFactory & factory,
 	if (count > this->maxEntries()) {
 		return false;
 	}
-	for(; count > 0; count--) {
-		ILTag * tag = factory.deserialize(inp);
-		if (!tag) {
-			return false;
-		}
-		if (!this->add(tag)) {
-			return false;
-		}
+	if (!this->deserializeEntries(factory, inp.roPosBuffer(),
+			inp.available())) {
+		return false;
 	}
-	return (inp.available() == 0);
+	return (this->count() == count);
 }
 
 //==============================================================================
@@ -284,6 +666,7 @@ ILTag * ILTagFactory::create(std::uint64_t tagId) const {
 
 //------------------------------------------------------------------------------
 ILTag * ILTagFactory::deserialize(IRBuffer & inp) const {
+	ILTagArena::Scope scope(this->_arena, this->secure());
 	ILTag * tag;
 	std::uint64_t tagId;
 	std::uint64_t tagSize;
@@ -333,6 +716,7 @@ bool ILTagFactory::extractTagHeader(IRBuffer & inp,
 
 //------------------------------------------------------------------------------
 bool ILTagFactory::deserialize(IRBuffer & inp, ILTag & tag) const {
+	ILTagArena::Scope scope(this->_arena, this->secure());
 	std::uint64_t tagId;
 	std::uint64_t tagSize;
 
@@ -367,22 +751,18 @@ bool ILTagUtil::sameClass(const ILTag & a, const ILTag & b) {
 
 //------------------------------------------------------------------------------
 bool ILTagUtil::equals(const ILTag & a, const ILTag & b) {
-	IRBuffer ba(0, true);
-	IRBuffer bb(0, true);
+	ILTagSizeCache cache;
 
-	if (a.id() != b.id()) {
-		return false;
-	}
-	if (!a.serialize(ba)) {
-		return false;
+	if (&a == &b) {
+		return true;
 	}
-	if (!b.serialize(bb)) {
+	if (a.id() != b.id()) {
 		return false;
 	}
-	if (ba.size() != bb.size()) {
+	if (a.cachedSize() != b.cachedSize()) {
 		return false;
 	}
-	return (std::memcmp(ba.roBuffer(), bb.roBuffer(), ba.size()) == 0);
+	return a.equalsValue(b);
 }
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,393 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <ircommon/iltagarena.h>
+#include <ircommon/irutils.h>
+#include <stdexcept>
+#include <new>
+#include <atomic>
+#include <map>
+#include <mutex>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif // _WIN32
+
+using namespace ircommon;
+using namespace ircommon::iltags;
+
+/**
+ * Alignment of all blocks.
+ */
+static const std::size_t ILTagArena_ALIGNMENT = alignof(std::max_align_t);
+
+/**
+ * Size of the header of the chunks.
+ */
+static const std::size_t ILTagArena_CHUNK_HEADER_SIZE =
+		((sizeof(void *) + 2 * sizeof(std::size_t) + ILTagArena_ALIGNMENT - 1) /
+				ILTagArena_ALIGNMENT) * ILTagArena_ALIGNMENT;
+
+/**
+ * The arena active in the current thread.
+ */
+static thread_local ILTagArena * ILTagArena_current = nullptr;
+
+/**
+ * Size of the address range reserved for the chunks of all arenas.
+ */
+static const std::size_t ILTagArena_REGION_SIZE = (sizeof(void *) >= 8) ?
+		(std::size_t(1) << 34) : (std::size_t(1) << 28);
+
+/**
+ * Granularity of the chunks inside the region. It is a multiple of the page
+ * size on all supported platforms.
+ */
+static const std::size_t ILTagArena_GRANULARITY = 64 * 1024;
+
+/**
+ * Address of the region that holds the chunks of all arenas or 0 if it was
+ * not reserved yet. It never changes once it is set.
+ */
+static std::atomic<std::uintptr_t> ILTagArena_regionBase(0);
+
+/**
+ * Type of the list of released ranges. It maps the size of each range to its
+ * address.
+ */
+typedef std::multimap<std::size_t, std::uintptr_t> ILTagArena_FreeList;
+
+/**
+ * State of the region. It must be used only while holding its lock.
+ */
+struct ILTagArena_Region {
+	/**
+	 * The lock.
+	 */
+	std::mutex lock;
+	/**
+	 * Offset of the first byte of the region never used by a chunk.
+	 */
+	std::size_t top;
+	/**
+	 * Released ranges, indexed by size.
+	 */
+	ILTagArena_FreeList free;
+	/**
+	 * Set if the region could not be reserved.
+	 */
+	bool failed;
+};
+
+/**
+ * Returns the state of the region.
+ *
+ * @return The state of the region.
+ */
+static ILTagArena_Region & ILTagArena_region() {
+	// Never destroyed, arenas may outlive the static objects
+	static ILTagArena_Region * region = new ILTagArena_Region{{}, 0, {}, false};
+	return *region;
+}
+
+/**
+ * Reserves the address range of the region. No memory is committed.
+ *
+ * @param[in,out] region The state of the region.
+ * @return true for success or false otherwise.
+ */
+static bool ILTagArena_reserve(ILTagArena_Region & region) {
+	void * base;
+
+	if (ILTagArena_regionBase.load(std::memory_order_relaxed)) {
+		return true;
+	}
+	if (region.failed) {
+		return false;
+	}
+#ifdef _WIN32
+	base = VirtualAlloc(nullptr, ILTagArena_REGION_SIZE, MEM_RESERVE,
+			PAGE_NOACCESS);
+	if (!base) {
+		region.failed = true;
+		return false;
+	}
+#else
+	base = mmap(nullptr, ILTagArena_REGION_SIZE, PROT_NONE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (base == MAP_FAILED) {
+		region.failed = true;
+		return false;
+	}
+#endif // _WIN32
+	ILTagArena_regionBase.store((std::uintptr_t)base,
+			std::memory_order_release);
+	return true;
+}
+
+/**
+ * Commits a range of the region.
+ *
+ * @param[in] addr The address of the range.
+ * @param[in] size The size of the range.
+ * @return true for success or false otherwise.
+ */
+static bool ILTagArena_commit(std::uintptr_t addr, std::size_t size) {
+#ifdef _WIN32
+	return VirtualAlloc((void *)addr, size, MEM_COMMIT, PAGE_READWRITE) !=
+			nullptr;
+#else
+	return mprotect((void *)addr, size, PROT_READ | PROT_WRITE) == 0;
+#endif // _WIN32
+}
+
+/**
+ * Returns a range of the region to the system. The address range itself
+ * remains reserved.
+ *
+ * @param[in] addr The address of the range.
+ * @param[in] size The size of the range.
+ */
+static void ILTagArena_decommit(std::uintptr_t addr, std::size_t size) {
+#ifdef _WIN32
+	VirtualFree((void *)addr, size, MEM_DECOMMIT);
+#else
+	// Replacing the mapping drops the pages and the commit charge
+	mmap((void *)addr, size, PROT_NONE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+#endif // _WIN32
+}
+
+/**
+ * Allocates a range of the region.
+ *
+ * @param[in] size The size of the range. It must be a multiple of
+ * ILTagArena_GRANULARITY.
+ * @return The address of the range or null if it cannot be allocated.
+ */
+static void * ILTagArena_allocateRange(std::size_t size) {
+	ILTagArena_FreeList::iterator i;
+	std::uintptr_t addr;
+
+	ILTagArena_Region & region = ILTagArena_region();
+	std::lock_guard<std::mutex> lock(region.lock);
+	if (!ILTagArena_reserve(region)) {
+		return nullptr;
+	}
+	i = region.free.lower_bound(size);
+	if (i != region.free.end()) {
+		addr = i->second;
+		if (i->first > size) {
+			region.free.emplace(i->first - size, addr + size);
+		}
+		region.free.erase(i);
+	} else if (ILTagArena_REGION_SIZE - region.top >= size) {
+		addr = ILTagArena_regionBase.load(std::memory_order_relaxed) +
+				region.top;
+		region.top += size;
+	} else {
+		return nullptr;
+	}
+	if (!ILTagArena_commit(addr, size)) {
+		region.free.emplace(size, addr);
+		return nullptr;
+	}
+	return (void *)addr;
+}
+
+/**
+ * Releases a range allocated by ILTagArena_allocateRange().
+ *
+ * @param[in] ptr The address of the range.
+ * @param[in] size The size of the range.
+ */
+static void ILTagArena_releaseRange(void * ptr, std::size_t size) {
+
+	ILTagArena_decommit((std::uintptr_t)ptr, size);
+	ILTagArena_Region & region = ILTagArena_region();
+	std::lock_guard<std::mutex> lock(region.lock);
+	region.free.emplace(size, (std::uintptr_t)ptr);
+}
+
+//==============================================================================
+// Class ILTagArena::Scope
+//------------------------------------------------------------------------------
+ILTagArena::Scope::Scope(ILTagArena * arena, bool secure):
+		_previous(ILTagArena_current), _arena(arena), _secure(false) {
+
+	if (arena) {
+		this->_secure = arena->secure();
+		if (secure) {
+			arena->setSecure(true);
+		}
+	}
+	ILTagArena_current = arena;
+}
+
+//------------------------------------------------------------------------------
+ILTagArena::Scope::~Scope() {
+
+	if (this->_arena) {
+		this->_arena->setSecure(this->_secure);
+	}
+	ILTagArena_current = this->_previous;
+}
+
+//==============================================================================
+// Class ILTagArena
+//------------------------------------------------------------------------------
+ILTagArena::ILTagArena(std::size_t chunkSize, bool secure):
+		_chunks(nullptr), _offset(0), _chunkSize(chunkSize), _used(0),
+		_secure(secure), _wipe(false) {
+
+	if (chunkSize == 0) {
+		throw std::invalid_argument("Invalid chunk size.");
+	}
+}
+
+//------------------------------------------------------------------------------
+ILTagArena::~ILTagArena() {
+
+	this->reset();
+	if (this->_chunks) {
+		this->releaseChunk(this->_chunks, 0);
+		this->_chunks = nullptr;
+	}
+}
+
+//------------------------------------------------------------------------------
+std::uint8_t * ILTagArena::chunkData(Chunk * chunk) {
+	return ((std::uint8_t *)chunk) + ILTagArena_CHUNK_HEADER_SIZE;
+}
+
+//------------------------------------------------------------------------------
+void ILTagArena::releaseChunk(Chunk * chunk, std::size_t used) {
+
+	if ((this->secure() || this->_wipe) && (used > 0)) {
+		IRUtils::clearMemory(chunkData(chunk), used);
+	}
+	ILTagArena_releaseRange(chunk, chunk->capacity);
+}
+
+//------------------------------------------------------------------------------
+void * ILTagArena::allocate(std::size_t size) {
+	std::size_t padded;
+	void * block;
+
+	padded = ((size + ILTagArena_ALIGNMENT - 1) / ILTagArena_ALIGNMENT) *
+			ILTagArena_ALIGNMENT;
+	if (padded < size) {
+		return nullptr;
+	}
+	if ((this->_chunks == nullptr) ||
+			(this->_chunks->size - this->_offset < padded)) {
+		std::size_t chunkSize;
+		std::uint8_t * buff;
+		Chunk * chunk;
+
+		chunkSize = (padded > this->_chunkSize) ? padded : this->_chunkSize;
+		if (chunkSize > ILTagArena_REGION_SIZE - ILTagArena_CHUNK_HEADER_SIZE) {
+			return nullptr;
+		}
+		chunkSize = ((ILTagArena_CHUNK_HEADER_SIZE + chunkSize +
+				ILTagArena_GRANULARITY - 1) / ILTagArena_GRANULARITY) *
+				ILTagArena_GRANULARITY;
+		buff = (std::uint8_t *)ILTagArena_allocateRange(chunkSize);
+		if (!buff) {
+			return nullptr;
+		}
+		chunk = (Chunk *)buff;
+		chunk->capacity = chunkSize;
+		chunkSize -= ILTagArena_CHUNK_HEADER_SIZE;
+		chunk->size = chunkSize;
+		chunk->next = this->_chunks;
+		// Only the used part of the previous chunk must be wiped later
+		if (this->_chunks) {
+			this->_chunks->size = this->_offset;
+		}
+		this->_chunks = chunk;
+		this->_offset = 0;
+	}
+	if (this->secure()) {
+		this->_wipe = true;
+	}
+	block = chunkData(this->_chunks) + this->_offset;
+	this->_offset += padded;
+	this->_used += padded;
+	return block;
+}
+
+//------------------------------------------------------------------------------
+void ILTagArena::reset() {
+	Chunk * chunk;
+
+	if (this->_chunks == nullptr) {
+		return;
+	}
+	chunk = this->_chunks->next;
+	while (chunk) {
+		Chunk * next = chunk->next;
+		this->releaseChunk(chunk, chunk->size);
+		chunk = next;
+	}
+	this->_chunks->next = nullptr;
+	if ((this->secure() || this->_wipe) && (this->_offset > 0)) {
+		IRUtils::clearMemory(chunkData(this->_chunks), this->_offset);
+	}
+	this->_offset = 0;
+	this->_used = 0;
+	this->_wipe = false;
+}
+
+//------------------------------------------------------------------------------
+ILTagArena * ILTagArena::current() {
+	return ILTagArena_current;
+}
+
+//------------------------------------------------------------------------------
+void * ILTagArena::allocateObject(std::size_t size) {
+	ILTagArena * arena;
+	void * block;
+
+	arena = ILTagArena_current;
+	if (arena) {
+		block = arena->allocate(size);
+		if (!block) {
+			throw std::bad_alloc();
+		}
+		return block;
+	} else {
+		return ::operator new(size);
+	}
+}
+
+//------------------------------------------------------------------------------
+void ILTagArena::releaseObject(void * ptr) {
+	std::uintptr_t base;
+
+	if (!ptr) {
+		return;
+	}
+	// Arena blocks are recognized by their address alone
+	base = ILTagArena_regionBase.load(std::memory_order_acquire);
+	if ((base != 0) &&
+			((std::uintptr_t)ptr - base < ILTagArena_REGION_SIZE)) {
+		return;
+	}
+	::operator delete(ptr);
+}
+
+//------------------------------------------------------------------------------
@@ -17,6 +17,7 @@
 #include <ircommon/irutils.h>
 #include <ircommon/ilint.h>
 #include <ircommon/irfp.h>
+#include <cstring>
 using namespace ircommon;
 using namespace ircommon::iltags;
 
@@ -27,12 +28,23 @@ bool ILNullTag::serializeValue(ircommon::IRBuffer & out) const {
 	return true;
 }
 
+//------------------------------------------------------------------------------
+bool ILNullTag::writeValue(ILTagStreamWriter & out) const {
+	return true;
+}
+
 //------------------------------------------------------------------------------
 bool ILNullTag::deserializeValue(const ILTagFactory & factory,
 		const void * buff, std::uint64_t size) {
 	return (size == 0);
 }
 
+//------------------------------------------------------------------------------
+bool ILNullTag::equalsValue(const ILTag & other) const {
+	// Both values are empty as the sizes were already compared.
+	return true;
+}
+
 //==============================================================================
 // Class ILBoolTag
 //------------------------------------------------------------------------------
@@ -40,6 +52,14 @@ bool ILBoolTag::serializeValue(ircommon::IRBuffer & out) const {
 	return out.write(this->_value ? 1: 0);
 }
 
+//------------------------------------------------------------------------------
+bool ILBoolTag::writeValue(ILTagStreamWriter & out) const {
+	std::uint8_t v;
+
+	v = this->_value ? 1 : 0;
+	return out.writeBody(&v, sizeof(v));
+}
+
 //------------------------------------------------------------------------------
 std::uint64_t ILBoolTag::size() const {
 	return 1;
@@ -64,6 +84,15 @@ bool ILBoolTag::deserializeValue(const ILTagFactory & factory,
 	return true;
 }
 
+//------------------------------------------------------------------------------
+bool ILBoolTag::equalsValue(const ILTag & other) const {
+
+	if (!ILTagUtil::sameClass(*this, other)) {
+		return ILTag::equalsValue(other);
+	}
+	return (this->_value == static_cast<const ILBoolTag &>(other)._value);
+}
+
 //==============================================================================
 // Class ILILIntTag
 //------------------------------------------------------------------------------
@@ -71,6 +100,11 @@ bool ILILIntTag::serializeValue(ircommon::IRBuffer & out) const {
 	return out.writeILInt(this->_value);
 }
 
+//------------------------------------------------------------------------------
+bool ILILIntTag::writeValue(ILTagStreamWriter & out) const {
+	return out.writeILInt(this->_value);
+}
+
 //------------------------------------------------------------------------------
 std::uint64_t ILILIntTag::size() const {
 	return ILInt::size(this->_value);
@@ -82,6 +116,15 @@ bool ILILIntTag::deserializeValue(const ILTagFactory & factory,
 	return ((unsigned int)(ILInt::decode(buff, size, &(this->_value))) == size);
 }
 
+//------------------------------------------------------------------------------
+bool ILILIntTag::equalsValue(const ILTag & other) const {
+
+	if (!ILTagUtil::sameClass(*this, other)) {
+		return ILTag::equalsValue(other);
+	}
+	return (this->_value == static_cast<const ILILIntTag &>(other)._value);
+}
+
 //==============================================================================
 // Class ILStringTag
 //------------------------------------------------------------------------------
@@ -90,6 +133,15 @@ bool ILStringTag::serializeValue(
 	return out.write(this->_value.c_str(), this->_value.size());
 }
 
+//------------------------------------------------------------------------------
+bool ILStringTag::writeValue(ILTagStreamWriter & out) const {
+
+	if (this->_value.empty()) {
+		return true;
+	}
+	return out.writeBody(this->_value.c_str(), this->_value.size());
+}
+
 //------------------------------------------------------------------------------
 bool ILStringTag::deserializeValue(
 		const ILTagFactory & factory, const void * buff, std::uint64_t size) {
@@ -99,6 +151,15 @@ bool ILStringTag::deserializeValue(
 	return true;
 }
 
+//------------------------------------------------------------------------------
+bool ILStringTag::equalsValue(const ILTag & other) const {
+
+	if (!ILTagUtil::sameClass(*this, other)) {
+		return ILTag::equalsValue(other);
+	}
+	return (this->_value == static_cast<const ILStringTag &>(other)._value);
+}
+
 //------------------------------------------------------------------------------
 std::uint64_t ILStringTag::size() const {
 	return this->_value.size();
@@ -119,11 +180,33 @@ bool ILBigDecimalTag::deserializeValue(const ILTagFactory & factory,
 		return false;
 	}
 	IRUtils::BE2Int(buff, this->_scale);
+	if (factory.viewMode()) {
+		return this->_integral.wrap(
+				((const std::uint8_t *)buff) + sizeof(this->_scale),
+				size - sizeof(this->_scale));
+	}
 	return this->_integral.set(
 			((const std::uint8_t *)buff) + sizeof(this->_scale),
 			size - sizeof(this->_scale));
 }
 
+//------------------------------------------------------------------------------
+bool ILBigDecimalTag::equalsValue(const ILTag & other) const {
+
+	if (!ILTagUtil::sameClass(*this, other)) {
+		return ILTag::equalsValue(other);
+	}
+	const ILBigDecimalTag & o = static_cast<const ILBigDecimalTag &>(other);
+	if (this->_scale != o._scale) {
+		return false;
+	}
+	if (this->_integral.size() != o._integral.size()) {
+		return false;
+	}
+	return (std::memcmp(this->_integral.roBuffer(), o._integral.roBuffer(),
+			o._integral.size()) == 0);
+}
+
 //------------------------------------------------------------------------------
 bool ILBigDecimalTag::serializeValue(ircommon::IRBuffer & out) const {
 
@@ -133,6 +216,21 @@ bool ILBigDecimalTag::serializeValue(ircommon::IRBuffer & out) const {
 	return out.write(this->_integral.roBuffer(), this->_integral.size());
 }
 
+//------------------------------------------------------------------------------
+bool ILBigDecimalTag::writeValue(ILTagStreamWriter & out) const {
+	std::uint8_t scale[sizeof(this->_scale)];
+
+	// The integral part is written directly from the tag
+	IRUtils::int2BE(this->_scale, scale);
+	if (!out.writeBody(scale, sizeof(scale))) {
+		return false;
+	}
+	if (this->_integral.size() == 0) {
+		return true;
+	}
+	return out.writeBody(this->_integral.roBuffer(), this->_integral.size());
+}
+
 //==============================================================================
 // Class ILILIntArrayTag
 //------------------------------------------------------------------------------
@@ -141,8 +239,17 @@ bool ILILIntArrayTag::serializeValue(ircommon::IRBuffer & out) const {
 	if (!out.writeILInt(this->count())) {
 		return false;
 	}
-	for (std::uint64_t i = 0; i < this->count(); i++) {
-		if (!out.writeILInt(this->get(i))) {
+	return out.writeILInts(this->_values.data(), this->count());
+}
+
+//------------------------------------------------------------------------------
+bool ILILIntArrayTag::writeValue(ILTagStreamWriter & out) const {
+
+	if (!out.writeILInt(this->count())) {
+		return false;
+	}
+	for (std::uint64_t v: this->_values) {
+		if (!out.writeILInt(v)) {
 			return false;
 		}
 	}
@@ -154,9 +261,7 @@ std::uint64_t ILILIntArrayTag::size() const {
 	std::uint64_t s;
 
 	s = ILInt::size(this->count());
-	for (std::uint64_t i = 0; i < this->count(); i++) {
-		s += ILInt::size(this->get(i));
-	}
+	s += ILInt::size(this->_values.data(), this->count());
 	return s;
 }
 
@@ -165,21 +270,33 @@ bool ILILIntArrayTag::deserializeValue(const ILTagFactory & factory,
 		const void * buff, std::uint64_t size) {
 	IRBuffer inp(buff, size);
 	std::uint64_t count;
-	std::uint64_t v;
 
 	if (!inp.readILInt(count)) {
 		return false;
 	}
 	this->clear();
-	for(; count > 0; count--) {
-		if (!inp.readILInt(v)) {
-			return false;
-		}
-		this->add(v);
+	// Each value uses at least 1 byte
+	if (count > inp.available()) {
+		return false;
+	}
+	this->_values.resize(count);
+	if (!inp.readILInts(this->_values.data(), count)) {
+		this->clear();
+		return false;
 	}
 	return (inp.available() == 0);
 }
 
+//------------------------------------------------------------------------------
+bool ILILIntArrayTag::equalsValue(const ILTag & other) const {
+
+	if (!ILTagUtil::sameClass(*this, other)) {
+		return ILTag::equalsValue(other);
+	}
+	return (this->_values ==
+			static_cast<const ILILIntArrayTag &>(other)._values);
+}
+
 //------------------------------------------------------------------------------
 bool ILILIntArrayTag::add(std::uint64_t v) {
 
@@ -0,0 +1,540 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <ircommon/iltagstream.h>
+#include <ircommon/ilint.h>
+#include <cstring>
+#include <stdexcept>
+#ifdef _WIN32
+	#include <io.h>
+#else
+	#include <unistd.h>
+	#include <cerrno>
+#endif //_WIN32
+
+using namespace ircommon;
+using namespace ircommon::iltags;
+
+/**
+ * Size of the temporary buffers used to move bytes around.
+ */
+#define ILTagStream_CHUNK_SIZE 4096
+
+/**
+ * Maximum size of an ILInt.
+ */
+#define ILTagStream_MAX_ILINT_SIZE 9
+
+//==============================================================================
+// Class ILTagInput
+//------------------------------------------------------------------------------
+bool ILTagInput::skip(std::uint64_t size) {
+	std::uint8_t tmp[ILTagStream_CHUNK_SIZE];
+
+	while (size > 0) {
+		std::uint64_t n = (size < sizeof(tmp)) ? size : sizeof(tmp);
+		if (!this->read(tmp, n)) {
+			return false;
+		}
+		size -= n;
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool ILTagInput::atEnd() {
+	return false;
+}
+
+//==============================================================================
+// Class ILTagMemoryInput
+//------------------------------------------------------------------------------
+bool ILTagMemoryInput::read(void * buff, std::uint64_t size) {
+
+	if (size > (this->_size - this->_position)) {
+		return false;
+	}
+	std::memcpy(buff, this->_buff + this->_position, size);
+	this->_position += size;
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool ILTagMemoryInput::skip(std::uint64_t size) {
+
+	if (size > (this->_size - this->_position)) {
+		return false;
+	}
+	this->_position += size;
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool ILTagMemoryInput::atEnd() {
+	return (this->_position == this->_size);
+}
+
+//==============================================================================
+// Class ILTagIStreamInput
+//------------------------------------------------------------------------------
+bool ILTagIStreamInput::read(void * buff, std::uint64_t size) {
+
+	this->_in.read((char *)buff, size);
+	return (std::uint64_t(this->_in.gcount()) == size);
+}
+
+//------------------------------------------------------------------------------
+bool ILTagIStreamInput::skip(std::uint64_t size) {
+
+	this->_in.ignore(size);
+	return (std::uint64_t(this->_in.gcount()) == size);
+}
+
+//------------------------------------------------------------------------------
+bool ILTagIStreamInput::atEnd() {
+	return (this->_in.peek() == std::istream::traits_type::eof());
+}
+
+//==============================================================================
+// Class ILTagOStreamOutput
+//------------------------------------------------------------------------------
+bool ILTagOStreamOutput::write(const void * buff, std::uint64_t size) {
+
+	this->_out.write((const char *)buff, size);
+	return this->_out.good();
+}
+
+//==============================================================================
+// Class ILTagBufferOutput
+//------------------------------------------------------------------------------
+bool ILTagBufferOutput::write(const void * buff, std::uint64_t size) {
+	return this->_out.write(buff, size);
+}
+
+//==============================================================================
+// Class ILTagTeeOutput
+//------------------------------------------------------------------------------
+bool ILTagTeeOutput::write(const void * buff, std::uint64_t size) {
+
+	if (!this->_first.write(buff, size)) {
+		return false;
+	}
+	return this->_second.write(buff, size);
+}
+
+//==============================================================================
+// Class ILTagFDInput
+//------------------------------------------------------------------------------
+bool ILTagFDInput::read(void * buff, std::uint64_t size) {
+	std::uint8_t * p = (std::uint8_t *)buff;
+
+	if ((size > 0) && (this->_hasPeek)) {
+		*p = this->_peek;
+		this->_hasPeek = false;
+		p++;
+		size--;
+	}
+	while (size > 0) {
+#ifdef _WIN32
+		int n = _read(this->_fd, p,
+				(size < 0x40000000) ? (unsigned int)size : 0x40000000);
+#else
+		ssize_t n = ::read(this->_fd, p,
+				(size < 0x40000000) ? size : 0x40000000);
+		if ((n < 0) && (errno == EINTR)) {
+			continue;
+		}
+#endif //_WIN32
+		if (n <= 0) {
+			return false;
+		}
+		p += n;
+		size -= n;
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool ILTagFDInput::atEnd() {
+
+	if (this->_hasPeek) {
+		return false;
+	}
+	while (true) {
+#ifdef _WIN32
+		int n = _read(this->_fd, &this->_peek, 1);
+#else
+		ssize_t n = ::read(this->_fd, &this->_peek, 1);
+		if ((n < 0) && (errno == EINTR)) {
+			continue;
+		}
+#endif //_WIN32
+		// Read errors are reported by the next call to read()
+		this->_hasPeek = (n == 1);
+		return (n == 0);
+	}
+}
+
+//==============================================================================
+// Class ILTagFDOutput
+//------------------------------------------------------------------------------
+bool ILTagFDOutput::write(const void * buff, std::uint64_t size) {
+	const std::uint8_t * p = (const std::uint8_t *)buff;
+
+	while (size > 0) {
+#ifdef _WIN32
+		int n = _write(this->_fd, p,
+				(size < 0x40000000) ? (unsigned int)size : 0x40000000);
+#else
+		ssize_t n = ::write(this->_fd, p,
+				(size < 0x40000000) ? size : 0x40000000);
+		if ((n < 0) && (errno == EINTR)) {
+			continue;
+		}
+#endif //_WIN32
+		if (n <= 0) {
+			return false;
+		}
+		p += n;
+		size -= n;
+	}
+	return true;
+}
+
+//==============================================================================
+// Class ILTagStreamReader
+//------------------------------------------------------------------------------
+ILTagStreamReader::ILTagStreamReader(ILTagInput & in): _in(in),
+		_remaining(0), _hasPeek(false), _peek(0), _error(false), _eof(false),
+		_tagId(0), _tagSize(0) {
+}
+
+//------------------------------------------------------------------------------
+bool ILTagStreamReader::readHeaderBytes(void * buff, std::uint64_t size) {
+
+	if ((!this->_levels.empty()) && (this->_levels.back() < size)) {
+		return this->fail();
+	}
+	if (!this->_in.read(buff, size)) {
+		return this->fail();
+	}
+	if (!this->_levels.empty()) {
+		this->_levels.back() -= size;
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool ILTagStreamReader::readHeaderILInt(std::uint64_t & v) {
+	std::uint8_t buff[ILTagStream_MAX_ILINT_SIZE];
+	int size;
+
+	if (!this->readHeaderBytes(buff, 1)) {
+		return false;
+	}
+	size = ILInt::encodedSize(buff[0]);
+	if ((size > 1) && (!this->readHeaderBytes(buff + 1, size - 1))) {
+		return false;
+	}
+	if (ILInt::decode(buff, size, v) != size) {
+		return this->fail();
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool ILTagStreamReader::next(std::uint64_t & tagId, std::uint64_t & tagSize) {
+
+	this->_eof = false;
+	if (!this->skip()) {
+		return false;
+	}
+	if (this->_levels.empty()) {
+		if (this->_in.atEnd()) {
+			this->_eof = true;
+			return false;
+		}
+	} else if (this->_levels.back() == 0) {
+		return false;
+	}
+	if (!this->readHeaderILInt(this->_tagId)) {
+		return false;
+	}
+	if (this->_tagId == ILTag::TAG_ILINT64) {
+		// The size depends on the first byte of the body
+		if (!this->readHeaderBytes(&this->_peek, 1)) {
+			return false;
+		}
+		if (!this->_levels.empty()) {
+			this->_levels.back() += 1;
+		}
+		this->_hasPeek = true;
+		this->_tagSize = ILInt::encodedSize(this->_peek);
+	} else if (ILTag::isImplicit(this->_tagId)) {
+		this->_tagSize = ILTag::getImplicitValueSize(this->_tagId);
+	} else {
+		if (!this->readHeaderILInt(this->_tagSize)) {
+			return false;
+		}
+	}
+	if (!this->_levels.empty()) {
+		if (this->_levels.back() < this->_tagSize) {
+			return this->fail();
+		}
+		this->_levels.back() -= this->_tagSize;
+	}
+	this->_remaining = this->_tagSize;
+	tagId = this->_tagId;
+	tagSize = this->_tagSize;
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool ILTagStreamReader::skip() {
+	std::uint64_t size;
+
+	if (this->_error) {
+		return false;
+	}
+	size = this->_remaining;
+	if (this->_hasPeek) {
+		this->_hasPeek = false;
+		size--;
+	}
+	this->_remaining = 0;
+	if (!this->_in.skip(size)) {
+		return this->fail();
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool ILTagStreamReader::read(void * buff, std::uint64_t size) {
+	std::uint8_t * p = (std::uint8_t *)buff;
+
+	if ((this->_error) || (size > this->_remaining)) {
+		return false;
+	}
+	if ((size > 0) && (this->_hasPeek)) {
+		*p = this->_peek;
+		this->_hasPeek = false;
+		this->_remaining--;
+		p++;
+		size--;
+	}
+	if (!this->_in.read(p, size)) {
+		return this->fail();
+	}
+	this->_remaining -= size;
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool ILTagStreamReader::readILInt(std::uint64_t & v) {
+	std::uint8_t buff[ILTagStream_MAX_ILINT_SIZE];
+	int size;
+
+	if (!this->read(buff, 1)) {
+		return false;
+	}
+	size = ILInt::encodedSize(buff[0]);
+	if ((size > 1) && (!this->read(buff + 1, size - 1))) {
+		return false;
+	}
+	if (ILInt::decode(buff, size, v) != size) {
+		return this->fail();
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool ILTagStreamReader::read(IRBuffer & out) {
+	std::uint8_t tmp[ILTagStream_CHUNK_SIZE];
+
+	if (!out.reserve(out.position() + this->_remaining)) {
+		return false;
+	}
+	while (this->_remaining > 0) {
+		std::uint64_t n = (this->_remaining < sizeof(tmp)) ?
+				this->_remaining : sizeof(tmp);
+		if (!this->read(tmp, n)) {
+			return false;
+		}
+		if (!out.write(tmp, n)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+ILTag * ILTagStreamReader::readTag(const ILTagFactory & factory) {
+
+	if ((factory.viewMode()) || (this->_remaining != this->_tagSize)) {
+		return nullptr;
+	}
+	// Rebuild the header to let the factory apply all its rules
+	IRBuffer serialized(0, factory.secure());
+	if (!serialized.writeILInt(this->_tagId)) {
+		return nullptr;
+	}
+	if ((!ILTag::isImplicit(this->_tagId)) &&
+			(!serialized.writeILInt(this->_tagSize))) {
+		return nullptr;
+	}
+	if (!this->read(serialized)) {
+		return nullptr;
+	}
+	serialized.beginning();
+	ILTag * tag = factory.deserialize(serialized);
+	if (!tag) {
+		this->fail();
+	}
+	return tag;
+}
+
+//------------------------------------------------------------------------------
+bool ILTagStreamReader::enter() {
+
+	if ((this->_error) || (this->_hasPeek)) {
+		return false;
+	}
+	this->_levels.push_back(this->_remaining);
+	this->_remaining = 0;
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool ILTagStreamReader::leave() {
+	std::uint64_t size;
+
+	if (this->_levels.empty()) {
+		return false;
+	}
+	if (!this->skip()) {
+		return false;
+	}
+	size = this->_levels.back();
+	this->_levels.pop_back();
+	if (!this->_in.skip(size)) {
+		return this->fail();
+	}
+	return true;
+}
+
+//==============================================================================
+// Class ILTagStreamWriter
+//------------------------------------------------------------------------------
+bool ILTagStreamWriter::emit(const void * buff, std::uint64_t size) {
+
+	if ((!this->_levels.empty()) && (this->_levels.back() < size)) {
+		return false;
+	}
+	if (!this->_out.write(buff, size)) {
+		return false;
+	}
+	if (!this->_levels.empty()) {
+		this->_levels.back() -= size;
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool ILTagStreamWriter::emitILInt(std::uint64_t v) {
+	std::uint8_t buff[ILTagStream_MAX_ILINT_SIZE];
+	int size;
+
+	size = ILInt::encode(v, buff, sizeof(buff));
+	if (size == 0) {
+		return false;
+	}
+	return this->emit(buff, size);
+}
+
+//------------------------------------------------------------------------------
+bool ILTagStreamWriter::beginTag(std::uint64_t tagId, std::uint64_t tagSize) {
+
+	if (tagId == ILTag::TAG_ILINT64) {
+		if ((tagSize == 0) || (tagSize > ILTagStream_MAX_ILINT_SIZE)) {
+			return false;
+		}
+	} else if (ILTag::isImplicit(tagId)) {
+		if (tagSize != ILTag::getImplicitValueSize(tagId)) {
+			return false;
+		}
+	}
+	if (!this->emitILInt(tagId)) {
+		return false;
+	}
+	if ((!ILTag::isImplicit(tagId)) && (!this->emitILInt(tagSize))) {
+		return false;
+	}
+	if (!this->_levels.empty()) {
+		if (this->_levels.back() < tagSize) {
+			return false;
+		}
+		this->_levels.back() -= tagSize;
+	}
+	this->_levels.push_back(tagSize);
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool ILTagStreamWriter::writeBody(const void * buff, std::uint64_t size) {
+
+	if (this->_levels.empty()) {
+		return false;
+	}
+	return this->emit(buff, size);
+}
+
+//------------------------------------------------------------------------------
+bool ILTagStreamWriter::writeILInt(std::uint64_t v) {
+
+	if (this->_levels.empty()) {
+		return false;
+	}
+	return this->emitILInt(v);
+}
+
+//------------------------------------------------------------------------------
+bool ILTagStreamWriter::endTag() {
+
+	if ((this->_levels.empty()) || (this->_levels.back() != 0)) {
+		return false;
+	}
+	this->_levels.pop_back();
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool ILTagStreamWriter::writeTag(const ILTag & tag) {
+
+	if (!this->beginTag(tag.id(), tag.cachedSize())) {
+		return false;
+	}
+	if (!tag.writeValue(*this)) {
+		return false;
+	}
+	return this->endTag();
+}
+
+//------------------------------------------------------------------------------
+bool ILTagStreamWriter::write(const ILTag & tag) {
+	ILTagSizeCache cache;
+
+	return this->writeTag(tag);
+}
+//------------------------------------------------------------------------------
@@ -26,11 +26,24 @@ using namespace ircommon::codec;
 //==============================================================================
 // Class IRAlphabet
 //------------------------------------------------------------------------------
-IRAlphabet::IRAlphabet(int size):_size(size){
+IRAlphabet::IRAlphabet(int size):_size(size), _charMap(nullptr) {
 
 	if (size < 2) {
 		throw std::invalid_argument("Invalid size.");
 	}
+	for (int i = 0; i < 256; i++) {
+		this->_valueMap[i] = -1;
+	}
+}
+
+//------------------------------------------------------------------------------
+void IRAlphabet::setMap(const char * map) {
+
+	this->_charMap = map;
+	// Scan backwards so the first occurrence of each character prevails.
+	for (int i = this->size() - 1; i >= 0; i--) {
+		this->addValue(map[i], i);
+	}
 }
 
 //==============================================================================
@@ -40,6 +53,7 @@ IRGenericAlphabet::IRGenericAlphabet(const char * map, int mapSize):
 		IRAlphabet(mapSize){
 	this->_map = new char[mapSize];
 	std::memcpy(this->_map, map, mapSize);
+	this->setMap(this->_map);
 }
 
 //------------------------------------------------------------------------------
@@ -51,13 +65,7 @@ IRGenericAlphabet::~IRGenericAlphabet() {
 
 //------------------------------------------------------------------------------
 int IRGenericAlphabet::getValue(int c) const {
-
-	for (int i = 0; i < this->size(); i++) {
-		if (this->_map[i] == c) {
-			return i;
-		}
-	}
-	return -1;
+	return this->mappedValue(c);
 }
 
 //------------------------------------------------------------------------------
@@ -75,18 +83,12 @@ IRBinaryAlphabet::IRBinaryAlphabet(char f, char t): IRAlphabet(2) {
 	}
 	this->_map[0] = f;
 	this->_map[1] = t;
+	this->setMap(this->_map);
 }
 
 //------------------------------------------------------------------------------
 int IRBinaryAlphabet::getValue(int c) const {
-
-	if (this->_map[0] == c) {
-		return 0;
-	} else if (this->_map[1] == c) {
-		return 1;
-	} else {
-		return -1;
-	}
+	return this->mappedValue(c);
 }
 
 //------------------------------------------------------------------------------
@@ -102,10 +104,18 @@ static const char * IRHexAlphabet_ALPHABET_U = "0123456789ABCDEF";
 static const char * IRHexAlphabet_ALPHABET_L = "0123456789abcdef";
 
 IRHexAlphabet::IRHexAlphabet(bool lower): IRAlphabet(16) {
+	const char * other;
+
 	if (lower) {
-		this->_map = IRHexAlphabet_ALPHABET_L;
+		this->setMap(IRHexAlphabet_ALPHABET_L);
+		other = IRHexAlphabet_ALPHABET_U;
 	} else {
-		this->_map = IRHexAlphabet_ALPHABET_U;
+		this->setMap(IRHexAlphabet_ALPHABET_U);
+		other = IRHexAlphabet_ALPHABET_L;
+	}
+	// Both cases are accepted on decoding
+	for (int i = 10; i < 16; i++) {
+		this->addValue(other[i], i);
 	}
 }
 
@@ -115,22 +125,13 @@ IRHexAlphabet::~IRHexAlphabet(){
 
 //------------------------------------------------------------------------------
 int IRHexAlphabet::getValue(int c) const {
-
-	if ((c >= '0') && (c <= '9')) {
-		return c - '0';
-	} else if ((c >= 'A') && (c <= 'F')) {
-		return c - 'A' + 10;
-	} else if ((c >= 'a') && (c <= 'f')) {
-		return c - 'a' + 10;
-	} else {
-		return -1;
-	}
+	return this->mappedValue(c);
 }
 
 //------------------------------------------------------------------------------
 int IRHexAlphabet::getChar(int v) const {
 
-	return this->_map[v & 0xF];
+	return this->charMap()[v & 0xF];
 }
 
 //==============================================================================
@@ -145,19 +146,24 @@ static const char * IRBase32Alphabet_ALPHABET_HEX =
 		"0123456789abcdefghijklmnopqrstuv";
 
 //------------------------------------------------------------------------------
-IRBase32Alphabet::IRBase32Alphabet(bool lower, bool extendedHex): IRAlphabet(32),
-		_extendedHex(extendedHex) {
-	int base;
+IRBase32Alphabet::IRBase32Alphabet(bool lower, bool extendedHex):
+		IRAlphabet(32) {
+	const char * map;
 
-	if (lower) {
-		base = 32;
+	if (extendedHex) {
+		map = IRBase32Alphabet_ALPHABET_HEX;
 	} else {
-		base = 0;
+		map = IRBase32Alphabet_ALPHABET;
 	}
-	if (extendedHex) {
-		this->_map = IRBase32Alphabet_ALPHABET_HEX + base;
+	if (lower) {
+		this->setMap(map + 32);
 	} else {
-		this->_map = IRBase32Alphabet_ALPHABET + base;
+		this->setMap(map);
+	}
+	// Both cases are accepted on decoding
+	for (int i = 0; i < 32; i++) {
+		this->addValue(map[i], i);
+		this->addValue(map[i + 32], i);
 	}
 }
 
@@ -167,34 +173,12 @@ IRBase32Alphabet::~IRBase32Alphabet() {
 
 //------------------------------------------------------------------------------
 int IRBase32Alphabet::getValue(int c) const {
-
-	// TODO This code is not ready to be compiled on EBCDIC encoding.
-	if (this->_extendedHex) {
-		if ((c >= '0') && (c <= '9')) {
-			return c - '0';
-		} else if ((c >= 'A') && (c <= 'V')) {
-			return c - 'A' + 10;
-		} else if ((c >= 'a') && (c <= 'v')) {
-			return c - 'a' + 10;
-		} else {
-			return -1;
-		}
-	} else {
-		if ((c >= 'A') && (c <= 'Z')) {
-			return c - 'A';
-		} else if ((c >= 'a') && (c <= 'z')) {
-			return c - 'a';
-		} else if ((c >= '2') && (c <= '7')) {
-			return c - '2' + 26;
-		}else {
-			return -1;
-		}
-	}
+	return this->mappedValue(c);
 }
 
 //------------------------------------------------------------------------------
 int IRBase32Alphabet::getChar(int v) const {
-	return _map[v & 0x1F];
+	return this->charMap()[v & 0x1F];
 }
 
 //==============================================================================
@@ -213,6 +197,7 @@ IRBase64Alphabet::IRBase64Alphabet(int s62, int s63) : IRAlphabet(64) {
 	std::memcpy(this->_map, IRBase64Alphabet_ALPHABET, 62);
 	this->_map[62] = s62;
 	this->_map[63] = s63;
+	this->setMap(this->_map);
 }
 
 //------------------------------------------------------------------------------
@@ -221,20 +206,7 @@ IRBase64Alphabet::~IRBase64Alphabet(){
 
 //------------------------------------------------------------------------------
 int IRBase64Alphabet::getValue(int c) const {
-
-	if ((c >= 'A') && (c <= 'Z')) {
-		return c - 'A';
-	} else if ((c >= 'a') && (c <= 'z')) {
-		return c - 'a' + 26;
-	} else if ((c >= '0') && (c <= '9')) {
-		return c - '0' + 26 + 26;
-	} else if (c == this->_map[62]) {
-		return 62;
-	} else if (c == this->_map[63]) {
-		return 63;
-	} else {
-		return -1;
-	}
+	return this->mappedValue(c);
 }
 
 //------------------------------------------------------------------------------
@@ -16,6 +16,7 @@
 #include <ircommon/irbuffer.h>
 #include <ircommon/ilint.h>
 #include <ircommon/irfp.h>
+#include <ircommon/irsecmem.h>
 #include <ircommon/irutils.h>
 #include <cstring>
 #include <algorithm>
@@ -24,25 +25,87 @@
 
 using namespace ircommon;
 
+//==============================================================================
+// Class IRFixedGrowthPolicy
+//------------------------------------------------------------------------------
+std::uint64_t IRFixedGrowthPolicy::nextSize(std::uint64_t buffSize,
+		std::uint64_t minSize, std::uint64_t inc) const {
+	return IRUtils::getPaddedSize(minSize, inc);
+}
+
+//------------------------------------------------------------------------------
+const IRFixedGrowthPolicy & IRFixedGrowthPolicy::instance() {
+	static IRFixedGrowthPolicy policy;
+	return policy;
+}
+
+//==============================================================================
+// Class IRGeometricGrowthPolicy
+//------------------------------------------------------------------------------
+IRGeometricGrowthPolicy::IRGeometricGrowthPolicy(std::uint64_t num,
+		std::uint64_t den): _num(num), _den(den) {
+
+	if ((den == 0) || (num <= den)) {
+		throw std::invalid_argument("The factor must be larger than 1.");
+	}
+}
+
+//------------------------------------------------------------------------------
+std::uint64_t IRGeometricGrowthPolicy::nextSize(std::uint64_t buffSize,
+		std::uint64_t minSize, std::uint64_t inc) const {
+	std::uint64_t newSize;
+
+	if (buffSize <= (0xFFFFFFFFFFFFFFFFll / this->_num)) {
+		newSize = (buffSize * this->_num) / this->_den;
+	} else {
+		newSize = minSize;
+	}
+	return IRUtils::getPaddedSizeBestFit(std::max(newSize, minSize), inc);
+}
+
+//------------------------------------------------------------------------------
+const IRGeometricGrowthPolicy & IRGeometricGrowthPolicy::doubling() {
+	static IRGeometricGrowthPolicy policy(2, 1);
+	return policy;
+}
+
+//------------------------------------------------------------------------------
+const IRGeometricGrowthPolicy & IRGeometricGrowthPolicy::oneAndHalf() {
+	static IRGeometricGrowthPolicy policy(3, 2);
+	return policy;
+}
+
 //==============================================================================
 // Class IRBuffer
 //------------------------------------------------------------------------------
 IRBuffer::IRBuffer(const void * buff, std::uint64_t buffSize):
 		_buff(nullptr),	_robuff((const std::uint8_t *)buff),
 		_size(buffSize), _buffSize(buffSize), _position(0),
-		_inc(0), _secure(false) {
+		_inc(0), _secure(false), _growthPolicy(nullptr), _view(false) {
 }
 
 //------------------------------------------------------------------------------
 IRBuffer::IRBuffer(std::uint64_t reserved, bool secure, std::uint64_t inc):
-		_robuff(nullptr),_size(0), _position(0), _inc(inc), _secure(secure) {
+		_robuff(nullptr),_size(0), _position(0), _inc(inc), _secure(secure),
+		_growthPolicy(nullptr), _view(false) {
 
 	if (inc == 0) {
 		throw std::invalid_argument("inc cannot be 0");
 	}
 
 	this->_buffSize = IRUtils::getPaddedSize(reserved, this->_inc);
-	this->_buff = new(std::nothrow) std::uint8_t[this->_buffSize];
+	this->_buff = this->allocate(this->_buffSize);
+}
+
+//------------------------------------------------------------------------------
+IRBuffer::IRBuffer(NoStorage, bool secure, std::uint64_t inc):
+		_buff(nullptr), _robuff(nullptr), _size(0), _buffSize(0),
+		_position(0), _inc(inc), _secure(secure), _growthPolicy(nullptr),
+		_view(false) {
+
+	if (inc == 0) {
+		throw std::invalid_argument("inc cannot be 0");
+	}
 }
 
 //------------------------------------------------------------------------------
@@ -55,7 +118,7 @@ IRBuffer::~IRBuffer() {
 //------------------------------------------------------------------------------
 bool IRBuffer::setSize(std::uint64_t size) {
 
-	if (this->readOnly()) {
+	if (!this->writable()) {
 		return false;
 	}
 
@@ -115,39 +178,60 @@ std::uint64_t IRBuffer::rewind(std::uint64_t delta) {
 }
 
 //------------------------------------------------------------------------------
-bool IRBuffer::reserve(std::uint64_t newSize) {
+bool IRBuffer::resize(std::uint64_t newBuffSize) {
+	std::uint8_t * newBuff;
 
-	if (this->readOnly()) {
+	newBuff = this->allocate(newBuffSize);
+	if (newBuff) {
+		if (this->_buff) {
+			std::memcpy(newBuff, this->_buff, this->_buffSize);
+			this->dispose(this->_buff, this->_buffSize);
+		}
+		this->_buff = newBuff;
+		this->_buffSize = newBuffSize;
+		return true;
+	} else {
 		return false;
 	}
+}
 
-	if (newSize > this->_buffSize) {
-		std::uint64_t newBuffSize = IRUtils::getPaddedSize(newSize, this->_inc);
-		std::uint8_t * newBuff = new(std::nothrow) std::uint8_t[newBuffSize];
-		if (newBuff) {
-			if (this->_buff) {
-				std::memcpy(newBuff, this->_buff, this->_buffSize);
-				this->dispose(this->_buff, this->_buffSize);
-			}
-			this->_buff = newBuff;
-			this->_buffSize = newBuffSize;
-			return true;
+//------------------------------------------------------------------------------
+bool IRBuffer::grow(std::uint64_t minSize) {
+
+	if (minSize > this->_buffSize) {
+		if (this->_growthPolicy) {
+			return this->resize(this->_growthPolicy->nextSize(
+					this->_buffSize, minSize, this->_inc));
 		} else {
-			return false;
+			return this->resize(IRUtils::getPaddedSize(minSize, this->_inc));
 		}
 	} else {
 		return true;
 	}
 }
 
+//------------------------------------------------------------------------------
+bool IRBuffer::reserve(std::uint64_t newSize) {
+
+	if (!this->writable()) {
+		return false;
+	}
+
+	if (newSize > this->_buffSize) {
+		return this->resize(IRUtils::getPaddedSize(newSize, this->_inc));
+	} else {
+		return true;
+	}
+}
+
 //------------------------------------------------------------------------------
 bool IRBuffer::write(const void * buff, std::uint64_t buffSize) {
 
-	if (this->readOnly()) {
+	if (!this->writable()) {
 		return false;
 	}
 
-	if (!this->reserve(this->_position + buffSize)) {
+	if (!this->grow(this->_position + buffSize)) {
 		return false;
 	}
 	std::memcpy(this->_buff + this->_position, buff, buffSize);
@@ -166,21 +250,32 @@ std::uint64_t IRBuffer::read(void * buff, std::uint64_t buffSize) {
 	return r;
 }
 
+//------------------------------------------------------------------------------
+std::uint8_t * IRBuffer::allocate(std::uint64_t buffSize) {
+
+	if (this->_secure) {
+		return (std::uint8_t *)IRSecureAllocator::instance().allocate(buffSize);
+	} else {
+		return new(std::nothrow) std::uint8_t[buffSize];
+	}
+}
+
 //------------------------------------------------------------------------------
 void IRBuffer::dispose(std::uint8_t * buff, std::uint64_t buffSize) {
 
 	if (buff) {
 		if (this->_secure) {
-			IRUtils::clearMemory(buff, buffSize);
+			IRSecureAllocator::instance().deallocate(buff, buffSize);
+		} else {
+			delete [] buff;
 		}
-		delete [] buff;
 	}
 }
 
 //------------------------------------------------------------------------------
 bool IRBuffer::set(const void * buff, std::uint64_t buffSize) {
 
-	if (this->readOnly()) {
+	if (!this->writable()) {
 		return false;
 	}
 
@@ -197,7 +292,7 @@ bool IRBuffer::set(const void * buff, std::uint64_t buffSize) {
 //------------------------------------------------------------------------------
 bool IRBuffer::shrink() {
 
-	if (this->readOnly()) {
+	if (!this->writable()) {
 		return false;
 	}
 
@@ -205,7 +300,7 @@ bool IRBuffer::shrink() {
 		return true;
 	} else {
 		std::uint64_t newBuffSize = std::max(this->_size, this->_inc);
-		std::uint8_t * newBuff = new(std::nothrow) std::uint8_t[newBuffSize];
+		std::uint8_t * newBuff = this->allocate(newBuffSize);
 		if (!newBuff) {
 			return false;
 		} else {
@@ -223,13 +318,13 @@ bool IRBuffer::writeILInt(std::uint64_t v) {
 	std::uint64_t newSize;
 	int vSize;
 
-	if (this->readOnly()) {
+	if (!this->writable()) {
 		return false;
 	}
 
 	vSize = ILInt::size(v);
 	newSize = std::max(this->position() + vSize, this->size());
-	if (this->setSize(newSize)) {
+	if (this->grow(newSize) && this->setSize(newSize)) {
 		ILInt::encode(v, this->buffer() + this->position(), vSize);
 		this->_position += vSize;
 		return true;
@@ -243,7 +338,47 @@ bool IRBuffer::readILInt(std::uint64_t & v) {
 	int read;
 
 	read = ILInt::decode(this->roBuffer() + this->position(),
-			this->available(), &v);
+			(int)std::min<std::uint64_t>(this->available(), 9), &v);
+	if (read == 0) {
+		return false;
+	} else {
+		this->_position += read;
+		return true;
+	}
+}
+
+//------------------------------------------------------------------------------
+bool IRBuffer::writeILInts(const std::uint64_t * values, std::uint64_t count) {
+	std::uint64_t newSize;
+	std::uint64_t vSize;
+
+	if (!this->writable()) {
+		return false;
+	}
+	if (count == 0) {
+		return true;
+	}
+	vSize = ILInt::size(values, count);
+	newSize = std::max(this->position() + vSize, this->size());
+	if (this->grow(newSize) && this->setSize(newSize)) {
+		ILInt::encodeMany(values, count, this->buffer() + this->position(),
+				vSize);
+		this->_position += vSize;
+		return true;
+	} else {
+		return false;
+	}
+}
+
+//------------------------------------------------------------------------------
+bool IRBuffer::readILInts(std::uint64_t * values, std::uint64_t count) {
+	std::uint64_t read;
+
+	if (count == 0) {
+		return true;
+	}
+	read = ILInt::decodeMany(this->roBuffer() + this->position(),
+			this->available(), values, count);
 	if (read == 0) {
 		return false;
 	} else {
@@ -255,10 +390,10 @@ bool IRBuffer::readILInt(std::uint64_t & v) {
 //------------------------------------------------------------------------------
 bool IRBuffer::write(int v) {
 
-	if (this->readOnly()) {
+	if (!this->writable()) {
 		return false;
 	}
-	if (!this->reserve(this->_position + 1)){
+	if (!this->grow(this->_position + 1)){
 		return false;
 	}
 	*(this->posBuffer()) = (std::uint8_t)v;
@@ -280,10 +415,10 @@ int IRBuffer::read() {
 //------------------------------------------------------------------------------
 bool IRBuffer::writeInt(std::uint8_t v) {
 
-	if (this->readOnly()) {
+	if (!this->writable()) {
 		return false;
 	}
-	if (this->reserve(this->position() + sizeof(v))) {
+	if (this->grow(this->position() + sizeof(v))) {
 		IRUtils::int2BE(v, this->posBuffer());
 		this->_position += sizeof(v);
 		this->_size = std::max(this->_size, this->_position);
@@ -296,10 +431,10 @@ bool IRBuffer::writeInt(std::uint8_t v) {
 //------------------------------------------------------------------------------
 bool IRBuffer::writeInt(std::uint16_t v) {
 
-	if (this->readOnly()) {
+	if (!this->writable()) {
 		return false;
 	}
-	if (this->reserve(this->position() + sizeof(v))) {
+	if (this->grow(this->position() + sizeof(v))) {
 		IRUtils::int2BE(v, this->posBuffer());
 		this->_position += sizeof(v);
 		this->_size = std::max(this->_size, this->_position);
@@ -312,10 +447,10 @@ bool IRBuffer::writeInt(std::uint16_t v) {
 //------------------------------------------------------------------------------
 bool IRBuffer::writeInt(std::uint32_t v) {
 
-	if (this->readOnly()) {
+	if (!this->writable()) {
 		return false;
 	}
-	if (this->reserve(this->position() + sizeof(v))) {
+	if (this->grow(this->position() + sizeof(v))) {
 		IRUtils::int2BE(v, this->posBuffer());
 		this->_position += sizeof(v);
 		this->_size = std::max(this->_size, this->_position);
@@ -328,10 +463,10 @@ bool IRBuffer::writeInt(std::uint32_t v) {
 //------------------------------------------------------------------------------
 bool IRBuffer::writeInt(std::uint64_t v) {
 
-	if (this->readOnly()) {
+	if (!this->writable()) {
 		return false;
 	}
-	if (this->reserve(this->position() + sizeof(v))) {
+	if (this->grow(this->position() + sizeof(v))) {
 		IRUtils::int2BE(v, this->posBuffer());
 		this->_position += sizeof(v);
 		this->_size = std::max(this->_size, this->_position);
@@ -392,10 +527,10 @@ bool IRBuffer::readInt(std::uint64_t & v) {
 //------------------------------------------------------------------------------
 bool IRBuffer::writeFloat(float v) {
 
-	if (this->readOnly()) {
+	if (!this->writable()) {
 		return false;
 	}
-	if (this->reserve(this->position() + sizeof(v))) {
+	if (this->grow(this->position() + sizeof(v))) {
 		IRFloatingPoint::toBytes(true, v, this->posBuffer());
 		this->_position += sizeof(v);
 		this->_size = std::max(this->_size, this->_position);
@@ -408,10 +543,10 @@ bool IRBuffer::writeFloat(float v) {
 //------------------------------------------------------------------------------
 bool IRBuffer::writeFloat(double v) {
 
-	if (this->readOnly()) {
+	if (!this->writable()) {
 		return false;
 	}
-	if (this->reserve(this->position() + sizeof(v))) {
+	if (this->grow(this->position() + sizeof(v))) {
 		IRFloatingPoint::toBytes(true, v, this->posBuffer());
 		this->_position += sizeof(v);
 		this->_size = std::max(this->_size, this->_position);
@@ -448,7 +583,7 @@ bool IRBuffer::readFloat(double & v) {
 //------------------------------------------------------------------------------
 bool IRBuffer::copy(const IRBuffer & other) {
 
-	if (this->readOnly()) {
+	if (!this->writable()) {
 		return false;
 	}
 	if (this == &other) {
@@ -463,3 +598,49 @@ bool IRBuffer::copy(const IRBuffer & other) {
 }
 
 //------------------------------------------------------------------------------
+bool IRBuffer::wrap(const void * buff, std::uint64_t buffSize) {
+
+	bool view;
+
+	if (!buff) {
+		return false;
+	}
+	// Instances created as read-only must remain read-only
+	view = this->_view || (!this->readOnly());
+	if (!this->readOnly()) {
+		this->dispose(this->_buff, this->_buffSize);
+		this->_buff = nullptr;
+	}
+	this->_robuff = (const std::uint8_t *)buff;
+	this->_size = buffSize;
+	this->_buffSize = buffSize;
+	this->_position = 0;
+	this->_view = view;
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool IRBuffer::detach() {
+	std::uint64_t newBuffSize;
+	std::uint8_t * newBuff;
+
+	if (!this->readOnly()) {
+		return true;
+	}
+	if (this->_inc == 0) {
+		this->_inc = DEFAULT_INCREMENT;
+	}
+	newBuffSize = IRUtils::getPaddedSize(this->_size, this->_inc);
+	newBuff = this->allocate(newBuffSize);
+	if (!newBuff) {
+		return false;
+	}
+	std::memcpy(newBuff, this->_robuff, this->_size);
+	this->_buff = newBuff;
+	this->_robuff = nullptr;
+	this->_buffSize = newBuffSize;
+	this->_view = false;
+	return true;
+}
+
+//------------------------------------------------------------------------------
@@ -17,6 +17,13 @@
 #include <locale>
 #include <stdexcept>
 #include <cassert>
+#include <cstring>
+#include <algorithm>
+#if (defined(__GNUC__) || defined(__clang__)) && \
+		(defined(__x86_64__) || defined(__i386__))
+	#define IRCODEC_SIMD_X86
+	#include <immintrin.h>
+#endif
 
 using namespace ircommon;
 using namespace ircommon::codec;
@@ -70,36 +77,784 @@ bool IRCodec::decode(const std::string & src, int srcStart, int srcSize,
 	}
 }
 
+#ifdef IRCODEC_SIMD_X86
 //==============================================================================
-// Class IRBase2NCodec
+// Vectorized kernels for the standard Base16 and Base64 alphabets
 //------------------------------------------------------------------------------
-IRBase2NCodec::IRBase2NCodec(std::shared_ptr<IRAlphabet> alphabet, int blockSize,
-		int paddingChar, bool ignoreSpaces):
-				IRCodec(), _alphabet(alphabet), _blockSize(blockSize),
-				_paddingChar(paddingChar), _ignoreSpaces(ignoreSpaces) {
+/**
+ * Signature of the vectorized encoders. They encode whole blocks while a full
+ * vector is readable from src.
+ *
+ * @param[in] map The characters of the alphabet.
+ * @param[in] src The source data.
+ * @param[in] srcSize The size of src.
+ * @param[out] dst The output. It must have room for all characters.
+ * @return The number of bytes encoded. It is always a multiple of the size of
+ * a group of bytes.
+ */
+typedef int (*IRBase2NCodec_encodeFunc)(const char * map,
+		const std::uint8_t * src, int srcSize, char * dst);
 
-	int charSize = 1;
-	while ((charSize < 8) && ((0x1 << charSize) != this->_alphabet->size())) {
-		charSize++;
+/**
+ * Signature of the vectorized decoders. They decode whole blocks while a full
+ * vector is writable to dst and stop at the first block that contains a
+ * character that is not part of the alphabet.
+ *
+ * @param[in] map The characters of the alphabet.
+ * @param[in] src The source data.
+ * @param[in] srcSize The size of src.
+ * @param[out] dst The output.
+ * @param[in] dstSize The number of bytes available in dst.
+ * @return The number of characters decoded. It is always a multiple of the
+ * size of a group of characters.
+ */
+typedef int (*IRBase2NCodec_decodeFunc)(const char * map,
+		const char * src, int srcSize, std::uint8_t * dst, int dstSize);
+
+/**
+ * The vectorized kernels supported by the current CPU.
+ */
+struct IRBase2NCodec_VectorKernels {
+	IRBase2NCodec_encodeFunc encode16;
+	IRBase2NCodec_decodeFunc decode16;
+	IRBase2NCodec_encodeFunc encode64;
+	IRBase2NCodec_decodeFunc decode64;
+};
+
+//------------------------------------------------------------------------------
+/**
+ * Returns a mask with all bits set for each byte of in that lies inside
+ * [first, last]. Bytes greater than 0x7F never match.
+ */
+__attribute__((target("ssse3")))
+static inline __m128i IRBase2NCodec_inRangeSSSE3(__m128i in, char first,
+		char last) {
+	return _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8(first - 1)),
+			_mm_cmplt_epi8(in, _mm_set1_epi8(last + 1)));
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Converts 16 hexadecimal characters into their values. Both cases are
+ * accepted.
+ *
+ * @return false if any character is invalid.
+ */
+__attribute__((target("ssse3")))
+static inline bool IRBase2NCodec_hexValuesSSSE3(__m128i in, __m128i & values) {
+	__m128i digit = IRBase2NCodec_inRangeSSSE3(in, '0', '9');
+	__m128i upper = IRBase2NCodec_inRangeSSSE3(in, 'A', 'F');
+	__m128i lower = IRBase2NCodec_inRangeSSSE3(in, 'a', 'f');
+	__m128i offset;
+
+	if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(digit, upper), lower))
+			!= 0xFFFF) {
+		return false;
 	}
-	if (charSize == 8) {
-		throw std::invalid_argument("Invalid alphabet size.");
+	offset = _mm_or_si128(
+			_mm_or_si128(
+				_mm_and_si128(digit, _mm_set1_epi8(-'0')),
+				_mm_and_si128(upper, _mm_set1_epi8(10 - 'A'))),
+			_mm_and_si128(lower, _mm_set1_epi8(10 - 'a')));
+	values = _mm_add_epi8(in, offset);
+	return true;
+}
+
+//------------------------------------------------------------------------------
+__attribute__((target("ssse3")))
+static int IRBase2NCodec_encode16SSSE3(const char * map,
+		const std::uint8_t * src, int srcSize, char * dst) {
+	const __m128i lut = _mm_loadu_si128((const __m128i *)map);
+	const __m128i mask = _mm_set1_epi8(0x0F);
+	int done;
+
+	for (done = 0; (srcSize - done) >= 16; done += 16) {
+		__m128i in = _mm_loadu_si128((const __m128i *)(src + done));
+		__m128i hi = _mm_shuffle_epi8(lut,
+				_mm_and_si128(_mm_srli_epi16(in, 4), mask));
+		__m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(in, mask));
+		_mm_storeu_si128((__m128i *)(dst + done * 2),
+				_mm_unpacklo_epi8(hi, lo));
+		_mm_storeu_si128((__m128i *)(dst + done * 2 + 16),
+				_mm_unpackhi_epi8(hi, lo));
 	}
+	return done;
+}
 
-	this->_charSize = charSize;
-	this->_clearMask = (0x1 << this->_charSize) - 1;
+//------------------------------------------------------------------------------
+__attribute__((target("ssse3")))
+static int IRBase2NCodec_decode16SSSE3(const char * map,
+		const char * src, int srcSize, std::uint8_t * dst, int dstSize) {
+	// Each pair of values v0 and v1 becomes (v0 * 16) + v1
+	const __m128i weights = _mm_set1_epi16(0x0110);
+	int done;
+
+	for (done = 0; ((srcSize - done) >= 32) && ((dstSize - done / 2) >= 16);
+			done += 32) {
+		__m128i a;
+		__m128i b;
+		if ((!IRBase2NCodec_hexValuesSSSE3(
+				_mm_loadu_si128((const __m128i *)(src + done)), a)) ||
+				(!IRBase2NCodec_hexValuesSSSE3(
+				_mm_loadu_si128((const __m128i *)(src + done + 16)), b))) {
+			break;
+		}
+		_mm_storeu_si128((__m128i *)(dst + done / 2), _mm_packus_epi16(
+				_mm_maddubs_epi16(a, weights),
+				_mm_maddubs_epi16(b, weights)));
+	}
+	return done;
 }
 
 //------------------------------------------------------------------------------
-void IRBase2NCodec::encodeCore(const std::uint8_t * src, int srcSize,
-			std::string & dst) const {
-	int bitBuffer;
-	int bitBufferSize;
+/**
+ * Splits each group of 3 bytes of in into 4 values of 6 bits. Only the first
+ * 12 bytes of in are used.
+ */
+__attribute__((target("ssse3")))
+static inline __m128i IRBase2NCodec_split64SSSE3(__m128i in) {
+	__m128i t0;
+	__m128i t1;
+
+	in = _mm_shuffle_epi8(in, _mm_setr_epi8(
+			1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+	t0 = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)),
+			_mm_set1_epi32(0x04000040));
+	t1 = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003F03F0)),
+			_mm_set1_epi32(0x01000010));
+	return _mm_or_si128(t0, t1);
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Maps 16 values of 6 bits into characters. The values 0-25, 26-51 and 52-61
+ * are translated by a fixed offset while 62 and 63 use the offsets to the
+ * characters of the alphabet.
+ */
+__attribute__((target("ssse3")))
+static inline __m128i IRBase2NCodec_map64SSSE3(__m128i values, __m128i lut) {
+	__m128i idx;
+
+	// 0-25 -> 13, 26-51 -> 0, 52-61 -> 1-10, 62 -> 11, 63 -> 12
+	idx = _mm_subs_epu8(values, _mm_set1_epi8(51));
+	idx = _mm_or_si128(idx, _mm_and_si128(
+			_mm_cmpgt_epi8(_mm_set1_epi8(26), values), _mm_set1_epi8(13)));
+	return _mm_add_epi8(values, _mm_shuffle_epi8(lut, idx));
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Creates the table used by IRBase2NCodec_map64SSSE3().
+ */
+__attribute__((target("ssse3")))
+static inline __m128i IRBase2NCodec_lut64SSSE3(const char * map) {
+	return _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+			'0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+			char(map[62] - 62), char(map[63] - 63), 'A', 0, 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Converts 16 Base64 characters into their values.
+ *
+ * @return false if any character is invalid.
+ */
+__attribute__((target("ssse3")))
+static inline bool IRBase2NCodec_values64SSSE3(const char * map, __m128i in,
+		__m128i & values) {
+	__m128i upper = IRBase2NCodec_inRangeSSSE3(in, 'A', 'Z');
+	__m128i lower = IRBase2NCodec_inRangeSSSE3(in, 'a', 'z');
+	__m128i digit = IRBase2NCodec_inRangeSSSE3(in, '0', '9');
+	__m128i c62 = _mm_cmpeq_epi8(in, _mm_set1_epi8(map[62]));
+	__m128i c63 = _mm_cmpeq_epi8(in, _mm_set1_epi8(map[63]));
+	__m128i offset;
+
+	if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(
+			_mm_or_si128(upper, lower), _mm_or_si128(digit, c62)), c63))
+			!= 0xFFFF) {
+		return false;
+	}
+	offset = _mm_or_si128(
+			_mm_or_si128(
+				_mm_and_si128(upper, _mm_set1_epi8(-'A')),
+				_mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+			_mm_or_si128(
+				_mm_and_si128(digit, _mm_set1_epi8(52 - '0')),
+				_mm_or_si128(
+					_mm_and_si128(c62, _mm_set1_epi8(char(62 - map[62]))),
+					_mm_and_si128(c63, _mm_set1_epi8(char(63 - map[63]))))));
+	values = _mm_add_epi8(in, offset);
+	return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Joins each group of 4 values of 6 bits into 3 bytes. The result is in the
+ * first 3 bytes of each 32-bit word, in reverse order.
+ */
+__attribute__((target("ssse3")))
+static inline __m128i IRBase2NCodec_join64SSSE3(__m128i values) {
+	values = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+	return _mm_madd_epi16(values, _mm_set1_epi32(0x00011000));
+}
+
+//------------------------------------------------------------------------------
+__attribute__((target("ssse3")))
+static int IRBase2NCodec_encode64SSSE3(const char * map,
+		const std::uint8_t * src, int srcSize, char * dst) {
+	const __m128i lut = IRBase2NCodec_lut64SSSE3(map);
+	int done;
+
+	// 12 bytes are encoded but 16 are loaded
+	for (done = 0; (srcSize - done) >= 16; done += 12) {
+		__m128i in = _mm_loadu_si128((const __m128i *)(src + done));
+		_mm_storeu_si128((__m128i *)(dst + (done / 3) * 4),
+				IRBase2NCodec_map64SSSE3(IRBase2NCodec_split64SSSE3(in), lut));
+	}
+	return done;
+}
+
+//------------------------------------------------------------------------------
+__attribute__((target("ssse3")))
+static int IRBase2NCodec_decode64SSSE3(const char * map,
+		const char * src, int srcSize, std::uint8_t * dst, int dstSize) {
+	const __m128i order = _mm_setr_epi8(
+			2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+	int done;
+
+	// 12 bytes are decoded but 16 are stored
+	for (done = 0; ((srcSize - done) >= 16) &&
+			((dstSize - (done / 4) * 3) >= 16); done += 16) {
+		__m128i values;
+		if (!IRBase2NCodec_values64SSSE3(map,
+				_mm_loadu_si128((const __m128i *)(src + done)), values)) {
+			break;
+		}
+		_mm_storeu_si128((__m128i *)(dst + (done / 4) * 3), _mm_shuffle_epi8(
+				IRBase2NCodec_join64SSSE3(values), order));
+	}
+	return done;
+}
+
+//------------------------------------------------------------------------------
+__attribute__((target("avx2")))
+static inline __m256i IRBase2NCodec_inRangeAVX2(__m256i in, char first,
+		char last) {
+	return _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8(first - 1)),
+			_mm256_cmpgt_epi8(_mm256_set1_epi8(last + 1), in));
+}
+
+//------------------------------------------------------------------------------
+__attribute__((target("avx2")))
+static inline bool IRBase2NCodec_hexValuesAVX2(__m256i in, __m256i & values) {
+	__m256i digit = IRBase2NCodec_inRangeAVX2(in, '0', '9');
+	__m256i upper = IRBase2NCodec_inRangeAVX2(in, 'A', 'F');
+	__m256i lower = IRBase2NCodec_inRangeAVX2(in, 'a', 'f');
+	__m256i offset;
+
+	if (_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(digit, upper),
+			lower)) != -1) {
+		return false;
+	}
+	offset = _mm256_or_si256(
+			_mm256_or_si256(
+				_mm256_and_si256(digit, _mm256_set1_epi8(-'0')),
+				_mm256_and_si256(upper, _mm256_set1_epi8(10 - 'A'))),
+			_mm256_and_si256(lower, _mm256_set1_epi8(10 - 'a')));
+	values = _mm256_add_epi8(in, offset);
+	return true;
+}
+
+//------------------------------------------------------------------------------
+__attribute__((target("avx2")))
+static int IRBase2NCodec_encode16AVX2(const char * map,
+		const std::uint8_t * src, int srcSize, char * dst) {
+	const __m256i lut = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((const __m128i *)map));
+	const __m256i mask = _mm256_set1_epi8(0x0F);
+	int done;
+
+	for (done = 0; (srcSize - done) >= 32; done += 32) {
+		__m256i in = _mm256_loadu_si256((const __m256i *)(src + done));
+		__m256i hi = _mm256_shuffle_epi8(lut,
+				_mm256_and_si256(_mm256_srli_epi16(in, 4), mask));
+		__m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(in, mask));
+		// The unpacks work inside each 128-bit lane
+		__m256i a = _mm256_unpacklo_epi8(hi, lo);
+		__m256i b = _mm256_unpackhi_epi8(hi, lo);
+		_mm256_storeu_si256((__m256i *)(dst + done * 2),
+				_mm256_permute2x128_si256(a, b, 0x20));
+		_mm256_storeu_si256((__m256i *)(dst + done * 2 + 32),
+				_mm256_permute2x128_si256(a, b, 0x31));
+	}
+	return done + IRBase2NCodec_encode16SSSE3(map, src + done, srcSize - done,
+			dst + done * 2);
+}
+
+//------------------------------------------------------------------------------
+__attribute__((target("avx2")))
+static int IRBase2NCodec_decode16AVX2(const char * map,
+		const char * src, int srcSize, std::uint8_t * dst, int dstSize) {
+	const __m256i weights = _mm256_set1_epi16(0x0110);
+	int done;
+
+	for (done = 0; ((srcSize - done) >= 64) && ((dstSize - done / 2) >= 32);
+			done += 64) {
+		__m256i a;
+		__m256i b;
+		if ((!IRBase2NCodec_hexValuesAVX2(
+				_mm256_loadu_si256((const __m256i *)(src + done)), a)) ||
+				(!IRBase2NCodec_hexValuesAVX2(
+				_mm256_loadu_si256((const __m256i *)(src + done + 32)), b))) {
+			break;
+		}
+		// The pack works inside each 128-bit lane
+		_mm256_storeu_si256((__m256i *)(dst + done / 2),
+				_mm256_permute4x64_epi64(_mm256_packus_epi16(
+				_mm256_maddubs_epi16(a, weights),
+				_mm256_maddubs_epi16(b, weights)), 0xD8));
+	}
+	return done + IRBase2NCodec_decode16SSSE3(map, src + done, srcSize - done,
+			dst + done / 2, dstSize - done / 2);
+}
+
+//------------------------------------------------------------------------------
+__attribute__((target("avx2")))
+static int IRBase2NCodec_encode64AVX2(const char * map,
+		const std::uint8_t * src, int srcSize, char * dst) {
+	const __m256i split = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+			1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+	const __m256i lut = _mm256_broadcastsi128_si256(
+			IRBase2NCodec_lut64SSSE3(map));
+	int done;
+
+	// 24 bytes are encoded but 28 are loaded
+	for (done = 0; (srcSize - done) >= 28; done += 24) {
+		__m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(
+				_mm_loadu_si128((const __m128i *)(src + done))),
+				_mm_loadu_si128((const __m128i *)(src + done + 12)), 1);
+		__m256i idx;
+		in = _mm256_shuffle_epi8(in, split);
+		in = _mm256_or_si256(
+				_mm256_mulhi_epu16(
+					_mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00)),
+					_mm256_set1_epi32(0x04000040)),
+				_mm256_mullo_epi16(
+					_mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0)),
+					_mm256_set1_epi32(0x01000010)));
+		idx = _mm256_subs_epu8(in, _mm256_set1_epi8(51));
+		idx = _mm256_or_si256(idx, _mm256_and_si256(
+				_mm256_cmpgt_epi8(_mm256_set1_epi8(26), in),
+				_mm256_set1_epi8(13)));
+		_mm256_storeu_si256((__m256i *)(dst + (done / 3) * 4),
+				_mm256_add_epi8(in, _mm256_shuffle_epi8(lut, idx)));
+	}
+	return done + IRBase2NCodec_encode64SSSE3(map, src + done, srcSize - done,
+			dst + (done / 3) * 4);
+}
+
+//------------------------------------------------------------------------------
+__attribute__((target("avx2")))
+static int IRBase2NCodec_decode64AVX2(const char * map,
+		const char * src, int srcSize, std::uint8_t * dst, int dstSize) {
+	const __m256i order = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+			2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+	const __m256i compact = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+	int done;
+
+	// 24 bytes are decoded but 32 are stored
+	for (done = 0; ((srcSize - done) >= 32) &&
+			((dstSize - (done / 4) * 3) >= 32); done += 32) {
+		__m256i in = _mm256_loadu_si256((const __m256i *)(src + done));
+		__m256i upper = IRBase2NCodec_inRangeAVX2(in, 'A', 'Z');
+		__m256i lower = IRBase2NCodec_inRangeAVX2(in, 'a', 'z');
+		__m256i digit = IRBase2NCodec_inRangeAVX2(in, '0', '9');
+		__m256i c62 = _mm256_cmpeq_epi8(in, _mm256_set1_epi8(map[62]));
+		__m256i c63 = _mm256_cmpeq_epi8(in, _mm256_set1_epi8(map[63]));
+		__m256i values;
+
+		if (_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(
+				_mm256_or_si256(upper, lower), _mm256_or_si256(digit, c62)),
+				c63)) != -1) {
+			break;
+		}
+		values = _mm256_add_epi8(in, _mm256_or_si256(
+				_mm256_or_si256(
+					_mm256_and_si256(upper, _mm256_set1_epi8(-'A')),
+					_mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a'))),
+				_mm256_or_si256(
+					_mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')),
+					_mm256_or_si256(
+						_mm256_and_si256(c62,
+							_mm256_set1_epi8(char(62 - map[62]))),
+						_mm256_and_si256(c63,
+							_mm256_set1_epi8(char(63 - map[63])))))));
+		values = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+		values = _mm256_madd_epi16(values, _mm256_set1_epi32(0x00011000));
+		values = _mm256_shuffle_epi8(values, order);
+		_mm256_storeu_si256((__m256i *)(dst + (done / 4) * 3),
+				_mm256_permutevar8x32_epi32(values, compact));
+	}
+	return done + IRBase2NCodec_decode64SSSE3(map, src + done, srcSize - done,
+			dst + (done / 4) * 3, dstSize - (done / 4) * 3);
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Selects the best kernels supported by the current CPU.
+ *
+ * @return The kernels. All of them are nullptr if no vectorized kernel is
+ * available.
+ */
+static IRBase2NCodec_VectorKernels IRBase2NCodec_selectKernels() {
+
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		return IRBase2NCodec_VectorKernels{
+				IRBase2NCodec_encode16AVX2, IRBase2NCodec_decode16AVX2,
+				IRBase2NCodec_encode64AVX2, IRBase2NCodec_decode64AVX2};
+	} else if (__builtin_cpu_supports("ssse3")) {
+		return IRBase2NCodec_VectorKernels{
+				IRBase2NCodec_encode16SSSE3, IRBase2NCodec_decode16SSSE3,
+				IRBase2NCodec_encode64SSSE3, IRBase2NCodec_decode64SSSE3};
+	} else {
+		return IRBase2NCodec_VectorKernels{nullptr, nullptr, nullptr, nullptr};
+	}
+}
+
+//------------------------------------------------------------------------------
+/**
+ * The vectorized kernels used by this process.
+ */
+static const IRBase2NCodec_VectorKernels & IRBase2NCodec_kernels() {
+	static const IRBase2NCodec_VectorKernels kernels =
+			IRBase2NCodec_selectKernels();
+	return kernels;
+}
+#endif //IRCODEC_SIMD_X86
+
+//------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes or characters passed to a single call of a
+ * vectorized kernel. It fits in an int and is a multiple of the block sizes of
+ * all kernels.
+ */
+static const std::uint64_t IRBase2NCodec_VECTOR_CHUNK = std::uint64_t(3) << 28;
+
+//------------------------------------------------------------------------------
+/**
+ * Encodes the largest prefix of src supported by the vectorized kernels. Large
+ * inputs are split into chunks that fit in the int sizes used by the kernels.
+ *
+ * @param[in] standard The standard alphabet as returned by
+ * IRBase2NCodec_standardAlphabet().
+ * @return The number of bytes encoded.
+ */
+static inline std::uint64_t IRBase2NCodec_encodeVector(int standard,
+		const char * map, const std::uint8_t * src, std::uint64_t srcSize,
+		char * dst) {
+	std::uint64_t done = 0;
+#ifdef IRCODEC_SIMD_X86
+	const IRBase2NCodec_VectorKernels & kernels = IRBase2NCodec_kernels();
+	IRBase2NCodec_encodeFunc encode;
+	int charSize;
+	int v;
+
+	if (standard == 16) {
+		encode = kernels.encode16;
+		charSize = 4;
+	} else if (standard == 64) {
+		encode = kernels.encode64;
+		charSize = 6;
+	} else {
+		return 0;
+	}
+	if (!encode) {
+		return 0;
+	}
+	while (done < srcSize) {
+		v = encode(map, src + done,
+				int(std::min(srcSize - done, IRBase2NCodec_VECTOR_CHUNK)),
+				dst + ((done * 8) / charSize));
+		if (v == 0) {
+			break;
+		}
+		done += v;
+	}
+#endif //IRCODEC_SIMD_X86
+	return done;
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Decodes the largest prefix of src supported by the vectorized kernels. Large
+ * inputs are split into chunks that fit in the int sizes used by the kernels.
+ *
+ * @param[in] standard The standard alphabet as returned by
+ * IRBase2NCodec_standardAlphabet().
+ * @return The number of characters decoded.
+ */
+static inline std::uint64_t IRBase2NCodec_decodeVector(int standard,
+		const char * map, const char * src, std::uint64_t srcSize,
+		std::uint8_t * dst, std::uint64_t dstSize) {
+	std::uint64_t done = 0;
+#ifdef IRCODEC_SIMD_X86
+	const IRBase2NCodec_VectorKernels & kernels = IRBase2NCodec_kernels();
+	IRBase2NCodec_decodeFunc decode;
+	std::uint64_t written;
+	int charSize;
+	int v;
+
+	if (standard == 16) {
+		decode = kernels.decode16;
+		charSize = 4;
+	} else if (standard == 64) {
+		decode = kernels.decode64;
+		charSize = 6;
+	} else {
+		return 0;
+	}
+	if (!decode) {
+		return 0;
+	}
+	while (done < srcSize) {
+		written = (done * charSize) / 8;
+		v = decode(map, src + done,
+				int(std::min(srcSize - done, IRBase2NCodec_VECTOR_CHUNK)),
+				dst + written,
+				int(std::min(dstSize - written, IRBase2NCodec_VECTOR_CHUNK)));
+		if (v == 0) {
+			break;
+		}
+		done += v;
+	}
+#endif //IRCODEC_SIMD_X86
+	return done;
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Verifies if the alphabet is one of the alphabets supported by the
+ * vectorized kernels: Base16 with both cases accepted on decoding or Base64
+ * with any pair of distinct characters for the values 62 and 63.
+ *
+ * @param[in] alphabet The alphabet.
+ * @return 16 for Base16, 64 for Base64 or 0 otherwise.
+ */
+static int IRBase2NCodec_standardAlphabet(const IRAlphabet & alphabet) {
+	static const char * HEX_U = "0123456789ABCDEF";
+	static const char * HEX_L = "0123456789abcdef";
+	static const char * BASE64 =
+			"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+	const char * map = alphabet.charMap();
+	std::int16_t expected[256];
+
+	if (!map) {
+		return 0;
+	}
+	for (int i = 0; i < 256; i++) {
+		expected[i] = -1;
+	}
+	switch (alphabet.size()) {
+	case 16:
+		if ((std::memcmp(map, HEX_U, 16) != 0) &&
+				(std::memcmp(map, HEX_L, 16) != 0)) {
+			return 0;
+		}
+		for (int i = 0; i < 16; i++) {
+			expected[std::uint8_t(HEX_U[i])] = i;
+			expected[std::uint8_t(HEX_L[i])] = i;
+		}
+		break;
+	case 64:
+		if (std::memcmp(map, BASE64, 62) != 0) {
+			return 0;
+		}
+		for (int i = 0; i < 64; i++) {
+			if (expected[std::uint8_t(map[i])] != -1) {
+				return 0;
+			}
+			expected[std::uint8_t(map[i])] = i;
+		}
+		break;
+	default:
+		return 0;
+	}
+	if (std::memcmp(alphabet.valueMap(), expected, sizeof(expected)) != 0) {
+		return 0;
+	}
+	return alphabet.size();
+}
+
+//==============================================================================
+// Class IRBase2NCodec
+//------------------------------------------------------------------------------
+/**
+ * Computes the greatest common divisor of a and b.
+ */
+static constexpr int IRBase2NCodec_gcd(int a, int b) {
+	return (b == 0) ? a : IRBase2NCodec_gcd(b, a % b);
+}
+
+//------------------------------------------------------------------------------
+template <int CharSize>
+char * IRBase2NCodec::encodeMapped(const std::uint8_t * src,
+		const std::uint8_t * srcEnd, char * dst, std::uint64_t & bitBuffer,
+		int & bitBufferSize) const {
+	// A group is the smallest sequence of bytes that maps to whole characters.
+	enum {
+		GROUP_BYTES = CharSize / IRBase2NCodec_gcd(8, CharSize),
+		GROUP_CHARS = 8 / IRBase2NCodec_gcd(8, CharSize),
+		MASK = (1 << CharSize) - 1
+	};
+	const char * map = this->alphabet().charMap();
+	std::uint64_t group;
+	std::uint64_t done;
+
+	while (src < srcEnd) {
+		// The bit buffer is empty only at the boundaries of the groups.
+		if (bitBufferSize == 0) {
+			done = IRBase2NCodec_encodeVector(this->_standardAlphabet, map,
+					src, srcEnd - src, dst);
+			src += done;
+			dst += (done * 8) / CharSize;
+			while ((srcEnd - src) >= GROUP_BYTES) {
+				group = 0;
+				for (int i = 0; i < GROUP_BYTES; i++) {
+					group = (group << 8) | src[i];
+				}
+				for (int i = GROUP_CHARS - 1; i >= 0; i--) {
+					dst[i] = map[group & MASK];
+					group >>= CharSize;
+				}
+				src += GROUP_BYTES;
+				dst += GROUP_CHARS;
+			}
+			if (src == srcEnd) {
+				break;
+			}
+		}
+
+		// One byte at a time
+		bitBuffer = (bitBuffer << 8) | (*src);
+		bitBufferSize += 8;
+		src++;
+		while (bitBufferSize >= CharSize) {
+			bitBufferSize -= CharSize;
+			*dst = map[(bitBuffer >> bitBufferSize) & MASK];
+			dst++;
+		}
+	}
+	return dst;
+}
+
+//------------------------------------------------------------------------------
+template <int CharSize>
+bool IRBase2NCodec::decodeMapped(const char * src, const char * srcEnd,
+		std::uint8_t * & dst, std::uint8_t * dstEnd, std::uint64_t & bitBuffer,
+		int & bitBufferSize) const {
+	enum {
+		GROUP_BYTES = CharSize / IRBase2NCodec_gcd(8, CharSize),
+		GROUP_CHARS = 8 / IRBase2NCodec_gcd(8, CharSize),
+		MASK = (1 << CharSize) - 1
+	};
+	const std::int16_t * values = this->alphabet().valueMap();
+	std::uint64_t group;
+	std::uint8_t * p;
+	int c;
+	int v;
+
+	p = dst;
+	while (src < srcEnd) {
+		// The bit buffer is empty only at the boundaries of the groups.
+		if (bitBufferSize == 0) {
+			std::uint64_t done = IRBase2NCodec_decodeVector(
+					this->_standardAlphabet, this->alphabet().charMap(), src,
+					srcEnd - src, p, dstEnd - p);
+			src += done;
+			p += (done * CharSize) / 8;
+			// Decode whole groups until an invalid or ignored character is
+			// found. Invalid characters are mapped to -1, so any of them
+			// turns v negative.
+			while ((srcEnd - src) >= GROUP_CHARS) {
+				group = 0;
+				v = 0;
+				for (int i = 0; i < GROUP_CHARS; i++) {
+					int cv = values[std::uint8_t(src[i])];
+					v |= cv;
+					group = (group << CharSize) | std::uint64_t(cv & MASK);
+				}
+				if (v < 0) {
+					break;
+				}
+				for (int i = GROUP_BYTES - 1; i >= 0; i--) {
+					p[i] = std::uint8_t(group);
+					group >>= 8;
+				}
+				src += GROUP_CHARS;
+				p += GROUP_BYTES;
+			}
+			if (src == srcEnd) {
+				break;
+			}
+		}
+
+		// One character at a time
+		c = *src;
+		src++;
+		v = values[std::uint8_t(c)];
+		if (v < 0) {
+			if (this->isIgnored(c)) {
+				continue;
+			}
+			dst = p;
+			return false;
+		}
+		bitBuffer = (bitBuffer << CharSize) | v;
+		bitBufferSize += CharSize;
+		if (bitBufferSize >= 8) {
+			bitBufferSize -= 8;
+			*p = std::uint8_t(bitBuffer >> bitBufferSize);
+			p++;
+		}
+	}
+	dst = p;
+	return true;
+}
+
+//------------------------------------------------------------------------------
+char * IRBase2NCodec::encodeBits(const std::uint8_t * src,
+		std::uint64_t srcSize, char * dst, std::uint64_t & bitBuffer,
+		int & bitBufferSize) const {
 	const std::uint8_t * srcEnd;
 
-	bitBuffer = 0;
-	bitBufferSize = 0;
 	srcEnd = src + srcSize;
+	if (this->alphabet().charMap()) {
+		switch (this->characterSize()) {
+		case 1:
+			return this->encodeMapped<1>(src, srcEnd, dst, bitBuffer,
+					bitBufferSize);
+		case 2:
+			return this->encodeMapped<2>(src, srcEnd, dst, bitBuffer,
+					bitBufferSize);
+		case 3:
+			return this->encodeMapped<3>(src, srcEnd, dst, bitBuffer,
+					bitBufferSize);
+		case 4:
+			return this->encodeMapped<4>(src, srcEnd, dst, bitBuffer,
+					bitBufferSize);
+		case 5:
+			return this->encodeMapped<5>(src, srcEnd, dst, bitBuffer,
+					bitBufferSize);
+		case 6:
+			return this->encodeMapped<6>(src, srcEnd, dst, bitBuffer,
+					bitBufferSize);
+		default:
+			return this->encodeMapped<7>(src, srcEnd, dst, bitBuffer,
+					bitBufferSize);
+		}
+	}
+
 	while (src < srcEnd) {
 		bitBuffer = (bitBuffer << 8) | (*src);
 		bitBufferSize += 8;
@@ -107,34 +862,63 @@ void IRBase2NCodec::encodeCore(const std::uint8_t * src, int srcSize,
 
 		while (bitBufferSize >= this->characterSize()) {
 			bitBufferSize -= this->characterSize();
-			dst.push_back(this->alphabet().getChar(
-					(bitBuffer >> bitBufferSize) & this->clearMask()));
+			*dst = this->alphabet().getChar(
+					(bitBuffer >> bitBufferSize) & this->clearMask());
+			dst++;
 		}
 	}
+	return dst;
+}
+
+//------------------------------------------------------------------------------
+char * IRBase2NCodec::flushBits(char * dst, std::uint64_t & bitBuffer,
+		int & bitBufferSize) const {
 
 	if (bitBufferSize) {
-		dst.push_back(this->alphabet().getChar(
+		*dst = this->alphabet().getChar(
 				(bitBuffer << (this->characterSize() - bitBufferSize)) &
-				this->clearMask()));
+				this->clearMask());
+		dst++;
+		bitBufferSize = 0;
 	}
+	return dst;
 }
 
 //------------------------------------------------------------------------------
-bool IRBase2NCodec::decodeCore(const char * src, int srcSize,
-			std::uint8_t * dst, int & dstSize) const {
+bool IRBase2NCodec::decodeBits(const char * src, std::uint64_t srcSize,
+		std::uint8_t * & dst, std::uint8_t * dstEnd, std::uint64_t & bitBuffer,
+		int & bitBufferSize) const {
 	const char * srcEnd;
 	int c;
 	int v;
-	int bitBuffer;
-	int bitBufferSize;
-	std::uint8_t * pEnd;
-	std::uint8_t * p;
 
-	bitBuffer = 0;
-	bitBufferSize = 0;
-	p = dst;
-	pEnd = dst + dstSize;
 	srcEnd = src + srcSize;
+	if (this->alphabet().valueMap()) {
+		switch (this->characterSize()) {
+		case 1:
+			return this->decodeMapped<1>(src, srcEnd, dst, dstEnd, bitBuffer,
+					bitBufferSize);
+		case 2:
+			return this->decodeMapped<2>(src, srcEnd, dst, dstEnd, bitBuffer,
+					bitBufferSize);
+		case 3:
+			return this->decodeMapped<3>(src, srcEnd, dst, dstEnd, bitBuffer,
+					bitBufferSize);
+		case 4:
+			return this->decodeMapped<4>(src, srcEnd, dst, dstEnd, bitBuffer,
+					bitBufferSize);
+		case 5:
+			return this->decodeMapped<5>(src, srcEnd, dst, dstEnd, bitBuffer,
+					bitBufferSize);
+		case 6:
+			return this->decodeMapped<6>(src, srcEnd, dst, dstEnd, bitBuffer,
+					bitBufferSize);
+		default:
+			return this->decodeMapped<7>(src, srcEnd, dst, dstEnd, bitBuffer,
+					bitBufferSize);
+		}
+	}
+
 	while (src < srcEnd) {
 		c = *src;
 		src++;
@@ -147,12 +931,69 @@ bool IRBase2NCodec::decodeCore(const char * src, int srcSize,
 			bitBufferSize += this->characterSize();
 			while (bitBufferSize >= 8) {
 				bitBufferSize -= 8;
-				assert(p < pEnd);
-				*p = std::uint8_t((bitBuffer >> bitBufferSize) & 0xFF);
-				p++;
+				assert(dst < dstEnd);
+				*dst = std::uint8_t((bitBuffer >> bitBufferSize) & 0xFF);
+				dst++;
 			}
 		}
 	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+IRBase2NCodec::IRBase2NCodec(std::shared_ptr<IRAlphabet> alphabet, int blockSize,
+		int paddingChar, bool ignoreSpaces):
+				IRCodec(), _alphabet(alphabet), _blockSize(blockSize),
+				_paddingChar(paddingChar), _ignoreSpaces(ignoreSpaces) {
+
+	int charSize = 1;
+	while ((charSize < 8) && ((0x1 << charSize) != this->_alphabet->size())) {
+		charSize++;
+	}
+	if (charSize == 8) {
+		throw std::invalid_argument("Invalid alphabet size.");
+	}
+
+	this->_charSize = charSize;
+	this->_clearMask = (0x1 << this->_charSize) - 1;
+	this->_standardAlphabet = IRBase2NCodec_standardAlphabet(*this->_alphabet);
+}
+
+//------------------------------------------------------------------------------
+void IRBase2NCodec::encodeCore(const std::uint8_t * src, int srcSize,
+			std::string & dst) const {
+	std::string::size_type start;
+	std::uint64_t bitBuffer;
+	int bitBufferSize;
+	char * p;
+
+	if (srcSize == 0) {
+		return;
+	}
+	start = dst.size();
+	dst.resize(start + (((srcSize * 8) + (this->characterSize() - 1)) /
+			this->characterSize()));
+	bitBuffer = 0;
+	bitBufferSize = 0;
+	p = this->encodeBits(src, srcSize, &(dst[start]), bitBuffer,
+			bitBufferSize);
+	this->flushBits(p, bitBuffer, bitBufferSize);
+}
+
+//------------------------------------------------------------------------------
+bool IRBase2NCodec::decodeCore(const char * src, int srcSize,
+			std::uint8_t * dst, int & dstSize) const {
+	std::uint64_t bitBuffer;
+	int bitBufferSize;
+	std::uint8_t * p;
+
+	bitBuffer = 0;
+	bitBufferSize = 0;
+	p = dst;
+	if (!this->decodeBits(src, srcSize, p, dst + dstSize, bitBuffer,
+			bitBufferSize)) {
+		return false;
+	}
 	dstSize = p - dst;
 	return true;
 }
@@ -231,4 +1072,212 @@ int IRBase2NCodec::getDecodedSize(int srcSize) const {
 	// Padding and ignored characters are not considered.
 	return (srcSize * this->characterSize()) / 8;
 }
+
+//==============================================================================
+// Class IRBase2NEncoder
+//------------------------------------------------------------------------------
+IRBase2NEncoder::IRBase2NEncoder(const IRBase2NCodec & codec): _codec(codec) {
+	this->reset();
+}
+
+//------------------------------------------------------------------------------
+void IRBase2NEncoder::reset() {
+	this->_bitBuffer = 0;
+	this->_bitBufferSize = 0;
+	this->_encodedSize = 0;
+}
+
+//------------------------------------------------------------------------------
+std::uint64_t IRBase2NEncoder::getFinishSize() const {
+	std::uint64_t size;
+
+	size = (this->_bitBufferSize) ? 1 : 0;
+	if (this->_codec.blockSize() > 0) {
+		std::uint64_t extra = (this->_encodedSize + size) %
+				this->_codec.blockSize();
+		if (extra) {
+			size += this->_codec.blockSize() - extra;
+		}
+	}
+	return size;
+}
+
+//------------------------------------------------------------------------------
+bool IRBase2NEncoder::update(const void * src, std::uint64_t srcSize,
+		void * dst, std::uint64_t & dstSize) {
+	std::uint64_t size;
+	char * end;
+
+	size = this->getUpdateSize(srcSize);
+	if ((!src) || (dstSize < size) || ((!dst) && (size))) {
+		return false;
+	}
+	end = this->_codec.encodeBits((const std::uint8_t *)src, srcSize,
+			(char *)dst, this->_bitBuffer, this->_bitBufferSize);
+	dstSize = end - (char *)dst;
+	this->_encodedSize += dstSize;
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool IRBase2NEncoder::update(const void * src, std::uint64_t srcSize,
+		IRBuffer & dst) {
+	std::uint64_t dstSize;
+	std::uint64_t position;
+
+	if (!src) {
+		return false;
+	}
+	dstSize = this->getUpdateSize(srcSize);
+	position = dst.position();
+	if (!dst.setSize(std::max(dst.size(), position + dstSize))) {
+		return false;
+	}
+	if (!this->update(src, srcSize, dst.posBuffer(), dstSize)) {
+		return false;
+	}
+	dst.skip(dstSize);
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool IRBase2NEncoder::finish(void * dst, std::uint64_t & dstSize) {
+	std::uint64_t size;
+	char * p;
+
+	size = this->getFinishSize();
+	if (dstSize < size) {
+		return false;
+	}
+	if (size) {
+		if (!dst) {
+			return false;
+		}
+		p = this->_codec.flushBits((char *)dst, this->_bitBuffer,
+				this->_bitBufferSize);
+		std::memset(p, this->_codec.paddingCharacter(), size - (p - (char *)dst));
+	}
+	dstSize = size;
+	this->reset();
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool IRBase2NEncoder::finish(IRBuffer & dst) {
+	std::uint64_t dstSize;
+	std::uint64_t position;
+
+	dstSize = this->getFinishSize();
+	position = dst.position();
+	if (!dst.setSize(std::max(dst.size(), position + dstSize))) {
+		return false;
+	}
+	if (!this->finish(dst.posBuffer(), dstSize)) {
+		return false;
+	}
+	dst.skip(dstSize);
+	return true;
+}
+
+//==============================================================================
+// Class IRBase2NDecoder
+//------------------------------------------------------------------------------
+IRBase2NDecoder::IRBase2NDecoder(const IRBase2NCodec & codec): _codec(codec) {
+	this->reset();
+}
+
+//------------------------------------------------------------------------------
+void IRBase2NDecoder::reset() {
+	this->_bitBuffer = 0;
+	this->_bitBufferSize = 0;
+	this->_totalSize = 0;
+	this->_paddingSize = 0;
+}
+
+//------------------------------------------------------------------------------
+bool IRBase2NDecoder::update(const char * src, std::uint64_t srcSize,
+		void * dst, std::uint64_t & dstSize) {
+	std::uint64_t dataSize;
+	std::uint64_t size;
+	std::uint8_t * p;
+
+	size = this->getUpdateSize(srcSize);
+	if ((!src) || (dstSize < size) || ((!dst) && (size))) {
+		return false;
+	}
+
+	// Locate the beginning of the padding
+	dataSize = srcSize;
+	if (this->_paddingSize) {
+		dataSize = 0;
+	} else if (this->_codec.blockSize() > 0) {
+		const char * padding = (const char *)std::memchr(src,
+				this->_codec.paddingCharacter(), srcSize);
+		if (padding) {
+			dataSize = padding - src;
+		}
+	}
+
+	// Decode the data
+	p = (std::uint8_t *)dst;
+	if (!this->_codec.decodeBits(src, dataSize, p, p + dstSize,
+			this->_bitBuffer, this->_bitBufferSize)) {
+		return false;
+	}
+	dstSize = p - (std::uint8_t *)dst;
+
+	// Only padding and ignored characters may follow the padding
+	for (const char * c = src + dataSize; c < src + srcSize; c++) {
+		if (*c == this->_codec.paddingCharacter()) {
+			this->_paddingSize++;
+		} else if (!this->_codec.isIgnored(*c)) {
+			return false;
+		}
+	}
+	this->_totalSize += srcSize;
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool IRBase2NDecoder::update(const char * src, std::uint64_t srcSize,
+		IRBuffer & dst) {
+	std::uint64_t dstSize;
+	std::uint64_t position;
+	std::uint64_t size;
+
+	if (!src) {
+		return false;
+	}
+	dstSize = this->getUpdateSize(srcSize);
+	position = dst.position();
+	size = dst.size();
+	if (!dst.setSize(std::max(size, position + dstSize))) {
+		return false;
+	}
+	if (!this->update(src, srcSize, dst.posBuffer(), dstSize)) {
+		dst.setSize(size);
+		return false;
+	}
+	dst.setSize(std::max(size, position + dstSize));
+	dst.setPosition(position + dstSize);
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool IRBase2NDecoder::finish() {
+
+	if ((this->_codec.blockSize() > 0) && (this->_totalSize > 0)) {
+		if (this->_totalSize < std::uint64_t(this->_codec.blockSize())) {
+			return false;
+		}
+		int minBlock = (8 + (this->_codec.characterSize() - 1)) /
+				this->_codec.characterSize();
+		std::uint64_t maxPadding = this->_codec.blockSize() - minBlock;
+		if (this->_paddingSize > maxPadding) {
+			return false;
+		}
+	}
+	this->reset();
+	return true;
+}
 //------------------------------------------------------------------------------
@@ -14,23 +14,48 @@
  * limitations under the License.
  */
 #include <ircommon/irpmem.h>
+#include <ircommon/irsecmem.h>
 #include <ircommon/irutils.h>
 #include <stdexcept>
 #include <cstring>
 #include <cassert>
+#include <new>
 using namespace ircommon;
 using namespace ircommon::crypto;
 
 #ifdef _WIN32
 	#include <windows.h>
-#else
-	#include <chrono>
+#endif //_WIN32
+
+#ifndef _WIN32
+//------------------------------------------------------------------------------
+/**
+ * XORs the buffer with the key stream, one 64-bit word at a time.
+ */
+static void IRProtectedMemory_applyMask(const std::uint8_t * mask, void * buff,
+		std::uint64_t size) {
+	std::uint8_t * p = (std::uint8_t *)buff;
+	std::uint64_t words = size / sizeof(std::uint64_t);
+	std::uint64_t v;
+	std::uint64_t m;
+
+	for (std::uint64_t i = 0; i < words; i++) {
+		std::memcpy(&v, p + (i * sizeof(v)), sizeof(v));
+		std::memcpy(&m, mask + (i * sizeof(m)), sizeof(m));
+		v ^= m;
+		std::memcpy(p + (i * sizeof(v)), &v, sizeof(v));
+	}
+	for (std::uint64_t i = words * sizeof(v); i < size; i++) {
+		p[i] ^= mask[i];
+	}
+}
 #endif //_WIN32
 
 //==============================================================================
 // Class IRProtectedMemory
 //------------------------------------------------------------------------------
-IRProtectedMemory::IRProtectedMemory(std::uint64_t size) {
+IRProtectedMemory::IRProtectedMemory(std::uint64_t size): _locks(0),
+		_plain(true), _hot(false), _hotUses(0) {
 
 #ifdef _WIN32
 	this->_valueBufferSize = size + (CRYPTPROTECTMEMORY_BLOCK_SIZE - (size % CRYPTPROTECTMEMORY_BLOCK_SIZE));
@@ -40,14 +65,36 @@ IRProtectedMemory::IRProtectedMemory(std::uint64_t size) {
 	this->_valueBufferSize = size;
 	auto now = std::chrono::high_resolution_clock::now();
 	std::uint64_t key = now.time_since_epoch().count();
-	this->_arc4 = new IRARC4(&key, sizeof(key));
-	IRUtils::lockMemory(this->_arc4, sizeof(IRARC4));
+	void * arc4 = IRSecureAllocator::instance().allocate(sizeof(IRARC4));
+	if (!arc4) {
+		throw std::bad_alloc();
+	}
+	this->_arc4 = new(arc4) IRARC4(&key, sizeof(key));
+	this->_newEpoch = true;
+	this->_maskSize = ((size / sizeof(std::uint64_t)) + 1) *
+			sizeof(std::uint64_t);
+	this->_mask = (std::uint8_t *)IRSecureAllocator::instance().allocate(
+			this->_maskSize);
+	if (!this->_mask) {
+		this->_arc4->~IRARC4();
+		IRSecureAllocator::instance().deallocate(this->_arc4, sizeof(IRARC4));
+		throw std::bad_alloc();
+	}
 #endif // _WIN32
 
 	this->_valueSize = size;
-	this->_value = new std::uint8_t[this->_valueBufferSize];
+	this->_value = (std::uint8_t *)IRSecureAllocator::instance().allocate(
+			this->_valueBufferSize);
+	if (!this->_value) {
+#ifndef _WIN32
+		this->_arc4->~IRARC4();
+		IRSecureAllocator::instance().deallocate(this->_arc4, sizeof(IRARC4));
+		IRSecureAllocator::instance().deallocate(this->_mask,
+				this->_maskSize);
+#endif //_WIN32
+		throw std::bad_alloc();
+	}
 	std::memset(this->_value, 0, this->_valueBufferSize);
-	IRUtils::lockMemory(this->_value, this->_valueBufferSize);
 	this->protect();
 }
 
@@ -55,45 +102,56 @@ IRProtectedMemory::IRProtectedMemory(std::uint64_t size) {
 IRProtectedMemory::~IRProtectedMemory() {
 #ifndef _WIN32
 	if (this->_arc4) {
-		IRUtils::unlockMemory(this->_arc4, sizeof(IRARC4));
-		delete this->_arc4;
+		this->_arc4->~IRARC4();
+		IRSecureAllocator::instance().deallocate(this->_arc4, sizeof(IRARC4));
 	}
+	IRSecureAllocator::instance().deallocate(this->_mask, this->_maskSize);
 #endif //_WIN32
-	if (this->_value) {
-		IRUtils::unlockMemory(this->_value, this->_valueBufferSize);
-		IRUtils::clearMemory(this->_value, this->_valueBufferSize);
-		delete[] this->_value;
-	}
+	IRSecureAllocator::instance().deallocate(this->_value,
+			this->_valueBufferSize);
 }
 
 //------------------------------------------------------------------------------
 bool IRProtectedMemory::protect() {
 #ifdef _WIN32
-	return (CryptProtectMemory(this->_value, this->_valueBufferSize, 
-		CRYPTPROTECTMEMORY_SAME_PROCESS) == TRUE);
+	if (CryptProtectMemory(this->_value, this->_valueBufferSize, 
+			CRYPTPROTECTMEMORY_SAME_PROCESS) != TRUE) {
+		return false;
+	}
 #else
-	this->_arc4->save();
-	this->_arc4->apply(this->_value, this->_valueBufferSize);
-	return true;
+	// The value is plain here, thus the key stream may be replaced
+	if (this->_newEpoch) {
+		std::memset(this->_mask, 0, this->_valueBufferSize);
+		this->_arc4->apply(this->_mask, this->_valueBufferSize);
+		this->_newEpoch = false;
+	}
+	IRProtectedMemory_applyMask(this->_mask, this->_value,
+			this->_valueBufferSize);
 #endif //_WIN32
+	this->_plain = false;
+	return true;
 }
 
 //------------------------------------------------------------------------------
 bool IRProtectedMemory::unprotect() {
 #ifdef _WIN32
-	return (CryptUnprotectMemory(this->_value, this->_valueBufferSize, 
-		CRYPTPROTECTMEMORY_SAME_PROCESS) == TRUE);
+	if (CryptUnprotectMemory(this->_value, this->_valueBufferSize, 
+			CRYPTPROTECTMEMORY_SAME_PROCESS) != TRUE) {
+		return false;
+	}
 #else
-	this->_arc4->load();
-	this->_arc4->apply(this->_value, this->_valueBufferSize);
-	return true;
+	IRProtectedMemory_applyMask(this->_mask, this->_value,
+			this->_valueBufferSize);
 #endif //_WIN32
+	this->_plain = true;
+	return true;
 }
 
 //------------------------------------------------------------------------------
 bool IRProtectedMemory::lock() {
 	this->_mutex.lock();
-	if (this->unprotect()) {
+	if ((this->_plain) || (this->unprotect())) {
+		this->_locks++;
 		return true;
 	} else {
 		this->_mutex.unlock();
@@ -105,9 +163,61 @@ bool IRProtectedMemory::lock() {
 bool IRProtectedMemory::unlock() {
 	bool retval;
 
+	this->_locks--;
+	if (this->_locks > 0) {
+		this->_mutex.unlock();
+		return true;
+	}
+	if (this->_hot) {
+		if (this->_hotUses > 0) {
+			this->_hotUses--;
+		}
+		if ((this->_hotUses > 0) &&
+				(std::chrono::steady_clock::now() < this->_hotDeadline)) {
+			this->_mutex.unlock();
+			return true;
+		}
+		this->_hot = false;
+	}
 	retval = this->protect();
 	this->_mutex.unlock();
 	return retval;
 }
 
 //------------------------------------------------------------------------------
+void IRProtectedMemory::beginHot(std::uint64_t maxUses, std::uint64_t maxTime) {
+	std::lock_guard<std::recursive_mutex> lock(this->_mutex);
+
+	this->_hot = true;
+#ifndef _WIN32
+	this->_newEpoch = true;
+#endif //_WIN32
+	this->_hotUses = maxUses;
+	this->_hotDeadline = std::chrono::steady_clock::now() +
+			std::chrono::milliseconds(maxTime);
+}
+
+//------------------------------------------------------------------------------
+bool IRProtectedMemory::endHot() {
+	std::lock_guard<std::recursive_mutex> lock(this->_mutex);
+
+	this->_hot = false;
+#ifndef _WIN32
+	this->_newEpoch = true;
+#endif //_WIN32
+	// If locked, the data will be protected by unlock()
+	if ((this->_plain) && (this->_locks == 0)) {
+		return this->protect();
+	} else {
+		return true;
+	}
+}
+
+//------------------------------------------------------------------------------
+bool IRProtectedMemory::plain() {
+	std::lock_guard<std::recursive_mutex> lock(this->_mutex);
+
+	return this->_plain;
+}
+
+//------------------------------------------------------------------------------
@@ -21,49 +21,173 @@ using namespace ircommon::threading;
 //------------------------------------------------------------------------------
 // class IRRWLock
 //------------------------------------------------------------------------------
-IRRWLock::IRRWLock():_readerCount(0) {
+constexpr std::uint32_t IRRWLock::READER_MASK;
+constexpr std::uint32_t IRRWLock::WRITER;
+constexpr std::uint32_t IRRWLock::WAITERS;
+
+//------------------------------------------------------------------------------
+IRRWLock::IRRWLock():_state(0), _waitingReaders(0), _waitingWriters(0),
+		_readerPhase(0), _writerPhase(0) {
 }
 
 //------------------------------------------------------------------------------
 IRRWLock::~IRRWLock() {
 }
 
+//------------------------------------------------------------------------------
+bool IRRWLock::markWaiters() {
+	std::uint32_t s;
+
+	s = this->_state.load();
+	while (s & WRITER) {
+		if (this->_state.compare_exchange_weak(s, s | WAITERS)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+//------------------------------------------------------------------------------
+void IRRWLock::updateWaiters() {
+
+	if ((this->_waitingReaders == 0) && (this->_waitingWriters == 0)) {
+		this->_state.fetch_and(~WAITERS);
+	}
+}
+
 //------------------------------------------------------------------------------
 void IRRWLock::lockRead() {
+	std::uint32_t s;
+
+	s = this->_state.load(std::memory_order_relaxed);
+	while (!(s & WRITER)) {
+		if (this->_state.compare_exchange_weak(s, s + 1,
+				std::memory_order_acquire, std::memory_order_relaxed)) {
+			return;
+		}
+	}
+	this->lockReadSlow();
+}
 
-	this->_writeReq.lock();
-	this->_writeReq.unlock();
+//------------------------------------------------------------------------------
+void IRRWLock::lockReadSlow() {
+	std::unique_lock<std::mutex> lock(this->_mutex);
+	std::uint32_t s;
+	std::uint32_t phase;
 
-	this->_readLock.lock();
-	this->_readerCount++;
-	if (this->_readerCount == 1) {
-		this->_writeLock.wait();
+	s = this->_state.load();
+	while (true) {
+		if (!(s & WRITER)) {
+			if (this->_state.compare_exchange_weak(s, s + 1)) {
+				return;
+			}
+		} else if (this->markWaiters()) {
+			break;
+		} else {
+			s = this->_state.load();
+		}
 	}
-	this->_readLock.unlock();
+
+	// Wait for the writer. It will count this reader as active when it
+	// admits the parked readers.
+	this->_waitingReaders++;
+	phase = this->_readerPhase;
+	this->_readers.wait(lock, [this, phase]() {
+		return this->_readerPhase != phase;
+	});
 }
 
 //------------------------------------------------------------------------------
 void IRRWLock::unlockRead() {
+	std::uint32_t s;
 
-	this->_readLock.lock();
-	this->_readerCount--;
-	if (this->_readerCount == 0) {
-		this->_writeLock.release();
+	s = this->_state.fetch_sub(1, std::memory_order_release);
+	if (((s & READER_MASK) == 1) && (s & WRITER)) {
+		// The last reader wakes the writer that is waiting for the drain.
+		std::lock_guard<std::mutex> lock(this->_mutex);
+		this->_drain.notify_all();
 	}
-	this->_readLock.unlock();
 }
 
 //------------------------------------------------------------------------------
 void IRRWLock::lockWrite() {
+	std::uint32_t s;
 
-	this->_writeReq.lock();
-	this->_writeLock.wait();
-	this->_writeReq.unlock();
+	s = 0;
+	if (!this->_state.compare_exchange_strong(s, WRITER,
+			std::memory_order_acquire, std::memory_order_relaxed)) {
+		this->lockWriteSlow();
+	}
+}
+
+//------------------------------------------------------------------------------
+void IRRWLock::lockWriteSlow() {
+	std::unique_lock<std::mutex> lock(this->_mutex);
+	std::uint32_t s;
+	std::uint32_t phase;
+
+	s = this->_state.load();
+	while (true) {
+		if (!(s & WRITER)) {
+			if (this->_state.compare_exchange_weak(s, s | WRITER)) {
+				break;
+			}
+		} else if (this->markWaiters()) {
+			// Wait for the release of the current writer and try again.
+			this->_waitingWriters++;
+			phase = this->_writerPhase;
+			this->_writers.wait(lock, [this, phase]() {
+				return this->_writerPhase != phase;
+			});
+			this->_waitingWriters--;
+			this->updateWaiters();
+			s = this->_state.load();
+		} else {
+			s = this->_state.load();
+		}
+	}
+
+	// This thread owns the WRITER flag. Wait for the active readers to leave.
+	this->_drain.wait(lock, [this]() {
+		return (this->_state.load() & READER_MASK) == 0;
+	});
 }
 
 //------------------------------------------------------------------------------
 void IRRWLock::unlockWrite() {
-	this->_writeLock.release();
+	std::uint32_t s;
+
+	s = WRITER;
+	if (!this->_state.compare_exchange_strong(s, 0,
+			std::memory_order_release, std::memory_order_relaxed)) {
+		this->unlockWriteSlow();
+	}
+}
+
+//------------------------------------------------------------------------------
+void IRRWLock::unlockWriteSlow() {
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	std::uint32_t s;
+
+	// Admit all parked readers at once. The WAITERS flag is preserved while
+	// there are parked writers.
+	s = std::uint32_t(this->_waitingReaders);
+	if (this->_waitingWriters > 0) {
+		s |= WAITERS;
+	}
+	this->_state.store(s);
+	if (this->_waitingReaders > 0) {
+		this->_waitingReaders = 0;
+		this->_readerPhase++;
+		this->_readers.notify_all();
+	}
+
+	// Wake one writer. It will compete for the lock and block new readers as
+	// soon as it sets the WRITER flag.
+	if (this->_waitingWriters > 0) {
+		this->_writerPhase++;
+		this->_writers.notify_one();
+	}
 }
 
 //------------------------------------------------------------------------------
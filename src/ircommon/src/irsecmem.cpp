@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <ircommon/irsecmem.h>
+#include <ircommon/irutils.h>
+#include <cstring>
+#include <new>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif // _WIN32
+
+using namespace ircommon;
+
+//==============================================================================
+// Class IRSecureAllocator
+//------------------------------------------------------------------------------
+constexpr std::uint64_t IRSecureAllocator::MIN_CHUNK_SIZE;
+constexpr std::uint64_t IRSecureAllocator::MAX_CHUNK_SIZE;
+constexpr int IRSecureAllocator::CLASS_COUNT;
+constexpr std::uint64_t IRSecureAllocator::REGION_SIZE;
+constexpr int IRSecureAllocator::MAX_REGIONS;
+
+//------------------------------------------------------------------------------
+IRSecureAllocator::IRSecureAllocator(): _regionCount(0), _regionFree(0),
+		_exhausted(false) {
+
+	std::memset(this->_free, 0, sizeof(this->_free));
+	std::memset(this->_regions, 0, sizeof(this->_regions));
+	std::memset(&this->_stats, 0, sizeof(this->_stats));
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	this->_pageSize = info.dwPageSize;
+#else
+	long pageSize = sysconf(_SC_PAGESIZE);
+	this->_pageSize = (pageSize > 0) ? pageSize : 4096;
+#endif // _WIN32
+}
+
+//------------------------------------------------------------------------------
+IRSecureAllocator::~IRSecureAllocator() {
+
+	for (int i = 0; i < this->_regionCount; i++) {
+		IRUtils::clearMemory(this->_regions[i], REGION_SIZE);
+		IRUtils::unlockMemory(this->_regions[i], REGION_SIZE);
+#ifdef _WIN32
+		VirtualFree(this->_regions[i], 0, MEM_RELEASE);
+#else
+		munmap(this->_regions[i], REGION_SIZE);
+#endif // _WIN32
+	}
+}
+
+//------------------------------------------------------------------------------
+IRSecureAllocator & IRSecureAllocator::instance() {
+	// Never disposed on purpose. Secure buffers held by static objects may be
+	// released after the static destructors of this module.
+	static IRSecureAllocator * instance = new IRSecureAllocator();
+	return *instance;
+}
+
+//------------------------------------------------------------------------------
+int IRSecureAllocator::sizeClass(std::uint64_t size) {
+	int c = 0;
+
+	while (classSize(c) < size) {
+		c++;
+	}
+	return c;
+}
+
+//------------------------------------------------------------------------------
+bool IRSecureAllocator::inPool(const void * p) const {
+	const std::uint8_t * b = (const std::uint8_t *)p;
+
+	for (int i = 0; i < this->_regionCount; i++) {
+		if ((b >= this->_regions[i]) &&
+				(b < this->_regions[i] + REGION_SIZE)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+//------------------------------------------------------------------------------
+bool IRSecureAllocator::addRegion() {
+	void * region;
+
+	if (this->_exhausted || (this->_regionCount == MAX_REGIONS)) {
+		return false;
+	}
+#ifdef _WIN32
+	region = VirtualAlloc(nullptr, REGION_SIZE, MEM_COMMIT | MEM_RESERVE,
+			PAGE_READWRITE);
+	if (!region) {
+		this->_exhausted = true;
+		return false;
+	}
+	if (!IRUtils::lockMemory(region, REGION_SIZE)) {
+		VirtualFree(region, 0, MEM_RELEASE);
+		this->_exhausted = true;
+		return false;
+	}
+#else
+	region = mmap(nullptr, REGION_SIZE, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (region == MAP_FAILED) {
+		this->_exhausted = true;
+		return false;
+	}
+	if (!IRUtils::lockMemory(region, REGION_SIZE)) {
+		munmap(region, REGION_SIZE);
+		this->_exhausted = true;
+		return false;
+	}
+#ifdef MADV_DONTDUMP
+	madvise(region, REGION_SIZE, MADV_DONTDUMP);
+#endif // MADV_DONTDUMP
+#endif // _WIN32
+	this->_regions[this->_regionCount] = (std::uint8_t *)region;
+	this->_regionCount++;
+	this->_regionFree = REGION_SIZE;
+	this->_stats.lockedPages += REGION_SIZE / this->_pageSize;
+	return true;
+}
+
+//------------------------------------------------------------------------------
+void * IRSecureAllocator::poolAllocate(int c) {
+	void * p;
+	std::uint64_t size = classSize(c);
+
+	p = this->_free[c];
+	if (p) {
+		std::memcpy(&this->_free[c], p, sizeof(void *));
+		std::memset(p, 0, sizeof(void *));
+		return p;
+	}
+	if ((this->_regionFree < size) && (!this->addRegion())) {
+		return nullptr;
+	}
+	// All sizes are multiples of MIN_CHUNK_SIZE, thus the chunks carved
+	// from the region remain aligned to it.
+	p = this->_regions[this->_regionCount - 1] +
+			(REGION_SIZE - this->_regionFree);
+	this->_regionFree -= size;
+	return p;
+}
+
+//------------------------------------------------------------------------------
+void * IRSecureAllocator::fallbackAllocate(std::uint64_t size) const {
+	std::uint64_t mapped;
+	void * p;
+
+	// Each buffer gets its own pages, thus its lock is never shared
+	mapped = this->fallbackSize(size);
+	if (mapped < size) {
+		return nullptr;
+	}
+#ifdef _WIN32
+	p = VirtualAlloc(nullptr, mapped, MEM_COMMIT | MEM_RESERVE,
+			PAGE_READWRITE);
+	if (!p) {
+		return nullptr;
+	}
+#else
+	p = mmap(nullptr, mapped, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (p == MAP_FAILED) {
+		return nullptr;
+	}
+#ifdef MADV_DONTDUMP
+	madvise(p, mapped, MADV_DONTDUMP);
+#endif // MADV_DONTDUMP
+#endif // _WIN32
+	IRUtils::lockMemory(p, mapped);
+	return p;
+}
+
+//------------------------------------------------------------------------------
+void IRSecureAllocator::fallbackDeallocate(void * p,
+		std::uint64_t size) const {
+	std::uint64_t mapped;
+
+	// Releasing the pages also unlocks them
+	mapped = this->fallbackSize(size);
+#ifdef _WIN32
+	IRUtils::unlockMemory(p, mapped);
+	VirtualFree(p, 0, MEM_RELEASE);
+#else
+	munmap(p, mapped);
+#endif // _WIN32
+}
+
+//------------------------------------------------------------------------------
+void * IRSecureAllocator::allocate(std::uint64_t size) {
+	void * p;
+
+	if (size <= MAX_CHUNK_SIZE) {
+		int c = sizeClass(size);
+		std::lock_guard<std::mutex> lock(this->_mutex);
+		p = this->poolAllocate(c);
+		if (p) {
+			this->_stats.bytesInUse += classSize(c);
+			return p;
+		}
+	}
+	p = fallbackAllocate(size);
+	if (p) {
+		std::lock_guard<std::mutex> lock(this->_mutex);
+		this->_stats.bytesInUse += size;
+		this->_stats.fallbacks++;
+	}
+	return p;
+}
+
+//------------------------------------------------------------------------------
+void IRSecureAllocator::deallocate(void * p, std::uint64_t size) {
+
+	if (!p) {
+		return;
+	}
+	if (size <= MAX_CHUNK_SIZE) {
+		int c = sizeClass(size);
+		std::lock_guard<std::mutex> lock(this->_mutex);
+		if (this->inPool(p)) {
+			IRUtils::clearMemory(p, classSize(c));
+			std::memcpy(p, &this->_free[c], sizeof(void *));
+			this->_free[c] = p;
+			this->_stats.bytesInUse -= classSize(c);
+			return;
+		}
+	}
+	IRUtils::clearMemory(p, size);
+	fallbackDeallocate(p, size);
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	this->_stats.bytesInUse -= size;
+}
+
+//------------------------------------------------------------------------------
+void IRSecureAllocator::getStats(IRSecureAllocatorStats & stats) {
+	std::lock_guard<std::mutex> lock(this->_mutex);
+
+	stats = this->_stats;
+}
+
+//------------------------------------------------------------------------------
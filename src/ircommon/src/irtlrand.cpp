@@ -0,0 +1,377 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <ircommon/irtlrand.h>
+#include <ircommon/irutils.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+
+using namespace ircommon;
+using namespace ircommon::threading;
+
+/**
+ * Entry of the thread-local cache of slots.
+ */
+struct IRThreadLocalRandom_CacheEntry {
+	std::uint64_t id;
+	void * slot;
+};
+
+/**
+ * Source of the unique identifiers of the instances.
+ */
+static std::atomic<std::uint64_t> IRThreadLocalRandom_nextID(1);
+
+/**
+ * Type of the registry of the live instances indexed by their identifiers.
+ */
+typedef std::map<std::uint64_t, IRThreadLocalRandom *>
+		IRThreadLocalRandom_Registry;
+
+/**
+ * Returns the lock that guards the registry of live instances. It must be
+ * acquired before the lock of any instance.
+ *
+ * @return The lock.
+ */
+static std::mutex & IRThreadLocalRandom_registryLock() {
+	// Never destroyed, threads may exit after the static objects
+	static std::mutex * lock = new std::mutex();
+	return *lock;
+}
+
+/**
+ * Returns the registry of live instances.
+ *
+ * @return The registry. It must be used only while holding
+ * IRThreadLocalRandom_registryLock().
+ */
+static IRThreadLocalRandom_Registry & IRThreadLocalRandom_registry() {
+	static IRThreadLocalRandom_Registry * registry =
+			new IRThreadLocalRandom_Registry();
+	return *registry;
+}
+
+/**
+ * The last slot used by the current thread.
+ */
+static thread_local IRThreadLocalRandom_CacheEntry IRThreadLocalRandom_last =
+		{0, nullptr};
+
+//==============================================================================
+// Struct IRThreadLocalRandom::ThreadCache
+//------------------------------------------------------------------------------
+/**
+ * The slots used by a thread. The slots are given back to their instances
+ * when the thread exits.
+ */
+struct IRThreadLocalRandom::ThreadCache {
+	std::vector<IRThreadLocalRandom_CacheEntry> entries;
+
+	~ThreadCache();
+
+	/**
+	 * Removes the entries of the instances already disposed.
+	 */
+	void purge();
+
+	/**
+	 * Removes the entry of a given instance.
+	 *
+	 * @param[in] id The identifier of the instance.
+	 */
+	void remove(std::uint64_t id);
+};
+
+//------------------------------------------------------------------------------
+IRThreadLocalRandom::ThreadCache::~ThreadCache() {
+	std::lock_guard<std::mutex> lock(IRThreadLocalRandom_registryLock());
+	IRThreadLocalRandom_Registry & registry = IRThreadLocalRandom_registry();
+
+	for (const IRThreadLocalRandom_CacheEntry & entry : this->entries) {
+		IRThreadLocalRandom_Registry::iterator i = registry.find(entry.id);
+		if (i != registry.end()) {
+			i->second->release(static_cast<Slot *>(entry.slot));
+		}
+	}
+	IRThreadLocalRandom_last = {0, nullptr};
+}
+
+//------------------------------------------------------------------------------
+void IRThreadLocalRandom::ThreadCache::purge() {
+	std::lock_guard<std::mutex> lock(IRThreadLocalRandom_registryLock());
+	IRThreadLocalRandom_Registry & registry = IRThreadLocalRandom_registry();
+
+	this->entries.erase(std::remove_if(this->entries.begin(),
+			this->entries.end(),
+			[&registry](const IRThreadLocalRandom_CacheEntry & entry) {
+				return registry.count(entry.id) == 0;
+			}), this->entries.end());
+}
+
+//------------------------------------------------------------------------------
+void IRThreadLocalRandom::ThreadCache::remove(std::uint64_t id) {
+
+	this->entries.erase(std::remove_if(this->entries.begin(),
+			this->entries.end(),
+			[id](const IRThreadLocalRandom_CacheEntry & entry) {
+				return entry.id == id;
+			}), this->entries.end());
+}
+
+//==============================================================================
+// Class IRThreadLocalRandom
+//------------------------------------------------------------------------------
+constexpr int IRThreadLocalRandom::SEED_SIZE;
+
+//------------------------------------------------------------------------------
+IRThreadLocalRandom::IRThreadLocalRandom(IRRandom * parent, Factory factory,
+		std::uint64_t bufferSize): IRRandom(), _parent(parent),
+		_factory(factory), _bufferSize(bufferSize),
+		_id(IRThreadLocalRandom_nextID.fetch_add(1)) {
+
+	if ((!parent) || (!factory)) {
+		throw std::invalid_argument("Invalid parent or factory.");
+	}
+	std::lock_guard<std::mutex> lock(IRThreadLocalRandom_registryLock());
+	IRThreadLocalRandom_registry()[this->_id] = this;
+}
+
+//------------------------------------------------------------------------------
+IRThreadLocalRandom::~IRThreadLocalRandom() {
+
+	{
+		// Exiting threads will not touch this instance anymore
+		std::lock_guard<std::mutex> lock(IRThreadLocalRandom_registryLock());
+		IRThreadLocalRandom_registry().erase(this->_id);
+	}
+	// Other threads purge their entries on their next fork
+	threadCache().remove(this->_id);
+	if (IRThreadLocalRandom_last.id == this->_id) {
+		IRThreadLocalRandom_last = {0, nullptr};
+	}
+	for (std::unique_ptr<Slot> & slot : this->_slots) {
+		if (slot->buffer) {
+			IRUtils::clearMemory(slot->buffer.get(), this->_bufferSize);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+IRThreadLocalRandom::Slot & IRThreadLocalRandom::slot() {
+
+	if (IRThreadLocalRandom_last.id == this->_id) {
+		return *static_cast<Slot *>(IRThreadLocalRandom_last.slot);
+	}
+	for (const IRThreadLocalRandom_CacheEntry & entry :
+			threadCache().entries) {
+		if (entry.id == this->_id) {
+			IRThreadLocalRandom_last = entry;
+			return *static_cast<Slot *>(entry.slot);
+		}
+	}
+	threadCache().purge();
+	IRThreadLocalRandom_last = {this->_id, this->fork()};
+	threadCache().entries.push_back(IRThreadLocalRandom_last);
+	return *static_cast<Slot *>(IRThreadLocalRandom_last.slot);
+}
+
+//------------------------------------------------------------------------------
+IRThreadLocalRandom::Slot * IRThreadLocalRandom::fork() {
+	std::uint8_t seed[SEED_SIZE];
+	IRUtils::IRAutoMemoryCleaner cleaner(seed, sizeof(seed));
+	std::unique_ptr<Slot> slot(new Slot());
+	Slot * ret;
+
+	slot->random.reset(this->_factory());
+	if (!slot->random) {
+		throw std::runtime_error("Unable to create the random generator.");
+	}
+	slot->available = 0;
+	if (this->_bufferSize) {
+		slot->buffer.reset(new std::uint8_t[this->_bufferSize]);
+	}
+
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	this->_parent->nextBytes(seed, sizeof(seed));
+	slot->random->setSeed(seed, sizeof(seed));
+	ret = slot.get();
+	this->_slots.push_back(std::move(slot));
+	return ret;
+}
+
+//------------------------------------------------------------------------------
+IRThreadLocalRandom::ThreadCache & IRThreadLocalRandom::threadCache() {
+	// The slots used by the current thread, indexed by the instance identifier
+	static thread_local ThreadCache cache;
+	return cache;
+}
+
+//------------------------------------------------------------------------------
+void IRThreadLocalRandom::release(Slot * slot) {
+	std::lock_guard<std::mutex> lock(this->_mutex);
+
+	for (std::vector<std::unique_ptr<Slot>>::iterator i = this->_slots.begin();
+			i != this->_slots.end(); i++) {
+		if (i->get() == slot) {
+			if (slot->buffer) {
+				IRUtils::clearMemory(slot->buffer.get(), this->_bufferSize);
+			}
+			this->_slots.erase(i);
+			return;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+std::size_t IRThreadLocalRandom::threadCacheSize() {
+	return threadCache().entries.size();
+}
+
+//------------------------------------------------------------------------------
+int IRThreadLocalRandom::forkCount() {
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	return this->_slots.size();
+}
+
+//------------------------------------------------------------------------------
+void IRThreadLocalRandom::setSeed(std::uint64_t seed) {
+	Slot & s = this->slot();
+
+	s.random->setSeed(seed);
+	if (s.buffer) {
+		IRUtils::clearMemory(s.buffer.get(), this->_bufferSize);
+		s.available = 0;
+	}
+}
+
+//------------------------------------------------------------------------------
+void IRThreadLocalRandom::setSeed(const void * seed, std::uint64_t seedSize) {
+	Slot & s = this->slot();
+
+	s.random->setSeed(seed, seedSize);
+	if (s.buffer) {
+		IRUtils::clearMemory(s.buffer.get(), this->_bufferSize);
+		s.available = 0;
+	}
+}
+
+//------------------------------------------------------------------------------
+bool IRThreadLocalRandom::nextBoolean() {
+
+	if (this->_bufferSize) {
+		return IRRandom::nextBoolean();
+	} else {
+		return this->slot().random->nextBoolean();
+	}
+}
+
+//------------------------------------------------------------------------------
+std::uint8_t IRThreadLocalRandom::next() {
+
+	if (this->_bufferSize) {
+		return IRRandom::next();
+	} else {
+		return this->slot().random->next();
+	}
+}
+
+//------------------------------------------------------------------------------
+std::uint16_t IRThreadLocalRandom::next16() {
+
+	if (this->_bufferSize) {
+		return IRRandom::next16();
+	} else {
+		return this->slot().random->next16();
+	}
+}
+
+//------------------------------------------------------------------------------
+std::uint32_t IRThreadLocalRandom::next32() {
+
+	if (this->_bufferSize) {
+		return IRRandom::next32();
+	} else {
+		return this->slot().random->next32();
+	}
+}
+
+//------------------------------------------------------------------------------
+std::uint64_t IRThreadLocalRandom::next64() {
+
+	if (this->_bufferSize) {
+		return IRRandom::next64();
+	} else {
+		return this->slot().random->next64();
+	}
+}
+
+//------------------------------------------------------------------------------
+float IRThreadLocalRandom::nextFloat() {
+
+	if (this->_bufferSize) {
+		return IRRandom::nextFloat();
+	} else {
+		return this->slot().random->nextFloat();
+	}
+}
+
+//------------------------------------------------------------------------------
+double IRThreadLocalRandom::nextDouble() {
+
+	if (this->_bufferSize) {
+		return IRRandom::nextDouble();
+	} else {
+		return this->slot().random->nextDouble();
+	}
+}
+
+//------------------------------------------------------------------------------
+void IRThreadLocalRandom::nextBytes(void * out, std::uint64_t outSize) {
+	std::uint8_t * p;
+	std::uint8_t * src;
+	std::uint64_t n;
+	Slot & s = this->slot();
+
+	if (!s.buffer) {
+		s.random->nextBytes(out, outSize);
+		return;
+	}
+
+	p = (std::uint8_t *)out;
+	while (outSize > 0) {
+		if (s.available == 0) {
+			// Large requests bypass the buffer
+			if (outSize >= this->_bufferSize) {
+				s.random->nextBytes(p, outSize);
+				return;
+			}
+			s.random->nextBytes(s.buffer.get(), this->_bufferSize);
+			s.available = this->_bufferSize;
+		}
+		n = std::min(outSize, s.available);
+		src = s.buffer.get() + (this->_bufferSize - s.available);
+		std::memcpy(p, src, n);
+		IRUtils::clearMemory(src, n);
+		s.available -= n;
+		p += n;
+		outSize -= n;
+	}
+}
+
+//------------------------------------------------------------------------------
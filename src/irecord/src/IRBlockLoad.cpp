@@ -20,7 +20,7 @@
 
 //------------------------------------------------------------------------------
 IR_EXPORT_ATTR int IR_EXPORT_CALL IRBlockLoad(IRContext context, int blockSize, const void * block, int * hBlock) {
-	// TODO 
+	// TODO Load the block with a factory in view mode to avoid copying its contents.
 	return IRE_NOT_IMPLEMENTED;
 }
 //------------------------------------------------------------------------------
@@ -20,7 +20,7 @@
 
 //------------------------------------------------------------------------------
 IR_EXPORT_ATTR int IR_EXPORT_CALL IRBlockSerialize(IRContext context, int hBlock, int * buffSize, void * buff) {
-	// TODO 
+	// TODO Serialize the block with ILTag::serializeTo() to avoid the growth of the output.
 	return IRE_NOT_IMPLEMENTED;
 }
 //------------------------------------------------------------------------------
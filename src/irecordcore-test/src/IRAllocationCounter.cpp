@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "IRAllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<std::uint64_t> IRAllocationCounter_count(0);
+
+//------------------------------------------------------------------------------
+static void * IRAllocationCounter_alloc(std::size_t size) {
+
+	IRAllocationCounter_count.fetch_add(1, std::memory_order_relaxed);
+	return std::malloc(size ? size : 1);
+}
+
+//==============================================================================
+// Class IRAllocationCounter
+//------------------------------------------------------------------------------
+std::uint64_t IRAllocationCounter::count() {
+	return IRAllocationCounter_count.load(std::memory_order_relaxed);
+}
+
+//==============================================================================
+// Global operators
+//------------------------------------------------------------------------------
+void * operator new(std::size_t size) {
+	void * p;
+
+	p = IRAllocationCounter_alloc(size);
+	if (!p) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+//------------------------------------------------------------------------------
+void * operator new[](std::size_t size) {
+	return operator new(size);
+}
+
+//------------------------------------------------------------------------------
+void * operator new(std::size_t size, const std::nothrow_t &) noexcept {
+	return IRAllocationCounter_alloc(size);
+}
+
+//------------------------------------------------------------------------------
+void * operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+	return IRAllocationCounter_alloc(size);
+}
+
+//------------------------------------------------------------------------------
+void operator delete(void * p) noexcept {
+	std::free(p);
+}
+
+//------------------------------------------------------------------------------
+void operator delete[](void * p) noexcept {
+	std::free(p);
+}
+
+//------------------------------------------------------------------------------
+void operator delete(void * p, std::size_t size) noexcept {
+	std::free(p);
+}
+
+//------------------------------------------------------------------------------
+void operator delete[](void * p, std::size_t size) noexcept {
+	std::free(p);
+}
+
+//------------------------------------------------------------------------------
+void operator delete(void * p, const std::nothrow_t &) noexcept {
+	std::free(p);
+}
+
+//------------------------------------------------------------------------------
+void operator delete[](void * p, const std::nothrow_t &) noexcept {
+	std::free(p);
+}
+//------------------------------------------------------------------------------
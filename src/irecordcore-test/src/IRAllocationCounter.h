@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _IRALLOCATIONCOUNTER_H_
+#define _IRALLOCATIONCOUNTER_H_
+
+#include <cstdint>
+
+/**
+ * This class grants access to the number of dynamic memory allocations
+ * performed by this program. It is used by the tests to verify that hot paths
+ * do not allocate memory.
+ *
+ * <p>The counting is achieved by replacing the global operators new and
+ * new[].</p>
+ */
+class IRAllocationCounter {
+public:
+	/**
+	 * Returns the number of allocations performed so far.
+	 *
+	 * @return The number of allocations.
+	 */
+	static std::uint64_t count();
+};
+
+#endif /* _IRALLOCATIONCOUNTER_H_ */
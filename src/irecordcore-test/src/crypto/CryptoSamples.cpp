@@ -241,3 +241,41 @@ const std::uint8_t CRYPTOSAMPLES_SAMPLE4_PADDED_PKCS7_CBC[32] = {
 		0x00, 0x50, 0x6F, 0x5C, 0xBC, 0xD8, 0xDD, 0x86,
 		0x6F, 0x70, 0x1B, 0x2E, 0xC5, 0xF6, 0xDF, 0x84
 };
+
+const std::uint8_t CRYPTOSAMPLES_AES128_CTR_SAMPLE[62] = {
+		0x1c, 0xf4, 0x8c, 0x84, 0x79, 0xc8, 0xe2, 0xbd,
+		0x30, 0x57, 0x14, 0xb0, 0x98, 0x2a, 0xfb, 0x35,
+		0xaa, 0x1e, 0xe6, 0xb5, 0x08, 0xf3, 0x95, 0x4e,
+		0xe4, 0x56, 0xe8, 0xb1, 0xd4, 0x7d, 0xf9, 0x73,
+		0xb0, 0x39, 0xf1, 0xd2, 0x1d, 0x62, 0x54, 0x48,
+		0x84, 0x44, 0x6d, 0x91, 0x44, 0x1e, 0x77, 0x3c,
+		0x41, 0x0d, 0x17, 0x3c, 0xd2, 0xe6, 0x8e, 0x78,
+		0x3a, 0xe7, 0x26, 0xa5, 0xf8, 0xbb};
+
+const std::uint8_t CRYPTOSAMPLES_AES128_GCM_SAMPLE[62] = {
+		0xb5, 0xf4, 0x0d, 0x9a, 0xbc, 0x49, 0x07, 0xf2,
+		0xad, 0x84, 0xec, 0x9b, 0x9c, 0x54, 0x1c, 0x25,
+		0x92, 0xeb, 0x85, 0xa1, 0x8b, 0xdd, 0xb1, 0x9e,
+		0xdf, 0x54, 0x82, 0xc8, 0xaa, 0x3f, 0x23, 0x4d,
+		0xac, 0x5e, 0xcd, 0x3b, 0x58, 0xf6, 0xda, 0xe7,
+		0x6f, 0xc3, 0x15, 0xb6, 0xc6, 0xdd, 0x40, 0xde,
+		0x43, 0x90, 0xa0, 0x6a, 0x15, 0x6a, 0x95, 0x65,
+		0xac, 0x16, 0x89, 0x39, 0x41, 0xc0};
+
+const std::uint8_t CRYPTOSAMPLES_AES128_GCM_SAMPLE_TAG[16] = {
+		0x38, 0xd3, 0x64, 0x6b, 0x42, 0xe3, 0xdb, 0x7e,
+		0x67, 0x9b, 0xdc, 0x63, 0x90, 0xb2, 0x03, 0x8d};
+
+const std::uint8_t CRYPTOSAMPLES_AES128_GCM40_SAMPLE[62] = {
+		0xc4, 0x75, 0x40, 0x08, 0x39, 0xab, 0x73, 0x44,
+		0xdb, 0x2a, 0x2e, 0xc6, 0xdd, 0xca, 0x49, 0xbf,
+		0x01, 0x34, 0x09, 0xb5, 0x44, 0x3e, 0x01, 0x9b,
+		0xef, 0x0b, 0x77, 0xdf, 0x66, 0x5b, 0x07, 0xf8,
+		0xbd, 0x34, 0x2a, 0x54, 0xd7, 0xf0, 0xab, 0x88,
+		0x88, 0x81, 0x6e, 0xc5, 0xd7, 0x11, 0x58, 0x3f,
+		0xe5, 0x9e, 0x2b, 0xc0, 0x47, 0x02, 0x19, 0x35,
+		0xa5, 0x31, 0x20, 0xc3, 0x23, 0x34};
+
+const std::uint8_t CRYPTOSAMPLES_AES128_GCM40_SAMPLE_TAG[16] = {
+		0xe2, 0x83, 0x0f, 0x65, 0xeb, 0x48, 0x79, 0x96,
+		0x05, 0x61, 0xda, 0x23, 0xb3, 0x13, 0x97, 0x10};
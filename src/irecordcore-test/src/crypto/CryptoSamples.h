@@ -171,4 +171,34 @@ extern const std::uint8_t CRYPTOSAMPLES_IV_8[8];
  */
 extern const std::uint8_t CRYPTOSAMPLES_SAMPLE4_PADDED_PKCS7_CBC[32];
 
+/**
+ * AES128 in CTR mode of CRYPTOSAMPLES_SAMPLE using CRYPTOSAMPLES_KEY128 as
+ * the key and the first 16 bytes of CRYPTOSAMPLES_SAMPLE5 as the IV.
+ */
+extern const std::uint8_t CRYPTOSAMPLES_AES128_CTR_SAMPLE[62];
+
+/**
+ * AES128 in GCM mode of CRYPTOSAMPLES_SAMPLE using CRYPTOSAMPLES_KEY128 as
+ * the key, the first 12 bytes of CRYPTOSAMPLES_SAMPLE5 as the IV and
+ * CRYPTOSAMPLES_SAMPLE5 as the additional authenticated data.
+ */
+extern const std::uint8_t CRYPTOSAMPLES_AES128_GCM_SAMPLE[62];
+
+/**
+ * Authentication tag of CRYPTOSAMPLES_AES128_GCM_SAMPLE.
+ */
+extern const std::uint8_t CRYPTOSAMPLES_AES128_GCM_SAMPLE_TAG[16];
+
+/**
+ * AES128 in GCM mode of CRYPTOSAMPLES_SAMPLE using CRYPTOSAMPLES_KEY128 as
+ * the key, CRYPTOSAMPLES_SAMPLE5 as the IV and CRYPTOSAMPLES_SAMPLE5 as the
+ * additional authenticated data.
+ */
+extern const std::uint8_t CRYPTOSAMPLES_AES128_GCM40_SAMPLE[62];
+
+/**
+ * Authentication tag of CRYPTOSAMPLES_AES128_GCM40_SAMPLE.
+ */
+extern const std::uint8_t CRYPTOSAMPLES_AES128_GCM40_SAMPLE_TAG[16];
+
 #endif /* _CRYPTO_CRYPTOSAMPLES_H_ */
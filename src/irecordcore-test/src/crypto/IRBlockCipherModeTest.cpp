@@ -16,6 +16,7 @@
 #include "IRBlockCipherModeTest.h"
 #include "CryptoSamples.h"
 #include <irecordcore/irbciphm.h>
+#include <irecordcore/irbciphr.h>
 #include <cstring>
 
 using namespace irecordcore::crypto;
@@ -268,4 +269,59 @@ TEST_F(IRBlockCipherModeTest, processDecipher) {
 			out.size()));
 }
 //------------------------------------------------------------------------------
+TEST_F(IRBlockCipherModeTest, processBulk) {
+	IRAES128BlockCipherAlgorithm ref(true);
+	IRAES128BlockCipherAlgorithm * enc = new IRAES128BlockCipherAlgorithm(true);
+	IRAES128BlockCipherAlgorithm * dec = new IRAES128BlockCipherAlgorithm(false);
+	ASSERT_TRUE(ref.setRawKey(CRYPTOSAMPLES_KEY128, 16));
+	ASSERT_TRUE(enc->setRawKey(CRYPTOSAMPLES_KEY128, 16));
+	ASSERT_TRUE(dec->setRawKey(CRYPTOSAMPLES_KEY128, 16));
+	IRBlockCipherMode cme(enc, new IRPKCS7Padding());
+	IRBlockCipherMode cmd(dec, new IRPKCS7Padding());
+	std::uint8_t plain[1000];
+	std::uint8_t expected[1008];
+	std::uint8_t dst[sizeof(expected)];
+	std::uint64_t dstSize;
+	ircommon::IRBuffer out;
+	static const unsigned int STEPS[] = {1, 15, 16, 17, 250, sizeof(plain)};
+
+	for (unsigned int i = 0; i < sizeof(plain); i++) {
+		plain[i] = (std::uint8_t)(i * 13 + 1);
+	}
+	std::memcpy(expected, plain, sizeof(plain));
+	std::memset(expected + sizeof(plain), 8, 8);
+	for (unsigned int offs = 0; offs < sizeof(expected); offs += 16) {
+		ASSERT_TRUE(ref.processBlocks(expected + offs, expected + offs, 1));
+	}
 
+	for (unsigned int step : STEPS) {
+		// Cipher
+		cme.reset();
+		out.setSize(0);
+		for (unsigned int offs = 0; offs < sizeof(plain); offs += step) {
+			std::uint64_t size = std::min<std::uint64_t>(step,
+					sizeof(plain) - offs);
+			dstSize = sizeof(dst);
+			ASSERT_TRUE(cme.process(plain + offs, size, dst, dstSize,
+					(offs + size) == sizeof(plain)));
+			ASSERT_TRUE(out.write(dst, dstSize));
+		}
+		ASSERT_EQ(sizeof(expected), out.size());
+		ASSERT_EQ(0, std::memcmp(expected, out.roBuffer(), out.size()));
+
+		// Decipher
+		cmd.reset();
+		out.setSize(0);
+		for (unsigned int offs = 0; offs < sizeof(expected); offs += step) {
+			std::uint64_t size = std::min<std::uint64_t>(step,
+					sizeof(expected) - offs);
+			dstSize = sizeof(dst);
+			ASSERT_TRUE(cmd.process(expected + offs, size, dst, dstSize,
+					(offs + size) == sizeof(expected)));
+			ASSERT_TRUE(out.write(dst, dstSize));
+		}
+		ASSERT_EQ(sizeof(plain), out.size());
+		ASSERT_EQ(0, std::memcmp(plain, out.roBuffer(), out.size()));
+	}
+}
+//------------------------------------------------------------------------------
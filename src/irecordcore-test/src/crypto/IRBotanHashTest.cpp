@@ -15,6 +15,7 @@
  */
 #include "IRBotanHashTest.h"
 #include <irecordcore/irhash.h>
+#include <memory>
 #include <botan/sha160.h>
 #include "CryptoSamples.h"
 
@@ -130,4 +131,45 @@ TEST_F(IRBotanHashTest, finalize) {
 }
 
 //------------------------------------------------------------------------------
+TEST_F(IRBotanHashTest, copyState) {
+	IRDummyBotanHash h;
+	std::unique_ptr<IRHashAlgorithm> c;
+	std::uint8_t out[20];
+
+	h.update(CRYPTOSAMPLES_SAMPLE, 10);
+	c.reset(h.copyState());
+	ASSERT_NE(nullptr, c.get());
+	ASSERT_EQ(typeid(IRSHA1Hash), typeid(*c));
+
+	// Both must resume from the same point
+	c->update(CRYPTOSAMPLES_SAMPLE + 10, sizeof(CRYPTOSAMPLES_SAMPLE) - 10);
+	ASSERT_TRUE(c->finalize(out, sizeof(out)));
+	ASSERT_EQ(0, memcmp(CRYPTOSAMPLES_SHA1_SAMPLE, out, sizeof(out)));
+
+	h.update(CRYPTOSAMPLES_SAMPLE + 10, sizeof(CRYPTOSAMPLES_SAMPLE) - 10);
+	ASSERT_TRUE(h.finalize(out, sizeof(out)));
+	ASSERT_EQ(0, memcmp(CRYPTOSAMPLES_SHA1_SAMPLE, out, sizeof(out)));
+}
+//------------------------------------------------------------------------------
+TEST_F(IRBotanHashTest, restoreState) {
+	IRDummyBotanHash h;
+	IRDummyBotanHash s;
+	IRSHA256Hash other;
+	std::uint8_t out[20];
+
+	ASSERT_FALSE(h.restoreState(other));
+
+	s.update(CRYPTOSAMPLES_SAMPLE, 10);
+	h.update(CRYPTOSAMPLES_SAMPLE2, sizeof(CRYPTOSAMPLES_SAMPLE2));
+	ASSERT_TRUE(h.restoreState(s));
 
+	// Both must resume from the same point
+	h.update(CRYPTOSAMPLES_SAMPLE + 10, sizeof(CRYPTOSAMPLES_SAMPLE) - 10);
+	ASSERT_TRUE(h.finalize(out, sizeof(out)));
+	ASSERT_EQ(0, memcmp(CRYPTOSAMPLES_SHA1_SAMPLE, out, sizeof(out)));
+
+	s.update(CRYPTOSAMPLES_SAMPLE + 10, sizeof(CRYPTOSAMPLES_SAMPLE) - 10);
+	ASSERT_TRUE(s.finalize(out, sizeof(out)));
+	ASSERT_EQ(0, memcmp(CRYPTOSAMPLES_SHA1_SAMPLE, out, sizeof(out)));
+}
+//------------------------------------------------------------------------------
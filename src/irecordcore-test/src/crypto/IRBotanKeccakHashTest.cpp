@@ -15,6 +15,7 @@
  */
 #include "IRBotanKeccakHashTest.h"
 #include <irecordcore/irhash.h>
+#include <memory>
 #include "CryptoSamples.h"
 
 using namespace irecordcore;
@@ -123,4 +124,45 @@ TEST_F(IRBotanKeccakHashTest, finalize) {
 	}
 }
 //------------------------------------------------------------------------------
+TEST_F(IRBotanKeccakHashTest, copyState) {
+	IRDummyBotanKeccakHash h;
+	std::unique_ptr<IRHashAlgorithm> c;
+	std::uint8_t out[32];
+
+	h.update(CRYPTOSAMPLES_SAMPLE, 10);
+	c.reset(h.copyState());
+	ASSERT_NE(nullptr, c.get());
+	ASSERT_EQ(typeid(IRDummyBotanKeccakHash), typeid(*c));
+
+	// Both must resume from the same point
+	c->update(CRYPTOSAMPLES_SAMPLE + 10, sizeof(CRYPTOSAMPLES_SAMPLE) - 10);
+	ASSERT_TRUE(c->finalize(out, sizeof(out)));
+	ASSERT_EQ(0, memcmp(CRYPTOSAMPLES_SHA3_256_SAMPLE, out, sizeof(out)));
+
+	h.update(CRYPTOSAMPLES_SAMPLE + 10, sizeof(CRYPTOSAMPLES_SAMPLE) - 10);
+	ASSERT_TRUE(h.finalize(out, sizeof(out)));
+	ASSERT_EQ(0, memcmp(CRYPTOSAMPLES_SHA3_256_SAMPLE, out, sizeof(out)));
+}
+//------------------------------------------------------------------------------
+TEST_F(IRBotanKeccakHashTest, restoreState) {
+	IRDummyBotanKeccakHash h;
+	IRDummyBotanKeccakHash s;
+	IRSHA3_512Hash other;
+	std::uint8_t out[32];
+
+	ASSERT_FALSE(h.restoreState(other));
+
+	s.update(CRYPTOSAMPLES_SAMPLE, 10);
+	h.update(CRYPTOSAMPLES_SAMPLE2, sizeof(CRYPTOSAMPLES_SAMPLE2));
+	ASSERT_TRUE(h.restoreState(s));
 
+	// Both must resume from the same point
+	h.update(CRYPTOSAMPLES_SAMPLE + 10, sizeof(CRYPTOSAMPLES_SAMPLE) - 10);
+	ASSERT_TRUE(h.finalize(out, sizeof(out)));
+	ASSERT_EQ(0, memcmp(CRYPTOSAMPLES_SHA3_256_SAMPLE, out, sizeof(out)));
+
+	s.update(CRYPTOSAMPLES_SAMPLE + 10, sizeof(CRYPTOSAMPLES_SAMPLE) - 10);
+	ASSERT_TRUE(s.finalize(out, sizeof(out)));
+	ASSERT_EQ(0, memcmp(CRYPTOSAMPLES_SHA3_256_SAMPLE, out, sizeof(out)));
+}
+//------------------------------------------------------------------------------
@@ -15,7 +15,10 @@
  */
 #include "IRCBCBlockCipherModeTest.h"
 #include "CryptoSamples.h"
+#include "../IRAllocationCounter.h"
 #include <irecordcore/irbciphm.h>
+#include <irecordcore/irbciphr.h>
+#include <ircommon/irbuffer.h>
 #include <cstring>
 
 using namespace irecordcore::crypto;
@@ -233,4 +236,116 @@ TEST_F(IRCBCBlockCipherModeTest, processDecryptFull) {
 }
 
 //------------------------------------------------------------------------------
+TEST_F(IRCBCBlockCipherModeTest, processBulk) {
+	IRAES128BlockCipherAlgorithm ref(true);
+	IRAES128BlockCipherAlgorithm * enc = new IRAES128BlockCipherAlgorithm(true);
+	IRAES128BlockCipherAlgorithm * dec = new IRAES128BlockCipherAlgorithm(false);
+	ASSERT_TRUE(enc->setRawKey(CRYPTOSAMPLES_KEY128, 16));
+	ASSERT_TRUE(dec->setRawKey(CRYPTOSAMPLES_KEY128, 16));
+	IRCBCBlockCipherMode cme(enc, new IRPKCS7Padding());
+	IRCBCBlockCipherMode cmd(dec, new IRPKCS7Padding());
+	std::uint8_t plain[1024];
+	std::uint8_t expected[sizeof(plain) + 16];
+	std::uint8_t dst[sizeof(expected)];
+	std::uint64_t dstSize;
+	ircommon::IRBuffer out;
+	static const unsigned int STEPS[] = {1, 7, 16, 33, 100, sizeof(plain)};
+
+	for (unsigned int i = 0; i < sizeof(plain); i++) {
+		plain[i] = (std::uint8_t)(i * 31 + 7);
+	}
+
+	// Reference CBC using the IV CRYPTOSAMPLES_KEY256
+	ASSERT_TRUE(ref.setRawKey(CRYPTOSAMPLES_KEY128, 16));
+	std::memcpy(expected, plain, sizeof(plain));
+	std::memset(expected + sizeof(plain), 16, 16);
+	for (unsigned int offs = 0; offs < sizeof(expected); offs += 16) {
+		const std::uint8_t * prev = (offs == 0) ? CRYPTOSAMPLES_KEY256 :
+				expected + offs - 16;
+		for (int i = 0; i < 16; i++) {
+			expected[offs + i] ^= prev[i];
+		}
+		ASSERT_TRUE(ref.processBlocks(expected + offs, expected + offs, 1));
+	}
+
+	ASSERT_TRUE(cme.setIV(CRYPTOSAMPLES_KEY256, 16));
+	ASSERT_TRUE(cmd.setIV(CRYPTOSAMPLES_KEY256, 16));
+	for (unsigned int step : STEPS) {
+		// Cipher
+		cme.reset();
+		out.setSize(0);
+		for (unsigned int offs = 0; offs < sizeof(plain); offs += step) {
+			dstSize = sizeof(dst);
+			ASSERT_TRUE(cme.process(plain + offs,
+					std::min<std::uint64_t>(step, sizeof(plain) - offs),
+					dst, dstSize));
+			ASSERT_TRUE(out.write(dst, dstSize));
+		}
+		dstSize = sizeof(dst);
+		ASSERT_TRUE(cme.process(NULL, 0, dst, dstSize, true));
+		ASSERT_TRUE(out.write(dst, dstSize));
+		ASSERT_EQ(sizeof(expected), out.size());
+		ASSERT_EQ(0, std::memcmp(expected, out.roBuffer(), out.size()));
+
+		// Decipher
+		cmd.reset();
+		out.setSize(0);
+		for (unsigned int offs = 0; offs < sizeof(expected); offs += step) {
+			std::uint64_t size = std::min<std::uint64_t>(step,
+					sizeof(expected) - offs);
+			dstSize = sizeof(dst);
+			ASSERT_TRUE(cmd.process(expected + offs, size, dst, dstSize,
+					(offs + size) == sizeof(expected)));
+			ASSERT_TRUE(out.write(dst, dstSize));
+		}
+		ASSERT_EQ(sizeof(plain), out.size());
+		ASSERT_EQ(0, std::memcmp(plain, out.roBuffer(), out.size()));
+	}
+
+	// In place
+	cme.reset();
+	std::memcpy(dst, plain, sizeof(plain));
+	dstSize = sizeof(dst);
+	ASSERT_TRUE(cme.process(dst, sizeof(plain), dst, dstSize, true));
+	ASSERT_EQ(sizeof(expected), dstSize);
+	ASSERT_EQ(0, std::memcmp(expected, dst, dstSize));
+
+	cmd.reset();
+	dstSize = sizeof(dst);
+	ASSERT_TRUE(cmd.process(dst, sizeof(expected), dst, dstSize, true));
+	ASSERT_EQ(sizeof(plain), dstSize);
+	ASSERT_EQ(0, std::memcmp(plain, dst, dstSize));
+}
+//------------------------------------------------------------------------------
+TEST_F(IRCBCBlockCipherModeTest, processInPlace) {
+	IRAES128BlockCipherAlgorithm * enc = new IRAES128BlockCipherAlgorithm(true);
+	IRAES128BlockCipherAlgorithm * dec = new IRAES128BlockCipherAlgorithm(false);
+	ASSERT_TRUE(enc->setRawKey(CRYPTOSAMPLES_KEY128, 16));
+	ASSERT_TRUE(dec->setRawKey(CRYPTOSAMPLES_KEY128, 16));
+	IRCBCBlockCipherMode cme(enc, new IRPKCS7Padding());
+	IRCBCBlockCipherMode cmd(dec, new IRPKCS7Padding());
+	std::uint8_t plain[10000];
+	std::uint8_t buff[sizeof(plain) + 16];
+	std::uint64_t dstSize;
+	std::uint64_t count;
+
+	for (unsigned int i = 0; i < sizeof(plain); i++) {
+		plain[i] = (std::uint8_t)(i * 13 + 5);
+	}
+	ASSERT_TRUE(cme.setIV(CRYPTOSAMPLES_KEY256, 16));
+	ASSERT_TRUE(cmd.setIV(CRYPTOSAMPLES_KEY256, 16));
+	std::memcpy(buff, plain, sizeof(plain));
+	dstSize = sizeof(buff);
+	ASSERT_TRUE(cme.process(buff, sizeof(plain), buff, dstSize, true));
+	ASSERT_EQ(sizeof(buff), dstSize);
+
+	// Spans multiple chunks without allocating memory
+	count = IRAllocationCounter::count();
+	dstSize = sizeof(buff);
+	ASSERT_TRUE(cmd.process(buff, sizeof(buff), buff, dstSize, true));
+	ASSERT_EQ(count, IRAllocationCounter::count());
+	ASSERT_EQ(sizeof(plain), dstSize);
+	ASSERT_EQ(0, std::memcmp(plain, buff, dstSize));
+}
 
+//------------------------------------------------------------------------------
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "IRCTRBlockCipherModeTest.h"
+#include "CryptoSamples.h"
+#include <irecordcore/irbciphm.h>
+#include <irecordcore/irbciphr.h>
+#include <cstring>
+#include <stdexcept>
+
+using namespace irecordcore::crypto;
+
+//------------------------------------------------------------------------------
+static IRAES128BlockCipherAlgorithm * IRCTRBlockCipherModeTest_createAES128() {
+	IRAES128BlockCipherAlgorithm * cipher;
+
+	cipher = new IRAES128BlockCipherAlgorithm(true);
+	cipher->setRawKey(CRYPTOSAMPLES_KEY128, sizeof(CRYPTOSAMPLES_KEY128));
+	return cipher;
+}
+
+//==============================================================================
+// class IRCTRBlockCipherModeTest
+//------------------------------------------------------------------------------
+IRCTRBlockCipherModeTest::IRCTRBlockCipherModeTest() {
+}
+
+//------------------------------------------------------------------------------
+IRCTRBlockCipherModeTest::~IRCTRBlockCipherModeTest() {
+}
+
+//------------------------------------------------------------------------------
+void IRCTRBlockCipherModeTest::SetUp() {
+}
+
+//------------------------------------------------------------------------------
+void IRCTRBlockCipherModeTest::TearDown() {
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRCTRBlockCipherModeTest, Constructor) {
+	IRCTRBlockCipherMode * cm;
+	std::uint8_t expectedIV[16];
+
+	cm = new IRCTRBlockCipherMode(IRCTRBlockCipherModeTest_createAES128());
+	ASSERT_EQ(typeid(const IRAES128BlockCipherAlgorithm &), typeid(cm->cipher()));
+	ASSERT_EQ(16, cm->blockSizeInBytes());
+	ASSERT_TRUE(cm->cipherMode());
+	std::memset(expectedIV, 0, sizeof(expectedIV));
+	ASSERT_EQ(0, std::memcmp(expectedIV, cm->iv(), cm->blockSizeInBytes()));
+	delete cm;
+
+	ASSERT_THROW(new IRCTRBlockCipherMode(
+			new IRNullBlockCipherAlgorithm(false, 8 * 8)),
+			std::invalid_argument);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRCTRBlockCipherModeTest, iv) {
+	IRCTRBlockCipherMode cm(new IRNullBlockCipherAlgorithm(true, 8 * 8));
+
+	for (unsigned int size = 8; size <= sizeof(CRYPTOSAMPLES_SAMPLE5); size++) {
+		ASSERT_TRUE(cm.setIV(CRYPTOSAMPLES_SAMPLE5, size));
+		ASSERT_EQ(0, std::memcmp(CRYPTOSAMPLES_SAMPLE5, cm.iv(),
+				cm.blockSizeInBytes()));
+	}
+	for (unsigned int size = 0; size < 8; size++) {
+		ASSERT_FALSE(cm.setIV(CRYPTOSAMPLES_SAMPLE5, size));
+	}
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRCTRBlockCipherModeTest, getOutputSize) {
+	IRCTRBlockCipherMode cm(new IRNullBlockCipherAlgorithm(true, 8 * 8));
+
+	for (std::uint64_t size = 0; size < 64; size++) {
+		ASSERT_EQ(size, cm.getOutputSize(size));
+	}
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRCTRBlockCipherModeTest, process) {
+	IRCTRBlockCipherMode cm(IRCTRBlockCipherModeTest_createAES128());
+	std::uint8_t dst[sizeof(CRYPTOSAMPLES_SAMPLE)];
+	std::uint64_t dstSize;
+	static const unsigned int STEPS[] = {1, 7, 16, 33, sizeof(dst)};
+
+	ASSERT_TRUE(cm.setIV(CRYPTOSAMPLES_SAMPLE5, 16));
+	for (unsigned int step : STEPS) {
+		// Cipher
+		cm.reset();
+		std::memset(dst, 0, sizeof(dst));
+		for (unsigned int offs = 0; offs < sizeof(dst); offs += step) {
+			std::uint64_t size = std::min<std::uint64_t>(step,
+					sizeof(dst) - offs);
+			dstSize = size;
+			ASSERT_TRUE(cm.process(CRYPTOSAMPLES_SAMPLE + offs, size,
+					dst + offs, dstSize));
+			ASSERT_EQ(size, dstSize);
+		}
+		ASSERT_EQ(0, std::memcmp(CRYPTOSAMPLES_AES128_CTR_SAMPLE, dst,
+				sizeof(dst)));
+
+		// Decipher in place
+		cm.reset();
+		for (unsigned int offs = 0; offs < sizeof(dst); offs += step) {
+			std::uint64_t size = std::min<std::uint64_t>(step,
+					sizeof(dst) - offs);
+			dstSize = size;
+			ASSERT_TRUE(cm.process(dst + offs, size, dst + offs, dstSize,
+					(offs + size) == sizeof(dst)));
+		}
+		ASSERT_EQ(0, std::memcmp(CRYPTOSAMPLES_SAMPLE, dst, sizeof(dst)));
+	}
+
+	// Output too small
+	cm.reset();
+	dstSize = sizeof(dst) - 1;
+	ASSERT_FALSE(cm.process(CRYPTOSAMPLES_SAMPLE, sizeof(dst), dst, dstSize));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRCTRBlockCipherModeTest, processLarge) {
+	IRCTRBlockCipherMode cm(IRCTRBlockCipherModeTest_createAES128());
+	IRAES128BlockCipherAlgorithm ref(true);
+	std::uint8_t plain[16 * 1024 + 5];
+	std::uint8_t dst[sizeof(plain)];
+	std::uint8_t counter[16];
+	std::uint8_t keyStream[16];
+	std::uint64_t dstSize;
+
+	// The counter overflows after the first block
+	ASSERT_TRUE(ref.setRawKey(CRYPTOSAMPLES_KEY128, 16));
+	std::memset(counter, 0xFF, sizeof(counter));
+	ASSERT_TRUE(cm.setIV(counter, sizeof(counter)));
+	for (unsigned int i = 0; i < sizeof(plain); i++) {
+		plain[i] = (std::uint8_t)(i * 31 + 7);
+	}
+	dstSize = sizeof(dst);
+	ASSERT_TRUE(cm.process(plain, sizeof(plain), dst, dstSize));
+	ASSERT_EQ(sizeof(plain), dstSize);
+
+	for (unsigned int offs = 0; offs < sizeof(plain); offs += 16) {
+		ASSERT_TRUE(ref.processBlocks(counter, keyStream, 1));
+		for (unsigned int i = 0; (i < 16) && (offs + i < sizeof(plain)); i++) {
+			ASSERT_EQ(plain[offs + i] ^ keyStream[i], dst[offs + i]);
+		}
+		for (int i = 15; i >= 0; i--) {
+			counter[i]++;
+			if (counter[i]) {
+				break;
+			}
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRCTRBlockCipherModeTest, seek) {
+	IRCTRBlockCipherMode cm(IRCTRBlockCipherModeTest_createAES128());
+	std::uint8_t dst[sizeof(CRYPTOSAMPLES_SAMPLE)];
+	std::uint64_t dstSize;
+
+	ASSERT_TRUE(cm.setIV(CRYPTOSAMPLES_SAMPLE5, 16));
+	for (unsigned int offs = 0; offs <= sizeof(dst); offs++) {
+		ASSERT_TRUE(cm.seek(offs));
+		dstSize = sizeof(dst) - offs;
+		ASSERT_TRUE(cm.process(CRYPTOSAMPLES_AES128_CTR_SAMPLE + offs,
+				sizeof(dst) - offs, dst, dstSize));
+		ASSERT_EQ(sizeof(dst) - offs, dstSize);
+		ASSERT_EQ(0, std::memcmp(CRYPTOSAMPLES_SAMPLE + offs, dst, dstSize));
+	}
+
+	// Reset goes back to the start
+	cm.reset();
+	dstSize = sizeof(dst);
+	ASSERT_TRUE(cm.process(CRYPTOSAMPLES_AES128_CTR_SAMPLE, sizeof(dst), dst,
+			dstSize));
+	ASSERT_EQ(0, std::memcmp(CRYPTOSAMPLES_SAMPLE, dst, dstSize));
+}
+
+//------------------------------------------------------------------------------
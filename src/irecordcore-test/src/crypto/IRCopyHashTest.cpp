@@ -16,6 +16,7 @@
 #include "IRCopyHashTest.h"
 #include "CryptoSamples.h"
 #include <irecordcore/irhash.h>
+#include <memory>
 #include <cstring>
 
 using namespace irecordcore;
@@ -129,4 +130,42 @@ TEST_F(IRCopyHashTest, finalize) {
 }
 
 //------------------------------------------------------------------------------
+TEST_F(IRCopyHashTest, copyState) {
+	IRCopyHash h;
+	std::unique_ptr<IRHashAlgorithm> c;
+	std::uint8_t out[sizeof(CRYPTOSAMPLES_SAMPLE)];
 
+	h.update(CRYPTOSAMPLES_SAMPLE, 10);
+	c.reset(h.copyState());
+	ASSERT_NE(nullptr, c.get());
+	ASSERT_EQ(typeid(IRCopyHash), typeid(*c));
+
+	c->update(CRYPTOSAMPLES_SAMPLE + 10, sizeof(CRYPTOSAMPLES_SAMPLE) - 10);
+	ASSERT_EQ(sizeof(CRYPTOSAMPLES_SAMPLE), c->sizeInBytes());
+	ASSERT_TRUE(c->finalize(out, sizeof(out)));
+	ASSERT_EQ(0, std::memcmp(out, CRYPTOSAMPLES_SAMPLE, sizeof(out)));
+	ASSERT_EQ(10, h.sizeInBytes());
+}
+//------------------------------------------------------------------------------
+TEST_F(IRCopyHashTest, restoreState) {
+	IRCopyHash h;
+	IRCopyHash s;
+	IRSHA1Hash other;
+	std::uint8_t out[sizeof(CRYPTOSAMPLES_SAMPLE)];
+
+	ASSERT_FALSE(h.restoreState(other));
+
+	s.update(CRYPTOSAMPLES_SAMPLE, 10);
+	h.update(CRYPTOSAMPLES_SAMPLE2, sizeof(CRYPTOSAMPLES_SAMPLE2));
+	ASSERT_TRUE(h.restoreState(s));
+	ASSERT_EQ(10, h.sizeInBytes());
+	ASSERT_TRUE(h.restoreState(h));
+	ASSERT_EQ(10, h.sizeInBytes());
+
+	h.update(CRYPTOSAMPLES_SAMPLE + 10, sizeof(CRYPTOSAMPLES_SAMPLE) - 10);
+	ASSERT_EQ(sizeof(CRYPTOSAMPLES_SAMPLE), h.sizeInBytes());
+	ASSERT_TRUE(h.finalize(out, sizeof(out)));
+	ASSERT_EQ(0, std::memcmp(out, CRYPTOSAMPLES_SAMPLE, sizeof(out)));
+	ASSERT_EQ(10, s.sizeInBytes());
+}
+//------------------------------------------------------------------------------
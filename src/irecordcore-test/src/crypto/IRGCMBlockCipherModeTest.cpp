@@ -0,0 +1,493 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "IRGCMBlockCipherModeTest.h"
+#include "CryptoSamples.h"
+#include <irecordcore/irbciphm.h>
+#include <irecordcore/irbciphr.h>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+using namespace irecordcore::crypto;
+
+//------------------------------------------------------------------------------
+static IRAES128BlockCipherAlgorithm * IRGCMBlockCipherModeTest_createAES128(
+		const std::uint8_t * key) {
+	IRAES128BlockCipherAlgorithm * cipher;
+
+	cipher = new IRAES128BlockCipherAlgorithm(true);
+	cipher->setRawKey(key, 16);
+	return cipher;
+}
+
+/**
+ * NIST GCM test case 2: AES128 with a zero key and IV over a zero block.
+ */
+static const std::uint8_t IRGCMBlockCipherModeTest_NIST2_CIPHER[16] = {
+		0x03, 0x88, 0xda, 0xce, 0x60, 0xb6, 0xa3, 0x92,
+		0xf3, 0x28, 0xc2, 0xb9, 0x71, 0xb2, 0xfe, 0x78};
+
+static const std::uint8_t IRGCMBlockCipherModeTest_NIST2_TAG[16] = {
+		0xab, 0x6e, 0x47, 0xd4, 0x2c, 0xec, 0x13, 0xbd,
+		0xf5, 0x3a, 0x67, 0xb2, 0x12, 0x57, 0xbd, 0xdf};
+
+/**
+ * NIST GCM test case 1: The same of test case 2 without data.
+ */
+static const std::uint8_t IRGCMBlockCipherModeTest_NIST1_TAG[16] = {
+		0x58, 0xe2, 0xfc, 0xce, 0xfa, 0x7e, 0x30, 0x61,
+		0x36, 0x7f, 0x1d, 0x57, 0xa4, 0xe7, 0x45, 0x5a};
+
+/**
+ * NIST GCM test cases 3 and 4: AES128 over 4 blocks. Test case 4 drops the
+ * last 4 bytes of the plaintext and adds AAD.
+ */
+static const std::uint8_t IRGCMBlockCipherModeTest_NIST3_KEY[16] = {
+		0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c,
+		0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08};
+
+static const std::uint8_t IRGCMBlockCipherModeTest_NIST3_IV[12] = {
+		0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad,
+		0xde, 0xca, 0xf8, 0x88};
+
+static const std::uint8_t IRGCMBlockCipherModeTest_NIST3_PLAIN[64] = {
+		0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5,
+		0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26, 0x9a,
+		0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda,
+		0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72,
+		0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53,
+		0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25,
+		0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57,
+		0xba, 0x63, 0x7b, 0x39, 0x1a, 0xaf, 0xd2, 0x55};
+
+static const std::uint8_t IRGCMBlockCipherModeTest_NIST3_CIPHER[64] = {
+		0x42, 0x83, 0x1e, 0xc2, 0x21, 0x77, 0x74, 0x24,
+		0x4b, 0x72, 0x21, 0xb7, 0x84, 0xd0, 0xd4, 0x9c,
+		0xe3, 0xaa, 0x21, 0x2f, 0x2c, 0x02, 0xa4, 0xe0,
+		0x35, 0xc1, 0x7e, 0x23, 0x29, 0xac, 0xa1, 0x2e,
+		0x21, 0xd5, 0x14, 0xb2, 0x54, 0x66, 0x93, 0x1c,
+		0x7d, 0x8f, 0x6a, 0x5a, 0xac, 0x84, 0xaa, 0x05,
+		0x1b, 0xa3, 0x0b, 0x39, 0x6a, 0x0a, 0xac, 0x97,
+		0x3d, 0x58, 0xe0, 0x91, 0x47, 0x3f, 0x59, 0x85};
+
+static const std::uint8_t IRGCMBlockCipherModeTest_NIST3_TAG[16] = {
+		0x4d, 0x5c, 0x2a, 0xf3, 0x27, 0xcd, 0x64, 0xa6,
+		0x2c, 0xf3, 0x5a, 0xbd, 0x2b, 0xa6, 0xfa, 0xb4};
+
+static const std::uint8_t IRGCMBlockCipherModeTest_NIST4_AAD[20] = {
+		0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+		0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+		0xab, 0xad, 0xda, 0xd2};
+
+static const std::uint8_t IRGCMBlockCipherModeTest_NIST4_TAG[16] = {
+		0x5b, 0xc9, 0x4f, 0xbc, 0x32, 0x21, 0xa5, 0xdb,
+		0x94, 0xfa, 0xe9, 0x5a, 0xe7, 0x12, 0x1a, 0x47};
+
+//==============================================================================
+// class IRGCMTableBlockCipherMode
+//------------------------------------------------------------------------------
+/**
+ * IRGCMBlockCipherMode that may be forced to use the portable GHASH.
+ */
+class IRGCMTableBlockCipherMode: public IRGCMBlockCipherMode {
+public:
+	IRGCMTableBlockCipherMode(IRBlockCipherAlgorithm * cipher, bool cipherMode,
+			bool table): IRGCMBlockCipherMode(cipher, cipherMode) {
+		if (table) {
+			this->_clmul = false;
+		}
+	}
+
+	bool clmul() const {
+		return this->_clmul;
+	}
+};
+
+//==============================================================================
+// class IRGCMBlockCipherModeTest
+//------------------------------------------------------------------------------
+IRGCMBlockCipherModeTest::IRGCMBlockCipherModeTest() {
+}
+
+//------------------------------------------------------------------------------
+IRGCMBlockCipherModeTest::~IRGCMBlockCipherModeTest() {
+}
+
+//------------------------------------------------------------------------------
+void IRGCMBlockCipherModeTest::SetUp() {
+}
+
+//------------------------------------------------------------------------------
+void IRGCMBlockCipherModeTest::TearDown() {
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRGCMBlockCipherModeTest, Constructor) {
+	IRGCMBlockCipherMode * cm;
+
+	cm = new IRGCMBlockCipherMode(IRGCMBlockCipherModeTest_createAES128(
+			CRYPTOSAMPLES_KEY128), true);
+	ASSERT_EQ(typeid(const IRAES128BlockCipherAlgorithm &), typeid(cm->cipher()));
+	ASSERT_EQ(16, cm->blockSizeInBytes());
+	ASSERT_TRUE(cm->cipherMode());
+	delete cm;
+
+	cm = new IRGCMBlockCipherMode(IRGCMBlockCipherModeTest_createAES128(
+			CRYPTOSAMPLES_KEY128), false);
+	ASSERT_FALSE(cm->cipherMode());
+	delete cm;
+
+	ASSERT_THROW(new IRGCMBlockCipherMode(
+			new IRNullBlockCipherAlgorithm(false, 16 * 8), true),
+			std::invalid_argument);
+	ASSERT_THROW(new IRGCMBlockCipherMode(
+			new IRNullBlockCipherAlgorithm(true, 8 * 8), true),
+			std::invalid_argument);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRGCMBlockCipherModeTest, iv) {
+	IRGCMBlockCipherMode cm(IRGCMBlockCipherModeTest_createAES128(
+			CRYPTOSAMPLES_KEY128), true);
+
+	ASSERT_FALSE(cm.setIV(CRYPTOSAMPLES_SAMPLE5, 0));
+	for (unsigned int size = 1; size <= sizeof(CRYPTOSAMPLES_SAMPLE5); size++) {
+		ASSERT_TRUE(cm.setIV(CRYPTOSAMPLES_SAMPLE5, size));
+	}
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRGCMBlockCipherModeTest, processNIST) {
+	std::uint8_t key[16];
+	std::uint8_t data[16];
+	std::uint8_t tag[16];
+	std::uint64_t dstSize;
+
+	std::memset(key, 0, sizeof(key));
+	IRGCMBlockCipherMode cm(IRGCMBlockCipherModeTest_createAES128(key), true);
+
+	// Test case 1
+	dstSize = 0;
+	ASSERT_TRUE(cm.process(nullptr, 0, data, dstSize, true));
+	ASSERT_EQ(0, dstSize);
+	ASSERT_TRUE(cm.tag(tag, sizeof(tag)));
+	ASSERT_EQ(0, std::memcmp(IRGCMBlockCipherModeTest_NIST1_TAG, tag,
+			sizeof(tag)));
+
+	// Test case 2
+	cm.reset();
+	std::memset(data, 0, sizeof(data));
+	dstSize = sizeof(data);
+	ASSERT_TRUE(cm.process(data, sizeof(data), data, dstSize, true));
+	ASSERT_EQ(sizeof(data), dstSize);
+	ASSERT_EQ(0, std::memcmp(IRGCMBlockCipherModeTest_NIST2_CIPHER, data,
+			sizeof(data)));
+	ASSERT_TRUE(cm.tag(tag, sizeof(tag)));
+	ASSERT_EQ(0, std::memcmp(IRGCMBlockCipherModeTest_NIST2_TAG, tag,
+			sizeof(tag)));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRGCMBlockCipherModeTest, processCipher) {
+	IRGCMBlockCipherMode cm(IRGCMBlockCipherModeTest_createAES128(
+			CRYPTOSAMPLES_KEY128), true);
+	std::uint8_t dst[sizeof(CRYPTOSAMPLES_SAMPLE)];
+	std::uint8_t tag[16];
+	std::uint64_t dstSize;
+	static const unsigned int STEPS[] = {1, 7, 16, 33, sizeof(dst)};
+
+	for (unsigned int step : STEPS) {
+		for (unsigned int ivSize : {12, 40}) {
+			const std::uint8_t * expected = (ivSize == 12) ?
+					CRYPTOSAMPLES_AES128_GCM_SAMPLE :
+					CRYPTOSAMPLES_AES128_GCM40_SAMPLE;
+			const std::uint8_t * expectedTag = (ivSize == 12) ?
+					CRYPTOSAMPLES_AES128_GCM_SAMPLE_TAG :
+					CRYPTOSAMPLES_AES128_GCM40_SAMPLE_TAG;
+
+			ASSERT_TRUE(cm.setIV(CRYPTOSAMPLES_SAMPLE5, ivSize));
+			for (unsigned int offs = 0; offs < sizeof(CRYPTOSAMPLES_SAMPLE5);
+					offs += step) {
+				ASSERT_TRUE(cm.addAAD(CRYPTOSAMPLES_SAMPLE5 + offs,
+						std::min<std::uint64_t>(step,
+						sizeof(CRYPTOSAMPLES_SAMPLE5) - offs)));
+			}
+			ASSERT_FALSE(cm.tag(tag, sizeof(tag)));
+			std::memset(dst, 0, sizeof(dst));
+			for (unsigned int offs = 0; offs < sizeof(dst); offs += step) {
+				std::uint64_t size = std::min<std::uint64_t>(step,
+						sizeof(dst) - offs);
+				dstSize = size;
+				ASSERT_TRUE(cm.process(CRYPTOSAMPLES_SAMPLE + offs, size,
+						dst + offs, dstSize, (offs + size) == sizeof(dst)));
+				ASSERT_EQ(size, dstSize);
+			}
+			ASSERT_EQ(0, std::memcmp(expected, dst, sizeof(dst)));
+			ASSERT_TRUE(cm.tag(tag, sizeof(tag)));
+			ASSERT_EQ(0, std::memcmp(expectedTag, tag, sizeof(tag)));
+			ASSERT_TRUE(cm.verifyTag(expectedTag, 16));
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRGCMBlockCipherModeTest, processDecipher) {
+	IRGCMBlockCipherMode cm(IRGCMBlockCipherModeTest_createAES128(
+			CRYPTOSAMPLES_KEY128), false);
+	std::uint8_t dst[sizeof(CRYPTOSAMPLES_SAMPLE)];
+	std::uint8_t tag[16];
+	std::uint64_t dstSize;
+	static const unsigned int STEPS[] = {1, 7, 16, 33, sizeof(dst)};
+
+	ASSERT_TRUE(cm.setIV(CRYPTOSAMPLES_SAMPLE5, 12));
+	for (unsigned int step : STEPS) {
+		// In place
+		cm.reset();
+		ASSERT_TRUE(cm.addAAD(CRYPTOSAMPLES_SAMPLE5,
+				sizeof(CRYPTOSAMPLES_SAMPLE5)));
+		std::memcpy(dst, CRYPTOSAMPLES_AES128_GCM_SAMPLE, sizeof(dst));
+		for (unsigned int offs = 0; offs < sizeof(dst); offs += step) {
+			std::uint64_t size = std::min<std::uint64_t>(step,
+					sizeof(dst) - offs);
+			dstSize = size;
+			ASSERT_TRUE(cm.process(dst + offs, size, dst + offs, dstSize,
+					(offs + size) == sizeof(dst)));
+		}
+		ASSERT_EQ(0, std::memcmp(CRYPTOSAMPLES_SAMPLE, dst, sizeof(dst)));
+		for (unsigned int size = 4; size <= 16; size++) {
+			ASSERT_TRUE(cm.verifyTag(CRYPTOSAMPLES_AES128_GCM_SAMPLE_TAG,
+					size));
+		}
+		ASSERT_FALSE(cm.verifyTag(CRYPTOSAMPLES_AES128_GCM_SAMPLE_TAG, 3));
+		ASSERT_FALSE(cm.verifyTag(CRYPTOSAMPLES_AES128_GCM_SAMPLE_TAG, 17));
+
+		std::memcpy(tag, CRYPTOSAMPLES_AES128_GCM_SAMPLE_TAG, sizeof(tag));
+		tag[15] ^= 1;
+		ASSERT_FALSE(cm.verifyTag(tag, sizeof(tag)));
+	}
+
+	// Tampered ciphertext
+	cm.reset();
+	ASSERT_TRUE(cm.addAAD(CRYPTOSAMPLES_SAMPLE5, sizeof(CRYPTOSAMPLES_SAMPLE5)));
+	std::memcpy(dst, CRYPTOSAMPLES_AES128_GCM_SAMPLE, sizeof(dst));
+	dst[10] ^= 0x80;
+	dstSize = sizeof(dst);
+	ASSERT_TRUE(cm.process(dst, sizeof(dst), dst, dstSize, true));
+	ASSERT_FALSE(cm.verifyTag(CRYPTOSAMPLES_AES128_GCM_SAMPLE_TAG, 16));
+
+	// Missing AAD
+	cm.reset();
+	std::memcpy(dst, CRYPTOSAMPLES_AES128_GCM_SAMPLE, sizeof(dst));
+	dstSize = sizeof(dst);
+	ASSERT_TRUE(cm.process(dst, sizeof(dst), dst, dstSize, true));
+	ASSERT_EQ(0, std::memcmp(CRYPTOSAMPLES_SAMPLE, dst, sizeof(dst)));
+	ASSERT_FALSE(cm.verifyTag(CRYPTOSAMPLES_AES128_GCM_SAMPLE_TAG, 16));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRGCMBlockCipherModeTest, processState) {
+	IRGCMBlockCipherMode cm(IRGCMBlockCipherModeTest_createAES128(
+			CRYPTOSAMPLES_KEY128), true);
+	std::uint8_t dst[sizeof(CRYPTOSAMPLES_SAMPLE)];
+	std::uint8_t tag[16];
+	std::uint64_t dstSize;
+
+	ASSERT_TRUE(cm.setIV(CRYPTOSAMPLES_SAMPLE5, 12));
+	ASSERT_TRUE(cm.addAAD(CRYPTOSAMPLES_SAMPLE5, sizeof(CRYPTOSAMPLES_SAMPLE5)));
+	dstSize = sizeof(dst) - 1;
+	ASSERT_FALSE(cm.process(CRYPTOSAMPLES_SAMPLE, sizeof(dst), dst, dstSize));
+	dstSize = sizeof(dst);
+	ASSERT_TRUE(cm.process(CRYPTOSAMPLES_SAMPLE, 1, dst, dstSize));
+
+	// No more AAD after the data
+	ASSERT_FALSE(cm.addAAD(CRYPTOSAMPLES_SAMPLE5, 1));
+	dstSize = sizeof(dst);
+	ASSERT_TRUE(cm.process(CRYPTOSAMPLES_SAMPLE + 1, sizeof(dst) - 1, dst + 1,
+			dstSize, true));
+	ASSERT_EQ(0, std::memcmp(CRYPTOSAMPLES_AES128_GCM_SAMPLE, dst, sizeof(dst)));
+	ASSERT_FALSE(cm.tag(tag, 3));
+	ASSERT_FALSE(cm.tag(tag, 17));
+	ASSERT_TRUE(cm.tag(tag, 4));
+	ASSERT_EQ(0, std::memcmp(CRYPTOSAMPLES_AES128_GCM_SAMPLE_TAG, tag, 4));
+
+	// Nothing else after the last chunk
+	dstSize = sizeof(dst);
+	ASSERT_FALSE(cm.process(CRYPTOSAMPLES_SAMPLE, 1, dst, dstSize));
+	ASSERT_FALSE(cm.addAAD(CRYPTOSAMPLES_SAMPLE5, 1));
+
+	// Reset starts over
+	cm.reset();
+	ASSERT_FALSE(cm.tag(tag, sizeof(tag)));
+	ASSERT_TRUE(cm.addAAD(CRYPTOSAMPLES_SAMPLE5, sizeof(CRYPTOSAMPLES_SAMPLE5)));
+	dstSize = sizeof(dst);
+	ASSERT_TRUE(cm.process(CRYPTOSAMPLES_SAMPLE, sizeof(dst), dst, dstSize,
+			true));
+	ASSERT_TRUE(cm.verifyTag(CRYPTOSAMPLES_AES128_GCM_SAMPLE_TAG, 16));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRGCMBlockCipherModeTest, processLarge) {
+	IRGCMBlockCipherMode cme(IRGCMBlockCipherModeTest_createAES128(
+			CRYPTOSAMPLES_KEY128), true);
+	IRGCMBlockCipherMode cmd(IRGCMBlockCipherModeTest_createAES128(
+			CRYPTOSAMPLES_KEY128), false);
+	std::vector<std::uint8_t> plain(64 * 1024 + 17);
+	std::vector<std::uint8_t> enc(plain.size());
+	std::vector<std::uint8_t> dec(plain.size());
+	std::uint8_t tag[16];
+	std::uint64_t dstSize;
+
+	for (unsigned int i = 0; i < plain.size(); i++) {
+		plain[i] = (std::uint8_t)(i * 31 + 7);
+	}
+	ASSERT_TRUE(cme.setIV(CRYPTOSAMPLES_SAMPLE5, 12));
+	ASSERT_TRUE(cmd.setIV(CRYPTOSAMPLES_SAMPLE5, 12));
+	dstSize = enc.size();
+	ASSERT_TRUE(cme.process(plain.data(), plain.size(), enc.data(), dstSize,
+			true));
+	ASSERT_TRUE(cme.tag(tag, sizeof(tag)));
+
+	// Deciphers in uneven chunks
+	for (unsigned int offs = 0; offs < plain.size(); offs += 5000) {
+		std::uint64_t size = std::min<std::uint64_t>(5000, plain.size() - offs);
+		dstSize = size;
+		ASSERT_TRUE(cmd.process(enc.data() + offs, size, dec.data() + offs,
+				dstSize, (offs + size) == plain.size()));
+	}
+	ASSERT_TRUE(cmd.verifyTag(tag, sizeof(tag)));
+	ASSERT_EQ(0, std::memcmp(plain.data(), dec.data(), plain.size()));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRGCMBlockCipherModeTest, seek) {
+	IRGCMBlockCipherMode cm(IRGCMBlockCipherModeTest_createAES128(
+			CRYPTOSAMPLES_KEY128), false);
+	std::uint8_t dst[sizeof(CRYPTOSAMPLES_SAMPLE)];
+	std::uint8_t tag[16];
+	std::uint64_t dstSize;
+
+	ASSERT_TRUE(cm.setIV(CRYPTOSAMPLES_SAMPLE5, 12));
+	for (unsigned int offs = 0; offs <= sizeof(dst); offs++) {
+		ASSERT_TRUE(cm.seek(offs));
+		ASSERT_FALSE(cm.addAAD(CRYPTOSAMPLES_SAMPLE5, 1));
+		dstSize = sizeof(dst) - offs;
+		ASSERT_TRUE(cm.process(CRYPTOSAMPLES_AES128_GCM_SAMPLE + offs,
+				sizeof(dst) - offs, dst, dstSize, true));
+		ASSERT_EQ(0, std::memcmp(CRYPTOSAMPLES_SAMPLE + offs, dst, dstSize));
+
+		// The tag is not available
+		ASSERT_FALSE(cm.tag(tag, sizeof(tag)));
+		ASSERT_FALSE(cm.verifyTag(CRYPTOSAMPLES_AES128_GCM_SAMPLE_TAG, 16));
+	}
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRGCMBlockCipherModeTest, processNIST34) {
+	std::uint8_t data[sizeof(IRGCMBlockCipherModeTest_NIST3_PLAIN)];
+	std::uint8_t tag[16];
+	std::uint64_t dstSize;
+
+	for (int table = 1; table >= 0; table--) {
+		IRGCMTableBlockCipherMode cme(IRGCMBlockCipherModeTest_createAES128(
+				IRGCMBlockCipherModeTest_NIST3_KEY), true, table);
+		IRGCMTableBlockCipherMode cmd(IRGCMBlockCipherModeTest_createAES128(
+				IRGCMBlockCipherModeTest_NIST3_KEY), false, table);
+		if (table) {
+			ASSERT_FALSE(cme.clmul());
+		}
+
+		// Test case 3
+		ASSERT_TRUE(cme.setIV(IRGCMBlockCipherModeTest_NIST3_IV,
+				sizeof(IRGCMBlockCipherModeTest_NIST3_IV)));
+		dstSize = sizeof(data);
+		ASSERT_TRUE(cme.process(IRGCMBlockCipherModeTest_NIST3_PLAIN,
+				sizeof(data), data, dstSize, true));
+		ASSERT_EQ(sizeof(data), dstSize);
+		ASSERT_EQ(0, std::memcmp(IRGCMBlockCipherModeTest_NIST3_CIPHER, data,
+				sizeof(data)));
+		ASSERT_TRUE(cme.tag(tag, sizeof(tag)));
+		ASSERT_EQ(0, std::memcmp(IRGCMBlockCipherModeTest_NIST3_TAG, tag,
+				sizeof(tag)));
+
+		ASSERT_TRUE(cmd.setIV(IRGCMBlockCipherModeTest_NIST3_IV,
+				sizeof(IRGCMBlockCipherModeTest_NIST3_IV)));
+		dstSize = sizeof(data);
+		ASSERT_TRUE(cmd.process(data, sizeof(data), data, dstSize, true));
+		ASSERT_EQ(0, std::memcmp(IRGCMBlockCipherModeTest_NIST3_PLAIN, data,
+				sizeof(data)));
+		ASSERT_TRUE(cmd.verifyTag(IRGCMBlockCipherModeTest_NIST3_TAG, 16));
+
+		// Test case 4
+		cme.reset();
+		ASSERT_TRUE(cme.addAAD(IRGCMBlockCipherModeTest_NIST4_AAD,
+				sizeof(IRGCMBlockCipherModeTest_NIST4_AAD)));
+		dstSize = sizeof(data) - 4;
+		ASSERT_TRUE(cme.process(IRGCMBlockCipherModeTest_NIST3_PLAIN,
+				sizeof(data) - 4, data, dstSize, true));
+		ASSERT_EQ(sizeof(data) - 4, dstSize);
+		ASSERT_EQ(0, std::memcmp(IRGCMBlockCipherModeTest_NIST3_CIPHER, data,
+				sizeof(data) - 4));
+		ASSERT_TRUE(cme.tag(tag, sizeof(tag)));
+		ASSERT_EQ(0, std::memcmp(IRGCMBlockCipherModeTest_NIST4_TAG, tag,
+				sizeof(tag)));
+
+		cmd.reset();
+		ASSERT_TRUE(cmd.addAAD(IRGCMBlockCipherModeTest_NIST4_AAD,
+				sizeof(IRGCMBlockCipherModeTest_NIST4_AAD)));
+		dstSize = sizeof(data) - 4;
+		ASSERT_TRUE(cmd.process(data, sizeof(data) - 4, data, dstSize, true));
+		ASSERT_EQ(0, std::memcmp(IRGCMBlockCipherModeTest_NIST3_PLAIN, data,
+				sizeof(data) - 4));
+		ASSERT_TRUE(cmd.verifyTag(IRGCMBlockCipherModeTest_NIST4_TAG, 16));
+	}
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRGCMBlockCipherModeTest, processTable) {
+	IRGCMTableBlockCipherMode table(IRGCMBlockCipherModeTest_createAES128(
+			CRYPTOSAMPLES_KEY128), true, true);
+	IRGCMTableBlockCipherMode fast(IRGCMBlockCipherModeTest_createAES128(
+			CRYPTOSAMPLES_KEY128), true, false);
+	std::vector<std::uint8_t> plain(4096 + 77);
+	std::vector<std::uint8_t> enc1(plain.size());
+	std::vector<std::uint8_t> enc2(plain.size());
+	std::uint8_t tag1[16];
+	std::uint8_t tag2[16];
+	std::uint64_t dstSize;
+
+	// Both GHASH implementations must agree on every block count
+	for (unsigned int i = 0; i < plain.size(); i++) {
+		plain[i] = (std::uint8_t)(i * 13 + 1);
+	}
+	for (unsigned int size = 0; size <= plain.size(); size += 37) {
+		table.reset();
+		fast.reset();
+		ASSERT_TRUE(table.addAAD(plain.data(), size % 100));
+		ASSERT_TRUE(fast.addAAD(plain.data(), size % 100));
+		dstSize = size;
+		ASSERT_TRUE(table.process(plain.data(), size, enc1.data(), dstSize,
+				true));
+		dstSize = size;
+		ASSERT_TRUE(fast.process(plain.data(), size, enc2.data(), dstSize,
+				true));
+		ASSERT_EQ(0, std::memcmp(enc1.data(), enc2.data(), size));
+		ASSERT_TRUE(table.tag(tag1, sizeof(tag1)));
+		ASSERT_TRUE(fast.tag(tag2, sizeof(tag2)));
+		ASSERT_EQ(0, std::memcmp(tag1, tag2, sizeof(tag1)));
+	}
+}
+
+//------------------------------------------------------------------------------
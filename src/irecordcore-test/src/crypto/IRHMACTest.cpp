@@ -15,12 +15,43 @@
  */
 #include "IRHMACTest.h"
 #include "CryptoSamples.h"
+#include "../IRAllocationCounter.h"
 #include <irecordcore/irmac.h>
 #include <cstring>
 
 using namespace irecordcore;
 using namespace irecordcore::crypto;
 
+//==============================================================================
+// class IRNoCopySHA256Hash
+//------------------------------------------------------------------------------
+/**
+ * SHA256 that is unable to copy its state.
+ */
+class IRNoCopySHA256Hash: public IRSHA256Hash {
+public:
+	virtual IRHashAlgorithm * copyState() const {
+		return nullptr;
+	}
+};
+
+//==============================================================================
+// class IRNoRestoreSHA256Hash
+//------------------------------------------------------------------------------
+/**
+ * SHA256 that is unable to restore its state in place.
+ */
+class IRNoRestoreSHA256Hash: public IRSHA256Hash {
+public:
+	virtual IRHashAlgorithm * copyState() const {
+		return new IRNoRestoreSHA256Hash(*this);
+	}
+
+	virtual bool restoreState(const IRHashAlgorithm & src) {
+		return false;
+	}
+};
+
 //==============================================================================
 // class IRHMACTest
 //------------------------------------------------------------------------------
@@ -248,4 +279,109 @@ TEST_F(IRHMACTest, CryptoSamplesSHA512) {
 }
 
 //------------------------------------------------------------------------------
+TEST_F(IRHMACTest, reuse) {
+	IRHMAC m(new IRSHA256Hash());
+	IRHMAC n(new IRNoCopySHA256Hash());
+	std::uint8_t out[32];
+
+	ASSERT_TRUE(m.setRawKey(CRYPTOSAMPLES_KEY128, sizeof(CRYPTOSAMPLES_KEY128)));
+	ASSERT_TRUE(n.setRawKey(CRYPTOSAMPLES_KEY128, sizeof(CRYPTOSAMPLES_KEY128)));
+	for (int i = 0; i < 4; i++) {
+		m.reset();
+		m.update(CRYPTOSAMPLES_SAMPLE2, sizeof(CRYPTOSAMPLES_SAMPLE2));
+		ASSERT_TRUE(m.finalize(out, sizeof(out)));
+		ASSERT_EQ(0, std::memcmp(CRYPTOSAMPLES_HMAC_SHA256_KEY128_SAMPLE2, out,
+				sizeof(out)));
+
+		n.reset();
+		n.update(CRYPTOSAMPLES_SAMPLE2, sizeof(CRYPTOSAMPLES_SAMPLE2));
+		ASSERT_TRUE(n.finalize(out, sizeof(out)));
+		ASSERT_EQ(0, std::memcmp(CRYPTOSAMPLES_HMAC_SHA256_KEY128_SAMPLE2, out,
+				sizeof(out)));
+	}
+
+	// Dropped data
+	m.update(CRYPTOSAMPLES_SAMPLE, sizeof(CRYPTOSAMPLES_SAMPLE));
+	m.reset();
+	ASSERT_TRUE(m.finalize(out, sizeof(out)));
+	ASSERT_EQ(0, std::memcmp(CRYPTOSAMPLES_HMAC_SHA256_KEY128_EMPTY, out,
+			sizeof(out)));
+}
+//------------------------------------------------------------------------------
+TEST_F(IRHMACTest, copyState) {
+	IRHMAC m(new IRSHA256Hash());
+	IRHMAC n(new IRNoCopySHA256Hash());
+	std::unique_ptr<IRHashAlgorithm> copy;
+	std::uint8_t out[32];
+
+	ASSERT_EQ(nullptr, n.copyState());
+
+	ASSERT_TRUE(m.setRawKey(CRYPTOSAMPLES_KEY128, sizeof(CRYPTOSAMPLES_KEY128)));
+	m.update(CRYPTOSAMPLES_SAMPLE2, 4);
+	copy.reset(m.copyState());
+	ASSERT_NE(nullptr, copy.get());
+	ASSERT_EQ(typeid(IRHMAC), typeid(*copy));
+	ASSERT_EQ(m.size(), copy->size());
+
+	// Resume from the copy
+	copy->update(CRYPTOSAMPLES_SAMPLE2 + 4, sizeof(CRYPTOSAMPLES_SAMPLE2) - 4);
+	ASSERT_TRUE(copy->finalize(out, sizeof(out)));
+	ASSERT_EQ(0, std::memcmp(CRYPTOSAMPLES_HMAC_SHA256_KEY128_SAMPLE2, out,
+			sizeof(out)));
+
+	// The copy keeps the key
+	copy->reset();
+	ASSERT_TRUE(copy->finalize(out, sizeof(out)));
+	ASSERT_EQ(0, std::memcmp(CRYPTOSAMPLES_HMAC_SHA256_KEY128_EMPTY, out,
+			sizeof(out)));
+
+	// The original is not affected
+	m.update(CRYPTOSAMPLES_SAMPLE2 + 4, sizeof(CRYPTOSAMPLES_SAMPLE2) - 4);
+	ASSERT_TRUE(m.finalize(out, sizeof(out)));
+	ASSERT_EQ(0, std::memcmp(CRYPTOSAMPLES_HMAC_SHA256_KEY128_SAMPLE2, out,
+			sizeof(out)));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRHMACTest, restoreState) {
+	IRHMAC m(new IRSHA256Hash());
+	IRHMAC n(new IRNoRestoreSHA256Hash());
+	std::uint8_t out[32];
+
+	ASSERT_TRUE(m.setRawKey(CRYPTOSAMPLES_KEY128, sizeof(CRYPTOSAMPLES_KEY128)));
+	ASSERT_TRUE(n.setRawKey(CRYPTOSAMPLES_KEY128, sizeof(CRYPTOSAMPLES_KEY128)));
+	for (int i = 0; i < 4; i++) {
+		m.update(CRYPTOSAMPLES_SAMPLE2, sizeof(CRYPTOSAMPLES_SAMPLE2));
+		ASSERT_TRUE(m.finalize(out, sizeof(out)));
+		ASSERT_EQ(0, std::memcmp(CRYPTOSAMPLES_HMAC_SHA256_KEY128_SAMPLE2, out,
+				sizeof(out)));
+		m.reset();
 
+		// Falls back to copyState()
+		n.update(CRYPTOSAMPLES_SAMPLE2, sizeof(CRYPTOSAMPLES_SAMPLE2));
+		ASSERT_TRUE(n.finalize(out, sizeof(out)));
+		ASSERT_EQ(0, std::memcmp(CRYPTOSAMPLES_HMAC_SHA256_KEY128_SAMPLE2, out,
+				sizeof(out)));
+		n.reset();
+	}
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRHMACTest, resetNoAllocation) {
+	IRHMAC m(new IRSHA256Hash());
+	std::uint8_t out[32];
+	std::uint64_t count;
+
+	ASSERT_TRUE(m.setRawKey(CRYPTOSAMPLES_KEY128, sizeof(CRYPTOSAMPLES_KEY128)));
+	count = IRAllocationCounter::count();
+	for (int i = 0; i < 4; i++) {
+		m.reset();
+		m.update(CRYPTOSAMPLES_SAMPLE2, sizeof(CRYPTOSAMPLES_SAMPLE2));
+		ASSERT_TRUE(m.finalize(out, sizeof(out)));
+	}
+	ASSERT_EQ(count, IRAllocationCounter::count());
+	ASSERT_EQ(0, std::memcmp(CRYPTOSAMPLES_HMAC_SHA256_KEY128_SAMPLE2, out,
+			sizeof(out)));
+}
+
+//------------------------------------------------------------------------------
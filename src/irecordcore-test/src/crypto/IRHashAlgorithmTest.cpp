@@ -94,4 +94,16 @@ TEST_F(IRHashAlgorithmTest, sizeInBytes) {
 }
 
 //------------------------------------------------------------------------------
+TEST_F(IRHashAlgorithmTest, copyState) {
+	DummyIRHashAlgorithm h(1);
 
+	ASSERT_EQ(nullptr, h.copyState());
+}
+//------------------------------------------------------------------------------
+TEST_F(IRHashAlgorithmTest, restoreState) {
+	DummyIRHashAlgorithm h(1);
+	DummyIRHashAlgorithm s(1);
+
+	ASSERT_FALSE(h.restoreState(s));
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "IRHashOutputTest.h"
+#include <irecordcore/irhashout.h>
+#include <irecordcore/irtags.h>
+#include <ircommon/iltagstd.h>
+#include <cstring>
+
+using namespace irecordcore;
+using namespace irecordcore::crypto;
+using namespace irecordcore::tags;
+using namespace ircommon;
+using namespace ircommon::iltags;
+
+//==============================================================================
+// class IRHashOutputTest
+//------------------------------------------------------------------------------
+IRHashOutputTest::IRHashOutputTest() {
+}
+
+//------------------------------------------------------------------------------
+IRHashOutputTest::~IRHashOutputTest() {
+}
+
+//------------------------------------------------------------------------------
+void IRHashOutputTest::SetUp() {
+}
+
+//------------------------------------------------------------------------------
+void IRHashOutputTest::TearDown() {
+}
+
+//------------------------------------------------------------------------------
+static void IRHashOutputTest_createBlock(IRBlockTag & block) {
+	std::uint8_t payload[10000];
+
+	for (unsigned int i = 0; i < sizeof(payload); i++) {
+		payload[i] = i & 0xFF;
+	}
+	ILUInt64Tag * serial = new ILUInt64Tag();
+	serial->setValue(1);
+	block.signedTag().header().add(serial);
+	block.signedTag().payload().value().set(payload, sizeof(payload));
+	block.signedTag().nextPub().value().setType(1);
+	block.signedTag().nextPub().value().set("key", 3);
+	block.signature().parentHashType().setValue(IR_HASH_SHA256);
+	block.signature().signature().value().setType(2);
+	block.signature().signature().value().set("signature", 9);
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRHashOutputTest, Constructor) {
+	IRSHA256Hash hash;
+	IRHashOutput out(hash);
+
+	ASSERT_EQ(&hash, &out.hash());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRHashOutputTest, write) {
+	IRSHA256Hash hash;
+	IRSHA256Hash exp;
+	IRHashOutput out(hash);
+	std::uint8_t buff[256];
+	std::uint8_t expDigest[32];
+	std::uint8_t digest[32];
+
+	for (unsigned int i = 0; i < sizeof(buff); i++) {
+		buff[i] = i;
+	}
+	exp.update(buff, sizeof(buff));
+	ASSERT_TRUE(exp.finalize(expDigest, sizeof(expDigest)));
+
+	ASSERT_TRUE(out.write(buff, 100));
+	ASSERT_TRUE(out.write(buff + 100, 0));
+	ASSERT_TRUE(out.write(buff + 100, sizeof(buff) - 100));
+	ASSERT_TRUE(hash.finalize(digest, sizeof(digest)));
+	ASSERT_EQ(0, std::memcmp(expDigest, digest, sizeof(digest)));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRHashOutputTest, serializeTag) {
+	IRBlockTag block;
+	IRBuffer serialized;
+	IRSHA256Hash hash;
+	IRHashOutput out(hash);
+	std::uint8_t expDigest[32];
+	std::uint8_t digest[32];
+
+	IRHashOutputTest_createBlock(block);
+	ASSERT_TRUE(block.serialize(serialized));
+	hash.update(serialized.roBuffer(), serialized.size());
+	ASSERT_TRUE(hash.finalize(expDigest, sizeof(expDigest)));
+
+	hash.reset();
+	ASSERT_TRUE(block.serialize(out));
+	ASSERT_TRUE(hash.finalize(digest, sizeof(digest)));
+	ASSERT_EQ(0, std::memcmp(expDigest, digest, sizeof(digest)));
+
+	hash.reset();
+	ASSERT_TRUE(block.signedTag().serialize(out));
+	ASSERT_TRUE(hash.finalize(digest, sizeof(digest)));
+	ASSERT_NE(0, std::memcmp(expDigest, digest, sizeof(digest)));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRHashOutputTest, tee) {
+	IRBlockTag block;
+	IRBuffer exp;
+	IRBuffer act;
+	IRSHA256Hash hash;
+	IRHashOutput hashOut(hash);
+	ILTagBufferOutput buffOut(act);
+	ILTagTeeOutput out(buffOut, hashOut);
+	std::uint8_t expDigest[32];
+	std::uint8_t digest[32];
+
+	IRHashOutputTest_createBlock(block);
+	ASSERT_TRUE(block.serialize(exp));
+	hash.update(exp.roBuffer(), exp.size());
+	ASSERT_TRUE(hash.finalize(expDigest, sizeof(expDigest)));
+
+	hash.reset();
+	ASSERT_TRUE(block.serialize(out));
+	ASSERT_TRUE(hash.finalize(digest, sizeof(digest)));
+	ASSERT_EQ(0, std::memcmp(expDigest, digest, sizeof(digest)));
+	ASSERT_EQ(exp.size(), act.size());
+	ASSERT_EQ(0, std::memcmp(exp.roBuffer(), act.roBuffer(), exp.size()));
+}
+
+//------------------------------------------------------------------------------
@@ -15,7 +15,9 @@
  */
 #include "IRPBKDF2KeyGeneratorTest.h"
 #include <irecordcore/irpbkdf2.h>
+#include <atomic>
 #include <cstring>
+#include <stdexcept>
 
 using namespace irecordcore::crypto;
 
@@ -42,6 +44,44 @@ static const std::uint8_t IRPBKDF2KeyGenerator_KEY[80] = {
 		0x5F, 0x7B, 0xA6, 0x32, 0xCE, 0x9E, 0x86, 0xF9,
 		0xBE, 0xC4, 0x2E, 0xB4, 0x0F, 0xA1, 0x83, 0xE1};
 
+//==============================================================================
+// class IRNoCopySHA1Hash
+//------------------------------------------------------------------------------
+/**
+ * SHA1 that is unable to copy its state.
+ */
+class IRNoCopySHA1Hash: public IRSHA1Hash {
+public:
+	virtual IRHashAlgorithm * copyState() const {
+		return nullptr;
+	}
+};
+
+//==============================================================================
+// class IRFailingSHA1Hash
+//------------------------------------------------------------------------------
+/**
+ * SHA1 whose copies throw after a given number of finalize() calls shared
+ * among all of them.
+ */
+class IRFailingSHA1Hash: public IRSHA1Hash {
+public:
+	static std::atomic<int> remaining;
+
+	virtual bool finalize(void * out, std::uint64_t size) {
+		if (remaining-- <= 0) {
+			throw std::runtime_error("Failure injected.");
+		}
+		return IRSHA1Hash::finalize(out, size);
+	}
+
+	virtual IRHashAlgorithm * copyState() const {
+		return new IRFailingSHA1Hash(*this);
+	}
+};
+
+std::atomic<int> IRFailingSHA1Hash::remaining(0x7FFFFFFF);
+
 //==============================================================================
 // class IRPBKDF2KeyGeneratorTest
 //------------------------------------------------------------------------------
@@ -94,6 +134,17 @@ TEST_F(IRPBKDF2KeyGeneratorTest, rounds) {
 	ASSERT_EQ(10, kg.rounds());
 }
 
+//------------------------------------------------------------------------------
+TEST_F(IRPBKDF2KeyGeneratorTest, threads) {
+	IRPBKDF2KeyGenerator kg(new IRHMAC(new IRSHA1Hash()));
+
+	ASSERT_EQ(1, kg.threads());
+	kg.setThreads(4);
+	ASSERT_EQ(4, kg.threads());
+	kg.setThreads(0);
+	ASSERT_EQ(0, kg.threads());
+}
+
 //------------------------------------------------------------------------------
 TEST_F(IRPBKDF2KeyGeneratorTest, setPassword) {
 	IRPBKDF2KeyGenerator kg(new IRHMAC(new IRSHA1Hash()));
@@ -180,4 +231,157 @@ TEST_F(IRPBKDF2KeyGeneratorTest, generateRaw) {
 }
 
 //------------------------------------------------------------------------------
+TEST_F(IRPBKDF2KeyGeneratorTest, generateRawThreads) {
+	IRPBKDF2KeyGenerator kg(new IRHMAC(new IRSHA1Hash()));
+	IRPBKDF2KeyGenerator kgNoCopy(new IRHMAC(new IRNoCopySHA1Hash()));
+	std::uint8_t key[81];
+
+	// Setup
+	kg.setRounds(IRPBKDF2KeyGenerator_ROUNDS);
+	kg.setPassword(IRPBKDF2KeyGenerator_PASSWD,
+			sizeof(IRPBKDF2KeyGenerator_PASSWD));
+	kg.setSalt(IRPBKDF2KeyGenerator_SALT,
+			sizeof(IRPBKDF2KeyGenerator_SALT));
+	kgNoCopy.setRounds(IRPBKDF2KeyGenerator_ROUNDS);
+	kgNoCopy.setPassword(IRPBKDF2KeyGenerator_PASSWD,
+			sizeof(IRPBKDF2KeyGenerator_PASSWD));
+	kgNoCopy.setSalt(IRPBKDF2KeyGenerator_SALT,
+			sizeof(IRPBKDF2KeyGenerator_SALT));
+	for (unsigned int threads = 0; threads <= 5; threads++) {
+		kg.setThreads(threads);
+		kgNoCopy.setThreads(threads);
+		for (unsigned int size = 1; size <= 80; size++) {
+			kg.setKeySize(size * 8);
+			std::memset(key, 0, sizeof(key));
+			ASSERT_TRUE(kg.generateRaw(key, sizeof(key)));
+			ASSERT_EQ(0, std::memcmp(key, IRPBKDF2KeyGenerator_KEY,	size));
+			ASSERT_EQ(0, key[size]);
+
+			// Falls back to a single thread
+			kgNoCopy.setKeySize(size * 8);
+			std::memset(key, 0, sizeof(key));
+			ASSERT_TRUE(kgNoCopy.generateRaw(key, sizeof(key)));
+			ASSERT_EQ(0, std::memcmp(key, IRPBKDF2KeyGenerator_KEY,	size));
+			ASSERT_EQ(0, key[size]);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRPBKDF2KeyGeneratorTest, generateRawBatch) {
+	IRPBKDF2KeyGenerator kg(new IRHMAC(new IRSHA1Hash()));
+	IRPBKDF2KeyGenerator::BatchEntry entries[7];
+	std::uint8_t keys[7][81];
+	std::uint8_t exp[81];
+
+	kg.setRounds(IRPBKDF2KeyGenerator_ROUNDS);
+	kg.setKeySize(50 * 8);
+	for (unsigned int i = 0; i < 7; i++) {
+		entries[i].password = IRPBKDF2KeyGenerator_PASSWD;
+		entries[i].passwordSize = i + 1;
+		entries[i].salt = IRPBKDF2KeyGenerator_SALT;
+		entries[i].saltSize = sizeof(IRPBKDF2KeyGenerator_SALT) - i;
+		entries[i].key = keys[i];
+	}
+	entries[0].passwordSize = sizeof(IRPBKDF2KeyGenerator_PASSWD);
+	entries[0].saltSize = sizeof(IRPBKDF2KeyGenerator_SALT);
+
+	for (unsigned int threads = 0; threads <= 8; threads++) {
+		kg.setThreads(threads);
+		std::memset(keys, 0, sizeof(keys));
+		ASSERT_TRUE(kg.generateRawBatch(entries, 7));
+		ASSERT_EQ(0, std::memcmp(keys[0], IRPBKDF2KeyGenerator_KEY, 50));
+		for (unsigned int i = 0; i < 7; i++) {
+			IRPBKDF2KeyGenerator single(new IRHMAC(new IRSHA1Hash()),
+					IRPBKDF2KeyGenerator_ROUNDS);
+			single.setKeySize(50 * 8);
+			single.setPassword(entries[i].password, entries[i].passwordSize);
+			single.setSalt(entries[i].salt, entries[i].saltSize);
+			ASSERT_TRUE(single.generateRaw(exp, sizeof(exp)));
+			ASSERT_EQ(0, std::memcmp(keys[i], exp, 50));
+			ASSERT_EQ(0, keys[i][50]);
+		}
+	}
+	ASSERT_TRUE(kg.generateRawBatch(entries, 0));
+
+	// Invalid parameters
+	std::memset(keys, 0, sizeof(keys));
+	entries[6].saltSize = 0;
+	ASSERT_FALSE(kg.generateRawBatch(entries, 7));
+	entries[6].saltSize = 1;
+	kg.setRounds(0);
+	ASSERT_FALSE(kg.generateRawBatch(entries, 7));
+	kg.setRounds(IRPBKDF2KeyGenerator_ROUNDS);
+	kg.setKeySize(0);
+	ASSERT_FALSE(kg.generateRawBatch(entries, 7));
+	for (unsigned int i = 0; i < 7; i++) {
+		ASSERT_EQ(0, keys[i][0]);
+	}
+
+	// PRF without copyState()
+	IRPBKDF2KeyGenerator kgNoCopy(new IRHMAC(new IRNoCopySHA1Hash()));
+	kgNoCopy.setKeySize(50 * 8);
+	ASSERT_FALSE(kgNoCopy.generateRawBatch(entries, 7));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRPBKDF2KeyGeneratorTest, generateRawWorkerFailure) {
+	IRPBKDF2KeyGenerator kg(new IRHMAC(new IRFailingSHA1Hash()));
+	std::uint8_t key[80];
+
+	IRFailingSHA1Hash::remaining = 0x7FFFFFFF;
+	kg.setRounds(IRPBKDF2KeyGenerator_ROUNDS);
+	kg.setKeySize(sizeof(key) * 8);
+	kg.setPassword(IRPBKDF2KeyGenerator_PASSWD,
+			sizeof(IRPBKDF2KeyGenerator_PASSWD));
+	kg.setSalt(IRPBKDF2KeyGenerator_SALT,
+			sizeof(IRPBKDF2KeyGenerator_SALT));
+	kg.setThreads(4);
+	ASSERT_TRUE(kg.generateRaw(key, sizeof(key)));
+	ASSERT_EQ(0, std::memcmp(key, IRPBKDF2KeyGenerator_KEY, sizeof(key)));
+
+	// One worker fails midway, the others are joined
+	IRFailingSHA1Hash::remaining = IRPBKDF2KeyGenerator_ROUNDS * 2 * 3;
+	ASSERT_FALSE(kg.generateRaw(key, sizeof(key)));
+	for (unsigned int i = 0; i < sizeof(key); i++) {
+		ASSERT_EQ(0, key[i]);
+	}
+
+	// All workers fail, including the one in the calling thread
+	IRFailingSHA1Hash::remaining = 0;
+	ASSERT_FALSE(kg.generateRaw(key, sizeof(key)));
+	IRFailingSHA1Hash::remaining = 0x7FFFFFFF;
+}
 
+//------------------------------------------------------------------------------
+TEST_F(IRPBKDF2KeyGeneratorTest, generateRawBatchWorkerFailure) {
+	IRPBKDF2KeyGenerator kg(new IRHMAC(new IRFailingSHA1Hash()));
+	IRPBKDF2KeyGenerator::BatchEntry entries[7];
+	std::uint8_t keys[7][20];
+
+	IRFailingSHA1Hash::remaining = 0x7FFFFFFF;
+	kg.setRounds(IRPBKDF2KeyGenerator_ROUNDS);
+	kg.setKeySize(sizeof(keys[0]) * 8);
+	for (unsigned int i = 0; i < 7; i++) {
+		entries[i].password = IRPBKDF2KeyGenerator_PASSWD;
+		entries[i].passwordSize = sizeof(IRPBKDF2KeyGenerator_PASSWD);
+		entries[i].salt = IRPBKDF2KeyGenerator_SALT;
+		entries[i].saltSize = sizeof(IRPBKDF2KeyGenerator_SALT);
+		entries[i].key = keys[i];
+	}
+	kg.setThreads(4);
+	ASSERT_TRUE(kg.generateRawBatch(entries, 7));
+	ASSERT_EQ(0, std::memcmp(keys[6], IRPBKDF2KeyGenerator_KEY,
+			sizeof(keys[0])));
+
+	IRFailingSHA1Hash::remaining = IRPBKDF2KeyGenerator_ROUNDS * 2 * 3;
+	ASSERT_FALSE(kg.generateRawBatch(entries, 7));
+	for (unsigned int i = 0; i < 7; i++) {
+		for (unsigned int j = 0; j < sizeof(keys[i]); j++) {
+			ASSERT_EQ(0, keys[i][j]);
+		}
+	}
+	IRFailingSHA1Hash::remaining = 0x7FFFFFFF;
+}
+
+//------------------------------------------------------------------------------
@@ -16,6 +16,8 @@
 #include "IRSHA256HashTest.h"
 #include <irecordcore/irhash.h>
 #include "CryptoSamples.h"
+#include "../IRAllocationCounter.h"
+#include <cstring>
 
 using namespace irecordcore;
 using namespace irecordcore::crypto;
@@ -90,3 +92,29 @@ TEST_F(IRSHA256HashTest, finalize) {
 
 //------------------------------------------------------------------------------
 
+TEST_F(IRSHA256HashTest, restoreState) {
+	IRSHA256Hash h;
+	IRSHA256Hash saved;
+	std::uint8_t out[32];
+	std::uint8_t exp[32];
+	std::uint64_t count;
+
+	saved.update(CRYPTOSAMPLES_SAMPLE, 4);
+	h.update(CRYPTOSAMPLES_SAMPLE, sizeof(CRYPTOSAMPLES_SAMPLE));
+	ASSERT_TRUE(h.finalize(exp, sizeof(exp)));
+
+	// SHA-256 is not copy assignable in Botan 2, yet it is restored in place
+	count = IRAllocationCounter::count();
+	h.update(CRYPTOSAMPLES_SAMPLE, 8);
+	ASSERT_TRUE(h.restoreState(saved));
+	h.reset();
+	ASSERT_TRUE(h.restoreState(saved));
+	ASSERT_EQ(count, IRAllocationCounter::count());
+
+	h.update(CRYPTOSAMPLES_SAMPLE + 4, sizeof(CRYPTOSAMPLES_SAMPLE) - 4);
+	ASSERT_TRUE(h.finalize(out, sizeof(out)));
+	ASSERT_EQ(0, std::memcmp(exp, out, sizeof(out)));
+	ASSERT_TRUE(h.restoreState(h));
+}
+
+//------------------------------------------------------------------------------
@@ -129,4 +129,28 @@ TEST_F(IRSecretKeyImplTest, serialize) {
 }
 
 //------------------------------------------------------------------------------
+TEST_F(IRSecretKeyImplTest, hot) {
+	IRSecretKeyImpl k(IRSecretKeyImplTest_SAMPLE,
+			sizeof(IRSecretKeyImplTest_SAMPLE));
+	std::uint8_t exported[sizeof(IRSecretKeyImplTest_SAMPLE)];
+	std::uint64_t exportedSize;
+
+	{
+		ircommon::crypto::IRHotScope<IRSecretKeyImpl> scope(k, 16, 60000);
+		for (int i = 0; i < 32; i++) {
+			exportedSize = sizeof(exported);
+			std::memset(exported, 0, sizeof(exported));
+			ASSERT_TRUE(k.exportKey(exported, exportedSize));
+			ASSERT_EQ(sizeof(IRSecretKeyImplTest_SAMPLE), exportedSize);
+			ASSERT_EQ(0, std::memcmp(IRSecretKeyImplTest_SAMPLE, exported,
+					exportedSize));
+		}
+	}
+	ASSERT_TRUE(k.endHot());
+	exportedSize = sizeof(exported);
+	ASSERT_TRUE(k.exportKey(exported, exportedSize));
+	ASSERT_EQ(0, std::memcmp(IRSecretKeyImplTest_SAMPLE, exported,
+			exportedSize));
+}
 
+//------------------------------------------------------------------------------
@@ -148,3 +148,26 @@ TEST_F(IRBaseType16RawTagTest, serialize) {
 
 
 
+
+//------------------------------------------------------------------------------
+TEST_F(IRBaseType16RawTagTest, equalsValue) {
+	IRBaseType16RawTag a(0xFF, false);
+	IRBaseType16RawTag b(0xFF, false);
+	ILRawTag r(0xFF);
+
+	ASSERT_TRUE(ILTagUtil::equals(a, b));
+	a.value().setType(0x1234);
+	ASSERT_TRUE(a.value().write(CRYPTOSAMPLES_SAMPLE, sizeof(CRYPTOSAMPLES_SAMPLE)));
+	ASSERT_FALSE(ILTagUtil::equals(a, b));
+	ASSERT_TRUE(b.value().write(CRYPTOSAMPLES_SAMPLE, sizeof(CRYPTOSAMPLES_SAMPLE)));
+	ASSERT_FALSE(ILTagUtil::equals(a, b));
+	b.value().setType(0x1234);
+	ASSERT_TRUE(ILTagUtil::equals(a, b));
+	ASSERT_TRUE(ILTagUtil::equals(b, a));
+
+	// Distinct classes with the same serialization
+	ASSERT_TRUE(r.value().writeInt((std::uint16_t)0x1234));
+	ASSERT_TRUE(r.value().write(CRYPTOSAMPLES_SAMPLE, sizeof(CRYPTOSAMPLES_SAMPLE)));
+	ASSERT_TRUE(ILTagUtil::equals(a, r));
+	ASSERT_TRUE(ILTagUtil::equals(r, a));
+}
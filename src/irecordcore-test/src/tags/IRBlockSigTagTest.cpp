@@ -15,6 +15,8 @@
  */
 #include "IRBlockSigTagTest.h"
 #include <irecordcore/irtags.h>
+#include <ircommon/iltagstream.h>
+#include <cstring>
 
 
 using namespace irecordcore;
@@ -166,3 +168,41 @@ TEST_F(IRBlockSigTagTest, signature) {
 
 }
 
+
+//------------------------------------------------------------------------------
+TEST_F(IRBlockSigTagTest, equalsValue) {
+	IRBlockSigTag a;
+	IRBlockSigTag b;
+
+	ASSERT_TRUE(ILTagUtil::equals(a, b));
+	a.parentHashType().setValue(1);
+	ASSERT_FALSE(ILTagUtil::equals(a, b));
+	b.parentHashType().setValue(1);
+	ASSERT_TRUE(ILTagUtil::equals(a, b));
+
+	ASSERT_TRUE(a.signature().value().set("SIGNATURE", 9));
+	ASSERT_TRUE(b.signature().value().set("SIGNATURF", 9));
+	ASSERT_FALSE(ILTagUtil::equals(a, b));
+	ASSERT_TRUE(b.signature().value().set("SIGNATURE", 9));
+	ASSERT_TRUE(ILTagUtil::equals(a, b));
+	b.signature().value().setType(1);
+	ASSERT_FALSE(ILTagUtil::equals(a, b));
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBlockSigTagTest, serializeOutput) {
+	IRBlockSigTag tag;
+	IRBuffer exp;
+	IRBuffer act;
+	ILTagBufferOutput out(act);
+
+	tag.parentHashType().setValue(3);
+	tag.signature().value().setType(4);
+	ASSERT_TRUE(tag.signature().value().set("SIGNATURE", 9));
+	ASSERT_TRUE(tag.serialize(exp));
+	ASSERT_TRUE(tag.serialize(out));
+	ASSERT_EQ(exp.size(), act.size());
+	ASSERT_EQ(0, std::memcmp(exp.roBuffer(), act.roBuffer(), exp.size()));
+}
+
+//------------------------------------------------------------------------------
@@ -15,6 +15,9 @@
  */
 #include "IRBlockTagTest.h"
 #include <irecordcore/irtags.h>
+#include <ircommon/iltagstream.h>
+#include <ircommon/iltagstd.h>
+#include <cstring>
 
 
 using namespace irecordcore;
@@ -57,4 +60,57 @@ TEST_F(IRBlockTagTest,Constructor) {
 	*/
 }
 //------------------------------------------------------------------------------
+TEST_F(IRBlockTagTest, getters) {
+	IRBlockTag tag;
+	const IRBlockTag & cTag = tag;
 
+	ASSERT_EQ(TAG_SIGNED, tag.signedTag().id());
+	ASSERT_EQ(&tag.signedTag(), &cTag.signedTag());
+	ASSERT_EQ(TAG_BLOCK_SIG, tag.signature().id());
+	ASSERT_EQ(&tag.signature(), &cTag.signature());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBlockTagTest, serializeDeserialize) {
+	IRBlockTag tag;
+	IRBlockTag tag2;
+	ILStandardTagFactory factory;
+	IRBuffer out;
+
+	ASSERT_TRUE(tag.signedTag().payload().value().set("payload", 7));
+	tag.signature().parentHashType().setValue(1);
+	tag.signature().signature().value().setType(2);
+	ASSERT_TRUE(tag.signature().signature().value().set("signature", 9));
+	ASSERT_TRUE(tag.serialize(out));
+	ASSERT_EQ(tag.tagSize(), out.size());
+	out.beginning();
+	ASSERT_TRUE(factory.deserialize(out, tag2));
+	ASSERT_TRUE(ILTagUtil::equals(tag, tag2));
+	ASSERT_EQ(1, tag2.signature().parentHashType().value());
+	ASSERT_EQ(2, tag2.signature().signature().value().type());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRBlockTagTest, serializeOutput) {
+	IRBlockTag tag;
+	IRBuffer exp;
+	IRBuffer act;
+	ILTagBufferOutput out(act);
+	ILUInt64Tag * serial;
+
+	serial = new ILUInt64Tag();
+	serial->setValue(1234);
+	ASSERT_TRUE(tag.signedTag().header().add(serial));
+	ASSERT_TRUE(tag.signedTag().payload().value().set("payload", 7));
+	tag.signedTag().nextPub().value().setType(1);
+	ASSERT_TRUE(tag.signedTag().nextPub().value().set("key", 3));
+	tag.signature().parentHashType().setValue(1);
+	tag.signature().signature().value().setType(2);
+	ASSERT_TRUE(tag.signature().signature().value().set("signature", 9));
+	ASSERT_TRUE(tag.serialize(exp));
+	ASSERT_TRUE(tag.serialize(out));
+	ASSERT_EQ(exp.size(), act.size());
+	ASSERT_EQ(0, std::memcmp(exp.roBuffer(), act.roBuffer(), exp.size()));
+}
+
+//------------------------------------------------------------------------------
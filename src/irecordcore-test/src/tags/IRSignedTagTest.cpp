@@ -14,6 +14,15 @@
  * limitations under the License.
  */
 #include "IRSignedTagTest.h"
+#include <irecordcore/irtags.h>
+#include <ircommon/iltagstream.h>
+#include <ircommon/iltagstd.h>
+#include <cstring>
+
+using namespace irecordcore;
+using namespace irecordcore::tags;
+using namespace ircommon;
+using namespace ircommon::iltags;
 
 //==============================================================================
 // class IRSignedTagTest
@@ -40,4 +49,58 @@ TEST_F(IRSignedTagTest,Constructor) {
 	std::cout << "Implementation required!";
 }
 //------------------------------------------------------------------------------
+TEST_F(IRSignedTagTest, getters) {
+	IRSignedTag tag;
+	const IRSignedTag & cTag = tag;
+
+	ASSERT_EQ(TAG_HEADER, tag.header().id());
+	ASSERT_EQ(&tag.header(), &cTag.header());
+	ASSERT_EQ(TAG_PAYLOAD, tag.payload().id());
+	ASSERT_EQ(&tag.payload(), &cTag.payload());
+	ASSERT_EQ(TAG_PUB, tag.nextPub().id());
+	ASSERT_EQ(&tag.nextPub(), &cTag.nextPub());
+}
+
+//------------------------------------------------------------------------------
+TEST_F(IRSignedTagTest, serializeDeserialize) {
+	IRSignedTag tag;
+	IRSignedTag tag2;
+	ILStandardTagFactory factory;
+	IRBuffer out;
+
+	ASSERT_TRUE(tag.payload().value().set("payload", 7));
+	tag.nextPub().value().setType(1);
+	ASSERT_TRUE(tag.nextPub().value().set("key", 3));
+	ASSERT_TRUE(tag.serialize(out));
+	ASSERT_EQ(tag.tagSize(), out.size());
+	out.beginning();
+	ASSERT_TRUE(factory.deserialize(out, tag2));
+	ASSERT_TRUE(ILTagUtil::equals(tag, tag2));
+	ASSERT_EQ(7, tag2.payload().value().size());
+}
 
+//------------------------------------------------------------------------------
+TEST_F(IRSignedTagTest, serializeOutput) {
+	IRSignedTag tag;
+	IRBuffer exp;
+	IRBuffer act;
+	ILTagBufferOutput out(act);
+
+	// Empty values
+	ASSERT_TRUE(tag.serialize(exp));
+	ASSERT_TRUE(tag.serialize(out));
+	ASSERT_EQ(exp.size(), act.size());
+	ASSERT_EQ(0, std::memcmp(exp.roBuffer(), act.roBuffer(), exp.size()));
+
+	exp.setSize(0);
+	act.setSize(0);
+	ASSERT_TRUE(tag.payload().value().set("payload", 7));
+	tag.nextPub().value().setType(1);
+	ASSERT_TRUE(tag.nextPub().value().set("key", 3));
+	ASSERT_TRUE(tag.serialize(exp));
+	ASSERT_TRUE(tag.serialize(out));
+	ASSERT_EQ(exp.size(), act.size());
+	ASSERT_EQ(0, std::memcmp(exp.roBuffer(), act.roBuffer(), exp.size()));
+}
+
+//------------------------------------------------------------------------------
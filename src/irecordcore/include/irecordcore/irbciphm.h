@@ -88,12 +88,45 @@ protected:
 	 * @return true for success or false otherwise.
 	 */
 	virtual bool postBlock(const std::uint8_t * src, std::uint8_t * dst);
+
+	/**
+	 * Process a sequence of complete blocks. It is called by process() with
+	 * all complete blocks found in the input, without copying them into the
+	 * temporary block.
+	 *
+	 * <p>The default implementation sends all blocks to the inner cipher with
+	 * cipherBlocks(). It is valid only for modes that do not depend on
+	 * prepareBlock() and postBlock(), thus subclasses that override those
+	 * methods must override this method as well.</p>
+	 *
+	 * @param[in] src The input blocks.
+	 * @param[out] dst The output blocks.
+	 * @param[in] blockCount The number of blocks.
+	 * @return true for success or false otherwise.
+	 * @since 2018.04.25
+	 */
+	virtual bool processBlocks(const std::uint8_t * src, std::uint8_t * dst,
+			std::uint64_t blockCount);
+
+	/**
+	 * Ciphers/deciphers a sequence of blocks using the inner cipher's
+	 * processBlocks() method as few times as possible.
+	 *
+	 * @param[in] src The input blocks.
+	 * @param[out] dst The output blocks.
+	 * @param[in] blockCount The number of blocks.
+	 * @return true for success or false otherwise.
+	 * @since 2018.04.25
+	 */
+	bool cipherBlocks(const std::uint8_t * src, std::uint8_t * dst,
+			std::uint64_t blockCount);
 public:
 	/**
 	 * Creates a new instance of this class.
 	 *
 	 * @param[in] cipher The cipher to be used. It must be ready to be used.
-	 * @param[in] padding The padding to be used.
+	 * @param[in] padding The padding to be used. It may be nullptr if the
+	 * subclass does not use padding at all.
 	 * @note This class will take ownership of both cipher and padding instances.
 	 */
 	IRBlockCipherMode(IRBlockCipherAlgorithm * cipher, IRPadding * padding);
@@ -104,7 +137,8 @@ public:
 	virtual ~IRBlockCipherMode() = default;
 
 	/**
-	 * Grants a read-only access to the inner padding.
+	 * Grants a read-only access to the inner padding. It must not be called
+	 * by modes that do not use padding.
 	 *
 	 * @return The inner padding.
 	 */
@@ -131,11 +165,12 @@ public:
 	}
 
 	/**
-	 * Returns the current cipher mode.
+	 * Returns the current cipher mode. The default implementation returns
+	 * the cipher mode of the inner cipher.
 	 *
 	 * @return true for ciphering or false for deciphering.
 	 */
-	inline bool cipherMode() const {
+	virtual bool cipherMode() const {
 		return this->_cipher->cipherMode();
 	}
 
@@ -153,7 +188,7 @@ public:
 	 * @param[in] srcSize The size of the sorce.
 	 * @return The required size of the output.
 	 */
-	std::uint64_t getOutputSize(std::uint64_t srcSize) const;
+	virtual std::uint64_t getOutputSize(std::uint64_t srcSize) const;
 
 	/**
 	 * Returns the number of bytes that remains to be processed alongside with
@@ -182,7 +217,7 @@ public:
 	 * because the padding may already be processed without being removed by
 	 * previous calls.
 	 */
-	bool process(const void * src, std::uint64_t srcSize, void * dst,
+	virtual bool process(const void * src, std::uint64_t srcSize, void * dst,
 			std::uint64_t & dstSize, bool last = false);
 };
 
@@ -202,9 +237,39 @@ protected:
 	 * The last ciphered block.
 	 */
 	ircommon::IRUtils::IRSecureTemp _lastBlock;
+	/**
+	 * Copy of the ciphertext used to decipher the data in place.
+	 */
+	ircommon::IRUtils::IRSecureTemp _cipherText;
 	virtual bool prepareBlock(std::uint8_t * src) override;
 	virtual bool postBlock(const std::uint8_t * src, std::uint8_t * dst) override;
 
+	/**
+	 * Process a sequence of complete blocks. The encryption is sequential by
+	 * nature but the decryption of all blocks is performed by a single call to
+	 * the inner cipher before the XOR with the previous ciphertexts.
+	 *
+	 * @param[in] src The input blocks.
+	 * @param[out] dst The output blocks.
+	 * @param[in] blockCount The number of blocks.
+	 * @return true for success or false otherwise.
+	 * @since 2018.04.25
+	 */
+	virtual bool processBlocks(const std::uint8_t * src, std::uint8_t * dst,
+			std::uint64_t blockCount) override;
+
+	/**
+	 * Deciphers a sequence of blocks. src and dst must not overlap.
+	 *
+	 * @param[in] src The ciphertext.
+	 * @param[out] dst The plaintext.
+	 * @param[in] blockCount The number of blocks.
+	 * @return true for success or false otherwise.
+	 * @since 2018.04.25
+	 */
+	bool decipherBlocks(const std::uint8_t * src, std::uint8_t * dst,
+			std::uint64_t blockCount);
+
 	void xorBlock(const std::uint8_t * src, std::uint8_t * dst);
 public:
 	/**
@@ -246,6 +311,364 @@ public:
 	virtual void reset() override;
 };
 
+/**
+ * This class implements the CTR block cipher mode as defined by NIST
+ * SP 800-38A. It turns the block cipher into a stream cipher, thus it does
+ * not use padding and the output always has the same size of the input.
+ *
+ * <p>Since this mode uses only the forward direction of the cipher, the
+ * inner cipher must always be created in cipher mode, even to decipher
+ * the data. Both operations are exactly the same.</p>
+ *
+ * <p>All blocks of the key stream are independent, thus they are ciphered
+ * in bulk and any position of the stream can be reached directly with
+ * seek().</p>
+ *
+ * @since 2018.04.26
+ */
+class IRCTRBlockCipherMode : public IRBlockCipherMode {
+protected:
+	/**
+	 * The initial counter block.
+	 */
+	ircommon::IRUtils::IRSecureTemp _iv;
+	/**
+	 * The next counter block.
+	 */
+	ircommon::IRUtils::IRSecureTemp _counter;
+	/**
+	 * The counter blocks that are being ciphered.
+	 */
+	ircommon::IRUtils::IRSecureTemp _counterBlocks;
+	/**
+	 * The key stream. Its position points to the first unused byte.
+	 */
+	ircommon::IRUtils::IRSecureTemp _keyStream;
+	/**
+	 * Number of bytes available inside _keyStream.
+	 */
+	std::uint64_t _keyStreamSize;
+	/**
+	 * Number of bytes at the end of the counter block that are incremented.
+	 */
+	unsigned int _counterSize;
+
+	/**
+	 * Creates a new instance of this class with a custom counter size.
+	 *
+	 * @param[in] cipher The cipher to be used. It must be ready to be used and
+	 * in cipher mode.
+	 * @param[in] counterSize Number of bytes at the end of the counter block
+	 * that are incremented. It must be larger than 0 and not larger than the
+	 * block size.
+	 * @exception std::invalid_argument If the cipher or the counter size are
+	 * invalid.
+	 */
+	IRCTRBlockCipherMode(IRBlockCipherAlgorithm * cipher,
+			unsigned int counterSize);
+
+	/**
+	 * Adds a value to the counter part of a counter block. The counter wraps
+	 * around when it overflows.
+	 *
+	 * @param[in,out] counter The counter block.
+	 * @param[in] value The value to be added.
+	 */
+	void addCounter(std::uint8_t * counter, std::uint64_t value) const;
+
+	/**
+	 * Ciphers the next blocks of the key stream and stores them in
+	 * _keyStream.
+	 *
+	 * @param[in] blockCount The number of blocks. It must not exceed the
+	 * capacity of _keyStream.
+	 * @return true for success or false otherwise.
+	 */
+	bool generateKeyStream(std::uint64_t blockCount);
+
+	/**
+	 * Combines the data with the key stream.
+	 *
+	 * @param[in] src The input.
+	 * @param[out] dst The output. It may be equal to src.
+	 * @param[in] size The number of bytes to be processed.
+	 * @return true for success or false otherwise.
+	 */
+	bool xorKeyStream(const std::uint8_t * src, std::uint8_t * dst,
+			std::uint64_t size);
+public:
+	/**
+	 * Creates a new instance of this class. The whole counter block is used
+	 * as a big endian counter.
+	 *
+	 * @param[in] cipher The cipher to be used. It must be ready to be used and
+	 * in cipher mode.
+	 * @exception std::invalid_argument If the cipher is not in cipher mode.
+	 * @note This class will take ownership of the cipher.
+	 */
+	IRCTRBlockCipherMode(IRBlockCipherAlgorithm * cipher);
+
+	/**
+	 * Disposes this instance and releases all associated resources.
+	 */
+	virtual ~IRCTRBlockCipherMode() = default;
+
+	/**
+	 * Sets the initial counter block. The IV must have at least
+	 * blockSizeInBytes(). If ivSize is larger than the size of the block only
+	 * the first blockSizeInBytes() bytes will be used.
+	 *
+	 * <p>The default IV will set all bytes to zero. The same IV must never be
+	 * used twice with the same key.</p>
+	 *
+	 * @param[in] iv The IV value.
+	 * @param[in] ivSize The size of the IV.
+	 * @return true for success or false otherwise.
+	 */
+	virtual bool setIV(const void * iv, std::uint64_t ivSize);
+
+	/**
+	 * Returns the initial counter block. It has always blockSizeInBytes()
+	 * bytes.
+	 *
+	 * @return A pointer to the current IV.
+	 */
+	const void * iv() const {
+		return _iv.buff();
+	}
+
+	/**
+	 * Moves to the given position of the stream. The next call to process()
+	 * will process the data as if it started at this offset.
+	 *
+	 * @param[in] offset The offset in bytes from the start of the stream.
+	 * @return true for success or false otherwise.
+	 */
+	virtual bool seek(std::uint64_t offset);
+
+	virtual void reset() override;
+
+	/**
+	 * Returns the required output size for a given input size. It is always
+	 * srcSize.
+	 *
+	 * @param[in] srcSize The size of the sorce.
+	 * @return The required size of the output.
+	 */
+	virtual std::uint64_t getOutputSize(std::uint64_t srcSize) const override;
+
+	/**
+	 * Process a chunk of data. All bytes are processed immediately, thus
+	 * dstSize will always be equal to srcSize on success.
+	 *
+	 * @param[in] src The data to be processed.
+	 * @param[in] srcSize The size of src in bytes.
+	 * @param[out] dst The output. It may be equal to src.
+	 * @param[in,out] dstSrc On input, it is the size of dst. On output, it is
+	 * the actual size of the output.
+	 * @param[in] last Ignored by this mode.
+	 * @return true on success or false otherwise.
+	 */
+	virtual bool process(const void * src, std::uint64_t srcSize, void * dst,
+			std::uint64_t & dstSize, bool last = false) override;
+};
+
+/**
+ * This class implements the GCM authenticated block cipher mode as defined
+ * by NIST SP 800-38D. It can be used only with 128-bit block ciphers.
+ *
+ * <p>The data is ciphered in CTR mode while GHASH authenticates the
+ * additional data and the ciphertext. The authentication tag is computed
+ * when process() is called with last set to true. After that, it can be
+ * retrieved with tag() or checked with verifyTag().</p>
+ *
+ * <p>As in IRCTRBlockCipherMode, the inner cipher must always be created in
+ * cipher mode. The direction is defined by the constructor.</p>
+ *
+ * @since 2018.04.26
+ */
+class IRGCMBlockCipherMode : public IRCTRBlockCipherMode {
+protected:
+	/**
+	 * The direction of this mode.
+	 */
+	bool _cipherMode;
+	/**
+	 * The pre-counter block J0.
+	 */
+	ircommon::IRUtils::IRSecureTemp _j0;
+	/**
+	 * The hash subkey H.
+	 */
+	ircommon::IRUtils::IRSecureTemp _h;
+	/**
+	 * Multiples of H used by the portable GHASH implementation.
+	 */
+	ircommon::IRUtils::IRBaseSecureTemp<std::uint64_t> _hTable;
+	/**
+	 * The current GHASH value.
+	 */
+	ircommon::IRUtils::IRSecureTemp _ghash;
+	/**
+	 * Incomplete GHASH input block.
+	 */
+	ircommon::IRUtils::IRSecureTemp _ghashBlock;
+	/**
+	 * The authentication tag.
+	 */
+	ircommon::IRUtils::IRSecureTemp _tag;
+	/**
+	 * Size of the additional authenticated data in bytes.
+	 */
+	std::uint64_t _aadSize;
+	/**
+	 * Size of the processed data in bytes.
+	 */
+	std::uint64_t _dataSize;
+	/**
+	 * Flag that indicates that the tag was computed.
+	 */
+	bool _finished;
+	/**
+	 * Flag that indicates that seek() was used, thus the tag is not valid.
+	 */
+	bool _seeked;
+	/**
+	 * Flag that indicates that GHASH uses the PCLMULQDQ instruction. It is
+	 * set by the constructor when the CPU supports it. Subclasses may clear
+	 * it to force the portable implementation.
+	 */
+	bool _clmul;
+
+	/**
+	 * Computes the pre-counter block J0 from the given IV.
+	 *
+	 * @param[in] iv The IV.
+	 * @param[in] ivSize The size of the IV.
+	 */
+	void computeJ0(const void * iv, std::uint64_t ivSize);
+
+	/**
+	 * Updates the GHASH with complete blocks.
+	 *
+	 * @param[in] blocks The blocks.
+	 * @param[in] blockCount The number of blocks.
+	 */
+	void ghashBlocks(const std::uint8_t * blocks, std::uint64_t blockCount);
+
+	/**
+	 * Updates the GHASH with arbitrary data. Incomplete blocks are kept
+	 * inside _ghashBlock.
+	 *
+	 * @param[in] data The data.
+	 * @param[in] size The size of the data.
+	 */
+	void ghashUpdate(const std::uint8_t * data, std::uint64_t size);
+
+	/**
+	 * Pads the incomplete GHASH block with zeroes and updates the GHASH with
+	 * it.
+	 */
+	void ghashFlush();
+
+	/**
+	 * Computes the authentication tag.
+	 *
+	 * @return true for success or false otherwise.
+	 */
+	bool computeTag();
+public:
+	/**
+	 * Creates a new instance of this class. The default IV is 12 zero bytes.
+	 *
+	 * @param[in] cipher The cipher to be used. It must be ready to be used, in
+	 * cipher mode and with a 128-bit block.
+	 * @param[in] cipherMode true to cipher or false to decipher.
+	 * @exception std::invalid_argument If the cipher is not in cipher mode or
+	 * its block size is not 128 bits.
+	 * @note This class will take ownership of the cipher.
+	 */
+	IRGCMBlockCipherMode(IRBlockCipherAlgorithm * cipher, bool cipherMode);
+
+	/**
+	 * Disposes this instance and releases all associated resources.
+	 */
+	virtual ~IRGCMBlockCipherMode() = default;
+
+	virtual bool cipherMode() const override {
+		return this->_cipherMode;
+	}
+
+	/**
+	 * Sets the IV. Any non empty IV is accepted but 12 byte IVs are
+	 * recommended. The same IV must never be used twice with the same key.
+	 *
+	 * @param[in] iv The IV value.
+	 * @param[in] ivSize The size of the IV.
+	 * @return true for success or false otherwise.
+	 */
+	virtual bool setIV(const void * iv, std::uint64_t ivSize) override;
+
+	/**
+	 * Adds additional authenticated data. It must be called before the first
+	 * call to process().
+	 *
+	 * @param[in] aad The additional authenticated data.
+	 * @param[in] aadSize The size of aad.
+	 * @return true for success or false if the data is already being
+	 * processed.
+	 */
+	bool addAAD(const void * aad, std::uint64_t aadSize);
+
+	/**
+	 * Returns the authentication tag.
+	 *
+	 * @param[out] tag The tag.
+	 * @param[in] tagSize The size of the tag. It must be between 4 and 16.
+	 * Only the first tagSize bytes of the tag are returned.
+	 * @return true for success or false if the tag is not available or
+	 * tagSize is invalid.
+	 */
+	bool tag(void * tag, std::uint64_t tagSize) const;
+
+	/**
+	 * Verifies the authentication tag. The comparison is performed in
+	 * constant time.
+	 *
+	 * @param[in] tag The expected tag.
+	 * @param[in] tagSize The size of the tag. It must be between 4 and 16.
+	 * @return true if the tag matches or false otherwise.
+	 */
+	bool verifyTag(const void * tag, std::uint64_t tagSize) const;
+
+	/**
+	 * Moves to the given position of the stream. It allows random access to
+	 * the data but the tag will not be available until the next reset().
+	 *
+	 * @param[in] offset The offset in bytes from the start of the stream.
+	 * @return true for success or false otherwise.
+	 */
+	virtual bool seek(std::uint64_t offset) override;
+
+	virtual void reset() override;
+
+	/**
+	 * Process a chunk of data. All bytes are processed immediately, thus
+	 * dstSize will always be equal to srcSize on success.
+	 *
+	 * @param[in] src The data to be processed.
+	 * @param[in] srcSize The size of src in bytes.
+	 * @param[out] dst The output. It may be equal to src.
+	 * @param[in,out] dstSrc On input, it is the size of dst. On output, it is
+	 * the actual size of the output.
+	 * @param[in] last If true, the authentication tag will be computed and no
+	 * more data can be processed until the next reset().
+	 * @return true on success or false otherwise.
+	 */
+	virtual bool process(const void * src, std::uint64_t srcSize, void * dst,
+			std::uint64_t & dstSize, bool last = false) override;
+};
+
 } // namespace crypto
 } // namespace irecordcore
 
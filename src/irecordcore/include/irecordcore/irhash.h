@@ -19,6 +19,8 @@
 #include <ircommon/irbuffer.h>
 #include <irecordcore/ircrypto.h>
 #include <cstdint>
+#include <new>
+#include <type_traits>
 #include <botan/sha160.h>
 #include <botan/sha2_32.h>
 #include <botan/sha2_64.h>
@@ -78,6 +80,36 @@ public:
 	 * @return true for success or false otherwise.
 	 */
 	virtual bool finalize(void * out, std::uint64_t size) = 0;
+
+	/**
+	 * Creates a new instance of the same algorithm that holds a copy of the
+	 * current state of this instance. It allows the caller to save an
+	 * intermediate state and resume the computation from it later, as many
+	 * times as required.
+	 *
+	 * <p>The default implementation does not support this feature and
+	 * always returns nullptr.</p>
+	 *
+	 * @return The copy of this instance or nullptr if this algorithm is unable
+	 * to copy its state. The caller must dispose the returned instance.
+	 * @since 2018.04.25
+	 */
+	virtual IRHashAlgorithm * copyState() const;
+
+	/**
+	 * Replaces the current state of this instance with the state of another
+	 * instance of the same algorithm without creating new objects. It is
+	 * the in place counterpart of copyState().
+	 *
+	 * <p>The default implementation does not support this feature and
+	 * always returns false.</p>
+	 *
+	 * @param[in] src The instance that holds the state to be restored.
+	 * @return true for success or false if src is not compatible with this
+	 * instance or if this algorithm is unable to restore its state in place.
+	 * @since 2018.04.26
+	 */
+	virtual bool restoreState(const IRHashAlgorithm & src);
 };
 
 /**
@@ -150,8 +182,53 @@ public:
 	virtual void update(const void * buff, std::uint64_t size);
 
 	virtual bool finalize(void * out, std::uint64_t size);
+
+	virtual IRHashAlgorithm * copyState() const;
+
+	virtual bool restoreState(const IRHashAlgorithm & src);
 };
 
+/**
+ * Assigns the state of a Botan 2 hash to another instance of the same class.
+ *
+ * @param[out] dst The target instance.
+ * @param[in] src The source instance.
+ * @return true for success or false otherwise.
+ * @since 2018.04.26
+ */
+template <class BotanHashImpl>
+inline bool IRBotanHash_assign(BotanHashImpl & dst, const BotanHashImpl & src,
+		std::true_type) {
+	dst = src;
+	return true;
+}
+
+/**
+ * Version of IRBotanHash_assign() used when the Botan 2 class is not copy
+ * assignable, like the SHA-1 and SHA-2 classes derived from
+ * Botan::MDx_HashFunction. The target is destroyed and copy constructed in
+ * place from the source.
+ *
+ * @param[out] dst The target instance.
+ * @param[in] src The source instance.
+ * @return true for success or false otherwise. On failure, dst is left in
+ * its initial state.
+ * @since 2018.04.26
+ */
+template <class BotanHashImpl>
+inline bool IRBotanHash_assign(BotanHashImpl & dst, const BotanHashImpl & src,
+		std::false_type) {
+
+	dst.~BotanHashImpl();
+	try {
+		new (&dst) BotanHashImpl(src);
+	} catch (...) {
+		new (&dst) BotanHashImpl();
+		return false;
+	}
+	return true;
+}
+
 /**
  * This class template implements the hash algorithm implemented by Botan 2.
  *
@@ -192,6 +269,32 @@ public:
 		this->_hash.final((std::uint8_t *)out);
 		return true;
 	}
+
+	/**
+	 * Copies the state of this instance. The inner Botan instance is copied
+	 * just like Botan::HashFunction::copy_state() does.
+	 */
+	virtual IRHashAlgorithm * copyState() const {
+		return new IRBotanHash(*this);
+	}
+
+	/**
+	 * Restores the state of the inner Botan instance in place. It is assigned
+	 * or, if the Botan class is not copy assignable, copy constructed over
+	 * the current one. Only the internal buffers of the Botan class may be
+	 * allocated, by Botan itself.
+	 */
+	virtual bool restoreState(const IRHashAlgorithm & src) {
+		const IRBotanHash * s = dynamic_cast<const IRBotanHash *>(&src);
+		if (!s) {
+			return false;
+		}
+		if (s == this) {
+			return true;
+		}
+		return IRBotanHash_assign(this->_hash, s->_hash,
+				std::is_copy_assignable<BotanHashImpl>());
+	}
 };
 
 /**
@@ -261,6 +364,22 @@ public:
 		this->_hash.final((std::uint8_t *)out);
 		return true;
 	}
+
+	virtual IRHashAlgorithm * copyState() const {
+		return new IRBotanKeccakHash(*this);
+	}
+
+	virtual bool restoreState(const IRHashAlgorithm & src) {
+		const IRBotanKeccakHash * s = dynamic_cast<const IRBotanKeccakHash *>(&src);
+		if (!s) {
+			return false;
+		}
+		if (s == this) {
+			return true;
+		}
+		return IRBotanHash_assign(this->_hash, s->_hash,
+				std::is_copy_assignable<BotanHashImpl>());
+	}
 };
 
 typedef IRBotanKeccakHash<Botan::SHA_3,256, IR_HASH_SHA3_256> IRSHA3_256Hash;
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _IRECORDCORE_IRHASHOUT_H_
+#define _IRECORDCORE_IRHASHOUT_H_
+
+#include <ircommon/iltagstream.h>
+#include <irecordcore/irhash.h>
+
+namespace irecordcore {
+namespace crypto {
+
+/**
+ * Output sink that feeds the bytes written to it into a hash algorithm. It
+ * allows the computation of the hash of a tag without its serialization in
+ * memory:
+ *
+ * <pre>
+ * IRHashOutput out(hash);
+ * hash.reset();
+ * if (tag.serialize(out)) {
+ *     hash.finalize(digest, sizeof(digest));
+ * }
+ * </pre>
+ *
+ * <p>It can be combined with ircommon::iltags::ILTagBufferOutput inside an
+ * ircommon::iltags::ILTagTeeOutput to store and hash a tag in a single
+ * pass.</p>
+ *
+ * @since 2018.04.26
+ */
+class IRHashOutput: public ircommon::iltags::ILTagOutput {
+private:
+	IRHashAlgorithm & _hash;
+public:
+	/**
+	 * Creates a new instance of this class.
+	 *
+	 * @param[in] hash The hash algorithm. It is not reset by this class.
+	 */
+	IRHashOutput(IRHashAlgorithm & hash): _hash(hash) {}
+
+	/**
+	 * Disposes this instance and releases all associated resources.
+	 */
+	virtual ~IRHashOutput() = default;
+
+	/**
+	 * Returns the hash algorithm.
+	 *
+	 * @return The hash algorithm.
+	 */
+	IRHashAlgorithm & hash() {
+		return this->_hash;
+	}
+
+	virtual bool write(const void * buff, std::uint64_t size);
+};
+
+} //namespace crypto
+} //namespace irecordcore
+
+#endif /* _IRECORDCORE_IRHASHOUT_H_ */
@@ -173,6 +173,32 @@ public:
 
 	virtual bool exportKey(void * key, std::uint64_t & keySize);
 
+	/**
+	 * Opens a hot window on the protected key. While it is open, the key is
+	 * kept unprotected in the locked memory between uses, thus the
+	 * operations that use it repeatedly do not pay for the protection of
+	 * the key on each call.
+	 *
+	 * @param[in] maxUses The maximum number of uses.
+	 * @param[in] maxTime The maximum duration of the window in milliseconds.
+	 * @since 2018.04.26
+	 * @see ircommon::crypto::IRProtectedMemory::beginHot()
+	 * @see ircommon::crypto::IRHotScope
+	 */
+	void beginHot(std::uint64_t maxUses, std::uint64_t maxTime) {
+		this->_key.beginHot(maxUses, maxTime);
+	}
+
+	/**
+	 * Closes the current hot window, if any, and protects the key again.
+	 *
+	 * @return true for success or false otherwise.
+	 * @since 2018.04.26
+	 */
+	bool endHot() {
+		return this->_key.endHot();
+	}
+
 	/**
 	 * Serializes the key using the Interlock Record format.
 	 *
@@ -73,6 +73,18 @@ private:
 	std::uint64_t _blockSize;
 	std::unique_ptr<std::uint8_t[]> _ipad;
 	std::unique_ptr<std::uint8_t[]> _opad;
+	/**
+	 * State of the inner hash after the ipad. It is nullptr if the inner hash
+	 * is unable to copy its state. reset() restores it into the working hash
+	 * in place whenever IRHashAlgorithm::restoreState() is supported.
+	 */
+	std::unique_ptr<IRHashAlgorithm> _innerState;
+	/**
+	 * State of the inner hash after the opad. It is nullptr if the inner hash
+	 * is unable to copy its state. finalize() restores it into the working
+	 * hash in place whenever IRHashAlgorithm::restoreState() is supported.
+	 */
+	std::unique_ptr<IRHashAlgorithm> _outerState;
 
 	/**
 	 * Masks the specified block using the specified mask.
@@ -82,6 +94,17 @@ private:
 	 * @param[in] The mask to be used.
 	 */
 	void mask(std::uint8_t * block, std::uint8_t mask);
+
+	/**
+	 * Creates a copy of the given instance that uses the specified inner
+	 * hash. It is used by copyState().
+	 *
+	 * @param[in] src The source instance.
+	 * @param[in] hash The copy of the current state of the inner hash. This
+	 * class will claim full ownership of this instance.
+	 * @since 2018.04.26
+	 */
+	IRHMAC(const IRHMAC & src, IRHashAlgorithm * hash);
 public:
 	/**
 	 * Creates a new instance of this class.
@@ -123,6 +146,17 @@ public:
 	virtual void update(const void * buff, std::uint64_t size);
 
 	virtual bool finalize(void * out, std::uint64_t size);
+
+	/**
+	 * Creates a copy of this instance, including the key and the current
+	 * state. It is supported only if the inner hash also supports
+	 * IRHashAlgorithm::copyState().
+	 *
+	 * @return The copy of this instance or nullptr if the inner hash is unable
+	 * to copy its state. The caller must dispose the returned instance.
+	 * @since 2018.04.26
+	 */
+	virtual IRHashAlgorithm * copyState() const;
 };
 
 } //namespace crypto
@@ -18,6 +18,7 @@
 
 #include <ircommon/irutils.h>
 #include <irecordcore/irkeygen.h>
+#include <vector>
 
 namespace irecordcore {
 namespace crypto {
@@ -30,6 +31,34 @@ namespace crypto {
  * @author Fabio Jun Takada Chino (fchino at opencs.com.br)
  */
 class IRPBKDF2KeyGenerator: public IRSoftwareKeyGenerator {
+public:
+	/**
+	 * An entry of the batch key derivation performed by generateRawBatch().
+	 *
+	 * @since 2018.04.26
+	 */
+	struct BatchEntry {
+		/**
+		 * The password.
+		 */
+		const void * password;
+		/**
+		 * The size of the password in bytes.
+		 */
+		std::uint64_t passwordSize;
+		/**
+		 * The salt.
+		 */
+		const void * salt;
+		/**
+		 * The size of the salt in bytes. It must not be 0.
+		 */
+		std::uint64_t saltSize;
+		/**
+		 * The output key. It must have at least keySizeInBytes() bytes.
+		 */
+		void * key;
+	};
 private:
 	/**
 	 * The inner MAC.
@@ -43,18 +72,61 @@ private:
 	 * The current salt.
 	 */
 	ircommon::IRBuffer _salt;
+	/**
+	 * Maximum number of threads used to generate the keys.
+	 */
+	unsigned int _threads;
 	/**
 	 * Generates the block with the given index.
 	 *
+	 * @param[in] prf The PRF already initialized with the password.
+	 * @param[in] salt The salt.
+	 * @param[in] saltSize The size of the salt in bytes.
 	 * @param[in] index The block index.
 	 * @param[in,out] tmp The temporary buffer. It must have at least
 	 * blockSize() bytes or 4 witchever
 	 * @param[out] out The block output. It must have at least blockSize()
 	 * bytes.
 	 */
-	void generateBlock(std::uint32_t index, std::uint8_t * tmp,
+	void generateBlock(IRHashAlgorithm & prf, const void * salt,
+			std::uint64_t saltSize, std::uint32_t index, std::uint8_t * tmp,
 			std::uint8_t * out);
 
+	/**
+	 * Generates all blocks of the key sequentially.
+	 *
+	 * @param[in] prf The PRF already initialized with the password.
+	 * @param[in] salt The salt.
+	 * @param[in] saltSize The size of the salt in bytes.
+	 * @param[out] key The output key.
+	 * @param[in] keySize The size of the output key in bytes.
+	 * @since 2018.04.26
+	 */
+	void generateKey(IRHashAlgorithm & prf, const void * salt,
+			std::uint64_t saltSize, std::uint8_t * key, unsigned int keySize);
+
+	/**
+	 * Returns the number of threads that should be used to perform the
+	 * given number of independent jobs.
+	 *
+	 * @param[in] jobs The number of jobs.
+	 * @return The number of threads. It is never 0.
+	 * @since 2018.04.26
+	 */
+	unsigned int workerCount(std::uint64_t jobs) const;
+
+	/**
+	 * Creates one copy of the PRF for each thread.
+	 *
+	 * @param[in] workers The number of threads.
+	 * @param[out] prfs The copies of the PRF.
+	 * @return true for success or false if the PRF is unable to copy its
+	 * state.
+	 * @since 2018.04.26
+	 */
+	bool clonePRF(unsigned int workers,
+			std::vector<std::unique_ptr<IRMAC>> & prfs) const;
+
 	/**
 	 * Core of the key generation function.
 	 *
@@ -91,6 +163,35 @@ public:
 		this->_rounds = rounds;
 	}
 
+	/**
+	 * Maximum number of threads used to generate the keys. Since each block
+	 * of the key is independent, keys larger than blockSize() may be computed
+	 * in parallel.
+	 *
+	 * @return The maximum number of threads. 0 means one thread per available
+	 * processor.
+	 * @since 2018.04.26
+	 */
+	unsigned int threads() const {
+		return this->_threads;
+	}
+
+	/**
+	 * Sets the maximum number of threads used to generate the keys. The
+	 * default value is 1, which means that no additional threads will be
+	 * created.
+	 *
+	 * <p>The additional threads are used only if the PRF supports
+	 * IRHashAlgorithm::copyState().</p>
+	 *
+	 * @param[in] threads The maximum number of threads. Use 0 to use one
+	 * thread per available processor.
+	 * @since 2018.04.26
+	 */
+	void setThreads(unsigned int threads) {
+		this->_threads = threads;
+	}
+
 	/**
 	 * Size of the inner block.
 	 *
@@ -116,7 +217,35 @@ public:
 	 */
 	void setSalt(const void * salt, std::uint64_t saltSize);
 
+	/**
+	 * Generates the key. The blocks of the key are distributed among up to
+	 * threads() threads.
+	 *
+	 * @param[out] key The key.
+	 * @param[in] keySize The size of key in bytes.
+	 * @return true for success or false otherwise. If any worker fails, all
+	 * threads are still joined and the key is wiped.
+	 */
 	virtual bool generateRaw(void * key, unsigned int keySize);
+
+	/**
+	 * Derives the keys of multiple password/salt pairs at once using the
+	 * current key size and number of rounds. The entries are distributed
+	 * among up to threads() threads.
+	 *
+	 * <p>The password and salt of this instance are not used nor modified
+	 * by this method. It requires a PRF that supports
+	 * IRHashAlgorithm::copyState().</p>
+	 *
+	 * @param[in,out] entries The entries to be processed.
+	 * @param[in] count The number of entries. Each entry receives exactly
+	 * keySizeInBytes() bytes.
+	 * @return true for success or false otherwise. On failure, no key is
+	 * generated. If any worker fails, all threads are still joined and the
+	 * keys already generated are wiped.
+	 * @since 2018.04.26
+	 */
+	bool generateRawBatch(const BatchEntry * entries, std::uint64_t count);
 };
 
 } // namespace crypto
@@ -80,6 +80,8 @@ protected:
 	irecordcore::IRTypedRaw _value;
 
 	virtual bool serializeValue(ircommon::IRBuffer & out) const;
+
+	virtual bool writeValue(ircommon::iltags::ILTagStreamWriter & out) const;
 public:
     /**
      * Creates a new instance of this class.
@@ -100,6 +102,8 @@ public:
 			const ircommon::iltags::ILTagFactory & factory,
 			const void * buff, std::uint64_t size);
 
+	virtual bool equalsValue(const ircommon::iltags::ILTag & other) const;
+
 	/**
 	 * Returns the value of this tag without its type.
 	 *
@@ -186,6 +190,8 @@ protected:
 	ircommon::iltags::ILUInt16Tag _parentHashType;
 	IRSigTag _signature;
 	virtual bool serializeValue(ircommon::IRBuffer & out) const;
+
+	virtual bool writeValue(ircommon::iltags::ILTagStreamWriter & out) const;
 public:
 	IRBlockSigTag() : ILTag(TAG_BLOCK_SIG) {}
 
@@ -197,6 +203,8 @@ public:
 			const ircommon::iltags::ILTagFactory & factory,
 			const void * buff, std::uint64_t size);
 
+	virtual bool equalsValue(const ircommon::iltags::ILTag & other) const;
+
 	ircommon::iltags::ILUInt16Tag & parentHashType() {
 		return this->_parentHashType;
 	}
@@ -264,6 +272,8 @@ protected:
 	IRPubTag _nextPub;
 
 	virtual bool serializeValue(ircommon::IRBuffer & out) const;
+
+	virtual bool writeValue(ircommon::iltags::ILTagStreamWriter & out) const;
 public:
 	IRSignedTag();
 	virtual ~IRSignedTag() = default;
@@ -274,7 +284,31 @@ public:
 			const ircommon::iltags::ILTagFactory & factory,
 			const void * buff, std::uint64_t size);
 
-	// Add the getters (rw/ro).
+	virtual bool equalsValue(const ircommon::iltags::ILTag & other) const;
+
+	IRHeaderTag & header() {
+		return this->_header;
+	}
+
+	const IRHeaderTag & header() const {
+		return this->_header;
+	}
+
+	IRPayloadTag & payload() {
+		return this->_payload;
+	}
+
+	const IRPayloadTag & payload() const {
+		return this->_payload;
+	}
+
+	IRPubTag & nextPub() {
+		return this->_nextPub;
+	}
+
+	const IRPubTag & nextPub() const {
+		return this->_nextPub;
+	}
 };
 
 /**
@@ -290,6 +324,8 @@ protected:
 	IRBlockSigTag _signature;
 
 	virtual bool serializeValue(ircommon::IRBuffer & out) const;
+
+	virtual bool writeValue(ircommon::iltags::ILTagStreamWriter & out) const;
 public:
 	IRBlockTag();
 
@@ -301,7 +337,23 @@ public:
 			const ircommon::iltags::ILTagFactory & factory,
 			const void * buff, std::uint64_t size);
 
-	// Add the getters (rw/ro).
+	virtual bool equalsValue(const ircommon::iltags::ILTag & other) const;
+
+	IRSignedTag & signedTag() {
+		return this->_signed;
+	}
+
+	const IRSignedTag & signedTag() const {
+		return this->_signed;
+	}
+
+	IRBlockSigTag & signature() {
+		return this->_signature;
+	}
+
+	const IRBlockSigTag & signature() const {
+		return this->_signature;
+	}
 };
 
 /**
@@ -47,6 +47,20 @@ public:
 			IRBuffer(reserve, secure, inc), _type(0){
 	}
 
+	/**
+	 * Creates a new empty instance of this class without storage.
+	 *
+	 * @param[in] marker Must be NO_STORAGE.
+	 * @param[in] secure If true, all memory allocations will be treated as secure.
+	 * @param[in] inc The size of the increment. Must be a value larger than 0.
+	 * @exception std::invalid_argument If inc is 0.
+	 * @since 2018.04.26
+	 */
+	IRTypedRaw(NoStorage marker, bool secure = false,
+				std::uint64_t inc = DEFAULT_INCREMENT):
+			IRBuffer(marker, secure, inc), _type(0){
+	}
+
 	/**
 	 * Disposes this instance and releases all associated resources.
 	 */
@@ -16,9 +16,315 @@
 #include <irecordcore/irbciphm.h>
 #include <cstring>
 #include <algorithm>
+#include <limits>
+#include <stdexcept>
+#if (defined(__GNUC__) || defined(__clang__)) && \
+		(defined(__x86_64__) || defined(__i386__))
+	#define IRGCM_CLMUL_X86
+	#include <immintrin.h>
+#endif
 
 using namespace irecordcore::crypto;
 
+/**
+ * Size of the chunks used by IRCBCBlockCipherMode to decipher the data in
+ * place.
+ */
+#define IRCBC_INPLACE_CHUNK_SIZE 4096
+
+/**
+ * Size of the key stream generated by IRCTRBlockCipherMode at once.
+ */
+#define IRCTR_KEYSTREAM_SIZE 4096
+
+/**
+ * Size of the chunks that are ciphered and authenticated at once by
+ * IRGCMBlockCipherMode.
+ */
+#define IRGCM_CHUNK_SIZE 4096
+
+/**
+ * Maximum size of the data processed by IRGCMBlockCipherMode in bytes
+ * (2^39 - 256 bits).
+ */
+#define IRGCM_MAX_DATA_SIZE ((std::uint64_t(1) << 36) - 32)
+
+//==============================================================================
+// Utilities
+//------------------------------------------------------------------------------
+/**
+ * Computes dst = a XOR b.
+ *
+ * @param[in] a The first operand.
+ * @param[in] b The second operand.
+ * @param[out] dst The output. It may be equal to a.
+ * @param[in] size The number of bytes.
+ */
+static void IRBlockCipherMode_xor(const std::uint8_t * a,
+		const std::uint8_t * b, std::uint8_t * dst, std::uint64_t size) {
+	const std::uint8_t * aEnd;
+
+	aEnd = a + size;
+	for ( ; (aEnd - a) >= 8; a += 8, b += 8, dst += 8) {
+		std::uint64_t x;
+		std::uint64_t y;
+		std::memcpy(&x, a, sizeof(x));
+		std::memcpy(&y, b, sizeof(y));
+		x = x ^ y;
+		std::memcpy(dst, &x, sizeof(x));
+	}
+	for ( ; a != aEnd; a++, b++, dst++) {
+		(*dst) = (*a) ^ (*b);
+	}
+}
+
+//------------------------------------------------------------------------------
+static std::uint64_t IRGCM_loadBE64(const std::uint8_t * p) {
+	std::uint64_t v;
+
+	v = 0;
+	for (int i = 0; i < 8; i++) {
+		v = (v << 8) | p[i];
+	}
+	return v;
+}
+
+//------------------------------------------------------------------------------
+static void IRGCM_storeBE64(std::uint64_t v, std::uint8_t * p) {
+
+	for (int i = 7; i >= 0; i--) {
+		p[i] = (std::uint8_t)v;
+		v = v >> 8;
+	}
+}
+
+/**
+ * Reduction constants used by the 4-bit GHASH multiplication.
+ */
+static const std::uint64_t IRGCM_LAST4[16] = {
+		0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+		0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0};
+
+//------------------------------------------------------------------------------
+/**
+ * Computes the multiples of H used by IRGCM_ghashTable(). The first 16
+ * entries are the low halves and the last 16 are the high halves.
+ *
+ * @param[in] h The hash subkey.
+ * @param[out] table The table with 32 entries.
+ */
+static void IRGCM_createTable(const std::uint8_t * h, std::uint64_t * table) {
+	std::uint64_t * hl;
+	std::uint64_t * hh;
+	std::uint64_t vh;
+	std::uint64_t vl;
+
+	hl = table;
+	hh = table + 16;
+	vh = IRGCM_loadBE64(h);
+	vl = IRGCM_loadBE64(h + 8);
+	hl[0] = 0;
+	hh[0] = 0;
+	hl[8] = vl;
+	hh[8] = vh;
+	for (int i = 4; i > 0; i >>= 1) {
+		std::uint64_t t = (vl & 1) * 0xe1000000;
+		vl = (vh << 63) | (vl >> 1);
+		vh = (vh >> 1) ^ (t << 32);
+		hl[i] = vl;
+		hh[i] = vh;
+	}
+	for (int i = 2; i <= 8; i *= 2) {
+		vh = hh[i];
+		vl = hl[i];
+		for (int j = 1; j < i; j++) {
+			hh[i + j] = vh ^ hh[j];
+			hl[i + j] = vl ^ hl[j];
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Portable GHASH that uses a table with the multiples of H.
+ *
+ * @param[in] table The table created by IRGCM_createTable().
+ * @param[in,out] x The current GHASH value.
+ * @param[in] blocks The blocks to be hashed.
+ * @param[in] blockCount The number of blocks.
+ */
+static void IRGCM_ghashTable(const std::uint64_t * table, std::uint8_t * x,
+		const std::uint8_t * blocks, std::uint64_t blockCount) {
+	const std::uint64_t * hl;
+	const std::uint64_t * hh;
+	std::uint8_t y[16];
+
+	hl = table;
+	hh = table + 16;
+	for (; blockCount; blockCount--, blocks += 16) {
+		IRBlockCipherMode_xor(x, blocks, y, 16);
+		unsigned int lo = y[15] & 0xf;
+		std::uint64_t zh = hh[lo];
+		std::uint64_t zl = hl[lo];
+		for (int i = 15; i >= 0; i--) {
+			unsigned int rem;
+			lo = y[i] & 0xf;
+			unsigned int hi = (y[i] >> 4) & 0xf;
+			if (i != 15) {
+				rem = zl & 0xf;
+				zl = (zh << 60) | (zl >> 4);
+				zh = (zh >> 4) ^ (IRGCM_LAST4[rem] << 48);
+				zh ^= hh[lo];
+				zl ^= hl[lo];
+			}
+			rem = zl & 0xf;
+			zl = (zh << 60) | (zl >> 4);
+			zh = (zh >> 4) ^ (IRGCM_LAST4[rem] << 48);
+			zh ^= hh[hi];
+			zl ^= hl[hi];
+		}
+		IRGCM_storeBE64(zh, x);
+		IRGCM_storeBE64(zl, x + 8);
+	}
+}
+
+#ifdef IRGCM_CLMUL_X86
+//------------------------------------------------------------------------------
+/**
+ * Computes the 256-bit carry-less product of a and b without the reduction.
+ * Both values must have their bytes reversed.
+ */
+__attribute__((target("pclmul,ssse3")))
+static inline void IRGCM_clmul(__m128i a, __m128i b, __m128i & lo,
+		__m128i & hi) {
+	__m128i t3, t4, t5, t6;
+
+	t3 = _mm_clmulepi64_si128(a, b, 0x00);
+	t4 = _mm_clmulepi64_si128(a, b, 0x10);
+	t5 = _mm_clmulepi64_si128(a, b, 0x01);
+	t6 = _mm_clmulepi64_si128(a, b, 0x11);
+	t4 = _mm_xor_si128(t4, t5);
+	t5 = _mm_slli_si128(t4, 8);
+	t4 = _mm_srli_si128(t4, 8);
+	lo = _mm_xor_si128(t3, t5);
+	hi = _mm_xor_si128(t6, t4);
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Reduces the 256-bit product computed by IRGCM_clmul(). Since the reduction
+ * is linear, the sum of many products can be reduced at once.
+ */
+__attribute__((target("pclmul,ssse3")))
+static inline __m128i IRGCM_clmulReduce(__m128i t3, __m128i t6) {
+	__m128i t2, t4, t5, t7, t8, t9;
+
+	// Shift left by 1 bit due to the reflected representation
+	t7 = _mm_srli_epi32(t3, 31);
+	t8 = _mm_srli_epi32(t6, 31);
+	t3 = _mm_slli_epi32(t3, 1);
+	t6 = _mm_slli_epi32(t6, 1);
+	t9 = _mm_srli_si128(t7, 12);
+	t8 = _mm_slli_si128(t8, 4);
+	t7 = _mm_slli_si128(t7, 4);
+	t3 = _mm_or_si128(t3, t7);
+	t6 = _mm_or_si128(t6, t8);
+	t6 = _mm_or_si128(t6, t9);
+
+	// Reduction modulo x^128 + x^7 + x^2 + x + 1
+	t7 = _mm_slli_epi32(t3, 31);
+	t8 = _mm_slli_epi32(t3, 30);
+	t9 = _mm_slli_epi32(t3, 25);
+	t7 = _mm_xor_si128(t7, t8);
+	t7 = _mm_xor_si128(t7, t9);
+	t8 = _mm_srli_si128(t7, 4);
+	t7 = _mm_slli_si128(t7, 12);
+	t3 = _mm_xor_si128(t3, t7);
+	t2 = _mm_srli_epi32(t3, 1);
+	t4 = _mm_srli_epi32(t3, 2);
+	t5 = _mm_srli_epi32(t3, 7);
+	t2 = _mm_xor_si128(t2, t4);
+	t2 = _mm_xor_si128(t2, t5);
+	t2 = _mm_xor_si128(t2, t8);
+	t3 = _mm_xor_si128(t3, t2);
+	return _mm_xor_si128(t6, t3);
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Multiplies a by b in GF(2^128). Both values must have their bytes reversed.
+ */
+__attribute__((target("pclmul,ssse3")))
+static inline __m128i IRGCM_gfmulCLMUL(__m128i a, __m128i b) {
+	__m128i lo, hi;
+
+	IRGCM_clmul(a, b, lo, hi);
+	return IRGCM_clmulReduce(lo, hi);
+}
+
+//------------------------------------------------------------------------------
+/**
+ * GHASH based on the PCLMULQDQ instruction. Groups of 4 blocks are multiplied
+ * by H^4, H^3, H^2 and H and reduced only once.
+ *
+ * @param[in] h The hash subkey.
+ * @param[in,out] x The current GHASH value.
+ * @param[in] blocks The blocks to be hashed.
+ * @param[in] blockCount The number of blocks.
+ */
+__attribute__((target("pclmul,ssse3")))
+static void IRGCM_ghashCLMUL(const std::uint8_t * h, std::uint8_t * x,
+		const std::uint8_t * blocks, std::uint64_t blockCount) {
+	const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+			12, 13, 14, 15);
+	__m128i h1, h2, h3, h4;
+	__m128i vx;
+
+	h1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)h), bswap);
+	vx = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)x), bswap);
+	if (blockCount >= 4) {
+		h2 = IRGCM_gfmulCLMUL(h1, h1);
+		h3 = IRGCM_gfmulCLMUL(h2, h1);
+		h4 = IRGCM_gfmulCLMUL(h3, h1);
+		for (; blockCount >= 4; blockCount -= 4, blocks += 64) {
+			__m128i lo, hi, tlo, thi;
+			__m128i b0 = _mm_shuffle_epi8(_mm_loadu_si128(
+					(const __m128i *)blocks), bswap);
+			__m128i b1 = _mm_shuffle_epi8(_mm_loadu_si128(
+					(const __m128i *)(blocks + 16)), bswap);
+			__m128i b2 = _mm_shuffle_epi8(_mm_loadu_si128(
+					(const __m128i *)(blocks + 32)), bswap);
+			__m128i b3 = _mm_shuffle_epi8(_mm_loadu_si128(
+					(const __m128i *)(blocks + 48)), bswap);
+			IRGCM_clmul(_mm_xor_si128(vx, b0), h4, lo, hi);
+			IRGCM_clmul(b1, h3, tlo, thi);
+			lo = _mm_xor_si128(lo, tlo);
+			hi = _mm_xor_si128(hi, thi);
+			IRGCM_clmul(b2, h2, tlo, thi);
+			lo = _mm_xor_si128(lo, tlo);
+			hi = _mm_xor_si128(hi, thi);
+			IRGCM_clmul(b3, h1, tlo, thi);
+			lo = _mm_xor_si128(lo, tlo);
+			hi = _mm_xor_si128(hi, thi);
+			vx = IRGCM_clmulReduce(lo, hi);
+		}
+	}
+	for (; blockCount; blockCount--, blocks += 16) {
+		__m128i b = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)blocks),
+				bswap);
+		vx = IRGCM_gfmulCLMUL(_mm_xor_si128(vx, b), h1);
+	}
+	_mm_storeu_si128((__m128i *)x, _mm_shuffle_epi8(vx, bswap));
+}
+
+//------------------------------------------------------------------------------
+static bool IRGCM_hasCLMUL() {
+
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3");
+}
+#endif //IRGCM_CLMUL_X86
+
 //==============================================================================
 // Class IRBlockCipherMode
 //------------------------------------------------------------------------------
@@ -55,6 +361,31 @@ bool IRBlockCipherMode::postBlock(const std::uint8_t * src, std::uint8_t * dst)
 	return true;
 }
 
+//------------------------------------------------------------------------------
+bool IRBlockCipherMode::processBlocks(const std::uint8_t * src,
+		std::uint8_t * dst, std::uint64_t blockCount) {
+	return this->cipherBlocks(src, dst, blockCount);
+}
+
+//------------------------------------------------------------------------------
+bool IRBlockCipherMode::cipherBlocks(const std::uint8_t * src,
+		std::uint8_t * dst, std::uint64_t blockCount) {
+	std::uint64_t blockSize;
+
+	blockSize = this->blockSizeInBytes();
+	while (blockCount) {
+		unsigned int count = (unsigned int)std::min<std::uint64_t>(blockCount,
+				std::numeric_limits<unsigned int>::max());
+		if (!this->_cipher->processBlocks(src, dst, count)) {
+			return false;
+		}
+		src += count * blockSize;
+		dst += count * blockSize;
+		blockCount -= count;
+	}
+	return true;
+}
+
 //------------------------------------------------------------------------------
 std::uint64_t IRBlockCipherMode::getOutputSize(std::uint64_t srcSize) const {
 
@@ -77,6 +408,8 @@ bool IRBlockCipherMode::process(const void * src, std::uint64_t srcSize,
 	const std::uint8_t * pSrc;
 	std::uint8_t * pDst;
 	std::uint64_t processedSize;
+	std::uint64_t blockSize;
+	std::uint64_t blockCount;
 
 	if (this->cipherMode()) {
 		if (dstSize < this->getOutputSize(srcSize)) {
@@ -88,30 +421,48 @@ bool IRBlockCipherMode::process(const void * src, std::uint64_t srcSize,
 		}
 	}
 
+	blockSize = this->blockSizeInBytes();
 	processedSize = 0;
 	pSrc = (const std::uint8_t *) src;
 	pDst = (std::uint8_t *) dst;
-	while (srcSize) {
-		std::uint64_t needed = std::min(srcSize,
-				this->_tmpBlock.remaining());
-		srcSize -= needed;
+
+	// Complete the pending block first
+	if (this->_tmpBlock.position() > 0) {
+		std::uint64_t needed = std::min(srcSize, this->_tmpBlock.remaining());
 		std::memcpy(this->_tmpBlock.posBuff(), pSrc, needed);
 		this->_tmpBlock.setPosition(this->_tmpBlock.position() + needed);
-		if (this->_tmpBlock.position() == this->blockSizeInBytes()) {
-			if (this->processBlock(this->_tmpBlock.buff(), pDst)) {
-				this->_tmpBlock.reset();
-				pDst += this->blockSizeInBytes();
-				pSrc += this->blockSizeInBytes();
-				processedSize += this->_tmpBlock.size();
-			} else {
+		pSrc += needed;
+		srcSize -= needed;
+		if (this->_tmpBlock.position() == blockSize) {
+			if (!this->processBlock(this->_tmpBlock.buff(), pDst)) {
 				return false;
 			}
+			this->_tmpBlock.reset();
+			pDst += blockSize;
+			processedSize += blockSize;
+		}
+	}
+
+	// All complete blocks go directly from src to dst
+	blockCount = srcSize / blockSize;
+	if (blockCount) {
+		if (!this->processBlocks(pSrc, pDst, blockCount)) {
+			return false;
 		}
+		pSrc += blockCount * blockSize;
+		pDst += blockCount * blockSize;
+		srcSize -= blockCount * blockSize;
+		processedSize += blockCount * blockSize;
+	}
+
+	// Keep the remaining bytes for the next call
+	if (srcSize) {
+		std::memcpy(this->_tmpBlock.buff(), pSrc, srcSize);
+		this->_tmpBlock.setPosition(srcSize);
 	}
 
 	if (last) {
 		if (this->cipherMode()) {
-			std::uint64_t blockSize = this->blockSizeInBytes();
 			if (!this->padding().addPadding(blockSize,
 					this->_tmpBlock.buff(), this->_tmpBlock.position(),
 					this->_tmpBlock.buff(), blockSize)) {
@@ -125,15 +476,19 @@ bool IRBlockCipherMode::process(const void * src, std::uint64_t srcSize,
 			if (this->_tmpBlock.position() == this->blockSizeInBytes()) {
 				return false;
 			}
+			// The padding must be in a block deciphered by this call
+			if (processedSize < blockSize) {
+				return false;
+			}
 
 			// Remove the padding
-			std::uint64_t blockSize = this->blockSizeInBytes();
+			std::uint64_t plainSize = blockSize;
 			pDst -= blockSize;
 			if (!this->padding().removePadding(blockSize, pDst,
-					blockSize)){
+					plainSize)){
 				return false;
 			}
-			processedSize -= (this->blockSizeInBytes() - blockSize);
+			processedSize -= (blockSize - plainSize);
 		}
 	}
 	dstSize = processedSize;
@@ -142,11 +497,28 @@ bool IRBlockCipherMode::process(const void * src, std::uint64_t srcSize,
 
 //==============================================================================
 // Class IRCBCBlockCipherMode
+//------------------------------------------------------------------------------
+/**
+ * Returns the size of the chunks used to decipher the data in place. It is
+ * the largest multiple of the block size that fits IRCBC_INPLACE_CHUNK_SIZE,
+ * with at least one block.
+ *
+ * @param[in] blockSize The block size in bytes.
+ * @return The size of the chunks in bytes.
+ */
+static std::uint64_t IRCBCBlockCipherMode_inPlaceChunkSize(
+		std::uint64_t blockSize) {
+	return std::max<std::uint64_t>(1, IRCBC_INPLACE_CHUNK_SIZE / blockSize) *
+			blockSize;
+}
+
 //------------------------------------------------------------------------------
 IRCBCBlockCipherMode::IRCBCBlockCipherMode(IRBlockCipherAlgorithm * cipher,
 		IRPadding * padding): IRBlockCipherMode(cipher, padding),
 				_iv(cipher->blockSizeInBytes()),
-				_lastBlock(cipher->blockSizeInBytes()){
+				_lastBlock(cipher->blockSizeInBytes()),
+				_cipherText(IRCBCBlockCipherMode_inPlaceChunkSize(
+						cipher->blockSizeInBytes())) {
 	this->_iv.clear();
 	this->_lastBlock.clear();
 }
@@ -156,10 +528,17 @@ void IRCBCBlockCipherMode::xorBlock(const std::uint8_t * src, std::uint8_t * dst
 	const std::uint8_t * srcEnd;
 
 	srcEnd = src + this->blockSizeInBytes();
+	for ( ; (srcEnd - src) >= 8; src += 8, dst += 8) {
+		std::uint64_t a;
+		std::uint64_t b;
+		std::memcpy(&a, src, sizeof(a));
+		std::memcpy(&b, dst, sizeof(b));
+		b = b ^ a;
+		std::memcpy(dst, &b, sizeof(b));
+	}
 	for ( ; src != srcEnd; src++, dst++) {
 		(*dst) = (*dst) ^ (*src);
 	}
-
 }
 
 
@@ -185,6 +564,71 @@ bool IRCBCBlockCipherMode::IRCBCBlockCipherMode::postBlock(
 	return true;
 }
 
+//------------------------------------------------------------------------------
+bool IRCBCBlockCipherMode::processBlocks(const std::uint8_t * src,
+		std::uint8_t * dst, std::uint64_t blockCount) {
+	std::uint64_t blockSize;
+
+	if (blockCount == 0) {
+		return true;
+	}
+	blockSize = this->blockSizeInBytes();
+	if (this->cipherMode()) {
+		// Each block depends on the previous ciphertext
+		const std::uint8_t * prev = this->_lastBlock.buff();
+		for (std::uint64_t i = 0; i < blockCount; i++) {
+			if (src != dst) {
+				std::memcpy(dst, src, blockSize);
+			}
+			this->xorBlock(prev, dst);
+			if (!this->cipherBlocks(dst, dst, 1)) {
+				return false;
+			}
+			prev = dst;
+			src += blockSize;
+			dst += blockSize;
+		}
+		std::memcpy(this->_lastBlock.buff(), prev, blockSize);
+		return true;
+	} else {
+		std::uint64_t size = blockCount * blockSize;
+		if ((src + size <= dst) || (dst + size <= src)) {
+			return this->decipherBlocks(src, dst, blockCount);
+		}
+		// The ciphertext is overwritten, thus it must be copied first
+		std::uint64_t chunkBlocks = this->_cipherText.size() / blockSize;
+		while (blockCount) {
+			std::uint64_t count = std::min(blockCount, chunkBlocks);
+			std::memcpy(this->_cipherText.buff(), src, count * blockSize);
+			if (!this->decipherBlocks(this->_cipherText.buff(), dst, count)) {
+				return false;
+			}
+			src += count * blockSize;
+			dst += count * blockSize;
+			blockCount -= count;
+		}
+		return true;
+	}
+}
+
+//------------------------------------------------------------------------------
+bool IRCBCBlockCipherMode::decipherBlocks(const std::uint8_t * src,
+		std::uint8_t * dst, std::uint64_t blockCount) {
+	std::uint64_t blockSize;
+
+	blockSize = this->blockSizeInBytes();
+	if (!this->cipherBlocks(src, dst, blockCount)) {
+		return false;
+	}
+	this->xorBlock(this->_lastBlock.buff(), dst);
+	for (std::uint64_t i = 1; i < blockCount; i++) {
+		this->xorBlock(src + ((i - 1) * blockSize), dst + (i * blockSize));
+	}
+	std::memcpy(this->_lastBlock.buff(), src + ((blockCount - 1) * blockSize),
+			blockSize);
+	return true;
+}
+
 //------------------------------------------------------------------------------
 bool IRCBCBlockCipherMode::setIV(const void * iv, std::uint64_t ivSize) {
 
@@ -204,3 +648,412 @@ void IRCBCBlockCipherMode::reset() {
 }
 
 //------------------------------------------------------------------------------
+//==============================================================================
+// Class IRCTRBlockCipherMode
+//------------------------------------------------------------------------------
+IRCTRBlockCipherMode::IRCTRBlockCipherMode(IRBlockCipherAlgorithm * cipher):
+		IRCTRBlockCipherMode(cipher, cipher->blockSizeInBytes()) {
+}
+
+//------------------------------------------------------------------------------
+IRCTRBlockCipherMode::IRCTRBlockCipherMode(IRBlockCipherAlgorithm * cipher,
+		unsigned int counterSize): IRBlockCipherMode(cipher, nullptr),
+				_iv(cipher->blockSizeInBytes()),
+				_counter(cipher->blockSizeInBytes()),
+				_counterBlocks(std::max<std::uint64_t>(
+						cipher->blockSizeInBytes(), IRCTR_KEYSTREAM_SIZE -
+						(IRCTR_KEYSTREAM_SIZE % cipher->blockSizeInBytes()))),
+				_keyStream(_counterBlocks.size()), _keyStreamSize(0),
+				_counterSize(counterSize) {
+
+	if (!cipher->cipherMode()) {
+		throw std::invalid_argument("The cipher must be in cipher mode.");
+	}
+	if ((counterSize == 0) || (counterSize > cipher->blockSizeInBytes())) {
+		throw std::invalid_argument("Invalid counter size.");
+	}
+	this->_iv.clear();
+	this->reset();
+}
+
+//------------------------------------------------------------------------------
+void IRCTRBlockCipherMode::addCounter(std::uint8_t * counter,
+		std::uint64_t value) const {
+	std::uint8_t * p;
+	std::uint8_t * pEnd;
+
+	p = counter + this->blockSizeInBytes();
+	pEnd = p - this->_counterSize;
+	while ((value) && (p != pEnd)) {
+		p--;
+		std::uint64_t sum = (*p) + (value & 0xFF);
+		(*p) = (std::uint8_t)sum;
+		value = (value >> 8) + (sum >> 8);
+	}
+}
+
+//------------------------------------------------------------------------------
+bool IRCTRBlockCipherMode::generateKeyStream(std::uint64_t blockCount) {
+	std::uint64_t blockSize;
+	std::uint8_t * counters;
+
+	blockSize = this->blockSizeInBytes();
+	counters = this->_counterBlocks.buff();
+	for (std::uint64_t i = 0; i < blockCount; i++) {
+		std::memcpy(counters, this->_counter.buff(), blockSize);
+		this->addCounter(this->_counter.buff(), 1);
+		counters += blockSize;
+	}
+	this->_keyStream.reset();
+	this->_keyStreamSize = 0;
+	if (!this->cipherBlocks(this->_counterBlocks.buff(),
+			this->_keyStream.buff(), blockCount)) {
+		return false;
+	}
+	this->_keyStreamSize = blockCount * blockSize;
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool IRCTRBlockCipherMode::xorKeyStream(const std::uint8_t * src,
+		std::uint8_t * dst, std::uint64_t size) {
+	std::uint64_t blockSize;
+	std::uint64_t maxBlocks;
+
+	blockSize = this->blockSizeInBytes();
+	maxBlocks = this->_keyStream.size() / blockSize;
+	while (size) {
+		if (this->_keyStream.position() == this->_keyStreamSize) {
+			if (!this->generateKeyStream(std::min(maxBlocks,
+					(size + blockSize - 1) / blockSize))) {
+				return false;
+			}
+		}
+		std::uint64_t n = std::min(size,
+				this->_keyStreamSize - this->_keyStream.position());
+		IRBlockCipherMode_xor(src, this->_keyStream.posBuff(), dst, n);
+		this->_keyStream.setPosition(this->_keyStream.position() + n);
+		src += n;
+		dst += n;
+		size -= n;
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool IRCTRBlockCipherMode::setIV(const void * iv, std::uint64_t ivSize) {
+
+	if (ivSize < this->blockSizeInBytes()) {
+		return false;
+	} else {
+		std::memcpy(this->_iv.buff(), iv, this->blockSizeInBytes());
+		this->reset();
+		return true;
+	}
+}
+
+//------------------------------------------------------------------------------
+bool IRCTRBlockCipherMode::seek(std::uint64_t offset) {
+	std::uint64_t blockSize;
+
+	blockSize = this->blockSizeInBytes();
+	std::memcpy(this->_counter.buff(), this->_iv.buff(), blockSize);
+	this->addCounter(this->_counter.buff(), offset / blockSize);
+	this->_keyStream.reset();
+	this->_keyStreamSize = 0;
+	if (offset % blockSize) {
+		if (!this->generateKeyStream(1)) {
+			return false;
+		}
+		this->_keyStream.setPosition(offset % blockSize);
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+void IRCTRBlockCipherMode::reset() {
+
+	IRBlockCipherMode::reset();
+	std::memcpy(this->_counter.buff(), this->_iv.buff(), this->_iv.size());
+	this->_keyStream.clear();
+	this->_keyStream.reset();
+	this->_keyStreamSize = 0;
+}
+
+//------------------------------------------------------------------------------
+std::uint64_t IRCTRBlockCipherMode::getOutputSize(std::uint64_t srcSize) const {
+	return srcSize;
+}
+
+//------------------------------------------------------------------------------
+bool IRCTRBlockCipherMode::process(const void * src, std::uint64_t srcSize,
+		void * dst, std::uint64_t & dstSize, bool last) {
+
+	if (dstSize < srcSize) {
+		return false;
+	}
+	if (!this->xorKeyStream((const std::uint8_t *)src, (std::uint8_t *)dst,
+			srcSize)) {
+		return false;
+	}
+	dstSize = srcSize;
+	return true;
+}
+
+//==============================================================================
+// Class IRGCMBlockCipherMode
+//------------------------------------------------------------------------------
+IRGCMBlockCipherMode::IRGCMBlockCipherMode(IRBlockCipherAlgorithm * cipher,
+		bool cipherMode): IRCTRBlockCipherMode(cipher, 4),
+				_cipherMode(cipherMode), _j0(16), _h(16), _hTable(32),
+				_ghash(16), _ghashBlock(16), _tag(16), _aadSize(0),
+				_dataSize(0), _finished(false), _seeked(false), _clmul(false) {
+	std::uint8_t zero[12];
+
+	if (this->blockSizeInBytes() != 16) {
+		throw std::invalid_argument("GCM requires a 128-bit block cipher.");
+	}
+	this->_h.clear();
+	if (!this->cipherBlocks(this->_h.buff(), this->_h.buff(), 1)) {
+		throw std::invalid_argument("Unable to compute the hash subkey.");
+	}
+	IRGCM_createTable(this->_h.buff(), this->_hTable.buff());
+#ifdef IRGCM_CLMUL_X86
+	static const bool clmul = IRGCM_hasCLMUL();
+	this->_clmul = clmul;
+#endif //IRGCM_CLMUL_X86
+	std::memset(zero, 0, sizeof(zero));
+	this->setIV(zero, sizeof(zero));
+}
+
+//------------------------------------------------------------------------------
+void IRGCMBlockCipherMode::ghashBlocks(const std::uint8_t * blocks,
+		std::uint64_t blockCount) {
+#ifdef IRGCM_CLMUL_X86
+	if (this->_clmul) {
+		IRGCM_ghashCLMUL(this->_h.buff(), this->_ghash.buff(), blocks,
+				blockCount);
+		return;
+	}
+#endif //IRGCM_CLMUL_X86
+	IRGCM_ghashTable(this->_hTable.buff(), this->_ghash.buff(), blocks,
+			blockCount);
+}
+
+//------------------------------------------------------------------------------
+void IRGCMBlockCipherMode::ghashUpdate(const std::uint8_t * data,
+		std::uint64_t size) {
+
+	// Complete the pending block first
+	if (this->_ghashBlock.position() > 0) {
+		std::uint64_t n = std::min(size, this->_ghashBlock.remaining());
+		std::memcpy(this->_ghashBlock.posBuff(), data, n);
+		this->_ghashBlock.setPosition(this->_ghashBlock.position() + n);
+		data += n;
+		size -= n;
+		if (this->_ghashBlock.remaining() > 0) {
+			return;
+		}
+		this->ghashBlocks(this->_ghashBlock.buff(), 1);
+		this->_ghashBlock.reset();
+	}
+	if (size >= 16) {
+		this->ghashBlocks(data, size / 16);
+		data += size - (size % 16);
+		size = size % 16;
+	}
+	if (size) {
+		std::memcpy(this->_ghashBlock.buff(), data, size);
+		this->_ghashBlock.setPosition(size);
+	}
+}
+
+//------------------------------------------------------------------------------
+void IRGCMBlockCipherMode::ghashFlush() {
+
+	if (this->_ghashBlock.position() > 0) {
+		std::memset(this->_ghashBlock.posBuff(), 0,
+				this->_ghashBlock.remaining());
+		this->ghashBlocks(this->_ghashBlock.buff(), 1);
+		this->_ghashBlock.reset();
+	}
+}
+
+//------------------------------------------------------------------------------
+void IRGCMBlockCipherMode::computeJ0(const void * iv, std::uint64_t ivSize) {
+	std::uint8_t lengths[16];
+
+	if (ivSize == 12) {
+		std::memcpy(this->_j0.buff(), iv, 12);
+		this->_j0[12] = 0;
+		this->_j0[13] = 0;
+		this->_j0[14] = 0;
+		this->_j0[15] = 1;
+	} else {
+		this->_ghash.clear();
+		this->_ghashBlock.reset();
+		this->ghashUpdate((const std::uint8_t *)iv, ivSize);
+		this->ghashFlush();
+		IRGCM_storeBE64(0, lengths);
+		IRGCM_storeBE64(ivSize * 8, lengths + 8);
+		this->ghashBlocks(lengths, 1);
+		std::memcpy(this->_j0.buff(), this->_ghash.buff(), 16);
+	}
+}
+
+//------------------------------------------------------------------------------
+bool IRGCMBlockCipherMode::computeTag() {
+	std::uint8_t lengths[16];
+
+	this->ghashFlush();
+	IRGCM_storeBE64(this->_aadSize * 8, lengths);
+	IRGCM_storeBE64(this->_dataSize * 8, lengths + 8);
+	this->ghashBlocks(lengths, 1);
+	if (!this->cipherBlocks(this->_j0.buff(), this->_tag.buff(), 1)) {
+		return false;
+	}
+	IRBlockCipherMode_xor(this->_tag.buff(), this->_ghash.buff(),
+			this->_tag.buff(), 16);
+	this->_finished = true;
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool IRGCMBlockCipherMode::setIV(const void * iv, std::uint64_t ivSize) {
+
+	if (ivSize == 0) {
+		return false;
+	}
+	this->computeJ0(iv, ivSize);
+	std::memcpy(this->_iv.buff(), this->_j0.buff(), 16);
+	this->addCounter(this->_iv.buff(), 1);
+	this->reset();
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool IRGCMBlockCipherMode::addAAD(const void * aad, std::uint64_t aadSize) {
+
+	if ((this->_finished) || (this->_dataSize > 0) || (this->_seeked)) {
+		return false;
+	}
+	this->ghashUpdate((const std::uint8_t *)aad, aadSize);
+	this->_aadSize += aadSize;
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool IRGCMBlockCipherMode::tag(void * tag, std::uint64_t tagSize) const {
+
+	if ((!this->_finished) || (this->_seeked)) {
+		return false;
+	}
+	if ((tagSize < 4) || (tagSize > 16)) {
+		return false;
+	}
+	std::memcpy(tag, this->_tag.buff(), tagSize);
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool IRGCMBlockCipherMode::verifyTag(const void * tag,
+		std::uint64_t tagSize) const {
+	const std::uint8_t * p;
+	std::uint8_t diff;
+
+	if ((!this->_finished) || (this->_seeked)) {
+		return false;
+	}
+	if ((tagSize < 4) || (tagSize > 16)) {
+		return false;
+	}
+	p = (const std::uint8_t *)tag;
+	diff = 0;
+	for (std::uint64_t i = 0; i < tagSize; i++) {
+		diff |= p[i] ^ this->_tag[i];
+	}
+	return (diff == 0);
+}
+
+//------------------------------------------------------------------------------
+bool IRGCMBlockCipherMode::seek(std::uint64_t offset) {
+
+	if (offset > IRGCM_MAX_DATA_SIZE) {
+		return false;
+	}
+	this->_seeked = true;
+	return IRCTRBlockCipherMode::seek(offset);
+}
+
+//------------------------------------------------------------------------------
+void IRGCMBlockCipherMode::reset() {
+
+	IRCTRBlockCipherMode::reset();
+	this->_ghash.clear();
+	this->_ghashBlock.clear();
+	this->_ghashBlock.reset();
+	this->_tag.clear();
+	this->_aadSize = 0;
+	this->_dataSize = 0;
+	this->_finished = false;
+	this->_seeked = false;
+}
+
+//------------------------------------------------------------------------------
+bool IRGCMBlockCipherMode::process(const void * src, std::uint64_t srcSize,
+		void * dst, std::uint64_t & dstSize, bool last) {
+	const std::uint8_t * pSrc;
+	std::uint8_t * pDst;
+	std::uint64_t size;
+
+	if (this->_finished) {
+		return false;
+	}
+	if (dstSize < srcSize) {
+		return false;
+	}
+	if (srcSize > IRGCM_MAX_DATA_SIZE - this->_dataSize) {
+		return false;
+	}
+
+	// The additional data is padded before the first data block
+	if ((this->_dataSize == 0) && (srcSize > 0)) {
+		this->ghashFlush();
+	}
+
+	// Process the data in chunks to authenticate the ciphertext while it is
+	// still in the cache
+	pSrc = (const std::uint8_t *)src;
+	pDst = (std::uint8_t *)dst;
+	size = srcSize;
+	while (size) {
+		std::uint64_t n = std::min<std::uint64_t>(size, IRGCM_CHUNK_SIZE);
+		if (this->cipherMode()) {
+			if (!this->xorKeyStream(pSrc, pDst, n)) {
+				return false;
+			}
+			if (!this->_seeked) {
+				this->ghashUpdate(pDst, n);
+			}
+		} else {
+			if (!this->_seeked) {
+				this->ghashUpdate(pSrc, n);
+			}
+			if (!this->xorKeyStream(pSrc, pDst, n)) {
+				return false;
+			}
+		}
+		pSrc += n;
+		pDst += n;
+		size -= n;
+	}
+	this->_dataSize += srcSize;
+	dstSize = srcSize;
+
+	if ((last) && (!this->_seeked)) {
+		return this->computeTag();
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
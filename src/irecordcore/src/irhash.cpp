@@ -26,6 +26,16 @@ std::uint64_t IRHashAlgorithm::sizeInBytes() const {
 	return this->size() / 8;
 }
 
+//------------------------------------------------------------------------------
+IRHashAlgorithm * IRHashAlgorithm::copyState() const {
+	return nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool IRHashAlgorithm::restoreState(const IRHashAlgorithm & src) {
+	return false;
+}
+
 //==============================================================================
 // Class IRHash
 //------------------------------------------------------------------------------
@@ -63,6 +73,31 @@ bool IRCopyHash::finalize(void * out, std::uint64_t size) {
 	return true;
 }
 
+//------------------------------------------------------------------------------
+IRHashAlgorithm * IRCopyHash::copyState() const {
+	IRCopyHash * copy;
+
+	copy = new IRCopyHash(this->_state.size());
+	copy->update(this->_state.roBuffer(), this->_state.size());
+	return copy;
+}
+
+//------------------------------------------------------------------------------
+bool IRCopyHash::restoreState(const IRHashAlgorithm & src) {
+	const IRCopyHash * s;
+
+	s = dynamic_cast<const IRCopyHash *>(&src);
+	if (!s) {
+		return false;
+	}
+	if (s == this) {
+		return true;
+	}
+	this->_state.setSize(0);
+	this->_state.write(s->_state.roBuffer(), s->_state.size());
+	return true;
+}
+
 //==============================================================================
 // Class IRHashFactory
 //------------------------------------------------------------------------------
@@ -60,6 +60,22 @@ IRHMAC::IRHMAC(IRHashAlgorithm * hash, std::uint64_t blockSize): IRMAC(),
 	this->setRawKey(nullptr, 0);
 }
 
+//------------------------------------------------------------------------------
+IRHMAC::IRHMAC(const IRHMAC & src, IRHashAlgorithm * hash): IRMAC(),
+		_hash(hash), _blockSize(src._blockSize),
+		_ipad(new std::uint8_t[src._blockSize]),
+		_opad(new std::uint8_t[src._blockSize]) {
+
+	std::memcpy(this->_ipad.get(), src._ipad.get(), this->_blockSize);
+	std::memcpy(this->_opad.get(), src._opad.get(), this->_blockSize);
+	if (src._innerState) {
+		this->_innerState.reset(src._innerState->copyState());
+	}
+	if (src._outerState) {
+		this->_outerState.reset(src._outerState->copyState());
+	}
+}
+
 //------------------------------------------------------------------------------
 IRHMAC::~IRHMAC() {
 
@@ -95,6 +111,14 @@ bool IRHMAC::setRawKey(const void * key, std::uint64_t keySize) {
 	std::memcpy(this->_ipad.get(), this->_opad.get(), this->_blockSize);
 	this->mask(this->_opad.get(), 0x5c);
 	this->mask(this->_ipad.get(), 0x36);
+
+	// Save the states after the pads, so they will not be hashed again
+	this->_hash->reset();
+	this->_hash->update(this->_opad.get(), this->_blockSize);
+	this->_outerState.reset(this->_hash->copyState());
+	this->_hash->reset();
+	this->_hash->update(this->_ipad.get(), this->_blockSize);
+	this->_innerState.reset(this->_hash->copyState());
 	this->reset();
 	return true;
 }
@@ -121,8 +145,15 @@ bool IRHMAC::setKey(IRSecretKey & key) {
 
 //------------------------------------------------------------------------------
 void IRHMAC::reset() {
-	this->_hash->reset();
-	this->_hash->update(this->_ipad.get(), this->_blockSize);
+
+	if (this->_innerState) {
+		if (!this->_hash->restoreState(*this->_innerState)) {
+			this->_hash.reset(this->_innerState->copyState());
+		}
+	} else {
+		this->_hash->reset();
+		this->_hash->update(this->_ipad.get(), this->_blockSize);
+	}
 }
 
 //------------------------------------------------------------------------------
@@ -149,10 +180,28 @@ bool IRHMAC::finalize(void * out, std::uint64_t size) {
 	if (!this->_hash->finalize(out, size)){
 		return false;
 	}
-	this->_hash->reset();
-	this->_hash->update(this->_opad.get(), this->_blockSize);
+	if (this->_outerState) {
+		if (!this->_hash->restoreState(*this->_outerState)) {
+			this->_hash.reset(this->_outerState->copyState());
+		}
+	} else {
+		this->_hash->reset();
+		this->_hash->update(this->_opad.get(), this->_blockSize);
+	}
 	this->_hash->update(out, this->sizeInBytes());
 	return this->_hash->finalize(out, size);
 }
 
 //------------------------------------------------------------------------------
+IRHashAlgorithm * IRHMAC::copyState() const {
+	IRHashAlgorithm * hash;
+
+	hash = this->_hash->copyState();
+	if (hash) {
+		return new IRHMAC(*this, hash);
+	} else {
+		return nullptr;
+	}
+}
+
+//------------------------------------------------------------------------------
@@ -16,6 +16,11 @@
 #include <irecordcore/irpbkdf2.h>
 #include <ircommon/irutils.h>
 #include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <system_error>
+#include <thread>
 
 using namespace ircommon;
 using namespace irecordcore;
@@ -23,11 +28,59 @@ using namespace irecordcore::crypto;
 
 // Reference https://tools.ietf.org/html/rfc2898
 
+//==============================================================================
+// Parallel execution
+//------------------------------------------------------------------------------
+/**
+ * Runs the worker once per PRF, each one in its own thread. The calling thread
+ * runs the first one. The workers are expected to pull their jobs from a
+ * shared counter, thus if the system is unable to create a new thread, the
+ * remaining jobs will be processed by the workers already running.
+ *
+ * <p>Exceptions thrown by the workers are caught and reported through the
+ * failed flag, which the workers should check before each job. All threads
+ * are joined before this function returns.</p>
+ *
+ * @param[in] prfs The PRF of each worker.
+ * @param[in] worker The worker.
+ * @param[in,out] failed The failure flag. It must be false on entry.
+ * @return true for success or false if any worker failed.
+ */
+static bool IRPBKDF2KeyGenerator_runWorkers(
+		std::vector<std::unique_ptr<IRMAC>> & prfs,
+		const std::function<void(IRMAC &)> & worker,
+		std::atomic<bool> & failed) {
+	std::vector<std::thread> threads;
+	std::function<void(IRMAC &)> guarded = [&worker, &failed](IRMAC & prf) {
+		try {
+			worker(prf);
+		} catch (...) {
+			failed = true;
+		}
+	};
+
+	try {
+		threads.reserve(prfs.size() - 1);
+		for (std::size_t i = 1; i < prfs.size(); i++) {
+			threads.emplace_back(guarded, std::ref(*prfs[i]));
+		}
+	} catch (std::system_error &) {
+		// Let the running threads do the job
+	} catch (std::bad_alloc &) {
+		// Let the running threads do the job
+	}
+	guarded(*prfs[0]);
+	for (std::thread & t: threads) {
+		t.join();
+	}
+	return !failed;
+}
+
 //==============================================================================
 // Class IRPBKDF2KeyGenerator
 //------------------------------------------------------------------------------
 IRPBKDF2KeyGenerator::IRPBKDF2KeyGenerator(IRMAC * prf, unsigned int rounds):
-		_prf(prf), _rounds(rounds), _salt() {
+		_prf(prf), _rounds(rounds), _salt(), _threads(1) {
 }
 
 //------------------------------------------------------------------------------
@@ -42,23 +95,24 @@ void IRPBKDF2KeyGenerator::setSalt(const void * salt, std::uint64_t saltSize) {
 }
 
 //------------------------------------------------------------------------------
-void IRPBKDF2KeyGenerator::generateBlock(std::uint32_t index,
+void IRPBKDF2KeyGenerator::generateBlock(IRHashAlgorithm & prf,
+		const void * salt, std::uint64_t saltSize, std::uint32_t index,
 		std::uint8_t * tmp, std::uint8_t * out) {
 
 	// U_1
-	this->_prf->reset();
-	this->_prf->update(this->_salt.roBuffer(), this->_salt.size());
+	prf.reset();
+	prf.update(salt, saltSize);
 	IRUtils::int2BE(index, tmp);
-	this->_prf->update(tmp, 4);
-	this->_prf->finalize(out, this->blockSize());
+	prf.update(tmp, 4);
+	prf.finalize(out, this->blockSize());
 
 	// U_2 to U_C
 	std::memcpy(tmp, out, this->blockSize());
 	for (unsigned int i = 1; i < this->rounds(); i++) {
 		// Compute U_i
-		this->_prf->reset();
-		this->_prf->update(tmp, this->blockSize());
-		this->_prf->finalize(tmp, this->blockSize());
+		prf.reset();
+		prf.update(tmp, this->blockSize());
+		prf.finalize(tmp, this->blockSize());
 		// Combine output with U_i
 		for (unsigned int j = 0; j < this->blockSize(); j++) {
 			out[j] = (out[j] ^ tmp[j]);
@@ -67,7 +121,8 @@ void IRPBKDF2KeyGenerator::generateBlock(std::uint32_t index,
 }
 
 //------------------------------------------------------------------------------
-bool IRPBKDF2KeyGenerator::generateRawCore(std::uint8_t * key,
+void IRPBKDF2KeyGenerator::generateKey(IRHashAlgorithm & prf,
+		const void * salt, std::uint64_t saltSize, std::uint8_t * key,
 		unsigned int keySize) {
 	IRUtils::IRSecureTemp tmp(std::max(this->blockSize(), (unsigned int)4));
 	IRUtils::IRSecureTemp out(this->blockSize());
@@ -76,7 +131,8 @@ bool IRPBKDF2KeyGenerator::generateRawCore(std::uint8_t * key,
 	blockNum = 1;
 	while (keySize > 0) {
 		// Compute the block
-		this->generateBlock(blockNum, tmp.buff(), out.buff());
+		this->generateBlock(prf, salt, saltSize, blockNum, tmp.buff(),
+				out.buff());
 		// Compose the key
 		std::uint32_t used = std::min(this->blockSize(), keySize);
 		std::memcpy(key, out.buff(), used);
@@ -85,6 +141,77 @@ bool IRPBKDF2KeyGenerator::generateRawCore(std::uint8_t * key,
 		key += used;
 		blockNum++;
 	}
+}
+
+//------------------------------------------------------------------------------
+unsigned int IRPBKDF2KeyGenerator::workerCount(std::uint64_t jobs) const {
+	unsigned int workers;
+
+	workers = this->threads();
+	if (workers == 0) {
+		workers = std::thread::hardware_concurrency();
+		if (workers == 0) {
+			workers = 1;
+		}
+	}
+	if (workers > jobs) {
+		workers = (unsigned int)std::max(jobs, (std::uint64_t)1);
+	}
+	return workers;
+}
+
+//------------------------------------------------------------------------------
+bool IRPBKDF2KeyGenerator::clonePRF(unsigned int workers,
+		std::vector<std::unique_ptr<IRMAC>> & prfs) const {
+
+	prfs.clear();
+	for (unsigned int i = 0; i < workers; i++) {
+		std::unique_ptr<IRHashAlgorithm> copy(this->_prf->copyState());
+		IRMAC * prf = dynamic_cast<IRMAC *>(copy.get());
+		if (!prf) {
+			prfs.clear();
+			return false;
+		}
+		copy.release();
+		prfs.emplace_back(prf);
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+bool IRPBKDF2KeyGenerator::generateRawCore(std::uint8_t * key,
+		unsigned int keySize) {
+	std::vector<std::unique_ptr<IRMAC>> prfs;
+	std::atomic<std::uint32_t> next(0);
+	std::atomic<bool> failed(false);
+	std::uint32_t blockCount;
+	unsigned int workers;
+
+	blockCount = (keySize + this->blockSize() - 1) / this->blockSize();
+	workers = this->workerCount(blockCount);
+	if ((workers == 1) || (!this->clonePRF(workers, prfs))) {
+		this->generateKey(*this->_prf, this->_salt.roBuffer(),
+				this->_salt.size(), key, keySize);
+		return true;
+	}
+
+	if (!IRPBKDF2KeyGenerator_runWorkers(prfs, [&](IRMAC & prf) {
+		IRUtils::IRSecureTemp tmp(std::max(this->blockSize(), (unsigned int)4));
+		IRUtils::IRSecureTemp out(this->blockSize());
+		std::uint32_t i;
+
+		while ((!failed) && ((i = next++) < blockCount)) {
+			this->generateBlock(prf, this->_salt.roBuffer(),
+					this->_salt.size(), i + 1, tmp.buff(), out.buff());
+			std::uint32_t offset = i * this->blockSize();
+			std::memcpy(key + offset, out.buff(),
+					std::min(this->blockSize(), keySize - offset));
+		}
+	}, failed)) {
+		// Do not leave a partial key behind
+		IRUtils::clearMemory(key, keySize);
+		return false;
+	}
 	return true;
 }
 
@@ -107,3 +234,47 @@ bool IRPBKDF2KeyGenerator::generateRaw(void * key, unsigned int keySize) {
 }
 
 //------------------------------------------------------------------------------
+bool IRPBKDF2KeyGenerator::generateRawBatch(const BatchEntry * entries,
+		std::uint64_t count) {
+	std::vector<std::unique_ptr<IRMAC>> prfs;
+	std::atomic<std::uint64_t> next(0);
+	std::atomic<bool> failed(false);
+
+	if (this->rounds() == 0) {
+		return false;
+	}
+	if (this->keySize() == 0) {
+		return false;
+	}
+	for (std::uint64_t i = 0; i < count; i++) {
+		if (entries[i].saltSize == 0) {
+			return false;
+		}
+	}
+	if (count == 0) {
+		return true;
+	}
+	if (!this->clonePRF(this->workerCount(count), prfs)) {
+		return false;
+	}
+
+	if (!IRPBKDF2KeyGenerator_runWorkers(prfs, [&](IRMAC & prf) {
+		std::uint64_t i;
+
+		while ((!failed) && ((i = next++) < count)) {
+			const BatchEntry & entry = entries[i];
+			prf.setRawKey(entry.password, entry.passwordSize);
+			this->generateKey(prf, entry.salt, entry.saltSize,
+					(std::uint8_t *)entry.key, this->keySizeInBytes());
+		}
+	}, failed)) {
+		// Do not leave partial keys behind
+		for (std::uint64_t i = 0; i < count; i++) {
+			IRUtils::clearMemory(entries[i].key, this->keySizeInBytes());
+		}
+		return false;
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
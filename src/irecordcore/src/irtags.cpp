@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 #include <irecordcore/irtags.h>
+#include <ircommon/iltagstream.h>
+#include <ircommon/irutils.h>
 
 using namespace irecordcore;
 using namespace irecordcore::tags;
@@ -24,7 +26,7 @@ using namespace ircommon::iltags;
 // Class IRBaseType16RawTag
 //------------------------------------------------------------------------------
 IRBaseType16RawTag::IRBaseType16RawTag(std::uint64_t id, bool secure):
-		ircommon::iltags::ILTag(id), _value(0, secure) {
+		ircommon::iltags::ILTag(id), _value(IRBuffer::NO_STORAGE, secure) {
 }
 
 //------------------------------------------------------------------------------
@@ -36,6 +38,20 @@ bool IRBaseType16RawTag::serializeValue(ircommon::IRBuffer & out) const {
 	return out.write(this->_value.roBuffer(), this->_value.size());
 }
 
+//------------------------------------------------------------------------------
+bool IRBaseType16RawTag::writeValue(ILTagStreamWriter & out) const {
+	std::uint8_t type[sizeof(std::uint16_t)];
+
+	IRUtils::int2BE(this->value().type(), type);
+	if (!out.writeBody(type, sizeof(type))) {
+		return false;
+	}
+	if (this->_value.size() == 0) {
+		return true;
+	}
+	return out.writeBody(this->_value.roBuffer(), this->_value.size());
+}
+
 //------------------------------------------------------------------------------
 std::uint64_t IRBaseType16RawTag::size() const {
 
@@ -53,9 +69,22 @@ bool IRBaseType16RawTag::deserializeValue(
 		return false;
 	}
 	this->_value.setType(type);
+	if (factory.viewMode()) {
+		return this->_value.wrap(inp.roPosBuffer(), inp.available());
+	}
 	return this->_value.set(inp.roPosBuffer(), inp.available());
 }
 
+//------------------------------------------------------------------------------
+bool IRBaseType16RawTag::equalsValue(const ILTag & other) const {
+
+	if (!ILTagUtil::sameClass(*this, other)) {
+		return ILTag::equalsValue(other);
+	}
+	return this->_value.equals(
+			static_cast<const IRBaseType16RawTag &>(other)._value);
+}
+
 //==============================================================================
 // Class IRBlockSigTag
 //------------------------------------------------------------------------------
@@ -67,6 +96,15 @@ bool IRBlockSigTag::serializeValue(ircommon::IRBuffer & out) const {
 	return this->_signature.serialize(out);
 }
 
+//------------------------------------------------------------------------------
+bool IRBlockSigTag::writeValue(ILTagStreamWriter & out) const {
+
+	if (!out.write(this->_parentHashType)) {
+		return false;
+	}
+	return out.write(this->_signature);
+}
+
 //------------------------------------------------------------------------------
 std::uint64_t IRBlockSigTag::size() const {
 
@@ -88,6 +126,19 @@ bool IRBlockSigTag::deserializeValue(
 	return (inp.available() == 0);
 }
 
+//------------------------------------------------------------------------------
+bool IRBlockSigTag::equalsValue(const ILTag & other) const {
+
+	if (!ILTagUtil::sameClass(*this, other)) {
+		return ILTag::equalsValue(other);
+	}
+	const IRBlockSigTag & o = static_cast<const IRBlockSigTag &>(other);
+	if (!ILTagUtil::equals(this->_parentHashType, o._parentHashType)) {
+		return false;
+	}
+	return ILTagUtil::equals(this->_signature, o._signature);
+}
+
 
 //==============================================================================
 // Class IRBlockTag
@@ -104,6 +155,15 @@ bool IRBlockTag::serializeValue(ircommon::IRBuffer & out) const {
 	}
 	return this->_signature.serialize(out);
 }
+
+//------------------------------------------------------------------------------
+bool IRBlockTag::writeValue(ILTagStreamWriter & out) const {
+
+	if (!out.write(this->_signed)) {
+		return false;
+	}
+	return out.write(this->_signature);
+}
 //------------------------------------------------------------------------------
 
 std::uint64_t IRBlockTag::size() const {
@@ -126,6 +186,19 @@ bool IRBlockTag::deserializeValue(
 	return (inp.available() == 0);
 }
 
+//------------------------------------------------------------------------------
+bool IRBlockTag::equalsValue(const ILTag & other) const {
+
+	if (!ILTagUtil::sameClass(*this, other)) {
+		return ILTag::equalsValue(other);
+	}
+	const IRBlockTag & o = static_cast<const IRBlockTag &>(other);
+	if (!ILTagUtil::equals(this->_signed, o._signed)) {
+		return false;
+	}
+	return ILTagUtil::equals(this->_signature, o._signature);
+}
+
 //==============================================================================
 // Class IRSignedTag
 //------------------------------------------------------------------------------
@@ -145,6 +218,18 @@ bool IRSignedTag::serializeValue(ircommon::IRBuffer & out) const {
 	return this->_nextPub.serialize(out);
 }
 
+//------------------------------------------------------------------------------
+bool IRSignedTag::writeValue(ILTagStreamWriter & out) const {
+
+	if (!out.write(this->_header)) {
+		return false;
+	}
+	if (!out.write(this->_payload)) {
+		return false;
+	}
+	return out.write(this->_nextPub);
+}
+
 //------------------------------------------------------------------------------
 std::uint64_t IRSignedTag::size() const {
 
@@ -169,6 +254,22 @@ bool IRSignedTag::deserializeValue(
 	return (inp.available() == 0);
 }
 
+//------------------------------------------------------------------------------
+bool IRSignedTag::equalsValue(const ILTag & other) const {
+
+	if (!ILTagUtil::sameClass(*this, other)) {
+		return ILTag::equalsValue(other);
+	}
+	const IRSignedTag & o = static_cast<const IRSignedTag &>(other);
+	if (!ILTagUtil::equals(this->_header, o._header)) {
+		return false;
+	}
+	if (!ILTagUtil::equals(this->_payload, o._payload)) {
+		return false;
+	}
+	return ILTagUtil::equals(this->_nextPub, o._nextPub);
+}
+
 //==============================================================================
 // Class IRHeaderTag
 //------------------------------------------------------------------------------
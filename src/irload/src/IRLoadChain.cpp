@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "IRLoadChain.h"
+#include <irecord/irconst.h>
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Value of pi. M_PI is not standard C++.
+ */
+static const double IRLoadPayloadGenerator_PI = 3.14159265358979323846;
+
+//==============================================================================
+// Struct IRLoadOptions
+//------------------------------------------------------------------------------
+IRLoadOptions::IRLoadOptions(): driver("core"), blocks(10000), threads(1),
+		dist(IRLOAD_DIST_FIXED), min(1024), max(1024), mean(1024), sigma(1.0),
+		applications({1}), hash(IRH_SHA_256), sign(IRS_RSA_PSS), seed(1) {
+}
+
+//==============================================================================
+// Class IRLoadPayloadGenerator
+//------------------------------------------------------------------------------
+IRLoadPayloadGenerator::IRLoadPayloadGenerator(const IRLoadOptions & options,
+		std::uint64_t seed): _options(options), _random(seed),
+		_payload(std::max(options.min, options.max)), _serial(0), _size(0),
+		_applicationID(0) {
+}
+
+//------------------------------------------------------------------------------
+int IRLoadPayloadGenerator::nextSize() {
+	const IRLoadOptions & o = this->_options;
+	double u1;
+	double u2;
+	double v;
+
+	switch (o.dist) {
+	case IRLOAD_DIST_UNIFORM:
+		return o.min + (this->_random.next32() % (o.max - o.min + 1));
+	case IRLOAD_DIST_LOGNORMAL:
+		// Box-Muller transform
+		do {
+			u1 = this->_random.nextDouble();
+		} while (u1 <= 0.0);
+		u2 = this->_random.nextDouble();
+		v = std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * IRLoadPayloadGenerator_PI * u2);
+		v = o.mean * std::exp(o.sigma * v);
+		if (v < o.min) {
+			return o.min;
+		} else if (v > o.max) {
+			return o.max;
+		} else {
+			return static_cast<int>(v);
+		}
+	default:
+		return o.min;
+	}
+}
+
+//------------------------------------------------------------------------------
+void IRLoadPayloadGenerator::next() {
+
+	this->_size = this->nextSize();
+	this->_random.nextBytes(this->_payload.data(), this->_size);
+	this->_applicationID = this->_options.applications[
+			this->_serial % this->_options.applications.size()];
+	this->_serial++;
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _IRLOAD_IRLOADCHAIN_H_
+#define _IRLOAD_IRLOADCHAIN_H_
+
+#include <ircommon/irrandom.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Payload size distributions supported by the chain generator.
+ *
+ * @since 2018.04.26
+ */
+typedef enum IRLoadPayloadDist {
+	/**
+	 * All payloads have the size min.
+	 */
+	IRLOAD_DIST_FIXED = 0,
+	/**
+	 * Sizes are uniformly distributed between min and max.
+	 */
+	IRLOAD_DIST_UNIFORM = 1,
+	/**
+	 * Sizes follow a log-normal distribution with median mean and shape sigma,
+	 * clamped to the interval [min, max].
+	 */
+	IRLOAD_DIST_LOGNORMAL = 2
+} IRLoadPayloadDist;
+
+/**
+ * Parameters of a load run.
+ *
+ * @since 2018.04.26
+ */
+struct IRLoadOptions {
+	/**
+	 * Name of the driver.
+	 */
+	std::string driver;
+	/**
+	 * Total number of data blocks, split among all threads.
+	 */
+	std::uint64_t blocks;
+	/**
+	 * Number of worker threads. Each thread owns its own chain.
+	 */
+	int threads;
+	/**
+	 * Payload size distribution.
+	 */
+	IRLoadPayloadDist dist;
+	/**
+	 * Minimum payload size.
+	 */
+	int min;
+	/**
+	 * Maximum payload size.
+	 */
+	int max;
+	/**
+	 * Median of the log-normal distribution.
+	 */
+	int mean;
+	/**
+	 * Shape of the log-normal distribution.
+	 */
+	double sigma;
+	/**
+	 * Application IDs, used in round robin.
+	 */
+	std::vector<std::uint64_t> applications;
+	/**
+	 * Hash algorithm, one of the IRH_* constants.
+	 */
+	int hash;
+	/**
+	 * Signature algorithm, one of the IRS_* constants.
+	 */
+	int sign;
+	/**
+	 * Seed of the payload generator.
+	 */
+	std::uint64_t seed;
+
+	/**
+	 * Creates a new instance with the default parameters.
+	 */
+	IRLoadOptions();
+};
+
+/**
+ * This class generates the payloads of a synthetic chain. Given the same
+ * options and seed, the sequence of payloads is always the same.
+ *
+ * @since 2018.04.26
+ */
+class IRLoadPayloadGenerator {
+private:
+	const IRLoadOptions & _options;
+	ircommon::IRXORShifRandom _random;
+	std::vector<std::uint8_t> _payload;
+	std::uint64_t _serial;
+	int _size;
+	std::uint64_t _applicationID;
+
+	int nextSize();
+public:
+	/**
+	 * Creates a new instance of this class.
+	 *
+	 * @param[in] options The options. Must outlive this instance.
+	 * @param[in] seed The seed of this generator.
+	 */
+	IRLoadPayloadGenerator(const IRLoadOptions & options, std::uint64_t seed);
+
+	/**
+	 * Disposes this instance and releases all associated resources.
+	 */
+	virtual ~IRLoadPayloadGenerator() = default;
+
+	/**
+	 * Generates the next payload.
+	 */
+	void next();
+
+	/**
+	 * Returns the current payload.
+	 *
+	 * @return The current payload.
+	 */
+	const std::uint8_t * payload() const {
+		return this->_payload.data();
+	}
+
+	/**
+	 * Returns the size of the current payload.
+	 *
+	 * @return The size of the current payload.
+	 */
+	int size() const {
+		return this->_size;
+	}
+
+	/**
+	 * Returns the application ID of the current payload.
+	 *
+	 * @return The application ID.
+	 */
+	std::uint64_t applicationID() const {
+		return this->_applicationID;
+	}
+};
+
+#endif /* _IRLOAD_IRLOADCHAIN_H_ */
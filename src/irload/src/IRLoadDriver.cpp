@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "IRLoadDriver.h"
+#include <ircommon/iltagstd.h>
+#include <irecord/irerr.h>
+#include <cstring>
+
+using namespace ircommon;
+using namespace ircommon::iltags;
+using namespace irecordcore;
+using namespace irecordcore::crypto;
+using namespace irecordcore::tags;
+
+//==============================================================================
+// Class IRLoadAPIDriver
+//------------------------------------------------------------------------------
+IRLoadAPIDriver::IRLoadAPIDriver(): _context(0), _hTemplate(0), _hState(0) {
+}
+
+//------------------------------------------------------------------------------
+IRLoadAPIDriver::~IRLoadAPIDriver() {
+	this->close();
+}
+
+//------------------------------------------------------------------------------
+int IRLoadAPIDriver::open(const IRLoadOptions & options) {
+	int retval;
+
+	retval = IRContextCreate(nullptr, &this->_context);
+	if (retval != IRE_SUCCESS) {
+		this->_context = 0;
+		return retval;
+	}
+	retval = IRRootTemplateCreate(this->_context, &this->_hTemplate);
+	if (retval != IRE_SUCCESS) {
+		return retval;
+	}
+	retval = IRInstanceStateCreate(this->_context, &this->_hState);
+	if (retval != IRE_SUCCESS) {
+		return retval;
+	}
+	retval = IRInstanceStateSetParam(this->_context, this->_hState,
+			PARAM_HASH, options.hash);
+	if (retval != IRE_SUCCESS) {
+		return retval;
+	}
+	return IRInstanceStateSetParam(this->_context, this->_hState,
+			PARAM_SIGN, options.sign);
+}
+
+//------------------------------------------------------------------------------
+void IRLoadAPIDriver::close() {
+
+	if (this->_context) {
+		if (this->_hState) {
+			IRInstanceStateDispose(this->_context, this->_hState);
+			this->_hState = 0;
+		}
+		if (this->_hTemplate) {
+			IRRootTemplateDispose(this->_context, this->_hTemplate);
+			this->_hTemplate = 0;
+		}
+		IRContextDispose(this->_context);
+		this->_context = 0;
+	}
+}
+
+//------------------------------------------------------------------------------
+int IRLoadAPIDriver::rootBlockCreate(int * hBlock) {
+	return IRRootBlockCreate(this->_context, this->_hTemplate, this->_hState,
+			hBlock);
+}
+
+//------------------------------------------------------------------------------
+int IRLoadAPIDriver::dataBlockAdd(int hParentBlock,
+		std::uint64_t applicationId, int payloadSize, const void * payload,
+		int * hBlock) {
+	return IRDataBlockAdd(this->_context, this->_hState, 0, hParentBlock,
+			applicationId, payloadSize, payload, hBlock);
+}
+
+//------------------------------------------------------------------------------
+int IRLoadAPIDriver::checkParent(int hBlock, int hParentBlock) {
+	return IRCheckParent(this->_context, hBlock, hParentBlock);
+}
+
+//------------------------------------------------------------------------------
+int IRLoadAPIDriver::blockSerialize(int hBlock, int * buffSize, void * buff) {
+	return IRBlockSerialize(this->_context, hBlock, buffSize, buff);
+}
+
+//------------------------------------------------------------------------------
+int IRLoadAPIDriver::blockDispose(int hBlock) {
+	return IRBlockDispose(this->_context, hBlock);
+}
+
+//==============================================================================
+// Class IRLoadCoreDriver
+//------------------------------------------------------------------------------
+IRLoadCoreDriver::IRLoadCoreDriver(): _options(nullptr), _nextHandle(1),
+		_serial(0) {
+}
+
+//------------------------------------------------------------------------------
+IRBlockTag * IRLoadCoreDriver::find(int hBlock) {
+	auto i = this->_blocks.find(hBlock);
+
+	if (i == this->_blocks.end()) {
+		return nullptr;
+	} else {
+		return i->second.get();
+	}
+}
+
+//------------------------------------------------------------------------------
+bool IRLoadCoreDriver::hashBlock(const IRBlockTag & block) {
+	IRHashOutput out(*this->_hash);
+
+	this->_parentHash.resize(this->_hash->sizeInBytes());
+	this->_hash->reset();
+	if (!block.serialize(out)) {
+		return false;
+	}
+	return this->_hash->finalize(this->_parentHash.data(),
+			this->_parentHash.size());
+}
+
+//------------------------------------------------------------------------------
+bool IRLoadCoreDriver::sign(const IRBlockTag & block) {
+	IRHashOutput out(*this->_mac);
+
+	this->_sig.resize(this->_mac->sizeInBytes());
+	this->_mac->reset();
+	if (!block.signedTag().serialize(out)) {
+		return false;
+	}
+	this->_mac->update(this->_parentHash.data(), this->_parentHash.size());
+	return this->_mac->finalize(this->_sig.data(), this->_sig.size());
+}
+
+//------------------------------------------------------------------------------
+int IRLoadCoreDriver::add(IRBlockTag * parent, std::uint64_t applicationId,
+		int payloadSize, const void * payload, int * hBlock) {
+	std::unique_ptr<IRBlockTag> block(new IRBlockTag());
+	std::uint8_t pub[32];
+	ILUInt64Tag * serial;
+	ILUInt64Tag * application;
+
+	if (parent) {
+		if (!this->hashBlock(*parent)) {
+			return IRE_BLOCK_CORRUPTED;
+		}
+	} else {
+		this->_parentHash.clear();
+	}
+
+	serial = new ILUInt64Tag();
+	serial->setValue(this->_serial++);
+	block->signedTag().header().add(serial);
+	application = new ILUInt64Tag();
+	application->setValue(applicationId);
+	block->signedTag().header().add(application);
+	if (!block->signedTag().payload().value().set(payload, payloadSize)) {
+		return IRE_UNKNOWN_ERROR;
+	}
+	this->_random.nextBytes(pub, sizeof(pub));
+	block->signedTag().nextPub().value().setType(this->_options->sign);
+	block->signedTag().nextPub().value().set(pub, sizeof(pub));
+
+	block->signature().parentHashType().setValue(this->_options->hash);
+	if (!this->sign(*block)) {
+		return IRE_UNKNOWN_ERROR;
+	}
+	block->signature().signature().value().setType(this->_options->sign);
+	block->signature().signature().value().set(
+			this->_sig.data(), this->_sig.size());
+
+	*hBlock = this->_nextHandle++;
+	this->_blocks[*hBlock] = std::move(block);
+	return IRE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------
+int IRLoadCoreDriver::open(const IRLoadOptions & options) {
+	IRHashFactory factory;
+	IRHash * hash;
+	std::uint8_t key[32];
+
+	this->close();
+	this->_options = &options;
+	this->_random.setSeed(options.seed);
+	this->_hash.reset(factory.create(options.hash));
+	hash = factory.create(options.hash);
+	if ((!this->_hash) || (!hash)) {
+		return IRE_UNSUPPORTED_ALG;
+	}
+	this->_mac.reset(new IRHMAC(hash));
+	this->_random.nextBytes(key, sizeof(key));
+	if (!this->_mac->setRawKey(key, sizeof(key))) {
+		return IRE_UNKNOWN_ERROR;
+	}
+	return IRE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------
+void IRLoadCoreDriver::close() {
+
+	this->_blocks.clear();
+	this->_mac.reset();
+	this->_hash.reset();
+	this->_nextHandle = 1;
+	this->_serial = 0;
+}
+
+//------------------------------------------------------------------------------
+int IRLoadCoreDriver::rootBlockCreate(int * hBlock) {
+	static const char ROOT_PAYLOAD[] = "irload";
+
+	return this->add(nullptr, 0, sizeof(ROOT_PAYLOAD), ROOT_PAYLOAD, hBlock);
+}
+
+//------------------------------------------------------------------------------
+int IRLoadCoreDriver::dataBlockAdd(int hParentBlock,
+		std::uint64_t applicationId, int payloadSize, const void * payload,
+		int * hBlock) {
+	IRBlockTag * parent;
+
+	parent = this->find(hParentBlock);
+	if (!parent) {
+		return IRE_INVALID_HANDLE;
+	}
+	return this->add(parent, applicationId, payloadSize, payload, hBlock);
+}
+
+//------------------------------------------------------------------------------
+int IRLoadCoreDriver::checkParent(int hBlock, int hParentBlock) {
+	IRBlockTag * block;
+	IRBlockTag * parent;
+	const IRTypedRaw * sig;
+
+	block = this->find(hBlock);
+	parent = this->find(hParentBlock);
+	if ((!block) || (!parent)) {
+		return IRE_INVALID_HANDLE;
+	}
+	if (block->signature().parentHashType().value() != this->_options->hash) {
+		return IRE_BLOCK_NOT_PARENT;
+	}
+	if ((!this->hashBlock(*parent)) || (!this->sign(*block))) {
+		return IRE_BLOCK_CORRUPTED;
+	}
+	sig = &block->signature().signature().value();
+	if ((sig->size() != this->_sig.size()) ||
+			(std::memcmp(sig->roBuffer(), this->_sig.data(),
+					this->_sig.size()) != 0)) {
+		return IRE_BLOCK_NOT_PARENT;
+	}
+	return IRE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------
+int IRLoadCoreDriver::blockSerialize(int hBlock, int * buffSize, void * buff) {
+	IRBlockTag * block;
+
+	block = this->find(hBlock);
+	if (!block) {
+		return IRE_INVALID_HANDLE;
+	}
+	this->_tmp.setSize(0);
+	if (!block->serializeTo(this->_tmp)) {
+		return IRE_BLOCK_CORRUPTED;
+	}
+	if ((!buff) || (*buffSize < static_cast<int>(this->_tmp.size()))) {
+		*buffSize = this->_tmp.size();
+		return IRE_BUFFER_TOO_SHORT;
+	}
+	*buffSize = this->_tmp.size();
+	std::memcpy(buff, this->_tmp.roBuffer(), this->_tmp.size());
+	return IRE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------
+int IRLoadCoreDriver::blockDispose(int hBlock) {
+
+	if (this->_blocks.erase(hBlock) == 0) {
+		return IRE_INVALID_HANDLE;
+	}
+	return IRE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------
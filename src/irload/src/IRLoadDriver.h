@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _IRLOAD_IRLOADDRIVER_H_
+#define _IRLOAD_IRLOADDRIVER_H_
+
+#include "IRLoadChain.h"
+#include <ircommon/irbuffer.h>
+#include <irecordcore/irhash.h>
+#include <irecordcore/irhashout.h>
+#include <irecordcore/irmac.h>
+#include <irecordcore/irtags.h>
+#include <irecord/irecord.h>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * This is the interface of the block operations exercised by irload. All
+ * methods mirror the functions of the public API with the same names and
+ * return the same IRE_* error codes.
+ *
+ * <p>Each worker thread owns its own driver instance.</p>
+ *
+ * @since 2018.04.26
+ */
+class IRLoadDriver {
+public:
+	/**
+	 * Disposes this instance and releases all associated resources.
+	 */
+	virtual ~IRLoadDriver() = default;
+
+	/**
+	 * Prepares this driver to create a new chain.
+	 *
+	 * @param[in] options The options.
+	 * @return IRE_SUCCESS on success or other error code in case of failure.
+	 */
+	virtual int open(const IRLoadOptions & options) = 0;
+
+	/**
+	 * Releases all resources allocated by open().
+	 */
+	virtual void close() = 0;
+
+	/**
+	 * @see IRRootBlockCreate()
+	 */
+	virtual int rootBlockCreate(int * hBlock) = 0;
+
+	/**
+	 * @see IRDataBlockAdd()
+	 */
+	virtual int dataBlockAdd(int hParentBlock, std::uint64_t applicationId,
+			int payloadSize, const void * payload, int * hBlock) = 0;
+
+	/**
+	 * @see IRCheckParent()
+	 */
+	virtual int checkParent(int hBlock, int hParentBlock) = 0;
+
+	/**
+	 * @see IRBlockSerialize()
+	 */
+	virtual int blockSerialize(int hBlock, int * buffSize, void * buff) = 0;
+
+	/**
+	 * @see IRBlockDispose()
+	 */
+	virtual int blockDispose(int hBlock) = 0;
+};
+
+/**
+ * This driver calls the public C API of irecord.
+ *
+ * <p>IRInitialize() must be called before the first call to open().</p>
+ *
+ * @since 2018.04.26
+ */
+class IRLoadAPIDriver: public IRLoadDriver {
+private:
+	IRContext _context;
+	int _hTemplate;
+	int _hState;
+public:
+	/**
+	 * Instance state parameter that holds the hash algorithm. The public API
+	 * does not define the parameter IDs yet.
+	 */
+	static const int PARAM_HASH = 0;
+
+	/**
+	 * Instance state parameter that holds the signature algorithm. The public
+	 * API does not define the parameter IDs yet.
+	 */
+	static const int PARAM_SIGN = 1;
+
+	IRLoadAPIDriver();
+
+	virtual ~IRLoadAPIDriver();
+
+	virtual int open(const IRLoadOptions & options);
+
+	virtual void close();
+
+	virtual int rootBlockCreate(int * hBlock);
+
+	virtual int dataBlockAdd(int hParentBlock, std::uint64_t applicationId,
+			int payloadSize, const void * payload, int * hBlock);
+
+	virtual int checkParent(int hBlock, int hParentBlock);
+
+	virtual int blockSerialize(int hBlock, int * buffSize, void * buff);
+
+	virtual int blockDispose(int hBlock);
+};
+
+/**
+ * This driver emulates the public API using the primitives of irecordcore. It
+ * builds the blocks as IRBlockTag instances, links each block to its parent
+ * by the hash of the serialized parent and verifies this link in
+ * checkParent().
+ *
+ * <p>Since irecordcore has no signature algorithms yet, the signature of each
+ * block is replaced by an HMAC over the serialized signed tag and the hash of
+ * the parent block, computed with a random key and the same hash algorithm of
+ * the chain.</p>
+ *
+ * @since 2018.04.26
+ */
+class IRLoadCoreDriver: public IRLoadDriver {
+private:
+	const IRLoadOptions * _options;
+	std::unordered_map<int, std::unique_ptr<irecordcore::tags::IRBlockTag>>
+			_blocks;
+	int _nextHandle;
+	std::uint64_t _serial;
+	std::unique_ptr<irecordcore::crypto::IRHash> _hash;
+	std::unique_ptr<irecordcore::crypto::IRHMAC> _mac;
+	ircommon::IRXORShifRandom _random;
+	ircommon::IRBuffer _tmp;
+	std::vector<std::uint8_t> _parentHash;
+	std::vector<std::uint8_t> _sig;
+
+	irecordcore::tags::IRBlockTag * find(int hBlock);
+
+	int add(irecordcore::tags::IRBlockTag * parent,
+			std::uint64_t applicationId, int payloadSize,
+			const void * payload, int * hBlock);
+
+	bool hashBlock(const irecordcore::tags::IRBlockTag & block);
+
+	bool sign(const irecordcore::tags::IRBlockTag & block);
+public:
+	IRLoadCoreDriver();
+
+	virtual ~IRLoadCoreDriver() = default;
+
+	virtual int open(const IRLoadOptions & options);
+
+	virtual void close();
+
+	virtual int rootBlockCreate(int * hBlock);
+
+	virtual int dataBlockAdd(int hParentBlock, std::uint64_t applicationId,
+			int payloadSize, const void * payload, int * hBlock);
+
+	virtual int checkParent(int hBlock, int hParentBlock);
+
+	virtual int blockSerialize(int hBlock, int * buffSize, void * buff);
+
+	virtual int blockDispose(int hBlock);
+};
+
+#endif /* _IRLOAD_IRLOADDRIVER_H_ */
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "IRLoadStats.h"
+#include <algorithm>
+#include <cmath>
+
+//==============================================================================
+// Class IRLoadLatency
+//------------------------------------------------------------------------------
+IRLoadLatency::IRLoadLatency(): _total(0), _sorted(true) {
+}
+
+//------------------------------------------------------------------------------
+void IRLoadLatency::reserve(std::uint64_t count) {
+	this->_samples.reserve(count);
+}
+
+//------------------------------------------------------------------------------
+void IRLoadLatency::merge(const IRLoadLatency & src) {
+	this->_samples.insert(this->_samples.end(),
+			src._samples.begin(), src._samples.end());
+	this->_total += src._total;
+	this->_sorted = this->_samples.empty();
+}
+
+//------------------------------------------------------------------------------
+std::uint64_t IRLoadLatency::percentile(double p) {
+	std::uint64_t rank;
+
+	if (this->_samples.empty()) {
+		return 0;
+	}
+	if (!this->_sorted) {
+		std::sort(this->_samples.begin(), this->_samples.end());
+		this->_sorted = true;
+	}
+	rank = static_cast<std::uint64_t>(
+			std::ceil((p / 100.0) * this->_samples.size()));
+	if (rank > 0) {
+		rank--;
+	}
+	if (rank >= this->_samples.size()) {
+		rank = this->_samples.size() - 1;
+	}
+	return this->_samples[rank];
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _IRLOAD_IRLOADSTATS_H_
+#define _IRLOAD_IRLOADSTATS_H_
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * This class records the latencies of a single call of the public API. Each
+ * worker thread owns its own instances, which are merged at the end of the
+ * run.
+ *
+ * @since 2018.04.26
+ */
+class IRLoadLatency {
+private:
+	/**
+	 * Samples in nanoseconds.
+	 */
+	std::vector<std::uint64_t> _samples;
+
+	/**
+	 * Sum of all samples in nanoseconds.
+	 */
+	std::uint64_t _total;
+
+	/**
+	 * Tells if the samples are sorted.
+	 */
+	bool _sorted;
+public:
+	/**
+	 * Creates a new instance of this class.
+	 */
+	IRLoadLatency();
+
+	/**
+	 * Disposes this instance and releases all associated resources.
+	 */
+	virtual ~IRLoadLatency() = default;
+
+	/**
+	 * Reserves space for the given number of samples.
+	 *
+	 * @param[in] count The expected number of samples.
+	 */
+	void reserve(std::uint64_t count);
+
+	/**
+	 * Adds a new sample.
+	 *
+	 * @param[in] ns The latency in nanoseconds.
+	 */
+	void add(std::uint64_t ns) {
+		this->_samples.push_back(ns);
+		this->_total += ns;
+		this->_sorted = false;
+	}
+
+	/**
+	 * Adds all samples of another instance to this instance.
+	 *
+	 * @param[in] src The source instance.
+	 */
+	void merge(const IRLoadLatency & src);
+
+	/**
+	 * Returns the number of samples.
+	 *
+	 * @return The number of samples.
+	 */
+	std::uint64_t count() const {
+		return this->_samples.size();
+	}
+
+	/**
+	 * Returns the sum of all samples.
+	 *
+	 * @return The sum of all samples in nanoseconds.
+	 */
+	std::uint64_t total() const {
+		return this->_total;
+	}
+
+	/**
+	 * Returns the given percentile using the nearest-rank method.
+	 *
+	 * @param[in] p The percentile, from 0.0 to 100.0.
+	 * @return The percentile in nanoseconds or 0 if there are no samples.
+	 */
+	std::uint64_t percentile(double p);
+};
+
+#endif /* _IRLOAD_IRLOADSTATS_H_ */
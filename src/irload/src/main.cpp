@@ -0,0 +1,451 @@
+/*
+ * Copyright (c) 2017-2018 InterlockLedger Network
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "IRLoadChain.h"
+#include "IRLoadDriver.h"
+#include "IRLoadStats.h"
+#include <irecord/irconst.h>
+#include <irecord/irecord.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Calls measured by irload.
+ */
+typedef enum IRLoadCall {
+	IRLOAD_CALL_ROOT = 0,
+	IRLOAD_CALL_ADD = 1,
+	IRLOAD_CALL_SERIALIZE = 2,
+	IRLOAD_CALL_CHECK = 3,
+	IRLOAD_CALL_COUNT = 4
+} IRLoadCall;
+
+static const char * const IRLOAD_CALL_NAMES[IRLOAD_CALL_COUNT] = {
+	"IRRootBlockCreate",
+	"IRDataBlockAdd",
+	"IRBlockSerialize",
+	"IRCheckParent"
+};
+
+static const char * const IRLOAD_HASH_NAMES[] = {
+	"sha1", "sha256", "sha512", "sha3-256", "sha3-512"};
+
+static const char * const IRLOAD_SIGN_NAMES[] = {
+	"rsa-pss", "rsa-pkcs1", "dsa", "elgamal", "ecdsa", "ed25519"};
+
+/**
+ * Results of a single worker thread.
+ */
+struct IRLoadWorker {
+	IRLoadLatency latency[IRLOAD_CALL_COUNT];
+	std::uint64_t blocks;
+	std::uint64_t payloadBytes;
+	std::uint64_t blockBytes;
+	int error;
+	IRLoadCall errorCall;
+
+	IRLoadWorker(): blocks(0), payloadBytes(0), blockBytes(0),
+			error(IRE_SUCCESS), errorCall(IRLOAD_CALL_ROOT) {}
+};
+
+//------------------------------------------------------------------------------
+static std::uint64_t IRLoad_now() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//------------------------------------------------------------------------------
+static void IRLoad_usage() {
+	std::printf(
+		"Usage: irload [options]\n"
+		"\n"
+		"Generates one synthetic chain per thread and drives it through\n"
+		"IRRootBlockCreate, IRDataBlockAdd, IRBlockSerialize and IRCheckParent.\n"
+		"\n"
+		"Options:\n"
+		"  --driver=api|core     api calls the public C API of irecord, core\n"
+		"                        emulates it with irecordcore (default: core)\n"
+		"  --blocks=N            total number of data blocks (default: 10000)\n"
+		"  --threads=N           number of threads/chains (default: 1)\n"
+		"  --payload=fixed:S     all payloads with S bytes (default: fixed:1024)\n"
+		"  --payload=uniform:MIN:MAX\n"
+		"  --payload=lognormal:MEDIAN:SIGMA:MIN:MAX\n"
+		"  --apps=ID[,ID...]     application IDs used in round robin (default: 1)\n"
+		"  --hash=ALG            sha1, sha256, sha512, sha3-256 or sha3-512\n"
+		"                        (default: sha256)\n"
+		"  --sign=ALG            rsa-pss, rsa-pkcs1, dsa, elgamal, ecdsa or\n"
+		"                        ed25519 (default: rsa-pss)\n"
+		"  --seed=N              seed of the payload generator (default: 1)\n");
+}
+
+//------------------------------------------------------------------------------
+static int IRLoad_findName(const char * const * names, int count,
+		const std::string & name) {
+
+	for (int i = 0; i < count; i++) {
+		if (name == names[i]) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+//------------------------------------------------------------------------------
+static bool IRLoad_parseUInt(const std::string & s, std::uint64_t & v) {
+	char * end;
+
+	if (s.empty()) {
+		return false;
+	}
+	v = std::strtoull(s.c_str(), &end, 0);
+	return (*end == 0);
+}
+
+//------------------------------------------------------------------------------
+static bool IRLoad_parseInt(const std::string & s, int & v) {
+	std::uint64_t tmp;
+
+	if ((!IRLoad_parseUInt(s, tmp)) || (tmp > 0x7FFFFFFF)) {
+		return false;
+	}
+	v = static_cast<int>(tmp);
+	return true;
+}
+
+//------------------------------------------------------------------------------
+static std::vector<std::string> IRLoad_split(const std::string & s, char sep) {
+	std::vector<std::string> ret;
+	std::string::size_type start = 0;
+	std::string::size_type end;
+
+	while ((end = s.find(sep, start)) != std::string::npos) {
+		ret.push_back(s.substr(start, end - start));
+		start = end + 1;
+	}
+	ret.push_back(s.substr(start));
+	return ret;
+}
+
+//------------------------------------------------------------------------------
+static bool IRLoad_parsePayload(const std::string & s, IRLoadOptions & o) {
+	std::vector<std::string> f = IRLoad_split(s, ':');
+	char * end;
+
+	if ((f[0] == "fixed") && (f.size() == 2)) {
+		o.dist = IRLOAD_DIST_FIXED;
+		if (!IRLoad_parseInt(f[1], o.min)) {
+			return false;
+		}
+		o.max = o.min;
+		o.mean = o.min;
+	} else if ((f[0] == "uniform") && (f.size() == 3)) {
+		o.dist = IRLOAD_DIST_UNIFORM;
+		if ((!IRLoad_parseInt(f[1], o.min)) || (!IRLoad_parseInt(f[2], o.max))) {
+			return false;
+		}
+	} else if ((f[0] == "lognormal") && (f.size() == 5)) {
+		o.dist = IRLOAD_DIST_LOGNORMAL;
+		o.sigma = std::strtod(f[2].c_str(), &end);
+		if ((*end != 0) || (o.sigma < 0) ||
+				(!IRLoad_parseInt(f[1], o.mean)) ||
+				(!IRLoad_parseInt(f[3], o.min)) ||
+				(!IRLoad_parseInt(f[4], o.max))) {
+			return false;
+		}
+	} else {
+		return false;
+	}
+	return (o.min <= o.max);
+}
+
+//------------------------------------------------------------------------------
+static bool IRLoad_parse(int argc, char ** argv, IRLoadOptions & o) {
+	std::string arg;
+	std::string name;
+	std::string value;
+	std::string::size_type sep;
+	std::uint64_t id;
+
+	for (int i = 1; i < argc; i++) {
+		arg = argv[i];
+		sep = arg.find('=');
+		if (sep == std::string::npos) {
+			std::fprintf(stderr, "Invalid argument: %s\n", argv[i]);
+			return false;
+		}
+		name = arg.substr(0, sep);
+		value = arg.substr(sep + 1);
+		if (name == "--driver") {
+			if ((value != "api") && (value != "core")) {
+				std::fprintf(stderr, "Unknown driver: %s\n", value.c_str());
+				return false;
+			}
+			o.driver = value;
+		} else if (name == "--blocks") {
+			if (!IRLoad_parseUInt(value, o.blocks)) {
+				std::fprintf(stderr, "Invalid number of blocks.\n");
+				return false;
+			}
+		} else if (name == "--threads") {
+			if ((!IRLoad_parseInt(value, o.threads)) || (o.threads < 1)) {
+				std::fprintf(stderr, "Invalid number of threads.\n");
+				return false;
+			}
+		} else if (name == "--payload") {
+			if (!IRLoad_parsePayload(value, o)) {
+				std::fprintf(stderr, "Invalid payload distribution.\n");
+				return false;
+			}
+		} else if (name == "--apps") {
+			o.applications.clear();
+			for (const std::string & s: IRLoad_split(value, ',')) {
+				if (!IRLoad_parseUInt(s, id)) {
+					std::fprintf(stderr, "Invalid application ID: %s\n",
+							s.c_str());
+					return false;
+				}
+				o.applications.push_back(id);
+			}
+		} else if (name == "--hash") {
+			o.hash = IRLoad_findName(IRLOAD_HASH_NAMES,
+					sizeof(IRLOAD_HASH_NAMES) / sizeof(char *), value);
+			if (o.hash < 0) {
+				std::fprintf(stderr, "Unknown hash: %s\n", value.c_str());
+				return false;
+			}
+		} else if (name == "--sign") {
+			o.sign = IRLoad_findName(IRLOAD_SIGN_NAMES,
+					sizeof(IRLOAD_SIGN_NAMES) / sizeof(char *), value);
+			if (o.sign < 0) {
+				std::fprintf(stderr, "Unknown signature: %s\n", value.c_str());
+				return false;
+			}
+		} else if (name == "--seed") {
+			if (!IRLoad_parseUInt(value, o.seed)) {
+				std::fprintf(stderr, "Invalid seed.\n");
+				return false;
+			}
+		} else {
+			std::fprintf(stderr, "Unknown option: %s\n", name.c_str());
+			return false;
+		}
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Serializes the block, growing the buffer when required.
+ */
+static int IRLoad_serialize(IRLoadDriver & driver, int hBlock,
+		std::vector<std::uint8_t> & buff, int & size) {
+	int retval;
+
+	size = buff.size();
+	retval = driver.blockSerialize(hBlock, &size, buff.data());
+	if (retval == IRE_BUFFER_TOO_SHORT) {
+		buff.resize(size);
+		retval = driver.blockSerialize(hBlock, &size, buff.data());
+	}
+	return retval;
+}
+
+//------------------------------------------------------------------------------
+/**
+ * Creates a chain with the given number of data blocks. Each data block is
+ * serialized and checked against its parent right after its creation.
+ */
+static void IRLoad_run(const IRLoadOptions & options, std::uint64_t blocks,
+		std::uint64_t seed, IRLoadWorker & w) {
+	std::unique_ptr<IRLoadDriver> driver;
+	IRLoadPayloadGenerator gen(options, seed);
+	std::vector<std::uint8_t> buff;
+	std::uint64_t start;
+	int hRoot;
+	int hParent;
+	int hBlock;
+	int size;
+
+	if (options.driver == "api") {
+		driver.reset(new IRLoadAPIDriver());
+	} else {
+		driver.reset(new IRLoadCoreDriver());
+	}
+	w.error = driver->open(options);
+	if (w.error != IRE_SUCCESS) {
+		return;
+	}
+	w.latency[IRLOAD_CALL_ADD].reserve(blocks);
+	w.latency[IRLOAD_CALL_SERIALIZE].reserve(blocks);
+	w.latency[IRLOAD_CALL_CHECK].reserve(blocks);
+
+	start = IRLoad_now();
+	w.error = driver->rootBlockCreate(&hRoot);
+	w.latency[IRLOAD_CALL_ROOT].add(IRLoad_now() - start);
+	if (w.error != IRE_SUCCESS) {
+		w.errorCall = IRLOAD_CALL_ROOT;
+		driver->close();
+		return;
+	}
+
+	hParent = hRoot;
+	for (std::uint64_t i = 0; i < blocks; i++) {
+		gen.next();
+
+		start = IRLoad_now();
+		w.error = driver->dataBlockAdd(hParent, gen.applicationID(),
+				gen.size(), gen.payload(), &hBlock);
+		w.latency[IRLOAD_CALL_ADD].add(IRLoad_now() - start);
+		if (w.error != IRE_SUCCESS) {
+			w.errorCall = IRLOAD_CALL_ADD;
+			break;
+		}
+
+		start = IRLoad_now();
+		w.error = IRLoad_serialize(*driver, hBlock, buff, size);
+		w.latency[IRLOAD_CALL_SERIALIZE].add(IRLoad_now() - start);
+		if (w.error != IRE_SUCCESS) {
+			w.errorCall = IRLOAD_CALL_SERIALIZE;
+			break;
+		}
+
+		start = IRLoad_now();
+		w.error = driver->checkParent(hBlock, hParent);
+		w.latency[IRLOAD_CALL_CHECK].add(IRLoad_now() - start);
+		if (w.error != IRE_SUCCESS) {
+			w.errorCall = IRLOAD_CALL_CHECK;
+			break;
+		}
+
+		w.blocks++;
+		w.payloadBytes += gen.size();
+		w.blockBytes += size;
+		if (hParent != hRoot) {
+			driver->blockDispose(hParent);
+		}
+		hParent = hBlock;
+	}
+	driver->close();
+}
+
+//------------------------------------------------------------------------------
+static void IRLoad_report(const IRLoadOptions & options,
+		std::vector<IRLoadWorker> & workers, std::uint64_t elapsed) {
+	IRLoadLatency latency[IRLOAD_CALL_COUNT];
+	std::uint64_t blocks = 0;
+	std::uint64_t payloadBytes = 0;
+	std::uint64_t blockBytes = 0;
+	double seconds = elapsed / 1e9;
+
+	for (IRLoadWorker & w: workers) {
+		for (int i = 0; i < IRLOAD_CALL_COUNT; i++) {
+			latency[i].merge(w.latency[i]);
+		}
+		blocks += w.blocks;
+		payloadBytes += w.payloadBytes;
+		blockBytes += w.blockBytes;
+	}
+
+	std::printf("driver:    %s\n", options.driver.c_str());
+	std::printf("hash:      %s\n", IRLOAD_HASH_NAMES[options.hash]);
+	std::printf("signature: %s%s\n", IRLOAD_SIGN_NAMES[options.sign],
+			(options.driver == "core") ? " (HMAC stand-in)" : "");
+	std::printf("threads:   %d\n", options.threads);
+	std::printf("blocks:    %llu in %.3f s\n",
+			static_cast<unsigned long long>(blocks), seconds);
+	std::printf("blocks/s:  %.1f\n", blocks / seconds);
+	std::printf("payload:   %.2f MB/s\n", payloadBytes / seconds / 1e6);
+	std::printf("blocks:    %.2f MB/s (serialized)\n",
+			blockBytes / seconds / 1e6);
+	std::printf("\n%-20s %10s %10s %10s %10s %10s\n", "call (us)", "count",
+			"mean", "p50", "p99", "p999");
+	for (int i = 0; i < IRLOAD_CALL_COUNT; i++) {
+		std::printf("%-20s %10llu %10.2f %10.2f %10.2f %10.2f\n",
+				IRLOAD_CALL_NAMES[i],
+				static_cast<unsigned long long>(latency[i].count()),
+				latency[i].count() ?
+						(latency[i].total() / 1e3) / latency[i].count() : 0.0,
+				latency[i].percentile(50.0) / 1e3,
+				latency[i].percentile(99.0) / 1e3,
+				latency[i].percentile(99.9) / 1e3);
+	}
+}
+
+//------------------------------------------------------------------------------
+int main(int argc, char ** argv) {
+	IRLoadOptions options;
+	std::vector<IRLoadWorker> workers;
+	std::vector<std::thread> threads;
+	std::uint64_t start;
+	std::uint64_t elapsed;
+	std::uint64_t blocks;
+	int retval;
+
+	if ((argc == 2) && ((std::strcmp(argv[1], "--help") == 0) ||
+			(std::strcmp(argv[1], "-h") == 0))) {
+		IRLoad_usage();
+		return 0;
+	}
+	if (!IRLoad_parse(argc, argv, options)) {
+		IRLoad_usage();
+		return 1;
+	}
+
+	if (options.driver == "api") {
+		retval = IRInitialize();
+		if (retval != IRE_SUCCESS) {
+			std::fprintf(stderr, "IRInitialize failed with error %d.\n",
+					retval);
+			return 2;
+		}
+	}
+
+	workers.resize(options.threads);
+	start = IRLoad_now();
+	for (int i = 0; i < options.threads; i++) {
+		blocks = options.blocks / options.threads;
+		if (static_cast<std::uint64_t>(i) < (options.blocks % options.threads)) {
+			blocks++;
+		}
+		threads.emplace_back(IRLoad_run, std::cref(options), blocks,
+				options.seed + i, std::ref(workers[i]));
+	}
+	for (std::thread & t: threads) {
+		t.join();
+	}
+	elapsed = IRLoad_now() - start;
+
+	if (options.driver == "api") {
+		IRDeinitialize();
+	}
+
+	retval = 0;
+	for (int i = 0; i < options.threads; i++) {
+		if (workers[i].error != IRE_SUCCESS) {
+			std::fprintf(stderr, "Thread %d: %s failed with error %d.\n", i,
+					IRLOAD_CALL_NAMES[workers[i].errorCall], workers[i].error);
+			retval = 2;
+		}
+	}
+	IRLoad_report(options, workers, elapsed);
+	return retval;
+}